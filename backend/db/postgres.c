@@ -2,12 +2,30 @@
 #include <glib.h>
 #include <gmodule.h>
 #include <libpq-fe.h>
+#include <stdio.h>
+#include <string.h>
 #include <julea.h>
 #include <julea-db.h>
 #include <db-util/jbson.h>
 #include <db-util/sql-generic.h>
 
-#define MAX_BUF_SIZE 4096
+/*
+ * Type OIDs of the built-in PostgreSQL types, see pg_type.dat.
+ * They are fixed and are not exported by libpq.
+ */
+#define J_PG_OID_BOOL 16
+#define J_PG_OID_BYTEA 17
+#define J_PG_OID_INT8 20
+#define J_PG_OID_INT2 21
+#define J_PG_OID_INT4 23
+#define J_PG_OID_FLOAT4 700
+#define J_PG_OID_FLOAT8 701
+
+/*
+ * The maximum number of statements that are sent in pipeline mode before their results are read.
+ * libpq blocks while sending, so the server must not be stalled by unread results.
+ */
+#define J_PG_MAX_PENDING 256
 
 struct JPostgreSQLData
 {
@@ -19,31 +37,281 @@ struct JPostgreSQLData
 
 typedef struct JPostgreSQLData JPostgreSQLData;
 
-struct pg_stmt_wrapper
+struct pg_stmt_wrapper;
+
+struct JPostgreSQLConnection
 {
 	PGconn* conn;
+	/*
+	 * The number of statements sent in pipeline mode whose results have not been read yet.
+	 */
+	guint pending;
+	/*
+	 * The statement whose rows are currently being received in single-row mode.
+	 */
+	struct pg_stmt_wrapper* streaming;
+	guint64 statement_id;
+};
+
+typedef struct JPostgreSQLConnection JPostgreSQLConnection;
+
+struct pg_stmt_wrapper
+{
+	JPostgreSQLConnection* connection;
+	gchar* name;
+	gboolean prepared;
+	gint param_count_in;
+	guint param_count_out;
+	/*
+	 * The parameter types as inferred by the server.
+	 */
+	Oid* param_types;
+	gchar const** param_values;
+	gint* param_lengths;
+	gint* param_formats;
+	/*
+	 * Storage for parameters sent in binary format (network byte order).
+	 */
+	guint64* param_buffer;
+	/*
+	 * Storage for parameters converted to text format.
+	 */
+	gchar** param_text;
 	PGresult* res;
-	gchar* query;
+	gint row;
+	/*
+	 * Results that had to be read ahead because another statement was executed.
+	 */
+	GQueue results[1];
 	gboolean active;
 };
 
 typedef struct pg_stmt_wrapper pg_stmt_wrapper;
 
+/*
+ * Reads the remaining results of the statement being streamed so that the connection can be used for other commands.
+ */
+static void
+j_pg_buffer(JPostgreSQLConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	pg_stmt_wrapper* wrapper = connection->streaming;
+	PGresult* res;
+
+	if (wrapper == NULL)
+	{
+		return;
+	}
+
+	while ((res = PQgetResult(connection->conn)) != NULL)
+	{
+		g_queue_push_tail(wrapper->results, res);
+	}
+
+	connection->streaming = NULL;
+}
+
+/*
+ * Reads the results of all pipelined statements and leaves pipeline mode.
+ * Returns the first error reported for any of the statements.
+ */
+static gboolean
+j_pg_sync(JPostgreSQLConnection* connection, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+#ifdef LIBPQ_HAS_PIPELINING
+	PGresult* res;
+	gboolean ret = TRUE;
+
+	if (PQpipelineStatus(connection->conn) == PQ_PIPELINE_OFF)
+	{
+		return TRUE;
+	}
+
+	if (connection->pending > 0)
+	{
+		if (!PQpipelineSync(connection->conn))
+		{
+			g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql pipeline sync failed: %s", PQerrorMessage(connection->conn));
+			return FALSE;
+		}
+
+		while (TRUE)
+		{
+			if ((res = PQgetResult(connection->conn)) == NULL)
+			{
+				// NULL separates the results of the individual statements
+				if (PQstatus(connection->conn) != CONNECTION_OK)
+				{
+					if (ret)
+					{
+						g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql pipeline failed: %s", PQerrorMessage(connection->conn));
+					}
+
+					ret = FALSE;
+					break;
+				}
+
+				continue;
+			}
+
+			if (PQresultStatus(res) == PGRES_PIPELINE_SYNC)
+			{
+				PQclear(res);
+				break;
+			}
+
+			// Statements following a failed one are reported as PGRES_PIPELINE_ABORTED
+			if (PQresultStatus(res) == PGRES_FATAL_ERROR && ret)
+			{
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQresultErrorMessage(res));
+				ret = FALSE;
+			}
+
+			PQclear(res);
+		}
+
+		connection->pending = 0;
+	}
+
+	PQexitPipelineMode(connection->conn);
+
+	return ret;
+#else
+	(void)connection;
+	(void)error;
+
+	return TRUE;
+#endif
+}
+
+/*
+ * Makes the connection ready for synchronous commands.
+ */
+static gboolean
+j_pg_idle(JPostgreSQLConnection* connection, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	j_pg_buffer(connection);
+
+	return j_pg_sync(connection, error);
+}
+
+/*
+ * Converts the ?-style placeholders used by sql-generic to PostgreSQL's $n-style ones.
+ */
+static gchar*
+j_pg_convert_placeholders(gchar const* sql)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GString* query;
+	gchar quote = '\0';
+	guint count = 0;
+
+	query = g_string_sized_new(strlen(sql) + 16);
+
+	for (gchar const* c = sql; *c != '\0'; c++)
+	{
+		if (quote != '\0')
+		{
+			if (*c == quote)
+			{
+				quote = '\0';
+			}
+		}
+		else if (*c == '\'' || *c == '"')
+		{
+			quote = *c;
+		}
+		else if (*c == '?')
+		{
+			g_string_append_printf(query, "$%u", ++count);
+			continue;
+		}
+
+		g_string_append_c(query, *c);
+	}
+
+	return g_string_free(query, FALSE);
+}
+
+static gboolean
+j_sql_reset(gpointer backend_db, void* _stmt, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	pg_stmt_wrapper* wrapper = _stmt;
+	PGresult* res;
+
+	(void)backend_db;
+	(void)error;
+
+	g_return_val_if_fail(_stmt != NULL, FALSE);
+
+	// Discard the rows that have not been fetched
+	if (wrapper->connection->streaming == wrapper)
+	{
+		while ((res = PQgetResult(wrapper->connection->conn)) != NULL)
+		{
+			PQclear(res);
+		}
+
+		wrapper->connection->streaming = NULL;
+	}
+
+	while ((res = g_queue_pop_head(wrapper->results)) != NULL)
+	{
+		PQclear(res);
+	}
+
+	g_clear_pointer(&(wrapper->res), PQclear);
+
+	wrapper->active = FALSE;
+
+	return TRUE;
+}
+
 static gboolean
 j_sql_finalize(gpointer backend_db, void* _stmt, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
 	pg_stmt_wrapper* wrapper = _stmt;
 
+	(void)error;
+
 	g_return_val_if_fail(backend_db != NULL, FALSE);
 	g_return_val_if_fail(_stmt != NULL, FALSE);
 
-	if (wrapper->res != NULL)
+	j_sql_reset(backend_db, wrapper, NULL);
+
+	if (wrapper->prepared)
 	{
-		PQclear(wrapper->res);
+		g_autofree gchar* sql = NULL;
+
+		sql = g_strdup_printf("DEALLOCATE %s", wrapper->name);
+
+		// Errors are ignored, the statement is dropped with the connection in any case
+		j_pg_idle(wrapper->connection, NULL);
+		PQclear(PQexec(wrapper->connection->conn, sql));
 	}
 
-	g_free(wrapper->query);
+	for (gint i = 0; i < wrapper->param_count_in; i++)
+	{
+		g_free(wrapper->param_text[i]);
+	}
+
+	g_free(wrapper->name);
+	g_free(wrapper->param_types);
+	g_free(wrapper->param_values);
+	g_free(wrapper->param_lengths);
+	g_free(wrapper->param_formats);
+	g_free(wrapper->param_buffer);
+	g_free(wrapper->param_text);
 	g_free(wrapper);
 
 	return TRUE;
@@ -53,18 +321,76 @@ static gboolean
 j_sql_prepare(gpointer backend_db, const char* sql, void* _stmt, GArray* types_in, GArray* types_out, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
+	JPostgreSQLConnection* connection = backend_db;
 	pg_stmt_wrapper** _wrapper = _stmt;
 	pg_stmt_wrapper* wrapper;
+	g_autofree gchar* query = NULL;
+	PGresult* res = NULL;
+
+	(void)types_in;
 
 	g_return_val_if_fail(backend_db != NULL, FALSE);
 	g_return_val_if_fail(sql != NULL, FALSE);
 	g_return_val_if_fail(_stmt != NULL, FALSE);
 
 	wrapper = *_wrapper = g_new0(pg_stmt_wrapper, 1);
-	wrapper->conn = backend_db;
-	wrapper->query = g_strdup(sql);
+	wrapper->connection = connection;
+	wrapper->name = g_strdup_printf("j_stmt_%" G_GUINT64_FORMAT, connection->statement_id++);
+	wrapper->param_count_out = types_out ? types_out->len : 0;
+	g_queue_init(wrapper->results);
+
+	query = j_pg_convert_placeholders(sql);
+
+	if (!j_pg_idle(connection, error))
+	{
+		goto _error;
+	}
+
+	res = PQprepare(connection->conn, wrapper->name, query, 0, NULL);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_PREPARE, "sql prepare failed: %s", PQresultErrorMessage(res));
+		goto _error;
+	}
+
+	wrapper->prepared = TRUE;
+	PQclear(res);
+
+	// The parameters are encoded according to the types inferred by the server
+	res = PQdescribePrepared(connection->conn, wrapper->name);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_PREPARE, "sql prepare failed: %s", PQresultErrorMessage(res));
+		goto _error;
+	}
+
+	wrapper->param_count_in = PQnparams(res);
+	wrapper->param_types = g_new(Oid, wrapper->param_count_in);
+	wrapper->param_values = g_new0(gchar const*, wrapper->param_count_in);
+	wrapper->param_lengths = g_new0(gint, wrapper->param_count_in);
+	wrapper->param_formats = g_new0(gint, wrapper->param_count_in);
+	wrapper->param_buffer = g_new0(guint64, wrapper->param_count_in);
+	wrapper->param_text = g_new0(gchar*, wrapper->param_count_in);
+
+	for (gint i = 0; i < wrapper->param_count_in; i++)
+	{
+		wrapper->param_types[i] = PQparamtype(res, i);
+	}
+
+	PQclear(res);
 
 	return TRUE;
+
+_error:
+	PQclear(res);
+	// sql-generic does not clean up after a failed prepare
+	j_sql_finalize(backend_db, wrapper, NULL);
+	*_wrapper = NULL;
+
+	return FALSE;
 }
 
 static gboolean
@@ -72,8 +398,20 @@ j_sql_bind_null(gpointer backend_db, void* _stmt, guint idx, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	// PostgreSQL does not have a direct bind null function like SQLite or MySQL.
-	// Instead, we handle null values during the execution.
+	pg_stmt_wrapper* wrapper = _stmt;
+
+	(void)backend_db;
+	(void)error;
+
+	g_return_val_if_fail(_stmt != NULL, FALSE);
+
+	idx--; //sqlite index start with 1, libpq index start with 0
+
+	g_return_val_if_fail(idx < (guint)wrapper->param_count_in, FALSE);
+
+	wrapper->param_values[idx] = NULL;
+	wrapper->param_lengths[idx] = 0;
+	wrapper->param_formats[idx] = 0;
 
 	return TRUE;
 }
@@ -82,68 +420,368 @@ static gboolean
 j_sql_bind_value(gpointer backend_db, void* _stmt, guint idx, JDBType type, JDBTypeValue* value, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
 	pg_stmt_wrapper* wrapper = _stmt;
+	guchar* buffer;
+	gboolean is_integer = TRUE;
+	gint64 val_int = 0;
+	gdouble val_float = 0.0;
+
+	(void)backend_db;
+
+	g_return_val_if_fail(_stmt != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
 
-	// PostgreSQL binding happens in the execution function since libpq does not support direct binding like MySQL/SQLite.
-	// Instead, use PQexecParams and handle parameters as part of query execution.
+	idx--; //sqlite index start with 1, libpq index start with 0
+
+	g_return_val_if_fail(idx < (guint)wrapper->param_count_in, FALSE);
+
+	g_clear_pointer(&(wrapper->param_text[idx]), g_free);
+	buffer = (guchar*)&(wrapper->param_buffer[idx]);
+
+	switch (type)
+	{
+		case J_DB_TYPE_SINT32:
+			val_int = value->val_sint32;
+			break;
+		case J_DB_TYPE_UINT32:
+			val_int = value->val_uint32;
+			break;
+		case J_DB_TYPE_SINT64:
+			val_int = value->val_sint64;
+			break;
+		case J_DB_TYPE_UINT64:
+			// BIGINT is signed, the value is stored in two's complement
+			val_int = (gint64)value->val_uint64;
+			break;
+		case J_DB_TYPE_FLOAT32:
+			is_integer = FALSE;
+			val_float = (gdouble)value->val_float32;
+			break;
+		case J_DB_TYPE_FLOAT64:
+			is_integer = FALSE;
+			val_float = value->val_float64;
+			break;
+		case J_DB_TYPE_STRING:
+			// The server converts text to any parameter type
+			wrapper->param_values[idx] = value->val_string;
+			wrapper->param_lengths[idx] = 0;
+			wrapper->param_formats[idx] = 0;
+			return TRUE;
+		case J_DB_TYPE_BLOB:
+			wrapper->param_values[idx] = value->val_blob;
+			wrapper->param_lengths[idx] = value->val_blob_length;
+			wrapper->param_formats[idx] = 1;
+			return TRUE;
+		case J_DB_TYPE_ID:
+		default:
+			g_set_error_literal(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_INVALID_TYPE, "sql invalid type");
+			return FALSE;
+	}
+
+	wrapper->param_values[idx] = (gchar const*)buffer;
+	wrapper->param_formats[idx] = 1;
+
+	// Numbers are sent in binary format using network byte order
+	switch (wrapper->param_types[idx])
+	{
+		case J_PG_OID_INT2:
+		{
+			guint16 tmp;
+
+			tmp = GUINT16_TO_BE((guint16)(is_integer ? val_int : (gint64)val_float));
+			memcpy(buffer, &tmp, sizeof(tmp));
+			wrapper->param_lengths[idx] = sizeof(tmp);
+		}
+		break;
+		case J_PG_OID_INT4:
+		{
+			guint32 tmp;
+
+			tmp = GUINT32_TO_BE((guint32)(is_integer ? val_int : (gint64)val_float));
+			memcpy(buffer, &tmp, sizeof(tmp));
+			wrapper->param_lengths[idx] = sizeof(tmp);
+		}
+		break;
+		case J_PG_OID_INT8:
+		{
+			guint64 tmp;
+
+			tmp = GUINT64_TO_BE((guint64)(is_integer ? val_int : (gint64)val_float));
+			memcpy(buffer, &tmp, sizeof(tmp));
+			wrapper->param_lengths[idx] = sizeof(tmp);
+		}
+		break;
+		case J_PG_OID_FLOAT4:
+		{
+			gfloat val = is_integer ? (gfloat)val_int : (gfloat)val_float;
+			guint32 tmp;
+
+			memcpy(&tmp, &val, sizeof(tmp));
+			tmp = GUINT32_TO_BE(tmp);
+			memcpy(buffer, &tmp, sizeof(tmp));
+			wrapper->param_lengths[idx] = sizeof(tmp);
+		}
+		break;
+		case J_PG_OID_FLOAT8:
+		{
+			gdouble val = is_integer ? (gdouble)val_int : val_float;
+			guint64 tmp;
+
+			memcpy(&tmp, &val, sizeof(tmp));
+			tmp = GUINT64_TO_BE(tmp);
+			memcpy(buffer, &tmp, sizeof(tmp));
+			wrapper->param_lengths[idx] = sizeof(tmp);
+		}
+		break;
+		default:
+			// Other types (such as TEXT or NUMERIC) are sent in text format
+			if (!is_integer)
+			{
+				wrapper->param_text[idx] = g_malloc(G_ASCII_DTOSTR_BUF_SIZE);
+				g_ascii_dtostr(wrapper->param_text[idx], G_ASCII_DTOSTR_BUF_SIZE, val_float);
+			}
+			else if (type == J_DB_TYPE_UINT64)
+			{
+				wrapper->param_text[idx] = g_strdup_printf("%" G_GUINT64_FORMAT, value->val_uint64);
+			}
+			else
+			{
+				wrapper->param_text[idx] = g_strdup_printf("%" G_GINT64_FORMAT, val_int);
+			}
+
+			wrapper->param_values[idx] = wrapper->param_text[idx];
+			wrapper->param_lengths[idx] = 0;
+			wrapper->param_formats[idx] = 0;
+			break;
+	}
 
 	return TRUE;
 }
 
+/*
+ * Advances to the next row, which is either part of the current result,
+ * a result that has been read ahead or the next result received in single-row mode.
+ */
+static gboolean
+j_pg_fetch(pg_stmt_wrapper* wrapper, gboolean* found, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	PGresult* res;
+
+	if (wrapper->res != NULL && wrapper->row + 1 < PQntuples(wrapper->res))
+	{
+		wrapper->row++;
+		*found = TRUE;
+
+		return TRUE;
+	}
+
+	while (TRUE)
+	{
+		g_clear_pointer(&(wrapper->res), PQclear);
+
+		if ((res = g_queue_pop_head(wrapper->results)) == NULL && wrapper->connection->streaming == wrapper)
+		{
+			if ((res = PQgetResult(wrapper->connection->conn)) == NULL)
+			{
+				wrapper->connection->streaming = NULL;
+			}
+		}
+
+		if (res == NULL)
+		{
+			*found = FALSE;
+
+			return TRUE;
+		}
+
+		// The final result of single-row mode is PGRES_TUPLES_OK without any rows
+		if (PQresultStatus(res) != PGRES_SINGLE_TUPLE && PQresultStatus(res) != PGRES_TUPLES_OK)
+		{
+			g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQresultErrorMessage(res));
+			PQclear(res);
+
+			return FALSE;
+		}
+
+		wrapper->res = res;
+		wrapper->row = 0;
+
+		if (PQntuples(res) > 0)
+		{
+			*found = TRUE;
+
+			return TRUE;
+		}
+	}
+}
+
 static gboolean
 j_sql_step(gpointer backend_db, void* _stmt, gboolean* found, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
+	JPostgreSQLConnection* connection = backend_db;
 	pg_stmt_wrapper* wrapper = _stmt;
 
-	// Execute the query and fetch the result
-	wrapper->res = PQexec(wrapper->conn, wrapper->query);
-	if (PQresultStatus(wrapper->res) != PGRES_TUPLES_OK)
+	g_return_val_if_fail(backend_db != NULL, FALSE);
+	g_return_val_if_fail(_stmt != NULL, FALSE);
+	g_return_val_if_fail(found != NULL, FALSE);
+
+	if (!wrapper->active)
 	{
-		g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "SQL step failed: %s", PQerrorMessage(wrapper->conn));
-		return FALSE;
+		if (wrapper->param_count_out == 0)
+		{
+#ifdef LIBPQ_HAS_PIPELINING
+			// Statements without results are pipelined, errors are reported when the pipeline is synchronized
+			if (connection->pending >= J_PG_MAX_PENDING && !j_pg_sync(connection, error))
+			{
+				goto _error;
+			}
+
+			j_pg_buffer(connection);
+
+			if (PQpipelineStatus(connection->conn) == PQ_PIPELINE_OFF && !PQenterPipelineMode(connection->conn))
+			{
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQerrorMessage(connection->conn));
+				goto _error;
+			}
+
+			if (!PQsendQueryPrepared(connection->conn, wrapper->name, wrapper->param_count_in, wrapper->param_values, wrapper->param_lengths, wrapper->param_formats, 1))
+			{
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQerrorMessage(connection->conn));
+				goto _error;
+			}
+
+			connection->pending++;
+#else
+			PGresult* res;
+
+			j_pg_buffer(connection);
+
+			res = PQexecPrepared(connection->conn, wrapper->name, wrapper->param_count_in, wrapper->param_values, wrapper->param_lengths, wrapper->param_formats, 1);
+
+			if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK)
+			{
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQresultErrorMessage(res));
+				PQclear(res);
+				goto _error;
+			}
+
+			PQclear(res);
+#endif
+		}
+		else
+		{
+			if (!j_pg_idle(connection, error))
+			{
+				goto _error;
+			}
+
+			if (!PQsendQueryPrepared(connection->conn, wrapper->name, wrapper->param_count_in, wrapper->param_values, wrapper->param_lengths, wrapper->param_formats, 1))
+			{
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: %s", PQerrorMessage(connection->conn));
+				goto _error;
+			}
+
+			// Rows are received one at a time instead of buffering the complete result
+			if (!PQsetSingleRowMode(connection->conn))
+			{
+				PGresult* res;
+
+				g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql step failed: could not enable single-row mode: %s", PQerrorMessage(connection->conn));
+
+				// Discard the query's results to leave the connection idle
+				while ((res = PQgetResult(connection->conn)) != NULL)
+				{
+					PQclear(res);
+				}
+
+				goto _error;
+			}
+
+			connection->streaming = wrapper;
+		}
+
+		wrapper->active = TRUE;
+	}
+
+	if (wrapper->param_count_out)
+	{
+		return j_pg_fetch(wrapper, found, error);
 	}
 
-	*found = (PQntuples(wrapper->res) > 0);
+	*found = TRUE;
 
 	return TRUE;
+
+_error:
+	return FALSE;
 }
 
 static gboolean
-j_sql_exec(gpointer backend_db, const char* sql, GError** error)
+j_sql_step_and_reset_check_done(gpointer backend_db, void* _stmt, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
-	PGconn* conn = backend_db;
-	PGresult* res;
+
+	gboolean sql_found;
 
 	g_return_val_if_fail(backend_db != NULL, FALSE);
-	g_return_val_if_fail(sql != NULL, FALSE);
+	g_return_val_if_fail(_stmt != NULL, FALSE);
 
-	res = PQexec(conn, sql);
-	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	if (G_UNLIKELY(!j_sql_step(backend_db, _stmt, &sql_found, error)))
 	{
-		g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "SQL execution failed: %s", PQerrorMessage(conn));
-		PQclear(res);
-		return FALSE;
+		goto _error;
 	}
-	PQclear(res);
+
+	if (G_UNLIKELY(!j_sql_reset(backend_db, _stmt, error)))
+	{
+		goto _error;
+	}
+
 	return TRUE;
+
+_error:
+	if (G_UNLIKELY(!j_sql_reset(backend_db, _stmt, NULL)))
+	{
+		goto _error2;
+	}
+
+	return FALSE;
+
+_error2:
+	/*something failed very hard*/
+	return FALSE;
 }
 
 static gboolean
-j_sql_reset(gpointer backend_db, void* _stmt, GError** error)
+j_sql_exec(gpointer backend_db, const char* sql, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
-	pg_stmt_wrapper* wrapper = _stmt;
 
-	// Reset the statement
-	if (wrapper->res != NULL)
+	JPostgreSQLConnection* connection = backend_db;
+	PGresult* res;
+
+	g_return_val_if_fail(backend_db != NULL, FALSE);
+	g_return_val_if_fail(sql != NULL, FALSE);
+
+	if (!j_pg_idle(connection, error))
 	{
-		PQclear(wrapper->res);
-		wrapper->res = NULL;
+		return FALSE;
 	}
 
-	wrapper->active = FALSE;
+	res = PQexec(connection->conn, sql);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		g_set_error(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_STEP, "sql execution failed: %s", PQresultErrorMessage(res));
+		PQclear(res);
+		return FALSE;
+	}
+
+	PQclear(res);
 
 	return TRUE;
 }
@@ -152,46 +790,131 @@ static gboolean
 j_sql_column(gpointer backend_db, void* _stmt, guint idx, JDBType type, JDBTypeValue* value, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
 	pg_stmt_wrapper* wrapper = _stmt;
-	PGresult* res = wrapper->res;
+	gchar const* data;
+	gboolean is_number = TRUE;
+	gint64 val_int = 0;
+	gdouble val_float = 0.0;
+
+	(void)backend_db;
 
-	g_return_val_if_fail(res != NULL, FALSE);
+	g_return_val_if_fail(_stmt != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(wrapper->res != NULL, FALSE);
 
 	memset(value, 0, sizeof(*value));
 
+	if (PQgetisnull(wrapper->res, wrapper->row, idx))
+	{
+		return TRUE;
+	}
+
+	// Results are received in binary format using network byte order
+	data = PQgetvalue(wrapper->res, wrapper->row, idx);
+
+	switch (PQftype(wrapper->res, idx))
+	{
+		case J_PG_OID_BOOL:
+			val_int = data[0] != 0;
+			val_float = val_int;
+			break;
+		case J_PG_OID_INT2:
+		{
+			guint16 tmp;
+
+			memcpy(&tmp, data, sizeof(tmp));
+			val_int = (gint16)GUINT16_FROM_BE(tmp);
+			val_float = val_int;
+		}
+		break;
+		case J_PG_OID_INT4:
+		{
+			guint32 tmp;
+
+			memcpy(&tmp, data, sizeof(tmp));
+			val_int = (gint32)GUINT32_FROM_BE(tmp);
+			val_float = val_int;
+		}
+		break;
+		case J_PG_OID_INT8:
+		{
+			guint64 tmp;
+
+			memcpy(&tmp, data, sizeof(tmp));
+			val_int = (gint64)GUINT64_FROM_BE(tmp);
+			val_float = val_int;
+		}
+		break;
+		case J_PG_OID_FLOAT4:
+		{
+			gfloat val;
+			guint32 tmp;
+
+			memcpy(&tmp, data, sizeof(tmp));
+			tmp = GUINT32_FROM_BE(tmp);
+			memcpy(&val, &tmp, sizeof(val));
+			val_float = (gdouble)val;
+			val_int = val;
+		}
+		break;
+		case J_PG_OID_FLOAT8:
+		{
+			gdouble val;
+			guint64 tmp;
+
+			memcpy(&tmp, data, sizeof(tmp));
+			tmp = GUINT64_FROM_BE(tmp);
+			memcpy(&val, &tmp, sizeof(val));
+			val_float = val;
+			val_int = val;
+		}
+		break;
+		default:
+			is_number = FALSE;
+			break;
+	}
+
 	switch (type)
 	{
 		case J_DB_TYPE_SINT32:
-			value->val_sint32 = atoi(PQgetvalue(res, 0, idx));
+			value->val_sint32 = val_int;
 			break;
 		case J_DB_TYPE_UINT32:
-			value->val_uint32 = (guint32)strtoul(PQgetvalue(res, 0, idx), NULL, 10);
+			value->val_uint32 = val_int;
 			break;
 		case J_DB_TYPE_SINT64:
-			value->val_sint64 = atoll(PQgetvalue(res, 0, idx));
+			value->val_sint64 = val_int;
 			break;
 		case J_DB_TYPE_UINT64:
-			value->val_uint64 = (guint64)strtoull(PQgetvalue(res, 0, idx), NULL, 10);
+			value->val_uint64 = val_int;
 			break;
 		case J_DB_TYPE_FLOAT32:
-			value->val_float32 = (gfloat)atof(PQgetvalue(res, 0, idx));
+			value->val_float32 = val_float;
 			break;
 		case J_DB_TYPE_FLOAT64:
-			value->val_float64 = atof(PQgetvalue(res, 0, idx));
+			value->val_float64 = val_float;
 			break;
 		case J_DB_TYPE_STRING:
-			value->val_string = g_strdup(PQgetvalue(res, 0, idx));
-			break;
+			// libpq terminates all values with a null byte, including binary ones
+			value->val_string = data;
+			return TRUE;
 		case J_DB_TYPE_BLOB:
-			value->val_blob = PQgetvalue(res, 0, idx);
-			value->val_blob_length = PQgetlength(res, 0, idx);
-			break;
+			value->val_blob = data;
+			value->val_blob_length = PQgetlength(wrapper->res, wrapper->row, idx);
+			return TRUE;
 		case J_DB_TYPE_ID:
 		default:
-			g_set_error_literal(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_INVALID_TYPE, "SQL invalid type");
+			g_set_error_literal(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_INVALID_TYPE, "sql invalid type");
 			return FALSE;
 	}
 
+	if (!is_number)
+	{
+		g_set_error_literal(error, J_BACKEND_SQL_ERROR, J_BACKEND_SQL_ERROR_INVALID_TYPE, "sql invalid type");
+		return FALSE;
+	}
+
 	return TRUE;
 }
 
@@ -199,10 +922,13 @@ static void*
 j_sql_open(gpointer backend_data)
 {
 	J_TRACE_FUNCTION(NULL);
+
 	JPostgreSQLData* bd = backend_data;
+	JPostgreSQLConnection* connection;
 	PGconn* conn;
 
 	conn = PQsetdbLogin(bd->db_host, "5432", NULL, NULL, bd->db_database, bd->db_user, bd->db_password);
+
 	if (PQstatus(conn) != CONNECTION_OK)
 	{
 		fprintf(stderr, "Connection to database failed: %s", PQerrorMessage(conn));
@@ -210,18 +936,23 @@ j_sql_open(gpointer backend_data)
 		return NULL;
 	}
 
-	return conn;
+	connection = g_new0(JPostgreSQLConnection, 1);
+	connection->conn = conn;
+
+	return connection;
 }
 
 static void
 j_sql_close(gpointer backend_db)
 {
 	J_TRACE_FUNCTION(NULL);
-	PGconn* conn = backend_db;
 
-	if (conn != NULL)
+	JPostgreSQLConnection* connection = backend_db;
+
+	if (connection != NULL)
 	{
-		PQfinish(conn);
+		PQfinish(connection->conn);
+		g_free(connection);
 	}
 }
 
@@ -236,6 +967,14 @@ static gboolean
 j_sql_commit_transaction(gpointer backend_db, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
+	// Errors of pipelined statements are only reported now, COMMIT would silently roll back
+	if (!j_pg_idle(backend_db, error))
+	{
+		j_sql_exec(backend_db, "ROLLBACK", NULL);
+		return FALSE;
+	}
+
 	return j_sql_exec(backend_db, "COMMIT", error);
 }
 
@@ -243,6 +982,9 @@ static gboolean
 j_sql_abort_transaction(gpointer backend_db, GError** error)
 {
 	J_TRACE_FUNCTION(NULL);
+
+	j_pg_idle(backend_db, NULL);
+
 	return j_sql_exec(backend_db, "ROLLBACK", error);
 }
 
@@ -335,6 +1077,7 @@ static JBackend postgres_backend = {
 		.backend_schema_get = sql_generic_schema_get,
 		.backend_schema_delete = sql_generic_schema_delete,
 		.backend_insert = sql_generic_insert,
+		.backend_insert_many = sql_generic_insert_many,
 		.backend_update = sql_generic_update,
 		.backend_delete = sql_generic_delete,
 		.backend_query = sql_generic_query,
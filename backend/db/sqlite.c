@@ -515,6 +515,7 @@ static JBackend sqlite_backend = {
 		.backend_schema_get = sql_generic_schema_get,
 		.backend_schema_delete = sql_generic_schema_delete,
 		.backend_insert = sql_generic_insert,
+		.backend_insert_many = sql_generic_insert_many,
 		.backend_update = sql_generic_update,
 		.backend_delete = sql_generic_delete,
 		.backend_query = sql_generic_query,
@@ -224,6 +224,19 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	return (iterator != NULL);
 }
 
+static void
+backend_iterate_abort(gpointer backend_data, gpointer data)
+{
+	JGDBMIterator* iterator = data;
+
+	(void)backend_data;
+
+	g_free(iterator->key.dptr);
+	g_free(iterator->value.dptr);
+	g_free(iterator->prefix);
+	g_free(iterator);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -286,8 +299,7 @@ backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstp
 		return TRUE;
 	}
 
-	g_free(iterator->prefix);
-	g_free(iterator);
+	backend_iterate_abort(bd, iterator);
 
 	return FALSE;
 }
@@ -353,7 +365,8 @@ static JBackend gdbm_backend = {
 		.backend_get = backend_get,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterate_abort = backend_iterate_abort }
 };
 
 G_MODULE_EXPORT
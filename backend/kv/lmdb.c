@@ -30,6 +30,7 @@ struct JLMDBBatch
 	MDB_txn* txn;
 	gchar* namespace;
 	JSemantics* semantics;
+	gboolean read_only;
 };
 
 typedef struct JLMDBBatch JLMDBBatch;
@@ -38,6 +39,13 @@ struct JLMDBData
 {
 	MDB_env* env;
 	MDB_dbi dbi;
+
+	/**
+	 * Read-only transactions that have been reset and can be renewed.
+	 * The environment is opened with MDB_NOTLS, so their reader slots are not bound to a thread.
+	 * Each concurrently active worker thread ends up with its own slot.
+	 **/
+	GAsyncQueue* read_txns;
 };
 
 typedef struct JLMDBData JLMDBData;
@@ -53,6 +61,37 @@ struct JLMDBIterator
 
 typedef struct JLMDBIterator JLMDBIterator;
 
+static MDB_txn*
+backend_read_txn_begin(JLMDBData* bd)
+{
+	MDB_txn* txn;
+
+	// Renewing a reset transaction reuses its reader slot.
+	if ((txn = g_async_queue_try_pop(bd->read_txns)) != NULL)
+	{
+		if (mdb_txn_renew(txn) == 0)
+		{
+			return txn;
+		}
+
+		mdb_txn_abort(txn);
+	}
+
+	if (mdb_txn_begin(bd->env, NULL, MDB_RDONLY, &txn) != 0)
+	{
+		return NULL;
+	}
+
+	return txn;
+}
+
+static void
+backend_read_txn_end(JLMDBData* bd, MDB_txn* txn)
+{
+	mdb_txn_reset(txn);
+	g_async_queue_push(bd->read_txns, txn);
+}
+
 static gboolean
 backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* data)
 {
@@ -69,6 +108,31 @@ backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* s
 		batch->txn = txn;
 		batch->namespace = g_strdup(namespace);
 		batch->semantics = j_semantics_ref(semantics);
+		batch->read_only = FALSE;
+	}
+
+	*data = batch;
+
+	return (batch != NULL);
+}
+
+static gboolean
+backend_batch_start_read_only(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* data)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBBatch* batch = NULL;
+	MDB_txn* txn;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	if ((txn = backend_read_txn_begin(bd)) != NULL)
+	{
+		batch = g_new(JLMDBBatch, 1);
+		batch->txn = txn;
+		batch->namespace = g_strdup(namespace);
+		batch->semantics = j_semantics_ref(semantics);
+		batch->read_only = TRUE;
 	}
 
 	*data = batch;
@@ -81,15 +145,19 @@ backend_batch_execute(gpointer backend_data, gpointer data)
 {
 	gboolean ret = FALSE;
 
+	JLMDBData* bd = backend_data;
 	JLMDBBatch* batch = data;
 
-	(void)backend_data;
-
 	g_return_val_if_fail(data != NULL, FALSE);
 
 	/// \todo do something with batch->semantics
 
-	if (mdb_txn_commit(batch->txn) == 0)
+	if (batch->read_only)
+	{
+		backend_read_txn_end(bd, batch->txn);
+		ret = TRUE;
+	}
+	else if (mdb_txn_commit(batch->txn) == 0)
 	{
 		ret = TRUE;
 	}
@@ -196,8 +264,15 @@ backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* data)
 	iterator->prefix = g_strdup_printf("%s:", namespace);
 	iterator->namespace_len = strlen(namespace) + 1;
 
-	mdb_txn_begin(bd->env, NULL, 0, &(iterator->txn));
-	mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+	if ((iterator->txn = backend_read_txn_begin(bd)) == NULL)
+	{
+		g_free(iterator->prefix);
+		g_clear_pointer(&iterator, g_free);
+	}
+	else
+	{
+		mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+	}
 
 	*data = iterator;
 
@@ -219,24 +294,43 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	iterator->prefix = g_strdup_printf("%s:%s", namespace, prefix);
 	iterator->namespace_len = strlen(namespace) + 1;
 
-	mdb_txn_begin(bd->env, NULL, 0, &(iterator->txn));
-	mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+	if ((iterator->txn = backend_read_txn_begin(bd)) == NULL)
+	{
+		g_free(iterator->prefix);
+		g_clear_pointer(&iterator, g_free);
+	}
+	else
+	{
+		mdb_cursor_open(iterator->txn, bd->dbi, &(iterator->cursor));
+	}
 
 	*data = iterator;
 
 	return (iterator != NULL);
 }
 
+static void
+backend_iterate_abort(gpointer backend_data, gpointer data)
+{
+	JLMDBData* bd = backend_data;
+	JLMDBIterator* iterator = data;
+
+	mdb_cursor_close(iterator->cursor);
+	backend_read_txn_end(bd, iterator->txn);
+
+	g_free(iterator->prefix);
+	g_free(iterator);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstpointer* value, guint32* len)
 {
+	JLMDBData* bd = backend_data;
 	JLMDBIterator* iterator = data;
 	MDB_cursor_op cursor_op = MDB_NEXT;
 	MDB_val m_key;
 	MDB_val m_value;
 
-	(void)backend_data;
-
 	g_return_val_if_fail(data != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
@@ -268,10 +362,7 @@ backend_iterate(gpointer backend_data, gpointer data, gchar const** key, gconstp
 	}
 
 out:
-	mdb_txn_commit(iterator->txn);
-
-	g_free(iterator->prefix);
-	g_free(iterator);
+	backend_iterate_abort(bd, iterator);
 
 	return FALSE;
 }
@@ -287,6 +378,7 @@ backend_init(gchar const* path, gpointer* backend_data)
 	g_mkdir_with_parents(path, 0700);
 
 	bd = g_new(JLMDBData, 1);
+	bd->read_txns = g_async_queue_new();
 
 	if (mdb_env_create(&(bd->env)) == 0)
 	{
@@ -296,7 +388,8 @@ backend_init(gchar const* path, gpointer* backend_data)
 			goto error;
 		}
 
-		if (mdb_env_open(bd->env, path, 0, 0600) != 0)
+		// Read-only transactions are reused across threads.
+		if (mdb_env_open(bd->env, path, MDB_NOTLS, 0600) != 0)
 		{
 			goto error;
 		}
@@ -323,6 +416,7 @@ backend_init(gchar const* path, gpointer* backend_data)
 
 error:
 	mdb_env_close(bd->env);
+	g_async_queue_unref(bd->read_txns);
 	g_free(bd);
 
 	return FALSE;
@@ -332,6 +426,15 @@ static void
 backend_fini(gpointer backend_data)
 {
 	JLMDBData* bd = backend_data;
+	MDB_txn* txn;
+
+	// Reader slots have to be released before closing the environment.
+	while ((txn = g_async_queue_try_pop(bd->read_txns)) != NULL)
+	{
+		mdb_txn_abort(txn);
+	}
+
+	g_async_queue_unref(bd->read_txns);
 
 	if (bd->env != NULL)
 	{
@@ -350,12 +453,14 @@ static JBackend lmdb_backend = {
 		.backend_fini = backend_fini,
 		.backend_batch_start = backend_batch_start,
 		.backend_batch_execute = backend_batch_execute,
+		.backend_batch_start_read_only = backend_batch_start_read_only,
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterate_abort = backend_iterate_abort }
 };
 
 G_MODULE_EXPORT
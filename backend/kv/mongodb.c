@@ -445,6 +445,18 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	return ret;
 }
 
+static void
+backend_iterate_abort(gpointer backend_data, gpointer backend_iterator)
+{
+	JMongoDBData* bd = backend_data;
+
+	mongoc_cursor_t* cursor = backend_iterator;
+
+	g_mutex_lock(bd->mutex);
+	mongoc_cursor_destroy(cursor);
+	g_mutex_unlock(bd->mutex);
+}
+
 static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
@@ -528,7 +540,8 @@ static JBackend mongodb_backend = {
 		.backend_get = backend_get,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterate_abort = backend_iterate_abort }
 };
 
 G_MODULE_EXPORT
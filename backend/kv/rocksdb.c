@@ -221,6 +221,18 @@ backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const
 	return (iterator != NULL);
 }
 
+static void
+backend_iterate_abort(gpointer backend_data, gpointer backend_iterator)
+{
+	JRocksDBIterator* iterator = backend_iterator;
+
+	(void)backend_data;
+
+	g_free(iterator->prefix);
+	rocksdb_iter_destroy(iterator->iterator);
+	g_free(iterator);
+}
+
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
@@ -263,9 +275,7 @@ backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const**
 	}
 
 out:
-	g_free(iterator->prefix);
-	rocksdb_iter_destroy(iterator->iterator);
-	g_free(iterator);
+	backend_iterate_abort(backend_data, iterator);
 
 	return FALSE;
 }
@@ -343,7 +353,8 @@ static JBackend rocksdb_backend = {
 		.backend_get = backend_get,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterate_abort = backend_iterate_abort }
 };
 
 G_MODULE_EXPORT
@@ -25,47 +25,232 @@
 
 #include <julea.h>
 
+/**
+ * A connection including its prepared statements.
+ * Connections are not shared, each active batch or iterator uses its own one.
+ **/
+struct JSQLiteConnection
+{
+	sqlite3* db;
+
+	sqlite3_stmt* stmt_put;
+	sqlite3_stmt* stmt_delete;
+	sqlite3_stmt* stmt_get;
+	sqlite3_stmt* stmt_get_all;
+	sqlite3_stmt* stmt_get_by_prefix;
+
+	/**
+	 * The current value of the synchronous pragma, -1 if unknown.
+	 **/
+	gint synchronous;
+};
+
+typedef struct JSQLiteConnection JSQLiteConnection;
+
 struct JSQLiteBatch
 {
+	JSQLiteConnection* connection;
 	gchar* namespace;
 	JSemantics* semantics;
 };
 
 typedef struct JSQLiteBatch JSQLiteBatch;
 
+struct JSQLiteIterator
+{
+	JSQLiteConnection* connection;
+	sqlite3_stmt* stmt;
+};
+
+typedef struct JSQLiteIterator JSQLiteIterator;
+
 struct JSQLiteData
 {
-	sqlite3* db;
-	GMutex mutex[1];
+	gchar* path;
+
+	/**
+	 * Idle connections.
+	 * Worker threads take a connection for the duration of a batch, so each concurrently active thread ends up with its own one.
+	 **/
+	GAsyncQueue* connections;
 };
 
 typedef struct JSQLiteData JSQLiteData;
 
+static void
+backend_connection_close(JSQLiteConnection* connection)
+{
+	// sqlite3_finalize is a no-op for NULL statements
+	sqlite3_finalize(connection->stmt_put);
+	sqlite3_finalize(connection->stmt_delete);
+	sqlite3_finalize(connection->stmt_get);
+	sqlite3_finalize(connection->stmt_get_all);
+	sqlite3_finalize(connection->stmt_get_by_prefix);
+
+	sqlite3_close(connection->db);
+
+	g_free(connection);
+}
+
+static JSQLiteConnection*
+backend_connection_open(JSQLiteData* bd)
+{
+	JSQLiteConnection* connection;
+
+	connection = g_new0(JSQLiteConnection, 1);
+	connection->synchronous = -1;
+
+	if (sqlite3_open(bd->path, &(connection->db)) != SQLITE_OK)
+	{
+		goto error;
+	}
+
+	// Writers lock the whole database, wait for them instead of failing
+	sqlite3_busy_timeout(connection->db, 60 * 1000);
+
+	if (sqlite3_prepare_v2(connection->db, "INSERT OR REPLACE INTO julea (namespace, key, value) VALUES (?, ?, ?);", -1, &(connection->stmt_put), NULL) != SQLITE_OK
+	    || sqlite3_prepare_v2(connection->db, "DELETE FROM julea WHERE namespace = ? AND key = ?;", -1, &(connection->stmt_delete), NULL) != SQLITE_OK
+	    || sqlite3_prepare_v2(connection->db, "SELECT value FROM julea WHERE namespace = ? AND key = ?;", -1, &(connection->stmt_get), NULL) != SQLITE_OK
+	    || sqlite3_prepare_v2(connection->db, "SELECT key, value FROM julea WHERE namespace = ?;", -1, &(connection->stmt_get_all), NULL) != SQLITE_OK
+	    || sqlite3_prepare_v2(connection->db, "SELECT key, value FROM julea WHERE namespace = ? AND key LIKE ? || '%';", -1, &(connection->stmt_get_by_prefix), NULL) != SQLITE_OK)
+	{
+		goto error;
+	}
+
+	return connection;
+
+error:
+	backend_connection_close(connection);
+
+	return NULL;
+}
+
+static JSQLiteConnection*
+backend_connection_pop(JSQLiteData* bd)
+{
+	JSQLiteConnection* connection;
+
+	if ((connection = g_async_queue_try_pop(bd->connections)) != NULL)
+	{
+		return connection;
+	}
+
+	return backend_connection_open(bd);
+}
+
+static void
+backend_connection_push(JSQLiteData* bd, JSQLiteConnection* connection)
+{
+	g_async_queue_push(bd->connections, connection);
+}
+
+/**
+ * Resets a statement so it can be reused.
+ *
+ * \param stmt A statement.
+ **/
+static void
+backend_statement_reset(sqlite3_stmt* stmt)
+{
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+}
+
+/**
+ * Sets the synchronous pragma according to the persistency semantics.
+ * In WAL mode, NORMAL only risks losing the most recent transactions on power loss.
+ *
+ * \param connection A connection.
+ * \param semantics  A semantics object.
+ **/
+static void
+backend_connection_set_synchronous(JSQLiteConnection* connection, JSemantics* semantics)
+{
+	gint synchronous;
+
+	switch (j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY))
+	{
+		case J_SEMANTICS_PERSISTENCY_STORAGE:
+			synchronous = 2;
+			break;
+		case J_SEMANTICS_PERSISTENCY_NETWORK:
+			synchronous = 1;
+			break;
+		case J_SEMANTICS_PERSISTENCY_NONE:
+			synchronous = 0;
+			break;
+		default:
+			g_assert_not_reached();
+	}
+
+	if (synchronous != connection->synchronous)
+	{
+		g_autofree gchar* pragma = NULL;
+
+		// Cannot be changed within a transaction
+		pragma = g_strdup_printf("PRAGMA synchronous = %d;", synchronous);
+
+		if (sqlite3_exec(connection->db, pragma, NULL, NULL, NULL) == SQLITE_OK)
+		{
+			connection->synchronous = synchronous;
+		}
+	}
+}
+
 static gboolean
-backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* backend_batch)
+backend_batch_begin(JSQLiteData* bd, gchar const* namespace, JSemantics* semantics, gchar const* begin, gpointer* backend_batch)
 {
 	JSQLiteBatch* batch = NULL;
-	JSQLiteData* bd = backend_data;
+	JSQLiteConnection* connection;
 
-	g_return_val_if_fail(namespace != NULL, FALSE);
-	g_return_val_if_fail(backend_batch != NULL, FALSE);
+	if ((connection = backend_connection_pop(bd)) == NULL)
+	{
+		goto end;
+	}
 
-	g_mutex_lock(bd->mutex);
+	backend_connection_set_synchronous(connection, semantics);
 
-	/// \todo Use immediate transaction and check for busy?
-	if (sqlite3_exec(bd->db, "BEGIN;", NULL, NULL, NULL) == SQLITE_OK)
+	if (sqlite3_exec(connection->db, begin, NULL, NULL, NULL) != SQLITE_OK)
 	{
-		batch = g_new(JSQLiteBatch, 1);
-
-		batch->namespace = g_strdup(namespace);
-		batch->semantics = j_semantics_ref(semantics);
+		backend_connection_push(bd, connection);
+		goto end;
 	}
 
+	batch = g_new(JSQLiteBatch, 1);
+	batch->connection = connection;
+	batch->namespace = g_strdup(namespace);
+	batch->semantics = j_semantics_ref(semantics);
+
+end:
 	*backend_batch = batch;
 
 	return (batch != NULL);
 }
 
+static gboolean
+backend_batch_start(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* backend_batch)
+{
+	JSQLiteData* bd = backend_data;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+
+	// Take the write lock immediately, upgrading a read transaction later could fail with SQLITE_BUSY
+	return backend_batch_begin(bd, namespace, semantics, "BEGIN IMMEDIATE;", backend_batch);
+}
+
+static gboolean
+backend_batch_start_read_only(gpointer backend_data, gchar const* namespace, JSemantics* semantics, gpointer* backend_batch)
+{
+	JSQLiteData* bd = backend_data;
+
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(backend_batch != NULL, FALSE);
+
+	// In WAL mode, read transactions neither block nor are blocked by the writer
+	return backend_batch_begin(bd, namespace, semantics, "BEGIN DEFERRED;", backend_batch);
+}
+
 static gboolean
 backend_batch_execute(gpointer backend_data, gpointer backend_batch)
 {
@@ -76,14 +261,16 @@ backend_batch_execute(gpointer backend_data, gpointer backend_batch)
 
 	g_return_val_if_fail(backend_batch != NULL, FALSE);
 
-	/// \todo do something with batch->semantics
-
-	if (sqlite3_exec(bd->db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK)
+	if (sqlite3_exec(batch->connection->db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK)
 	{
 		ret = TRUE;
 	}
+	else
+	{
+		sqlite3_exec(batch->connection->db, "ROLLBACK;", NULL, NULL, NULL);
+	}
 
-	g_mutex_unlock(bd->mutex);
+	backend_connection_push(bd, batch->connection);
 
 	j_semantics_unref(batch->semantics);
 	g_free(batch->namespace);
@@ -95,63 +282,73 @@ backend_batch_execute(gpointer backend_data, gpointer backend_batch)
 static gboolean
 backend_put(gpointer backend_data, gpointer backend_batch, gchar const* key, gconstpointer value, guint32 len)
 {
+	gboolean ret;
+
 	JSQLiteBatch* batch = backend_batch;
-	JSQLiteData* bd = backend_data;
 	sqlite3_stmt* stmt;
 
+	(void)backend_data;
+
 	g_return_val_if_fail(backend_batch != NULL, FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 
-	sqlite3_prepare_v2(bd->db, "INSERT OR REPLACE INTO julea (namespace, key, value) VALUES (?, ?, ?);", -1, &stmt, NULL);
+	stmt = batch->connection->stmt_put;
+
 	sqlite3_bind_text(stmt, 1, batch->namespace, -1, NULL);
 	sqlite3_bind_text(stmt, 2, key, -1, NULL);
 	sqlite3_bind_blob(stmt, 3, value, len, NULL);
 
-	sqlite3_step(stmt);
-	sqlite3_finalize(stmt);
+	ret = (sqlite3_step(stmt) == SQLITE_DONE);
 
-	/// \todo
-	return TRUE;
+	backend_statement_reset(stmt);
+
+	return ret;
 }
 
 static gboolean
 backend_delete(gpointer backend_data, gpointer backend_batch, gchar const* key)
 {
+	gboolean ret;
+
 	JSQLiteBatch* batch = backend_batch;
-	JSQLiteData* bd = backend_data;
 	sqlite3_stmt* stmt;
 
+	(void)backend_data;
+
 	g_return_val_if_fail(backend_batch != NULL, FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
 
-	sqlite3_prepare_v2(bd->db, "DELETE FROM julea WHERE namespace = ? AND key = ?;", -1, &stmt, NULL);
+	stmt = batch->connection->stmt_delete;
+
 	sqlite3_bind_text(stmt, 1, batch->namespace, -1, NULL);
 	sqlite3_bind_text(stmt, 2, key, -1, NULL);
 
-	sqlite3_step(stmt);
-	sqlite3_finalize(stmt);
+	ret = (sqlite3_step(stmt) == SQLITE_DONE);
 
-	/// \todo
-	return TRUE;
+	backend_statement_reset(stmt);
+
+	return ret;
 }
 
 static gboolean
 backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpointer* value, guint32* len)
 {
 	JSQLiteBatch* batch = backend_batch;
-	JSQLiteData* bd = backend_data;
 	sqlite3_stmt* stmt;
 	gint ret;
 	gconstpointer result = NULL;
 	gsize result_len;
 
+	(void)backend_data;
+
 	g_return_val_if_fail(backend_batch != NULL, FALSE);
 	g_return_val_if_fail(key != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
 
-	sqlite3_prepare_v2(bd->db, "SELECT value FROM julea WHERE namespace = ? AND key = ?;", -1, &stmt, NULL);
+	stmt = batch->connection->stmt_get;
+
 	sqlite3_bind_text(stmt, 1, batch->namespace, -1, NULL);
 	sqlite3_bind_text(stmt, 2, key, -1, NULL);
 
@@ -171,7 +368,7 @@ backend_get(gpointer backend_data, gpointer backend_batch, gchar const* key, gpo
 		*len = result_len;
 	}
 
-	sqlite3_finalize(stmt);
+	backend_statement_reset(stmt);
 
 	return (result != NULL);
 }
@@ -180,68 +377,86 @@ static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
 	JSQLiteData* bd = backend_data;
-	sqlite3_stmt* stmt = NULL;
+	JSQLiteConnection* connection;
+	JSQLiteIterator* iterator = NULL;
 
 	g_return_val_if_fail(namespace != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	g_mutex_lock(bd->mutex);
-
-	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ?;", -1, &stmt, NULL) == SQLITE_OK)
+	if ((connection = backend_connection_pop(bd)) != NULL)
 	{
-		sqlite3_bind_text(stmt, 1, namespace, -1, NULL);
+		iterator = g_new(JSQLiteIterator, 1);
+		iterator->connection = connection;
+		iterator->stmt = connection->stmt_get_all;
+
+		// SQLITE_TRANSIENT makes SQLite copy the namespace
+		sqlite3_bind_text(iterator->stmt, 1, namespace, -1, SQLITE_TRANSIENT);
 	}
 
-	*backend_iterator = stmt;
+	*backend_iterator = iterator;
 
-	return (stmt != NULL);
+	return (iterator != NULL);
 }
 
 static gboolean
 backend_get_by_prefix(gpointer backend_data, gchar const* namespace, gchar const* prefix, gpointer* backend_iterator)
 {
 	JSQLiteData* bd = backend_data;
-	sqlite3_stmt* stmt = NULL;
+	JSQLiteConnection* connection;
+	JSQLiteIterator* iterator = NULL;
 
 	g_return_val_if_fail(namespace != NULL, FALSE);
 	g_return_val_if_fail(prefix != NULL, FALSE);
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 
-	g_mutex_lock(bd->mutex);
-
-	if (sqlite3_prepare_v2(bd->db, "SELECT key, value FROM julea WHERE namespace = ? AND key LIKE ? || '%';", -1, &stmt, NULL) == SQLITE_OK)
+	if ((connection = backend_connection_pop(bd)) != NULL)
 	{
-		sqlite3_bind_text(stmt, 1, namespace, -1, NULL);
-		sqlite3_bind_text(stmt, 2, prefix, -1, NULL);
+		iterator = g_new(JSQLiteIterator, 1);
+		iterator->connection = connection;
+		iterator->stmt = connection->stmt_get_by_prefix;
+
+		// SQLITE_TRANSIENT makes SQLite copy the namespace and prefix
+		sqlite3_bind_text(iterator->stmt, 1, namespace, -1, SQLITE_TRANSIENT);
+		sqlite3_bind_text(iterator->stmt, 2, prefix, -1, SQLITE_TRANSIENT);
 	}
 
-	*backend_iterator = stmt;
+	*backend_iterator = iterator;
 
-	return (stmt != NULL);
+	return (iterator != NULL);
+}
+
+static void
+backend_iterate_abort(gpointer backend_data, gpointer backend_iterator)
+{
+	JSQLiteData* bd = backend_data;
+	JSQLiteIterator* iterator = backend_iterator;
+
+	backend_statement_reset(iterator->stmt);
+	backend_connection_push(bd, iterator->connection);
+
+	g_free(iterator);
 }
 
 static gboolean
 backend_iterate(gpointer backend_data, gpointer backend_iterator, gchar const** key, gconstpointer* value, guint32* len)
 {
 	JSQLiteData* bd = backend_data;
-	sqlite3_stmt* stmt = backend_iterator;
+	JSQLiteIterator* iterator = backend_iterator;
 
 	g_return_val_if_fail(backend_iterator != NULL, FALSE);
 	g_return_val_if_fail(value != NULL, FALSE);
 	g_return_val_if_fail(len != NULL, FALSE);
 
-	if (sqlite3_step(stmt) == SQLITE_ROW)
+	if (sqlite3_step(iterator->stmt) == SQLITE_ROW)
 	{
-		*key = (gchar const*)sqlite3_column_text(stmt, 0);
-		*value = sqlite3_column_blob(stmt, 1);
-		*len = sqlite3_column_bytes(stmt, 1);
+		*key = (gchar const*)sqlite3_column_text(iterator->stmt, 0);
+		*value = sqlite3_column_blob(iterator->stmt, 1);
+		*len = sqlite3_column_bytes(iterator->stmt, 1);
 
 		return TRUE;
 	}
 
-	sqlite3_finalize(stmt);
-
-	g_mutex_unlock(bd->mutex);
+	backend_iterate_abort(bd, iterator);
 
 	return FALSE;
 }
@@ -250,6 +465,8 @@ static gboolean
 backend_init(gchar const* path, gpointer* backend_data)
 {
 	JSQLiteData* bd;
+	JSQLiteConnection* connection;
+	sqlite3* db = NULL;
 	g_autofree gchar* dirname = NULL;
 
 	g_return_val_if_fail(path != NULL, FALSE);
@@ -258,30 +475,49 @@ backend_init(gchar const* path, gpointer* backend_data)
 	g_mkdir_with_parents(dirname, 0700);
 
 	bd = g_new(JSQLiteData, 1);
+	bd->path = g_strdup(path);
+	bd->connections = g_async_queue_new();
+
+	if (sqlite3_open(path, &db) != SQLITE_OK)
+	{
+		goto error;
+	}
+
+	// The journal mode is persistent and applies to all connections
+	if (sqlite3_exec(db, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL) != SQLITE_OK)
+	{
+		goto error;
+	}
 
-	if (sqlite3_open(path, &(bd->db)) != SQLITE_OK)
+	if (sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS julea (namespace TEXT NOT NULL, key TEXT NOT NULL, value BLOB NOT NULL);", NULL, NULL, NULL) != SQLITE_OK)
 	{
 		goto error;
 	}
 
-	if (sqlite3_exec(bd->db, "CREATE TABLE IF NOT EXISTS julea (namespace TEXT NOT NULL, key TEXT NOT NULL, value BLOB NOT NULL);", NULL, NULL, NULL) != SQLITE_OK)
+	if (sqlite3_exec(db, "CREATE UNIQUE INDEX IF NOT EXISTS julea_namespace_key ON julea (namespace, key);", NULL, NULL, NULL) != SQLITE_OK)
 	{
 		goto error;
 	}
 
-	if (sqlite3_exec(bd->db, "CREATE UNIQUE INDEX IF NOT EXISTS julea_namespace_key ON julea (namespace, key);", NULL, NULL, NULL) != SQLITE_OK)
+	sqlite3_close(db);
+	db = NULL;
+
+	// Make sure that connections can be opened and statements prepared
+	if ((connection = backend_connection_open(bd)) == NULL)
 	{
 		goto error;
 	}
 
-	g_mutex_init(bd->mutex);
+	backend_connection_push(bd, connection);
 
 	*backend_data = bd;
 
-	return (bd->db != NULL);
+	return TRUE;
 
 error:
-	sqlite3_close(bd->db);
+	sqlite3_close(db);
+	g_async_queue_unref(bd->connections);
+	g_free(bd->path);
 	g_free(bd);
 
 	return FALSE;
@@ -291,13 +527,15 @@ static void
 backend_fini(gpointer backend_data)
 {
 	JSQLiteData* bd = backend_data;
+	JSQLiteConnection* connection;
 
-	if (bd->db != NULL)
+	while ((connection = g_async_queue_try_pop(bd->connections)) != NULL)
 	{
-		sqlite3_close(bd->db);
+		backend_connection_close(connection);
 	}
 
-	g_mutex_clear(bd->mutex);
+	g_async_queue_unref(bd->connections);
+	g_free(bd->path);
 
 	g_free(bd);
 }
@@ -311,12 +549,14 @@ static JBackend sqlite_backend = {
 		.backend_fini = backend_fini,
 		.backend_batch_start = backend_batch_start,
 		.backend_batch_execute = backend_batch_execute,
+		.backend_batch_start_read_only = backend_batch_start_read_only,
 		.backend_put = backend_put,
 		.backend_delete = backend_delete,
 		.backend_get = backend_get,
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
-		.backend_iterate = backend_iterate }
+		.backend_iterate = backend_iterate,
+		.backend_iterate_abort = backend_iterate_abort }
 };
 
 G_MODULE_EXPORT
@@ -16,6 +16,11 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifdef JULEA_OBJECT_URING
+// Required for O_DIRECT.
+#define _GNU_SOURCE
+#endif
+
 #include <julea-config.h>
 
 #include <glib.h>
@@ -23,16 +28,43 @@
 #include <gmodule.h>
 
 #include <fcntl.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#ifdef JULEA_OBJECT_URING
+#include <liburing.h>
+#endif
+
 #include <julea.h>
 
+#ifdef JULEA_OBJECT_URING
+/**
+ * The number of submission queue entries of each thread's ring.
+ **/
+#define BACKEND_RING_ENTRIES 256
+
+/**
+ * The maximum length of a single submitted read or write, longer ones are completed synchronously.
+ **/
+#define BACKEND_RING_MAX_LENGTH (1024 * 1024 * 1024)
+
+/**
+ * The alignment of buffers, lengths and offsets required for direct I/O.
+ **/
+#define BACKEND_DIRECT_ALIGNMENT 4096
+#endif
+
 struct JBackendData
 {
 	gchar* path;
 	/// \todo check whether hash tables can stay global
+
+	/**
+	 * Whether aligned reads and writes should bypass the page cache.
+	 **/
+	gboolean direct;
 };
 
 typedef struct JBackendData JBackendData;
@@ -49,6 +81,13 @@ struct JBackendObject
 {
 	gchar* path;
 	gint fd;
+
+	/**
+	 * The file descriptor used for direct I/O.
+	 * It is opened on first use, -2 means not yet opened and -1 that opening failed.
+	 **/
+	gint fd_direct;
+
 	guint ref_count;
 };
 
@@ -86,6 +125,12 @@ backend_file_unref(gpointer data)
 
 		j_trace_file_begin(bo->path, J_TRACE_FILE_CLOSE);
 		close(bo->fd);
+
+		if (bo->fd_direct >= 0)
+		{
+			close(bo->fd_direct);
+		}
+
 		j_trace_file_end(bo->path, J_TRACE_FILE_CLOSE, 0, 0);
 
 		g_free(bo->path);
@@ -189,6 +234,7 @@ backend_create(gpointer backend_data, gchar const* namespace, gchar const* path,
 	bo = g_new(JBackendObject, 1);
 	bo->path = full_path;
 	bo->fd = fd;
+	bo->fd_direct = -2;
 	bo->ref_count = 1;
 
 	backend_file_add(files, bo);
@@ -234,6 +280,7 @@ backend_open(gpointer backend_data, gchar const* namespace, gchar const* path, g
 	bo = g_new(JBackendObject, 1);
 	bo->path = full_path;
 	bo->fd = fd;
+	bo->fd_direct = -2;
 	bo->ref_count = 1;
 
 	backend_file_add(files, bo);
@@ -324,22 +371,16 @@ backend_sync(gpointer backend_data, gpointer backend_object)
 	return ret;
 }
 
-static gboolean
-backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+static guint64
+backend_pread(gint fd, gpointer buffer, guint64 length, guint64 offset)
 {
-	JBackendObject* bo = backend_object;
-
-	gsize nbytes_total = 0;
-
-	(void)backend_data;
-
-	j_trace_file_begin(bo->path, J_TRACE_FILE_READ);
+	guint64 nbytes_total = 0;
 
 	while (nbytes_total < length)
 	{
 		gssize nbytes;
 
-		nbytes = pread(bo->fd, (gchar*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
+		nbytes = pread(fd, (gchar*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
 
 		if (nbytes == 0)
 		{
@@ -351,11 +392,54 @@ backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, gu
 			{
 				break;
 			}
+
+			continue;
+		}
+
+		nbytes_total += nbytes;
+	}
+
+	return nbytes_total;
+}
+
+static guint64
+backend_pwrite(gint fd, gconstpointer buffer, guint64 length, guint64 offset)
+{
+	guint64 nbytes_total = 0;
+
+	while (nbytes_total < length)
+	{
+		gssize nbytes;
+
+		nbytes = pwrite(fd, (gchar const*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
+
+		if (nbytes <= 0)
+		{
+			if (nbytes < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
 		}
 
 		nbytes_total += nbytes;
 	}
 
+	return nbytes_total;
+}
+
+static gboolean
+backend_read(gpointer backend_data, gpointer backend_object, gpointer buffer, guint64 length, guint64 offset, guint64* bytes_read)
+{
+	JBackendObject* bo = backend_object;
+
+	guint64 nbytes_total;
+
+	(void)backend_data;
+
+	j_trace_file_begin(bo->path, J_TRACE_FILE_READ);
+	nbytes_total = backend_pread(bo->fd, buffer, length, offset);
 	j_trace_file_end(bo->path, J_TRACE_FILE_READ, nbytes_total, offset);
 
 	if (bytes_read != NULL)
@@ -371,39 +455,406 @@ backend_write(gpointer backend_data, gpointer backend_object, gconstpointer buff
 {
 	JBackendObject* bo = backend_object;
 
-	gsize nbytes_total = 0;
+	guint64 nbytes_total;
 
 	(void)backend_data;
 
 	j_trace_file_begin(bo->path, J_TRACE_FILE_WRITE);
+	nbytes_total = backend_pwrite(bo->fd, buffer, length, offset);
+	j_trace_file_end(bo->path, J_TRACE_FILE_WRITE, nbytes_total, offset);
 
-	while (nbytes_total < length)
+	if (bytes_written != NULL)
 	{
-		gssize nbytes;
+		*bytes_written = nbytes_total;
+	}
 
-		nbytes = pwrite(bo->fd, (gchar const*)buffer + nbytes_total, length - nbytes_total, offset + nbytes_total);
+	return (nbytes_total == length);
+}
 
-		if (nbytes <= 0)
+#ifdef JULEA_OBJECT_URING
+
+struct JBackendRing
+{
+	struct io_uring ring;
+
+	/**
+	 * The last buffer passed to backend_register_buffer().
+	 **/
+	gchar* buffer;
+	guint64 buffer_size;
+
+	/**
+	 * Whether the buffer could be registered.
+	 * Registering pins the buffer's pages and can fail due to RLIMIT_MEMLOCK.
+	 **/
+	gboolean buffer_registered;
+};
+
+typedef struct JBackendRing JBackendRing;
+
+static void
+backend_ring_free(gpointer data)
+{
+	JBackendRing* ring = data;
+
+	io_uring_queue_exit(&(ring->ring));
+	g_free(ring);
+}
+
+static GPrivate backend_rings = G_PRIVATE_INIT(backend_ring_free);
+
+static JBackendRing*
+backend_ring_get_thread(void)
+{
+	JBackendRing* ring;
+
+	ring = g_private_get(&backend_rings);
+
+	if (G_UNLIKELY(ring == NULL))
+	{
+		ring = g_new(JBackendRing, 1);
+		ring->buffer = NULL;
+		ring->buffer_size = 0;
+		ring->buffer_registered = FALSE;
+
+		if (io_uring_queue_init(BACKEND_RING_ENTRIES, &(ring->ring), 0) < 0)
 		{
-			if (errno != EINTR)
+			// io_uring might be unavailable or forbidden, callers fall back to blocking I/O
+			g_free(ring);
+			return NULL;
+		}
+
+		g_private_set(&backend_rings, ring);
+	}
+
+	return ring;
+}
+
+static gint
+backend_file_get_direct(JBackendData* bd, JBackendObject* bo, JBackendObjectIO* io)
+{
+	gint fd;
+
+	if (!bd->direct || ((guintptr)io->buffer | io->length | io->offset) % BACKEND_DIRECT_ALIGNMENT != 0)
+	{
+		return bo->fd;
+	}
+
+	fd = g_atomic_int_get(&(bo->fd_direct));
+
+	if (fd == -2)
+	{
+		fd = open(bo->path, O_RDWR | O_DIRECT);
+
+		if (!g_atomic_int_compare_and_exchange(&(bo->fd_direct), -2, fd))
+		{
+			// Another thread has been faster
+			if (fd >= 0)
 			{
-				break;
+				close(fd);
 			}
+
+			fd = g_atomic_int_get(&(bo->fd_direct));
 		}
+	}
 
-		nbytes_total += nbytes;
+	// Some file systems do not support direct I/O
+	return (fd >= 0) ? fd : bo->fd;
+}
+
+/**
+ * Waits for a completion and stores its result.
+ *
+ * \param ring        A ring.
+ * \param results     The operations' results.
+ * \param sync_result Returns the result of the sync.
+ *
+ * \return TRUE on success, FALSE if waiting failed.
+ **/
+static gboolean
+backend_ring_reap(JBackendRing* ring, gint* results, gint* sync_result)
+{
+	struct io_uring_cqe* cqe;
+	guint index;
+	gint ret;
+
+	do
+	{
+		ret = io_uring_wait_cqe(&(ring->ring), &cqe);
+	} while (ret == -EINTR);
+
+	if (ret < 0)
+	{
+		return FALSE;
 	}
 
-	j_trace_file_end(bo->path, J_TRACE_FILE_WRITE, nbytes_total, offset);
+	index = GPOINTER_TO_UINT(io_uring_cqe_get_data(cqe));
 
-	if (bytes_written != NULL)
+	if (index == 0)
 	{
-		*bytes_written = nbytes_total;
+		*sync_result = cqe->res;
+	}
+	else
+	{
+		results[index - 1] = cqe->res;
 	}
 
-	return (nbytes_total == length);
+	io_uring_cqe_seen(&(ring->ring), cqe);
+
+	return TRUE;
+}
+
+/**
+ * Submits a window of reads or writes to the ring and waits for their completion.
+ *
+ * \param ring    A ring.
+ * \param bd      The backend data.
+ * \param bo      An object.
+ * \param ios     The operations.
+ * \param results Returns the operations' results, has to be initialized with G_MININT for operations that are not completed.
+ * \param count   The number of operations, less than BACKEND_RING_ENTRIES.
+ * \param write   Whether to write.
+ * \param sync    Whether to sync after the writes.
+ *
+ * \return The result of the sync, G_MININT if it has not been completed.
+ **/
+static gint
+backend_ring_submit(JBackendRing* ring, JBackendData* bd, JBackendObject* bo, JBackendObjectIO* ios, gint* results, guint count, gboolean write, gboolean sync)
+{
+	struct io_uring_sqe* sqe;
+	gint sync_result = G_MININT;
+	gboolean failed = FALSE;
+	guint completed = 0;
+	guint queued = 0;
+	guint submitted = 0;
+
+	for (guint i = 0; i < count; i++)
+	{
+		JBackendObjectIO* io = &(ios[i]);
+		gint fd;
+		guint length;
+
+		fd = backend_file_get_direct(bd, bo, io);
+		length = MIN(io->length, BACKEND_RING_MAX_LENGTH);
+
+		if ((sqe = io_uring_get_sqe(&(ring->ring))) == NULL)
+		{
+			// The remaining operations are completed synchronously
+			break;
+		}
+
+		if (ring->buffer_registered && (gchar*)io->buffer >= ring->buffer && (gchar*)io->buffer + length <= ring->buffer + ring->buffer_size)
+		{
+			if (write)
+			{
+				io_uring_prep_write_fixed(sqe, fd, io->buffer, length, io->offset, 0);
+			}
+			else
+			{
+				io_uring_prep_read_fixed(sqe, fd, io->buffer, length, io->offset, 0);
+			}
+		}
+		else if (write)
+		{
+			io_uring_prep_write(sqe, fd, io->buffer, length, io->offset);
+		}
+		else
+		{
+			io_uring_prep_read(sqe, fd, io->buffer, length, io->offset);
+		}
+
+		io_uring_sqe_set_data(sqe, GUINT_TO_POINTER(i + 1));
+		queued++;
+	}
+
+	// Without a free entry, the caller syncs synchronously
+	if (sync && (sqe = io_uring_get_sqe(&(ring->ring))) != NULL)
+	{
+		io_uring_prep_fsync(sqe, bo->fd, IORING_FSYNC_DATASYNC);
+		// Linking the writes would serialize them, draining only delays the sync until all of them have completed
+		io_uring_sqe_set_flags(sqe, IOSQE_IO_DRAIN);
+		io_uring_sqe_set_data(sqe, NULL);
+		queued++;
+	}
+
+	// The kernel might consume fewer entries than queued, so submit until all of them are in flight
+	while (submitted < queued && !failed)
+	{
+		gint ret;
+
+		ret = io_uring_submit(&(ring->ring));
+
+		if (ret > 0)
+		{
+			submitted += ret;
+		}
+		else if (ret == -EINTR)
+		{
+			continue;
+		}
+		else if ((ret == -EAGAIN || ret == -EBUSY) && completed < submitted)
+		{
+			// The kernel is short on resources, reaping a completion frees some
+			failed = !backend_ring_reap(ring, results, &sync_result);
+			completed++;
+		}
+		else
+		{
+			failed = TRUE;
+		}
+	}
+
+	// Only wait for the entries that have actually been submitted
+	while (completed < submitted && !failed)
+	{
+		failed = !backend_ring_reap(ring, results, &sync_result);
+		completed++;
+	}
+
+	if (failed || submitted != queued)
+	{
+		// The ring is in an unknown state or still holds unsubmitted entries, replace it
+		g_private_replace(&backend_rings, NULL);
+	}
+
+	return sync_result;
 }
 
+static gboolean
+backend_io_vector(JBackendData* bd, JBackendObject* bo, JBackendObjectIO* ios, guint count, gboolean write, gboolean sync)
+{
+	JBackendRing* ring;
+	gboolean ret = TRUE;
+	guint64 nbytes_total = 0;
+	g_autofree gint* results = NULL;
+
+	j_trace_file_begin(bo->path, (write) ? J_TRACE_FILE_WRITE : J_TRACE_FILE_READ);
+
+	results = g_new(gint, count);
+	ring = backend_ring_get_thread();
+
+	// Keep one entry free for the sync
+	for (guint first = 0; first < count; first += BACKEND_RING_ENTRIES - 1)
+	{
+		guint window = MIN(count - first, BACKEND_RING_ENTRIES - 1);
+		gboolean window_sync = (sync && first + window == count);
+		gboolean written_late = FALSE;
+		gint sync_result = G_MININT;
+
+		for (guint i = first; i < first + window; i++)
+		{
+			results[i] = G_MININT;
+		}
+
+		if (ring != NULL)
+		{
+			sync_result = backend_ring_submit(ring, bd, bo, ios + first, results + first, window, write, window_sync);
+			ring = backend_ring_get_thread();
+		}
+
+		for (guint i = first; i < first + window; i++)
+		{
+			JBackendObjectIO* io = &(ios[i]);
+			gint fd = bo->fd;
+
+			io->bytes = (results[i] > 0) ? (guint64)results[i] : 0;
+
+			if (results[i] == G_MININT)
+			{
+				fd = backend_file_get_direct(bd, bo, io);
+			}
+
+			// Operations that have not been submitted are done synchronously, failed and incomplete ones are retried without direct I/O
+			// For reads, a result of 0 signals the end of the file
+			if (io->bytes < io->length && (write || results[i] != 0))
+			{
+				gchar* buffer = (gchar*)io->buffer + io->bytes;
+				guint64 length = io->length - io->bytes;
+				guint64 offset = io->offset + io->bytes;
+
+				if (write)
+				{
+					io->bytes += backend_pwrite(fd, buffer, length, offset);
+					written_late = TRUE;
+				}
+				else
+				{
+					io->bytes += backend_pread(fd, buffer, length, offset);
+				}
+			}
+
+			nbytes_total += io->bytes;
+			ret = (io->bytes == io->length) && ret;
+		}
+
+		if (window_sync)
+		{
+			if (sync_result != 0 || written_late)
+			{
+				sync_result = (fdatasync(bo->fd) == 0) ? 0 : -1;
+			}
+
+			ret = (sync_result == 0) && ret;
+		}
+	}
+
+	if (sync && count == 0)
+	{
+		ret = (fdatasync(bo->fd) == 0);
+	}
+
+	j_trace_file_end(bo->path, (write) ? J_TRACE_FILE_WRITE : J_TRACE_FILE_READ, nbytes_total, (count > 0) ? ios[0].offset : 0);
+
+	return ret;
+}
+
+static gboolean
+backend_register_buffer(gpointer backend_data, gpointer buffer, guint64 size)
+{
+	JBackendRing* ring;
+	struct iovec iov;
+
+	(void)backend_data;
+
+	if ((ring = backend_ring_get_thread()) == NULL)
+	{
+		return FALSE;
+	}
+
+	if (ring->buffer == buffer && ring->buffer_size == size)
+	{
+		return ring->buffer_registered;
+	}
+
+	if (ring->buffer_registered)
+	{
+		io_uring_unregister_buffers(&(ring->ring));
+	}
+
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+
+	ring->buffer = buffer;
+	ring->buffer_size = size;
+	ring->buffer_registered = (io_uring_register_buffers(&(ring->ring), &iov, 1) == 0);
+
+	return ring->buffer_registered;
+}
+
+static gboolean
+backend_read_vector(gpointer backend_data, gpointer backend_object, JBackendObjectIO* ios, guint count)
+{
+	return backend_io_vector(backend_data, backend_object, ios, count, FALSE, FALSE);
+}
+
+static gboolean
+backend_write_vector(gpointer backend_data, gpointer backend_object, JBackendObjectIO* ios, guint count, gboolean sync)
+{
+	return backend_io_vector(backend_data, backend_object, ios, count, TRUE, sync);
+}
+
+#endif
+
 static gboolean
 backend_get_all(gpointer backend_data, gchar const* namespace, gpointer* backend_iterator)
 {
@@ -497,10 +948,19 @@ backend_init(gchar const* path, gpointer* backend_data)
 
 	bd = g_new(JBackendData, 1);
 	bd->path = g_strdup(path);
+	bd->direct = FALSE;
+
+#ifdef JULEA_OBJECT_URING
+	if (g_str_has_suffix(bd->path, ":direct"))
+	{
+		bd->path[strlen(bd->path) - strlen(":direct")] = '\0';
+		bd->direct = TRUE;
+	}
+#endif
 
 	jd_backend_file_cache = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, NULL);
 
-	g_mkdir_with_parents(path, 0700);
+	g_mkdir_with_parents(bd->path, 0700);
 
 	g_atomic_int_inc(&jd_num_backends);
 
@@ -539,6 +999,11 @@ static JBackend posix_backend = {
 		.backend_sync = backend_sync,
 		.backend_read = backend_read,
 		.backend_write = backend_write,
+#ifdef JULEA_OBJECT_URING
+		.backend_register_buffer = backend_register_buffer,
+		.backend_read_vector = backend_read_vector,
+		.backend_write_vector = backend_write_vector,
+#endif
 		.backend_get_all = backend_get_all,
 		.backend_get_by_prefix = backend_get_by_prefix,
 		.backend_iterate = backend_iterate }
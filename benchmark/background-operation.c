@@ -68,8 +68,42 @@ benchmark_background_operation_new_ref_unref(BenchmarkRun* run)
 	run->operations = n;
 }
 
+static void
+benchmark_background_operation_wait_all(BenchmarkRun* run)
+{
+	guint const n = 1000;
+
+	// Mimics a distributed object striped across 64 servers
+	JBackgroundOperation* background_operations[64];
+
+	j_benchmark_timer_start(run);
+
+	while (j_benchmark_iterate(run))
+	{
+		for (guint i = 0; i < n; i++)
+		{
+			for (guint j = 0; j < G_N_ELEMENTS(background_operations); j++)
+			{
+				background_operations[j] = j_background_operation_new(on_background_operation_completed, NULL);
+			}
+
+			j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+			for (guint j = 0; j < G_N_ELEMENTS(background_operations); j++)
+			{
+				j_background_operation_unref(background_operations[j]);
+			}
+		}
+	}
+
+	j_benchmark_timer_stop(run);
+
+	run->operations = n * G_N_ELEMENTS(background_operations);
+}
+
 void
 benchmark_background_operation(void)
 {
 	j_benchmark_add("/background-operation/new", benchmark_background_operation_new_ref_unref);
+	j_benchmark_add("/background-operation/wait-all", benchmark_background_operation_wait_all);
 }
@@ -132,7 +132,7 @@ _benchmark_db_prepare_scheme(gchar const* namespace, gboolean use_batch, gboolea
 }
 
 static void
-_benchmark_db_insert(BenchmarkRun* run, JDBSchema* scheme, gchar const* namespace, gboolean use_batch, gboolean use_index_all, gboolean use_index_single, gboolean use_timer)
+_benchmark_db_insert(BenchmarkRun* run, JDBSchema* scheme, gchar const* namespace, gboolean use_batch, gboolean use_index_all, gboolean use_index_single, gboolean use_timer, gboolean use_bulk)
 {
 	gboolean ret;
 	g_autoptr(JBatch) delete_batch = NULL;
@@ -192,7 +192,15 @@ _benchmark_db_insert(BenchmarkRun* run, JDBSchema* scheme, gchar const* namespac
 			g_assert_true(ret);
 			g_assert_null(b_s_error);
 
-			ret = j_db_entry_insert(entry, batch, &b_s_error);
+			if (use_bulk)
+			{
+				ret = j_db_entry_insert_bulk(entry, batch, &b_s_error);
+			}
+			else
+			{
+				ret = j_db_entry_insert(entry, batch, &b_s_error);
+			}
+
 			g_assert_true(ret);
 			g_assert_null(b_s_error);
 
@@ -50,7 +50,7 @@ _benchmark_db_delete(BenchmarkRun* run, gchar const* namespace, gboolean use_bat
 
 	while (j_benchmark_iterate(run))
 	{
-		_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false);
+		_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false, false);
 
 		j_benchmark_timer_start(run);
 
@@ -109,7 +109,7 @@ _benchmark_db_update(BenchmarkRun* run, gchar const* namespace, gboolean use_bat
 	g_assert_nonnull(b_scheme);
 	g_assert_nonnull(run);
 
-	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false);
+	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false, false);
 
 	j_benchmark_timer_start(run);
 
@@ -161,49 +161,55 @@ _benchmark_db_update(BenchmarkRun* run, gchar const* namespace, gboolean use_bat
 static void
 benchmark_db_insert(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert", false, false, false, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert", false, false, false, true, false);
 }
 
 static void
 benchmark_db_insert_batch(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_batch", true, false, false, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_batch", true, false, false, true, false);
+}
+
+static void
+benchmark_db_insert_batch_bulk(BenchmarkRun* run)
+{
+	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_bulk", true, false, false, true, true);
 }
 
 static void
 benchmark_db_insert_index_single(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_index_single", false, false, true, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_index_single", false, false, true, true, false);
 }
 
 static void
 benchmark_db_insert_batch_index_single(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_single", true, false, true, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_single", true, false, true, true, false);
 }
 
 static void
 benchmark_db_insert_index_all(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_index_all", false, true, false, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_index_all", false, true, false, true, false);
 }
 
 static void
 benchmark_db_insert_batch_index_all(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_all", true, true, false, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_all", true, true, false, true, false);
 }
 
 static void
 benchmark_db_insert_index_mixed(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_index_mixed", false, true, true, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_index_mixed", false, true, true, true, false);
 }
 
 static void
 benchmark_db_insert_batch_index_mixed(BenchmarkRun* run)
 {
-	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_mixed", true, true, true, true);
+	_benchmark_db_insert(run, NULL, "benchmark_insert_batch_index_mixed", true, true, true, true, false);
 }
 
 static void
@@ -307,6 +313,7 @@ benchmark_db_entry(void)
 {
 	j_benchmark_add("/db/entry/insert", benchmark_db_insert);
 	j_benchmark_add("/db/entry/insert-batch", benchmark_db_insert_batch);
+	j_benchmark_add("/db/entry/insert-batch-bulk", benchmark_db_insert_batch_bulk);
 	j_benchmark_add("/db/entry/insert-index-single", benchmark_db_insert_index_single);
 	j_benchmark_add("/db/entry/insert-batch-index-single", benchmark_db_insert_batch_index_single);
 	j_benchmark_add("/db/entry/insert-index-all", benchmark_db_insert_index_all);
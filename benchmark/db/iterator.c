@@ -48,7 +48,7 @@ _benchmark_db_get_simple(BenchmarkRun* run, gchar const* namespace, gboolean use
 	g_assert_nonnull(b_scheme);
 	g_assert_nonnull(run);
 
-	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false);
+	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false, false);
 
 	j_benchmark_timer_start(run);
 
@@ -108,7 +108,7 @@ _benchmark_db_get_range(BenchmarkRun* run, gchar const* namespace, gboolean use_
 	g_assert_nonnull(b_scheme);
 	g_assert_nonnull(run);
 
-	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false);
+	_benchmark_db_insert(NULL, b_scheme, NULL, true, false, false, false, false);
 
 	j_benchmark_timer_start(run);
 
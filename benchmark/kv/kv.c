@@ -28,10 +28,8 @@
 #include "benchmark.h"
 
 static void
-_benchmark_kv_put(BenchmarkRun* run, gboolean use_batch)
+_benchmark_kv_put(BenchmarkRun* run, gboolean use_batch, guint n)
 {
-	guint const n = 1000;
-
 	g_autoptr(JBatch) delete_batch = NULL;
 	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JSemantics) semantics = NULL;
@@ -81,13 +79,20 @@ _benchmark_kv_put(BenchmarkRun* run, gboolean use_batch)
 static void
 benchmark_kv_put(BenchmarkRun* run)
 {
-	_benchmark_kv_put(run, FALSE);
+	_benchmark_kv_put(run, FALSE, 1000);
 }
 
 static void
 benchmark_kv_put_batch(BenchmarkRun* run)
 {
-	_benchmark_kv_put(run, TRUE);
+	_benchmark_kv_put(run, TRUE, 1000);
+}
+
+static void
+benchmark_kv_put_batch_large(BenchmarkRun* run)
+{
+	// Large batches of small operations are dominated by allocating operations, list elements and messages
+	_benchmark_kv_put(run, TRUE, 100000);
 }
 
 static void
@@ -175,6 +180,119 @@ benchmark_kv_get_batch(BenchmarkRun* run)
 	_benchmark_kv_get(run, TRUE);
 }
 
+struct BenchmarkKVGetThread
+{
+	JSemantics* semantics;
+	guint n;
+};
+
+typedef struct BenchmarkKVGetThread BenchmarkKVGetThread;
+
+static gpointer
+_benchmark_kv_get_thread(gpointer data)
+{
+	BenchmarkKVGetThread* thread = data;
+
+	g_autoptr(JBatch) batch = NULL;
+	gboolean ret;
+
+	batch = j_batch_new(thread->semantics);
+
+	for (guint i = 0; i < thread->n; i++)
+	{
+		g_autoptr(JKV) object = NULL;
+		g_autofree gchar* name = NULL;
+
+		name = g_strdup_printf("benchmark-%d", i);
+		object = j_kv_new("benchmark", name);
+		j_kv_get_callback(object, _benchmark_kv_get_callback, NULL, batch);
+
+		ret = j_batch_execute(batch);
+		g_assert_true(ret);
+	}
+
+	return NULL;
+}
+
+/**
+ * Runs gets from multiple threads concurrently to show how well reads scale on the server.
+ **/
+static void
+_benchmark_kv_get_parallel(BenchmarkRun* run, guint thread_count)
+{
+	guint const n = 1000;
+
+	g_autoptr(JBatch) delete_batch = NULL;
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	g_autofree GThread** threads = NULL;
+	BenchmarkKVGetThread thread_data;
+	gboolean ret;
+
+	semantics = j_benchmark_get_semantics();
+	delete_batch = j_batch_new(semantics);
+	batch = j_batch_new(semantics);
+	threads = g_new(GThread*, thread_count);
+
+	thread_data.semantics = semantics;
+	thread_data.n = n;
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) object = NULL;
+		g_autofree gchar* name = NULL;
+
+		name = g_strdup_printf("benchmark-%d", i);
+		object = j_kv_new("benchmark", name);
+		j_kv_put(object, g_strdup(name), strlen(name), g_free, batch);
+
+		j_kv_delete(object, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	j_benchmark_timer_start(run);
+
+	while (j_benchmark_iterate(run))
+	{
+		for (guint i = 0; i < thread_count; i++)
+		{
+			threads[i] = g_thread_new("benchmark-kv-get", _benchmark_kv_get_thread, &thread_data);
+		}
+
+		for (guint i = 0; i < thread_count; i++)
+		{
+			g_thread_join(threads[i]);
+		}
+	}
+
+	j_benchmark_timer_stop(run);
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+
+	run->operations = n * thread_count;
+}
+
+static void
+benchmark_kv_get_parallel_2(BenchmarkRun* run)
+{
+	_benchmark_kv_get_parallel(run, 2);
+}
+
+static void
+benchmark_kv_get_parallel_4(BenchmarkRun* run)
+{
+	_benchmark_kv_get_parallel(run, 4);
+}
+
+static void
+benchmark_kv_get_parallel_8(BenchmarkRun* run)
+{
+	_benchmark_kv_get_parallel(run, 8);
+}
+
 static void
 _benchmark_kv_delete(BenchmarkRun* run, gboolean use_batch)
 {
@@ -307,8 +425,12 @@ benchmark_kv(void)
 {
 	j_benchmark_add("/kv/put", benchmark_kv_put);
 	j_benchmark_add("/kv/put-batch", benchmark_kv_put_batch);
+	j_benchmark_add("/kv/put-batch-large", benchmark_kv_put_batch_large);
 	j_benchmark_add("/kv/get", benchmark_kv_get);
 	j_benchmark_add("/kv/get-batch", benchmark_kv_get_batch);
+	j_benchmark_add("/kv/get-parallel-2", benchmark_kv_get_parallel_2);
+	j_benchmark_add("/kv/get-parallel-4", benchmark_kv_get_parallel_4);
+	j_benchmark_add("/kv/get-parallel-8", benchmark_kv_get_parallel_8);
 	j_benchmark_add("/kv/delete", benchmark_kv_delete);
 	j_benchmark_add("/kv/delete-batch", benchmark_kv_delete_batch);
 	j_benchmark_add("/kv/unordered-put-delete", benchmark_kv_unordered_put_delete);
@@ -114,6 +114,38 @@ benchmark_message_add_operation_large(BenchmarkRun* run)
 	_benchmark_message_add_operation(run, TRUE);
 }
 
+static void
+benchmark_message_add_send(BenchmarkRun* run)
+{
+	guint const n = 10000;
+	guint const m = 100;
+	guint64 const dummy = 42;
+
+	j_benchmark_timer_start(run);
+
+	while (j_benchmark_iterate(run))
+	{
+		for (guint i = 0; i < n; i++)
+		{
+			g_autoptr(JMessage) message = NULL;
+
+			message = j_message_new(J_MESSAGE_NONE, 0);
+
+			for (guint j = 0; j < m; j++)
+			{
+				j_message_add_operation(message, sizeof(guint64));
+				j_message_append_8(message, &dummy);
+				j_message_add_send(message, &dummy, sizeof(guint64));
+			}
+		}
+	}
+
+	j_benchmark_timer_stop(run);
+
+	run->operations = n;
+	run->bytes = n * m * sizeof(guint64);
+}
+
 void
 benchmark_message(void)
 {
@@ -121,4 +153,5 @@ benchmark_message(void)
 	j_benchmark_add("/message/new-append", benchmark_message_new_append);
 	j_benchmark_add("/message/add-operation-small", benchmark_message_add_operation_small);
 	j_benchmark_add("/message/add-operation-large", benchmark_message_add_operation_large);
+	j_benchmark_add("/message/add-send", benchmark_message_add_send);
 }
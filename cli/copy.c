@@ -27,11 +27,13 @@ j_cmd_copy(gchar const** arguments)
 {
 	gboolean ret = TRUE;
 	JObjectURI* ouri[2] = { NULL, NULL };
+	JObjectURI* duri[2] = { NULL, NULL };
 	JURI* uri[2] = { NULL, NULL };
 	GError* error;
 	GFile* file;
 	GFileIOStream* stream[2] = { NULL, NULL };
 	g_autofree gchar* buffer = NULL;
+	guint64 buffer_size;
 	guint64 offset;
 	guint i;
 
@@ -64,6 +66,20 @@ j_cmd_copy(gchar const** arguments)
 				}
 			}
 		}
+		else if ((duri[i] = j_object_uri_new(arguments[i], J_OBJECT_URI_SCHEME_DISTRIBUTED_OBJECT)) != NULL)
+		{
+			if (i == 1)
+			{
+				batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+				j_distributed_object_create(j_object_uri_get_distributed_object(duri[i]), batch);
+
+				if (!j_batch_execute(batch))
+				{
+					ret = FALSE;
+					goto end;
+				}
+			}
+		}
 		else if ((uri[i] = j_uri_new(arguments[i])) != NULL)
 		{
 			error = NULL;
@@ -157,8 +173,18 @@ j_cmd_copy(gchar const** arguments)
 		}
 	}
 
+	buffer_size = 1024 * 1024;
+
+	if (duri[0] != NULL || duri[1] != NULL)
+	{
+		JConfiguration* configuration = j_configuration();
+
+		// Copy enough data at once to keep the configured number of stripes in flight on every object server
+		buffer_size = j_configuration_get_stripe_size(configuration) * j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT) * j_configuration_get_stripe_window(configuration);
+	}
+
 	offset = 0;
-	buffer = g_new(gchar, 1024 * 1024);
+	buffer = g_new(gchar, buffer_size);
 
 	while (TRUE)
 	{
@@ -171,7 +197,21 @@ j_cmd_copy(gchar const** arguments)
 		{
 			guint64 nbytes;
 
-			j_object_read(j_object_uri_get_object(ouri[0]), buffer, 1024 * 1024, offset, &nbytes, batch);
+			j_object_read(j_object_uri_get_object(ouri[0]), buffer, buffer_size, offset, &nbytes, batch);
+
+			if (!j_batch_execute(batch))
+			{
+				ret = FALSE;
+				goto end;
+			}
+
+			bytes_read = nbytes;
+		}
+		else if (duri[0] != NULL)
+		{
+			guint64 nbytes;
+
+			j_distributed_object_read(j_object_uri_get_distributed_object(duri[0]), buffer, buffer_size, offset, &nbytes, batch);
 
 			if (!j_batch_execute(batch))
 			{
@@ -185,7 +225,7 @@ j_cmd_copy(gchar const** arguments)
 		{
 			guint64 nbytes;
 
-			j_item_read(j_uri_get_item(uri[0]), buffer, 1024 * 1024, offset, &nbytes, batch);
+			j_item_read(j_uri_get_item(uri[0]), buffer, buffer_size, offset, &nbytes, batch);
 
 			if (!j_batch_execute(batch))
 			{
@@ -202,7 +242,7 @@ j_cmd_copy(gchar const** arguments)
 
 			input = g_io_stream_get_input_stream(G_IO_STREAM(stream[0]));
 
-			g_input_stream_read_all(input, buffer, 1024 * 1024, &nbytes, NULL, NULL);
+			g_input_stream_read_all(input, buffer, buffer_size, &nbytes, NULL, NULL);
 			bytes_read = nbytes;
 		}
 
@@ -218,6 +258,18 @@ j_cmd_copy(gchar const** arguments)
 				goto end;
 			}
 		}
+		else if (duri[1] != NULL)
+		{
+			guint64 dummy;
+
+			j_distributed_object_write(j_object_uri_get_distributed_object(duri[1]), buffer, bytes_read, offset, &dummy, batch);
+
+			if (!j_batch_execute(batch))
+			{
+				ret = FALSE;
+				goto end;
+			}
+		}
 		else if (uri[1] != NULL)
 		{
 			guint64 dummy;
@@ -241,7 +293,7 @@ j_cmd_copy(gchar const** arguments)
 
 		offset += bytes_read;
 
-		if (bytes_read < 1024 * 1024)
+		if (bytes_read < buffer_size)
 		{
 			break;
 		}
@@ -260,6 +312,11 @@ end:
 			j_object_uri_free(ouri[i]);
 		}
 
+		if (duri[i] != NULL)
+		{
+			j_object_uri_free(duri[i]);
+		}
+
 		if (uri[i] != NULL)
 		{
 			j_uri_free(uri[i]);
@@ -29,7 +29,6 @@ jfs_create(char const* path, mode_t mode, struct fuse_file_info* fi)
 
 	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JKV) kv = NULL;
-	g_autoptr(JObject) object = NULL;
 	bson_t* tmp;
 	gpointer value;
 	guint32 len;
@@ -41,7 +40,6 @@ jfs_create(char const* path, mode_t mode, struct fuse_file_info* fi)
 	basename = g_path_get_basename(path);
 	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_POSIX);
 	kv = j_kv_new("posix", path);
-	object = j_object_new("posix", path);
 
 	tmp = bson_new();
 
@@ -53,7 +51,7 @@ jfs_create(char const* path, mode_t mode, struct fuse_file_info* fi)
 	value = bson_destroy_with_steal(tmp, TRUE, &len);
 
 	j_kv_put(kv, value, len, bson_free, batch);
-	j_object_create(object, batch);
+	jfs_object_create(path, batch);
 
 	if (j_batch_execute(batch))
 	{
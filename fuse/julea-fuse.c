@@ -23,6 +23,7 @@
 #include <glib.h>
 
 #include <locale.h>
+#include <stddef.h>
 
 struct fuse_operations jfs_vtable = {
 	.access = jfs_access,
@@ -42,15 +43,38 @@ struct fuse_operations jfs_vtable = {
 	.write = jfs_write,
 };
 
+struct jfs_options
+{
+	int distributed;
+};
+
+static struct fuse_opt const jfs_opts[] = {
+	// Stripe file data across all object servers
+	{ "--distributed", offsetof(struct jfs_options, distributed), 1 },
+	FUSE_OPT_END
+};
+
 int
 main(int argc, char** argv)
 {
 	gint ret;
 
+	struct fuse_args args = FUSE_ARGS_INIT(argc, argv);
+	struct jfs_options options = { 0 };
+
 	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
 	setlocale(LC_ALL, "C.UTF-8");
 
-	ret = fuse_main(argc, argv, &jfs_vtable, NULL);
+	if (fuse_opt_parse(&args, &options, jfs_opts, NULL) == -1)
+	{
+		return 1;
+	}
+
+	jfs_distributed = options.distributed;
+
+	ret = fuse_main(args.argc, args.argv, &jfs_vtable, NULL);
+
+	fuse_opt_free_args(&args);
 
 	return ret;
 }
@@ -45,3 +45,14 @@ int jfs_truncate(char const*, off_t, struct fuse_file_info*);
 int jfs_unlink(char const*);
 int jfs_utimens(char const*, const struct timespec[2], struct fuse_file_info*);
 int jfs_write(char const*, char const*, size_t, off_t, struct fuse_file_info*);
+
+/**
+ * Whether file data is stored in distributed objects.
+ * Has to be the same whenever a file system is mounted.
+ **/
+extern gboolean jfs_distributed;
+
+void jfs_object_create(char const*, JBatch*);
+void jfs_object_delete(char const*, JBatch*);
+void jfs_object_read(char const*, char*, size_t, off_t, guint64*, JBatch*);
+void jfs_object_write(char const*, char const*, size_t, off_t, guint64*, JBatch*);
@@ -0,0 +1,122 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include "julea-fuse.h"
+
+gboolean jfs_distributed = FALSE;
+
+/**
+ * Returns the distributed object storing a file's data.
+ * Its stripes are distributed round robin, starting at a server determined by the path.
+ *
+ * \param path A path.
+ *
+ * \return A distributed object. Should be freed with j_distributed_object_unref().
+ **/
+static JDistributedObject*
+jfs_distributed_object_new(char const* path)
+{
+	g_autoptr(JDistribution) distribution = NULL;
+	guint32 server_count;
+
+	server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
+
+	distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN);
+	// The start index has to be the same for all operations on a file
+	j_distribution_set(distribution, "start-index", j_helper_hash(path) % server_count);
+
+	return j_distributed_object_new("posix", path, distribution);
+}
+
+void
+jfs_object_create(char const* path, JBatch* batch)
+{
+	if (jfs_distributed)
+	{
+		g_autoptr(JDistributedObject) object = NULL;
+
+		object = jfs_distributed_object_new(path);
+		j_distributed_object_create(object, batch);
+	}
+	else
+	{
+		g_autoptr(JObject) object = NULL;
+
+		object = j_object_new("posix", path);
+		j_object_create(object, batch);
+	}
+}
+
+void
+jfs_object_delete(char const* path, JBatch* batch)
+{
+	if (jfs_distributed)
+	{
+		g_autoptr(JDistributedObject) object = NULL;
+
+		object = jfs_distributed_object_new(path);
+		j_distributed_object_delete(object, batch);
+	}
+	else
+	{
+		g_autoptr(JObject) object = NULL;
+
+		object = j_object_new("posix", path);
+		j_object_delete(object, batch);
+	}
+}
+
+void
+jfs_object_read(char const* path, char* buf, size_t size, off_t offset, guint64* bytes_read, JBatch* batch)
+{
+	if (jfs_distributed)
+	{
+		g_autoptr(JDistributedObject) object = NULL;
+
+		object = jfs_distributed_object_new(path);
+		j_distributed_object_read(object, buf, size, offset, bytes_read, batch);
+	}
+	else
+	{
+		g_autoptr(JObject) object = NULL;
+
+		object = j_object_new("posix", path);
+		j_object_read(object, buf, size, offset, bytes_read, batch);
+	}
+}
+
+void
+jfs_object_write(char const* path, char const* buf, size_t size, off_t offset, guint64* bytes_written, JBatch* batch)
+{
+	if (jfs_distributed)
+	{
+		g_autoptr(JDistributedObject) object = NULL;
+
+		object = jfs_distributed_object_new(path);
+		j_distributed_object_write(object, buf, size, offset, bytes_written, batch);
+	}
+	else
+	{
+		g_autoptr(JObject) object = NULL;
+
+		object = j_object_new("posix", path);
+		j_object_write(object, buf, size, offset, bytes_written, batch);
+	}
+}
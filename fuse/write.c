@@ -29,7 +29,6 @@ jfs_write(char const* path, char const* buf, size_t size, off_t offset, struct f
 
 	g_autoptr(JBatch) batch = NULL;
 	g_autoptr(JKV) kv = NULL;
-	g_autoptr(JObject) object = NULL;
 	guint64 bytes_written;
 	gpointer value;
 	guint32 len;
@@ -38,10 +37,9 @@ jfs_write(char const* path, char const* buf, size_t size, off_t offset, struct f
 
 	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_POSIX);
 	kv = j_kv_new("posix", path);
-	object = j_object_new("posix", path);
 
 	j_kv_get(kv, &value, &len, batch);
-	j_object_write(object, buf, size, offset, &bytes_written, batch);
+	jfs_object_write(path, buf, size, offset, &bytes_written, batch);
 
 	if (j_batch_execute(batch))
 	{
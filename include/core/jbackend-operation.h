@@ -125,6 +125,7 @@ gboolean j_backend_operation_unwrap_db_schema_create(JBackend*, gpointer, JBacke
 gboolean j_backend_operation_unwrap_db_schema_get(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_schema_delete(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_insert(JBackend*, gpointer, JBackendOperation*);
+gboolean j_backend_operation_unwrap_db_insert_many(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_update(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_delete(JBackend*, gpointer, JBackendOperation*);
 gboolean j_backend_operation_unwrap_db_query(JBackend*, gpointer, JBackendOperation*);
@@ -212,6 +213,23 @@ static const JBackendOperation j_backend_operation_db_insert = {
 	.out_param_count = 2,
 };
 
+static const JBackendOperation j_backend_operation_db_insert_many = {
+	.in_param = {
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_STR },
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_STR },
+		{
+			.type = J_BACKEND_OPERATION_PARAM_TYPE_BSON,
+			.bson_initialized = TRUE,
+		},
+	},
+	.out_param = {
+		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_ERROR },
+	},
+	.backend_func = j_backend_operation_unwrap_db_insert_many,
+	.in_param_count = 3,
+	.out_param_count = 1,
+};
+
 static const JBackendOperation j_backend_operation_db_update = {
 	.in_param = {
 		{ .type = J_BACKEND_OPERATION_PARAM_TYPE_STR },
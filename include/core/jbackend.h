@@ -128,6 +128,27 @@ enum JBackendFlags
 
 typedef enum JBackendFlags JBackendFlags;
 
+/**
+ * A single part of a vectored object read or write.
+ **/
+struct JBackendObjectIO
+{
+	/**
+	 * The buffer to read into or write from.
+	 **/
+	gpointer buffer;
+
+	guint64 length;
+	guint64 offset;
+
+	/**
+	 * Returns the number of bytes read or written.
+	 **/
+	guint64 bytes;
+};
+
+typedef struct JBackendObjectIO JBackendObjectIO;
+
 struct JBackend
 {
 	JBackendType type;
@@ -155,6 +176,34 @@ struct JBackend
 			gboolean (*backend_read)(gpointer, gpointer, gpointer, guint64, guint64, guint64*);
 			gboolean (*backend_write)(gpointer, gpointer, gconstpointer, guint64, guint64, guint64*);
 
+			/**
+			* Registers a buffer used for reads and writes of the calling thread (optional)
+			*
+			* Backends can use this to avoid mapping the buffer for every operation.
+			* Registering the same buffer again should be cheap.
+			**/
+			gboolean (*backend_register_buffer)(gpointer, gpointer, guint64);
+
+			/**
+			* Reads multiple parts of an object (optional)
+			*
+			* Backends can use this to submit all parts at once.
+			* If it is not provided, backend_read is called for each part.
+			*
+			* \return TRUE if all parts have been read completely, FALSE otherwise.
+			**/
+			gboolean (*backend_read_vector)(gpointer, gpointer, JBackendObjectIO*, guint);
+
+			/**
+			* Writes multiple parts of an object (optional)
+			*
+			* If the last parameter is TRUE, the data has to be on stable storage when returning.
+			* If it is not provided, backend_write is called for each part, followed by backend_sync if requested.
+			*
+			* \return TRUE if all parts have been written completely (and synced), FALSE otherwise.
+			**/
+			gboolean (*backend_write_vector)(gpointer, gpointer, JBackendObjectIO*, guint, gboolean);
+
 			gboolean (*backend_get_all)(gpointer, gchar const*, gpointer*);
 			gboolean (*backend_get_by_prefix)(gpointer, gchar const*, gchar const*, gpointer*);
 			gboolean (*backend_iterate)(gpointer, gpointer, gchar const**);
@@ -168,6 +217,15 @@ struct JBackend
 			gboolean (*backend_batch_start)(gpointer, gchar const*, JSemantics*, gpointer*);
 			gboolean (*backend_batch_execute)(gpointer, gpointer);
 
+			/**
+			* Starts a batch that only contains gets (optional)
+			*
+			* Backends can use this to avoid taking write locks.
+			* The batch is finished with backend_batch_execute.
+			* If it is not provided, backend_batch_start is used instead.
+			**/
+			gboolean (*backend_batch_start_read_only)(gpointer, gchar const*, JSemantics*, gpointer*);
+
 			gboolean (*backend_put)(gpointer, gpointer, gchar const*, gconstpointer, guint32);
 			gboolean (*backend_delete)(gpointer, gpointer, gchar const*);
 			gboolean (*backend_get)(gpointer, gpointer, gchar const*, gpointer*, guint32*);
@@ -175,6 +233,13 @@ struct JBackend
 			gboolean (*backend_get_all)(gpointer, gchar const*, gpointer*);
 			gboolean (*backend_get_by_prefix)(gpointer, gchar const*, gchar const*, gpointer*);
 			gboolean (*backend_iterate)(gpointer, gpointer, gchar const**, gconstpointer*, guint32*);
+
+			/**
+			* Frees an iterator that has not been exhausted (optional)
+			*
+			* If it is not provided, the remaining entries are iterated over instead.
+			**/
+			void (*backend_iterate_abort)(gpointer, gpointer);
 		} kv;
 
 		struct
@@ -259,6 +324,29 @@ struct JBackend
 			**/
 			gboolean (*backend_insert)(gpointer, gpointer, gchar const*, bson_t const*, bson_t*, GError**);
 
+			/**
+			* Insert multiple entries into a schema without returning their IDs (optional)
+			*
+			* Backends can use this to insert all entries using few statements.
+			* If it is not provided, backend_insert is called for each entry.
+			*
+			* \param[in] namespace Different use cases (e.g., "adios", "hdf5")
+			* \param[in] name      Schema name (e.g., "files")
+			* \param[in] entries   The entries to insert, each in the format expected by backend_insert.
+			*
+			* \code
+			* entries
+			* {
+			*	"0": data0 (document),
+			*	"1": data1 (document),
+			*	"N": dataN (document)
+			* }
+			* \endcode
+			*
+			* \return TRUE on success, FALSE otherwise.
+			**/
+			gboolean (*backend_insert_many)(gpointer, gpointer, gchar const*, bson_t const*, GError**);
+
 			/**
 			* Updates data
 			*
@@ -411,6 +499,10 @@ gboolean j_backend_object_sync(JBackend*, gpointer);
 gboolean j_backend_object_read(JBackend*, gpointer, gpointer, guint64, guint64, guint64*);
 gboolean j_backend_object_write(JBackend*, gpointer, gconstpointer, guint64, guint64, guint64*);
 
+gboolean j_backend_object_register_buffer(JBackend*, gpointer, guint64);
+gboolean j_backend_object_read_vector(JBackend*, gpointer, JBackendObjectIO*, guint);
+gboolean j_backend_object_write_vector(JBackend*, gpointer, JBackendObjectIO*, guint, gboolean);
+
 gboolean j_backend_object_get_all(JBackend*, gchar const*, gpointer*);
 gboolean j_backend_object_get_by_prefix(JBackend*, gchar const*, gchar const*, gpointer*);
 gboolean j_backend_object_iterate(JBackend*, gpointer, gchar const**);
@@ -419,6 +511,7 @@ gboolean j_backend_kv_init(JBackend*, gchar const*);
 void j_backend_kv_fini(JBackend*);
 
 gboolean j_backend_kv_batch_start(JBackend*, gchar const*, JSemantics*, gpointer*);
+gboolean j_backend_kv_batch_start_read_only(JBackend*, gchar const*, JSemantics*, gpointer*);
 gboolean j_backend_kv_batch_execute(JBackend*, gpointer);
 
 gboolean j_backend_kv_put(JBackend*, gpointer, gchar const*, gconstpointer, guint32);
@@ -428,6 +521,7 @@ gboolean j_backend_kv_get(JBackend*, gpointer, gchar const*, gpointer*, guint32*
 gboolean j_backend_kv_get_all(JBackend*, gchar const*, gpointer*);
 gboolean j_backend_kv_get_by_prefix(JBackend*, gchar const*, gchar const*, gpointer*);
 gboolean j_backend_kv_iterate(JBackend*, gpointer, gchar const**, gconstpointer*, guint32*);
+void j_backend_kv_iterate_abort(JBackend*, gpointer);
 
 gboolean j_backend_db_init(JBackend*, gchar const*);
 void j_backend_db_fini(JBackend*);
@@ -440,6 +534,7 @@ gboolean j_backend_db_schema_get(JBackend*, gpointer, gchar const*, bson_t*, GEr
 gboolean j_backend_db_schema_delete(JBackend*, gpointer, gchar const*, GError**);
 
 gboolean j_backend_db_insert(JBackend*, gpointer, gchar const*, bson_t const*, bson_t*, GError**);
+gboolean j_backend_db_insert_many(JBackend*, gpointer, gchar const*, bson_t const*, GError**);
 gboolean j_backend_db_update(JBackend*, gpointer, gchar const*, bson_t const*, bson_t const*, GError**);
 gboolean j_backend_db_delete(JBackend*, gpointer, gchar const*, bson_t const*, GError**);
 
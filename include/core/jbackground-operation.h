@@ -112,6 +112,21 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(JBackgroundOperation, j_background_operation_unref
  **/
 gpointer j_background_operation_wait(JBackgroundOperation* background_operation);
 
+/**
+ * Waits for multiple background operations to finish.
+ * Their results can be retrieved using j_background_operation_wait() afterwards, which will not block anymore.
+ *
+ * \code
+ * JBackgroundOperation* background_operations[2];
+ *
+ * j_background_operation_wait_all(background_operations, 2);
+ * \endcode
+ *
+ * \param background_operations An array of background operations, which may contain NULL entries.
+ * \param count                 The number of elements in \p background_operations.
+ **/
+void j_background_operation_wait_all(JBackgroundOperation** background_operations, guint count);
+
 /**
  * @}
  **/
@@ -30,6 +30,7 @@
 #include <glib.h>
 
 #include <core/jbatch.h>
+#include <core/jvector.h>
 
 G_BEGIN_DECLS
 
@@ -63,9 +64,9 @@ G_GNUC_INTERNAL JBatch* j_batch_new_from_batch(JBatch* batch);
  *
  * \param batch A batch.
  *
- * \return A list of parts.
+ * \return A vector of parts.
  **/
-G_GNUC_INTERNAL JList* j_batch_get_operations(JBatch* batch);
+G_GNUC_INTERNAL JVector* j_batch_get_operations(JBatch* batch);
 
 /**
  * Executes the batch.
@@ -43,6 +43,24 @@ struct JConfiguration;
 
 typedef struct JConfiguration JConfiguration;
 
+/**
+ * The transport used for communication between clients and servers.
+ **/
+enum JConfigurationTransport
+{
+	/**
+	 * Messages and data are sent via TCP sockets.
+	 **/
+	J_CONFIGURATION_TRANSPORT_TCP,
+
+	/**
+	 * Messages are sent via libfabric, bulk data is transferred using RMA.
+	 **/
+	J_CONFIGURATION_TRANSPORT_LIBFABRIC
+};
+
+typedef enum JConfigurationTransport JConfigurationTransport;
+
 /**
  * Returns the configuration.
  *
@@ -109,9 +127,16 @@ gchar const* j_configuration_get_backend_path(JConfiguration*, JBackendType);
 guint64 j_configuration_get_max_operation_size(JConfiguration*);
 guint64 j_configuration_get_max_inject_size(JConfiguration*);
 guint16 j_configuration_get_port(JConfiguration*);
+JConfigurationTransport j_configuration_get_transport(JConfiguration*);
 
 guint32 j_configuration_get_max_connections(JConfiguration*);
+gboolean j_configuration_get_multiplex(JConfiguration*);
 guint64 j_configuration_get_stripe_size(JConfiguration*);
+guint32 j_configuration_get_stripe_window(JConfiguration*);
+guint64 j_configuration_get_read_cache_size(JConfiguration*);
+guint32 j_configuration_get_read_cache_lease(JConfiguration*);
+
+guint32 j_configuration_get_db_query_batch_size(JConfiguration*);
 
 gchar const* j_configuration_get_checksum(JConfiguration*);
 
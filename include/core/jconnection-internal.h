@@ -0,0 +1,94 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_CONNECTION_INTERNAL_H
+#define JULEA_CONNECTION_INTERNAL_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+
+#include <core/jconnection.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \addtogroup JConnection
+ *
+ * @{
+ **/
+
+/**
+ * Starts a demultiplexer thread that reads reply headers and hands them to the matching receivers.
+ * Afterwards, multiple threads can use the connection concurrently.
+ * Only supported for TCP connections.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+G_GNUC_INTERNAL gboolean j_connection_start_multiplexing(JConnection* connection);
+
+/**
+ * Waits for the header of a message with the given ID.
+ * Afterwards, the caller owns the connection's input until it calls j_connection_release_input().
+ *
+ * \private
+ *
+ * \param connection A multiplexed connection.
+ * \param id         A message ID.
+ * \param header     A buffer of j_message_header_size() bytes.
+ *
+ * \return TRUE on success, FALSE if the connection has been closed.
+ **/
+G_GNUC_INTERNAL gboolean j_connection_receive_header(JConnection* connection, guint32 id, gpointer header);
+
+/**
+ * Acquires exclusive access to a connection's output.
+ * Used to prevent concurrent messages from interleaving.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ **/
+G_GNUC_INTERNAL void j_connection_lock_output(JConnection* connection);
+
+/**
+ * Releases exclusive access to a connection's output.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ **/
+G_GNUC_INTERNAL void j_connection_unlock_output(JConnection* connection);
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_CONNECTION_H
+#define JULEA_CONNECTION_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \defgroup JConnection Connection
+ *
+ * A connection between a client and a server.
+ * It abstracts the underlying transport, which is either a TCP socket or a libfabric connection.
+ *
+ * @{
+ **/
+
+struct JConnection;
+
+typedef struct JConnection JConnection;
+
+/**
+ * A function that is called when a connection's input is released.
+ *
+ * \param connection The connection.
+ * \param data       The user data.
+ **/
+typedef void (*JConnectionReleaseFunc)(JConnection* connection, gpointer data);
+
+G_END_DECLS
+
+#include <core/jconfiguration.h>
+#include <core/jnetwork.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Creates a new connection for a socket.
+ *
+ * \param socket A socket connection.
+ *
+ * \return A new connection. Should be freed with j_connection_free().
+ **/
+JConnection* j_connection_new_for_socket(GSocketConnection* socket);
+
+/**
+ * Creates a new connection for a libfabric connection.
+ * The connection takes ownership of \p network.
+ *
+ * \param network A libfabric connection.
+ *
+ * \return A new connection. Should be freed with j_connection_free().
+ **/
+JConnection* j_connection_new_for_network(JNetworkConnection* network);
+
+/**
+ * Closes a connection and frees the memory allocated for it.
+ *
+ * \param connection A connection.
+ **/
+void j_connection_free(JConnection* connection);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(JConnection, j_connection_free)
+
+/**
+ * Returns a connection's transport.
+ *
+ * \param connection A connection.
+ *
+ * \return The transport.
+ **/
+JConfigurationTransport j_connection_get_transport(JConnection* connection);
+
+/**
+ * Returns a connection's socket.
+ *
+ * \param connection A connection.
+ *
+ * \return The socket connection, NULL if the connection does not use TCP.
+ **/
+GSocketConnection* j_connection_get_socket(JConnection* connection);
+
+/**
+ * Returns a connection's libfabric connection.
+ *
+ * \param connection A connection.
+ *
+ * \return The libfabric connection, NULL if the connection does not use libfabric.
+ **/
+JNetworkConnection* j_connection_get_network(JConnection* connection);
+
+/**
+ * Reads data from a connection.
+ * Blocks until \p length bytes have been read.
+ *
+ * \param connection A connection.
+ * \param data       A buffer.
+ * \param length     Number of bytes to read.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_connection_read(JConnection* connection, gpointer data, gsize length);
+
+/**
+ * Reads data from a connection into multiple buffers.
+ * Blocks until all buffers have been filled.
+ * For TCP connections, this uses as few system calls as possible.
+ *
+ * \param connection A connection.
+ * \param vectors    The buffers.
+ * \param count      Number of buffers.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_connection_read_vectors(JConnection* connection, GInputVector const* vectors, guint count);
+
+/**
+ * Writes data to a connection.
+ * Blocks until \p length bytes have been written.
+ *
+ * For libfabric connections, every write has to be matched by a read of the same length on the other side.
+ *
+ * \param connection A connection.
+ * \param data       Data to write.
+ * \param length     Number of bytes to write.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_connection_write(JConnection* connection, gconstpointer data, gsize length);
+
+/**
+ * Enables or disables coalescing of writes.
+ * This is a no-op for connections that do not use TCP.
+ *
+ * \param connection A connection.
+ * \param enable     TRUE to enable coalescing, FALSE to flush and disable it.
+ **/
+void j_connection_set_cork(JConnection* connection, gboolean enable);
+
+/**
+ * Sets the function that is called when the connection's input is released.
+ * Servers use this to start reading the next message while the current one is still being processed.
+ *
+ * \param connection A connection.
+ * \param func       A function.
+ * \param data       User data passed to \p func.
+ **/
+void j_connection_set_release_func(JConnection* connection, JConnectionReleaseFunc func, gpointer data);
+
+/**
+ * Releases a connection's input.
+ * This is called automatically once a received message and all of its additional data have been read.
+ *
+ * \param connection A connection.
+ **/
+void j_connection_release_input(JConnection* connection);
+
+/**
+ * Returns whether multiple requests can be in flight on a connection.
+ *
+ * \param connection A connection.
+ *
+ * \return TRUE if the connection is multiplexed, FALSE otherwise.
+ **/
+gboolean j_connection_is_multiplexed(JConnection* connection);
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
@@ -91,6 +91,16 @@ void j_memory_chunk_free(JMemoryChunk* chunk);
  **/
 gpointer j_memory_chunk_get(JMemoryChunk* chunk, guint64 length);
 
+/**
+ * Returns the chunk's data.
+ * All segments returned by j_memory_chunk_get() are part of it.
+ *
+ * \param chunk A chunk.
+ *
+ * \return A pointer to the page-aligned data.
+ **/
+gpointer j_memory_chunk_get_data(JMemoryChunk* chunk);
+
 /**
  * Resets the given chunk. All data inside should be considered lost.
  *
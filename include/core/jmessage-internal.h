@@ -0,0 +1,66 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_MESSAGE_INTERNAL_H
+#define JULEA_MESSAGE_INTERNAL_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \addtogroup JMessage Message
+ *
+ * @{
+ **/
+
+/**
+ * Returns the size of a message header on the wire.
+ *
+ * \private
+ *
+ * \return The header size.
+ **/
+G_GNUC_INTERNAL gsize j_message_header_size(void);
+
+/**
+ * Returns the message ID stored in a raw message header.
+ *
+ * \private
+ *
+ * \param header A header of j_message_header_size() bytes.
+ *
+ * \return The message ID.
+ **/
+G_GNUC_INTERNAL guint32 j_message_header_get_id(gconstpointer header);
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
@@ -60,9 +60,11 @@ enum JMessageType
 	J_MESSAGE_DB_SCHEMA_GET,
 	J_MESSAGE_DB_SCHEMA_DELETE,
 	J_MESSAGE_DB_INSERT,
+	J_MESSAGE_DB_INSERT_MANY,
 	J_MESSAGE_DB_UPDATE,
 	J_MESSAGE_DB_DELETE,
-	J_MESSAGE_DB_QUERY
+	J_MESSAGE_DB_QUERY,
+	J_MESSAGE_DB_FETCH
 };
 
 typedef enum JMessageType JMessageType;
@@ -297,12 +299,24 @@ gchar const* j_message_get_string(JMessage* message);
  * \code
  * \endcode
  *
- * \param message A message.
- * \param stream  A network stream.
+ * \param message    A message.
+ * \param connection A JConnection.
  *
  * \return TRUE on success, FALSE if an error occurred.
  **/
-gboolean j_message_send(JMessage* message, gpointer stream);
+gboolean j_message_send(JMessage* message, gpointer connection);
+
+/**
+ * Releases the connection's input if not all additional data of a received message has been read.
+ * Usually, the input is released automatically by j_message_receive() and j_message_receive_data().
+ *
+ * \code
+ * \endcode
+ *
+ * \param message    A received message.
+ * \param connection The JConnection the message was received from.
+ **/
+void j_message_finish_receive(JMessage* message, gpointer connection);
 
 /**
  * Reads a message from the network.
@@ -310,12 +324,45 @@ gboolean j_message_send(JMessage* message, gpointer stream);
  * \code
  * \endcode
  *
- * \param message A message.
- * \param stream  A network stream.
+ * \param message    A message.
+ * \param connection A JConnection.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_message_receive(JMessage* message, gpointer connection);
+
+/**
+ * Reads additional data that has been added to a received message using j_message_add_send().
+ * Has to be called once for each j_message_add_send() on the sending side, in the same order.
+ * Depending on the transport, the data is either read from the stream or via RMA.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message    A received message.
+ * \param connection The JConnection the message was received from.
+ * \param data       A buffer.
+ * \param length     The length of the additional data.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_message_receive_data(JMessage* message, gpointer connection, gpointer data, guint64 length);
+
+/**
+ * Reads multiple buffers of additional data that have been added to a received message using j_message_add_send().
+ * This is equivalent to calling j_message_receive_data() for each buffer but requires fewer system calls.
+ *
+ * \code
+ * \endcode
+ *
+ * \param message    A received message.
+ * \param connection The JConnection the message was received from.
+ * \param vectors    The buffers.
+ * \param count      The number of buffers.
  *
  * \return TRUE on success, FALSE if an error occurred.
  **/
-gboolean j_message_receive(JMessage* message, gpointer stream);
+gboolean j_message_receive_data_vectors(JMessage* message, gpointer connection, GInputVector const* vectors, guint count);
 
 /**
  * Reads a message from the network.
@@ -173,6 +173,17 @@ G_BEGIN_DECLS
  **/
 JNetworkFabric* j_network_fabric_init_server(JConfiguration* configuration);
 
+/**
+ * Closes a fabric and frees used memory.
+ *
+ * \pre Finish all connections created from this fabric.
+ *
+ * \param fabric A fabric.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+gboolean j_network_fabric_fini(JNetworkFabric* fabric);
+
 /**
  * Gets identifier of memory region.
  *
@@ -29,8 +29,8 @@
 
 #include <glib.h>
 
-#include <core/jlist.h>
 #include <core/jsemantics.h>
+#include <core/jvector.h>
 
 G_BEGIN_DECLS
 
@@ -40,19 +40,43 @@ G_BEGIN_DECLS
  * @{
  **/
 
-typedef gboolean (*JOperationExecFunc)(JList*, JSemantics*);
+typedef gboolean (*JOperationExecFunc)(JVector*, JSemantics*);
 typedef void (*JOperationFreeFunc)(gpointer);
 
+/**
+ * Prepares an operation for being executed after its batch has returned.
+ *
+ * If \p buffer is NULL, only returns the number of bytes required to copy the operation's input.
+ * Otherwise, copies the input to \p buffer, makes the operation use the copy and fills in its results.
+ * Operations that do not require any bytes are not called with a buffer.
+ *
+ * \param data   The operation's data.
+ * \param buffer A buffer or NULL.
+ *
+ * \return The number of bytes required in \p buffer.
+ **/
+typedef guint64 (*JOperationCacheFunc)(gpointer data, gpointer buffer);
+
 /**
  * An operation.
  **/
 struct JOperation
 {
-	gconstpointer key;
+	/**
+	 * A string identifying the data accessed by the operation, such as the backend type, server, namespace and name.
+	 * Operations with equal keys are executed in order, operations with different keys are considered independent.
+	 * Operations without a key are executed in order with respect to all other operations.
+	 **/
+	gchar const* key;
 	gpointer data;
 
 	JOperationExecFunc exec_func;
 	JOperationFreeFunc free_func;
+
+	/**
+	 * Used by the operation cache, operations without it cannot be cached.
+	 **/
+	JOperationCacheFunc cache_func;
 };
 
 typedef struct JOperation JOperation;
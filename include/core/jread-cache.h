@@ -0,0 +1,146 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_READ_CACHE_H
+#define JULEA_READ_CACHE_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+
+#include <core/jsemantics.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \defgroup JReadCache Read Cache
+ *
+ * A size-bounded client-side cache for the results of read operations.
+ *
+ * Entries are evicted in least recently used order.
+ * Each entry is leased for a fixed time after it has been fetched.
+ * Whether an entry can still be used depends on the consistency of the batch reading it:
+ * Immediate consistency bypasses the cache, session consistency only uses entries whose lease has not expired
+ * and eventual consistency uses entries for ten times the lease time.
+ * Invalidations are tracked per key and are evicted like other entries.
+ *
+ * @{
+ **/
+
+struct JReadCache;
+
+typedef struct JReadCache JReadCache;
+
+/**
+ * Creates a new read cache.
+ *
+ * \code
+ * JReadCache* cache;
+ *
+ * cache = j_read_cache_new(1024 * 1024, G_USEC_PER_SEC);
+ * \endcode
+ *
+ * \param size  The maximum number of bytes used by keys and values.
+ * \param lease The lease time in microseconds.
+ *
+ * \return A new read cache. Should be freed with j_read_cache_free().
+ **/
+JReadCache* j_read_cache_new(guint64 size, gint64 lease);
+
+/**
+ * Frees the memory allocated for the read cache.
+ *
+ * \param cache A read cache.
+ **/
+void j_read_cache_free(JReadCache* cache);
+
+/**
+ * Returns the process-wide read cache.
+ *
+ * \return The read cache, NULL if it has been disabled in the configuration.
+ **/
+JReadCache* j_read_cache(void);
+
+/**
+ * Looks up an entry.
+ *
+ * \param cache       A read cache.
+ * \param key         A key.
+ * \param consistency The consistency of the batch performing the read.
+ * \param value       Returns a copy of the cached value. Should be freed with g_free().
+ * \param value_len   Returns the length of the cached value.
+ *
+ * \return TRUE if a usable entry was found, FALSE otherwise. Always FALSE for immediate consistency.
+ **/
+gboolean j_read_cache_get(JReadCache* cache, gchar const* key, JSemanticsConsistency consistency, gpointer* value, guint32* value_len);
+
+/**
+ * Inserts or replaces an entry.
+ *
+ * The entry is not inserted if the key was invalidated at or after \p since,
+ * because the value might have been read before a concurrent local modification.
+ * If the key's invalidation has already been evicted, the latest evicted invalidation is used instead.
+ *
+ * \param cache     A read cache.
+ * \param key       A key.
+ * \param value     A value, which is copied.
+ * \param value_len The value's length.
+ * \param since     The monotonic time at which the read was started, as returned by g_get_monotonic_time().
+ **/
+void j_read_cache_put(JReadCache* cache, gchar const* key, gconstpointer value, guint32 value_len, gint64 since);
+
+/**
+ * Invalidates an entry.
+ * This has to be called whenever the underlying data is modified by the local process.
+ *
+ * \param cache A read cache.
+ * \param key   A key.
+ **/
+void j_read_cache_invalidate(JReadCache* cache, gchar const* key);
+
+/**
+ * Returns the number of lookups that were answered from the cache.
+ *
+ * \param cache A read cache.
+ *
+ * \return The number of hits.
+ **/
+guint64 j_read_cache_get_hits(JReadCache* cache);
+
+/**
+ * Returns the number of lookups that could not be answered from the cache.
+ *
+ * \param cache A read cache.
+ *
+ * \return The number of misses.
+ **/
+guint64 j_read_cache_get_misses(JReadCache* cache);
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
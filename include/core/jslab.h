@@ -0,0 +1,103 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_SLAB_H
+#define JULEA_SLAB_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \defgroup JSlab Slab Allocator
+ *
+ * A size-classed allocator for small, frequently allocated objects and buffers.
+ *
+ * Sizes are rounded up to the next power of two and freed blocks are kept in per-thread caches,
+ * which are balanced using a global cache.
+ * Blocks larger than the biggest size class are allocated using g_malloc().
+ *
+ * @{
+ **/
+
+/**
+ * Allocates a block of memory for a structure.
+ *
+ * \param struct_type The type of the structure.
+ *
+ * \return A new block. Should be freed with j_slab_delete().
+ **/
+#define j_slab_new(struct_type) ((struct_type*)j_slab_alloc(sizeof(struct_type)))
+
+/**
+ * Frees a block of memory allocated with j_slab_new().
+ *
+ * \param struct_type The type of the structure.
+ * \param mem         The block.
+ **/
+#define j_slab_delete(struct_type, mem) j_slab_free((mem), sizeof(struct_type))
+
+/**
+ * Allocates a block of memory.
+ *
+ * \code
+ * gchar* buffer;
+ *
+ * buffer = j_slab_alloc(100);
+ * ...
+ * j_slab_free(buffer, 100);
+ * \endcode
+ *
+ * \param size The block's size.
+ *
+ * \return A new block of at least \p size bytes. Should be freed with j_slab_free().
+ **/
+gpointer j_slab_alloc(gsize size);
+
+/**
+ * Frees a block of memory.
+ *
+ * \param mem  The block.
+ * \param size The size that was passed to j_slab_alloc(), or any size up to the one returned by j_slab_get_size().
+ **/
+void j_slab_free(gpointer mem, gsize size);
+
+/**
+ * Returns the usable size of blocks allocated for a size.
+ *
+ * \param size A size.
+ *
+ * \return The size of the block that j_slab_alloc() returns for \p size.
+ **/
+gsize j_slab_get_size(gsize size);
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
@@ -29,6 +29,8 @@
 
 #include <glib.h>
 
+#include <core/jmessage.h>
+
 G_BEGIN_DECLS
 
 /**
@@ -51,6 +53,61 @@ enum JStatisticsType
 
 typedef enum JStatisticsType JStatisticsType;
 
+/**
+ * Per-message-type statistics.
+ **/
+enum JStatisticsMessage
+{
+	/**
+	 * The number of handled messages.
+	 **/
+	J_STATISTICS_MESSAGE_REQUESTS,
+
+	/**
+	 * The number of handled operations, that is, the number of backend calls.
+	 **/
+	J_STATISTICS_MESSAGE_OPERATIONS,
+
+	/**
+	 * The number of messages currently being handled.
+	 **/
+	J_STATISTICS_MESSAGE_IN_FLIGHT,
+
+	/**
+	 * The total time messages waited to be handled in microseconds.
+	 **/
+	J_STATISTICS_MESSAGE_QUEUE_TIME,
+
+	/**
+	 * The total time spent handling messages in microseconds.
+	 **/
+	J_STATISTICS_MESSAGE_SERVICE_TIME
+};
+
+typedef enum JStatisticsMessage JStatisticsMessage;
+
+/**
+ * Per-message-type latency histograms.
+ **/
+enum JStatisticsHistogram
+{
+	J_STATISTICS_HISTOGRAM_QUEUE_TIME,
+	J_STATISTICS_HISTOGRAM_SERVICE_TIME
+};
+
+typedef enum JStatisticsHistogram JStatisticsHistogram;
+
+/**
+ * The number of message types.
+ **/
+#define J_STATISTICS_MESSAGE_TYPES (J_MESSAGE_DB_FETCH + 1)
+
+/**
+ * The number of histogram buckets.
+ * Bucket \e i counts durations of less than 2^\e i microseconds, the last bucket counts all remaining ones.
+ **/
+#define J_STATISTICS_HISTOGRAM_BUCKETS 32
+
 struct JStatistics;
 
 typedef struct JStatistics JStatistics;
@@ -114,6 +171,133 @@ guint64 j_statistics_get(JStatistics* statistics, JStatisticsType type);
  **/
 void j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value);
 
+/**
+ * Marks the beginning of handling a message.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ **/
+void j_statistics_message_begin(JStatistics* statistics, JMessageType type);
+
+/**
+ * Marks the end of handling a message and records its latencies.
+ * Has to be preceded by j_statistics_message_begin().
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics   A statistics.
+ * \param type         A message type.
+ * \param operations   The number of operations contained in the message.
+ * \param queue_time   The time the message waited to be handled in microseconds.
+ * \param service_time The time spent handling the message in microseconds.
+ **/
+void j_statistics_message_end(JStatistics* statistics, JMessageType type, guint32 operations, guint64 queue_time, guint64 service_time);
+
+/**
+ * Gets a per-message-type value.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param statistic  A per-message-type statistic.
+ *
+ * \return The requested value.
+ **/
+guint64 j_statistics_get_message(JStatistics* statistics, JMessageType type, JStatisticsMessage statistic);
+
+/**
+ * Adds a value to a per-message-type statistic.
+ * This is useful to combine the statistics of multiple servers.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param statistic  A per-message-type statistic.
+ * \param value      A value to add to the statistic.
+ **/
+void j_statistics_add_message(JStatistics* statistics, JMessageType type, JStatisticsMessage statistic, guint64 value);
+
+/**
+ * Gets the value of a histogram bucket.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param histogram  A histogram.
+ * \param bucket     A bucket, less than #J_STATISTICS_HISTOGRAM_BUCKETS.
+ *
+ * \return The number of durations counted in the bucket.
+ **/
+guint64 j_statistics_get_histogram(JStatistics* statistics, JMessageType type, JStatisticsHistogram histogram, guint bucket);
+
+/**
+ * Adds a value to a histogram bucket.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param histogram  A histogram.
+ * \param bucket     A bucket, less than #J_STATISTICS_HISTOGRAM_BUCKETS.
+ * \param value      A value to add to the bucket.
+ **/
+void j_statistics_add_histogram(JStatistics* statistics, JMessageType type, JStatisticsHistogram histogram, guint bucket, guint64 value);
+
+/**
+ * Returns the name of a message type as used in the statistics.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param type A message type.
+ *
+ * \return The name, for instance, \e kv_put.
+ **/
+gchar const* j_statistics_get_message_type_name(JMessageType type);
+
+/**
+ * Formats the statistics in the Prometheus text exposition format.
+ *
+ * \private
+ *
+ * \code
+ * g_autofree gchar* text = NULL;
+ *
+ * text = j_statistics_to_prometheus(statistics, "server=\"0\"");
+ * \endcode
+ *
+ * \param statistics A statistics.
+ * \param labels     Additional labels added to all metrics, or NULL.
+ *
+ * \return The formatted statistics. Should be freed with g_free().
+ **/
+gchar* j_statistics_to_prometheus(JStatistics* statistics, gchar const* labels);
+
 /**
  * @}
  **/
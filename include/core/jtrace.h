@@ -55,6 +55,14 @@ enum JTraceFileOperation
 
 typedef enum JTraceFileOperation JTraceFileOperation;
 
+enum JTraceMessageOperation
+{
+	J_TRACE_MESSAGE_SEND,
+	J_TRACE_MESSAGE_RECEIVE
+};
+
+typedef enum JTraceMessageOperation JTraceMessageOperation;
+
 struct JTrace;
 
 typedef struct JTrace JTrace;
@@ -63,7 +71,7 @@ typedef struct JTrace JTrace;
  * Initializes the trace framework.
  * Tracing is disabled by default.
  * Set the \c J_TRACE environment variable to enable it.
- * Valid values are \e echo and \e otf.
+ * Valid values are \e echo, \e otf, \e summary and \e chrome.
  * Multiple values can be combined with commas.
  *
  * \code
@@ -159,6 +167,18 @@ void j_trace_file_end(gchar const* path, JTraceFileOperation op, guint64 length,
  **/
 void j_trace_counter(gchar const* name, guint64 counter_value);
 
+/**
+ * Traces sending or receiving a message.
+ * Allows connecting the client's and the server's events.
+ *
+ * \code
+ * \endcode
+ *
+ * \param op A message operation.
+ * \param id A message ID.
+ **/
+void j_trace_message(JTraceMessageOperation op, guint32 id);
+
 /**
  * @}
  **/
@@ -0,0 +1,277 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#ifndef JULEA_VECTOR_H
+#define JULEA_VECTOR_H
+
+#if !defined(JULEA_H) && !defined(JULEA_COMPILATION)
+#error "Only <julea.h> can be included directly."
+#endif
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \defgroup JVector Vector
+ *
+ * A growable array of pointers.
+ *
+ * In contrast to JList, elements are stored contiguously and iterators do not have to be allocated.
+ * Slices allow passing a part of a vector without copying its elements.
+ * The accessors used in hot loops are inline functions that are neither traced nor check their arguments.
+ *
+ * @{
+ **/
+
+typedef void (*JVectorFreeFunc)(gpointer);
+
+/**
+ * A vector.
+ **/
+struct JVector
+{
+	/**
+	 * The elements.
+	 **/
+	gpointer* data;
+
+	/**
+	 * The number of elements.
+	 **/
+	guint length;
+
+	/**
+	 * The number of allocated elements.
+	 **/
+	guint size;
+
+	/**
+	 * A function to free the elements, or NULL.
+	 **/
+	JVectorFreeFunc free_func;
+
+	/**
+	 * Whether the vector is a slice of another vector.
+	 * Slices do not own their elements and cannot be modified.
+	 **/
+	gboolean slice;
+};
+
+typedef struct JVector JVector;
+
+/**
+ * A vector iterator.
+ * Iterators are usually allocated on the stack and initialized using j_vector_iterator_init().
+ **/
+struct JVectorIterator
+{
+	/**
+	 * The vector.
+	 **/
+	JVector const* vector;
+
+	/**
+	 * The index of the next element.
+	 **/
+	guint index;
+
+	/**
+	 * The current element.
+	 **/
+	gpointer current;
+};
+
+typedef struct JVectorIterator JVectorIterator;
+
+/**
+ * Creates a new vector.
+ *
+ * \code
+ * JVector* vector;
+ *
+ * vector = j_vector_new(g_free);
+ * \endcode
+ *
+ * \param free_func A function to free the elements, or NULL.
+ *
+ * \return A new vector. Should be freed with j_vector_free().
+ **/
+JVector* j_vector_new(JVectorFreeFunc free_func);
+
+/**
+ * Frees the memory allocated for the vector and its elements.
+ *
+ * \param vector A vector.
+ **/
+void j_vector_free(JVector* vector);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(JVector, j_vector_free)
+
+/**
+ * Initializes a slice of a vector.
+ * The slice shares the vector's elements and stays valid until the vector is modified.
+ *
+ * \code
+ * JVector slice[1];
+ *
+ * j_vector_slice(slice, vector, 2, 3);
+ * \endcode
+ *
+ * \param slice  The slice to initialize.
+ * \param vector A vector.
+ * \param offset The index of the slice's first element.
+ * \param length The slice's length.
+ **/
+void j_vector_slice(JVector* slice, JVector const* vector, guint offset, guint length);
+
+/**
+ * Returns the vector's length.
+ *
+ * \param vector A vector.
+ *
+ * \return The vector's length.
+ **/
+static inline guint
+j_vector_length(JVector const* vector)
+{
+	return vector->length;
+}
+
+/**
+ * Appends an element to a vector.
+ *
+ * \param vector A vector.
+ * \param data   An element.
+ **/
+void j_vector_append(JVector* vector, gpointer data);
+
+/**
+ * Sets the vector's length.
+ * New elements are set to NULL, removed elements are freed.
+ *
+ * \param vector A vector.
+ * \param length The new length.
+ **/
+void j_vector_set_length(JVector* vector, guint length);
+
+/**
+ * Replaces an element.
+ * The previous element is not freed.
+ *
+ * \param vector A vector.
+ * \param index  The element's index.
+ * \param data   An element.
+ **/
+void j_vector_set(JVector* vector, guint index, gpointer data);
+
+/**
+ * Returns an element.
+ *
+ * \param vector A vector.
+ * \param index  The element's index, which has to be smaller than the vector's length.
+ *
+ * \return The element.
+ **/
+static inline gpointer
+j_vector_get(JVector const* vector, guint index)
+{
+	return vector->data[index];
+}
+
+/**
+ * Returns the first element.
+ *
+ * \param vector A vector.
+ *
+ * \return The first element, or NULL if the vector is empty.
+ **/
+gpointer j_vector_get_first(JVector const* vector);
+
+/**
+ * Deletes all elements.
+ * The allocated memory is kept for reuse.
+ *
+ * \param vector A vector.
+ **/
+void j_vector_delete_all(JVector* vector);
+
+/**
+ * Initializes an iterator.
+ *
+ * \code
+ * JVectorIterator iterator[1];
+ *
+ * j_vector_iterator_init(iterator, vector);
+ *
+ * while (j_vector_iterator_next(iterator))
+ * {
+ *     gpointer data = j_vector_iterator_get(iterator);
+ * }
+ * \endcode
+ *
+ * \param iterator An iterator.
+ * \param vector   A vector.
+ **/
+void j_vector_iterator_init(JVectorIterator* iterator, JVector const* vector);
+
+/**
+ * Advances the iterator to the next element.
+ *
+ * \param iterator An iterator.
+ *
+ * \return TRUE on success, FALSE if the end of the vector is reached.
+ **/
+static inline gboolean
+j_vector_iterator_next(JVectorIterator* iterator)
+{
+	if (iterator->index == iterator->vector->length)
+	{
+		return FALSE;
+	}
+
+	iterator->current = iterator->vector->data[iterator->index];
+	iterator->index++;
+
+	return TRUE;
+}
+
+/**
+ * Returns the current element.
+ *
+ * \param iterator An iterator.
+ *
+ * \return The current element.
+ **/
+static inline gpointer
+j_vector_iterator_get(JVectorIterator* iterator)
+{
+	return iterator->current;
+}
+
+/**
+ * @}
+ **/
+
+G_END_DECLS
+
+#endif
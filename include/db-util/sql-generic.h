@@ -74,6 +74,7 @@ gboolean sql_generic_schema_get(gpointer backend_data, gpointer _batch, gchar co
 gboolean sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* name, GError** error);
 
 gboolean sql_generic_insert(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* metadata, bson_t* id, GError** error);
+gboolean sql_generic_insert_many(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* entries, GError** error);
 gboolean sql_generic_update(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t const* metadata, GError** error);
 gboolean sql_generic_delete(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, GError** error);
 gboolean sql_generic_query(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, gpointer* iterator, GError** error);
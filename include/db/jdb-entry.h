@@ -120,6 +120,25 @@ gboolean j_db_entry_set_field(JDBEntry* entry, gchar const* name, gconstpointer
  **/
 gboolean j_db_entry_insert(JDBEntry* entry, JBatch* batch, GError** error);
 
+/**
+ * Save the entry in the backend without retrieving its id.
+ * Consecutive bulk inserts into the same schema within a batch are sent as a single operation,
+ * which allows backends to use multi-row inserts.
+ * j_db_entry_get_id must not be called for the entry.
+ *
+ * The entry must not be modified until the batch is executed.
+ *
+ * \param[in] entry the entry to save
+ * \param[in] batch the batch to append this operation to
+ * \param[out] error  A GError pointer. Will point to a GError object in case of failure.
+ * \pre entry != NULL
+ * \pre entry has a least 1 value set to not NULL
+ * \pre batch != NULL
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_entry_insert_bulk(JDBEntry* entry, JBatch* batch, GError** error);
+
 /**
  * Replayes all entrys attributes with the given entrys attributes in the backend where the selector matches.
  *
@@ -132,6 +151,7 @@ gboolean j_db_entry_insert(JDBEntry* entry, JBatch* batch, GError** error);
  * \param[out] error  A GError pointer. Will point to a GError object in case of failure.
  * \pre entry != NULL
  * \pre entry has a least 1 value set to not NULL
+ * \pre entry does not set the schema's shard key
  * \pre selector != NULL
  * \pre selector matches at least 1 entry
  * \pre batch != NULL
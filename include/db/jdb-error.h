@@ -45,6 +45,7 @@ enum JDBError
 	J_DB_ERROR_SELECTOR_EMPTY,
 	J_DB_ERROR_SELECTOR_MUST_NOT_EQUAL,
 	J_DB_ERROR_SELECTOR_TOO_COMPLEX,
+	J_DB_ERROR_SHARD_KEY_IMMUTABLE,
 	J_DB_ERROR_TYPE_INVALID,
 	J_DB_ERROR_VARIABLE_ALREADY_SET,
 	J_DB_ERROR_VARIABLE_NOT_FOUND
@@ -42,6 +42,11 @@
 
 G_BEGIN_DECLS
 
+/**
+ * Used for operations that have to be sent to all DB servers.
+ **/
+#define J_DB_ALL_SERVERS (-1)
+
 struct JDBEntry
 {
 	bson_t bson;
@@ -85,6 +90,12 @@ struct JDBSchema
 	gchar* namespace;
 	gchar* name;
 
+	/**
+	 * The field used to distribute the schema's entries across all DB servers.
+	 * NULL if the schema is stored on a single server.
+	 */
+	gchar* shard_key;
+
 	guint bson_index_count;
 	gint ref_count;
 
@@ -118,6 +129,13 @@ struct JDBSelector
 	GHashTable* join_schema; /// Stores the names of joined schemas. It is used as a set and all values are NULL.
 
 	guint selection_count; /// The number of selecotr entries must not exceed 500.
+
+	/**
+	 * The DB server storing the entries selected by an `_id` condition of a sharded schema.
+	 * J_DB_ALL_SERVERS if there is no such condition.
+	 */
+	gint id_server;
+
 	gint ref_count;
 };
 
@@ -126,13 +144,31 @@ gboolean j_db_internal_schema_create(JDBSchema* j_db_schema, JBatch* batch, GErr
 gboolean j_db_internal_schema_get(JDBSchema* j_db_schema, JBatch* batch, GError** error);
 gboolean j_db_internal_schema_delete(JDBSchema* j_db_schema, JBatch* batch, GError** error);
 gboolean j_db_internal_insert(JDBEntry* j_db_entry, JBatch* batch, GError** error);
+gboolean j_db_internal_insert_many(JDBEntry* j_db_entry, JBatch* batch, GError** error);
 gboolean j_db_internal_update(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* batch, GError** error);
 gboolean j_db_internal_delete(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* batch, GError** error);
 gboolean j_db_internal_query(JDBSchema* j_db_schema, JDBSelector* j_db_selector, JDBIterator* j_db_iterator, JBatch* batch, GError** error);
 gboolean j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error);
+void j_db_internal_iterate_close(JDBIterator* j_db_iterator);
 
 // Client-side additional internal functions
 
+/**
+ * \brief Translate an entry ID into the ID used by the server storing the entry.
+ *
+ * Entries of sharded schemas are stored on multiple servers, whose IDs are only unique per server.
+ * Therefore, the client encodes the server's index into the IDs it returns.
+ *
+ * \param schema the entry's schema.
+ * \param id the globally unique ID.
+ * \param local_id returns the ID used by the server.
+ * \param server returns the server's index.
+ *
+ * \return TRUE if the ID has been translated, FALSE if the schema's IDs are not translated.
+ **/
+gboolean j_db_internal_decode_id(JDBSchema* schema, guint64 id, guint64* local_id, gint* server);
+
+
 /**
  * \brief Get the selector data represented as a single bson document.
  *
@@ -150,6 +150,31 @@ guint32 j_db_schema_get_all_fields(JDBSchema* schema, gchar*** names, JDBType**
  **/
 gboolean j_db_schema_add_index(JDBSchema* schema, gchar const** names, GError** error);
 
+/**
+ * distributes the schema's entries across all DB servers.
+ *
+ * By default, all entries of a schema are stored on a single server that is chosen based on the schema's namespace.
+ * If a shard key is set, each entry is stored on the server chosen based on the value of its shard key field.
+ * Operations whose selector contains an equality condition on the shard key are sent to a single server,
+ * all other operations are sent to all servers and their results are merged.
+ *
+ * The shard key is stored together with the schema and restored by j_db_schema_get(), so it has to be set before j_db_schema_create().
+ * Entry IDs are made globally unique by encoding the index of the server storing the entry, so they can only be compared for equality.
+ * The shard key of an entry cannot be updated and joins are evaluated separately on each server.
+ *
+ * \param[in] schema the schema to distribute
+ * \param[in] name the name of the variable to use as the shard key
+ * \param[out] error A GError pointer. Will point to a GError object in case of failure.
+ *
+ * \pre schema != NULL
+ * \pre name != NULL
+ * \pre name is a previously defined variable-name
+ * \pre schema has not been created or retrieved yet
+ *
+ * \return TRUE on success, FALSE otherwise
+ **/
+gboolean j_db_schema_set_shard_key(JDBSchema* schema, gchar const* name, GError** error);
+
 /**
  * stores a schema in the backend.
  *
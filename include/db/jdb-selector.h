@@ -114,6 +114,7 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(JDBSelector, j_db_selector_unref)
  * \pre name != NULL
  * \pre name must exist in the schema
  * \pre operator must be applyable to the defined type of the variable
+ * \pre IDs of sharded schemas must be compared for equality in a selector using J_DB_SELECTOR_MODE_AND
  * \pre selector including all previously added sub_selectors must not contain more than 500 search fields after applying this operation
  * \post the value may be freed or modified by the caller immediately after calling this function
  *
@@ -36,6 +36,7 @@
 #include <core/jbatch.h>
 #include <core/jcache.h>
 #include <core/jconfiguration.h>
+#include <core/jconnection.h>
 #include <core/jconnection-pool.h>
 #include <core/jcredentials.h>
 #include <core/jdir-iterator.h>
@@ -47,9 +48,12 @@
 #include <core/jmessage.h>
 #include <core/jnetwork.h>
 #include <core/joperation.h>
+#include <core/jread-cache.h>
 #include <core/jsemantics.h>
+#include <core/jslab.h>
 #include <core/jstatistics.h>
 #include <core/jtrace.h>
+#include <core/jvector.h>
 
 #undef JULEA_H
 
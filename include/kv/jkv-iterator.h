@@ -43,6 +43,21 @@ struct JKVIterator;
 
 typedef struct JKVIterator JKVIterator;
 
+/**
+ * Flags for iterators.
+ **/
+enum JKVIteratorFlags
+{
+	J_KV_ITERATOR_NONE = 0,
+	/**
+	 * Only return keys and the lengths of their values.
+	 * The values themselves are not transferred and returned as NULL.
+	 **/
+	J_KV_ITERATOR_KEYS_ONLY = 1 << 0
+};
+
+typedef enum JKVIteratorFlags JKVIteratorFlags;
+
 G_END_DECLS
 
 #include <kv/jkv.h>
@@ -70,6 +85,29 @@ JKVIterator* j_kv_iterator_new(gchar const* namespace, gchar const* prefix);
  **/
 JKVIterator* j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const* prefix);
 
+/**
+ * Creates a new JKVIterator for a range of keys.
+ *
+ * Entries are fetched from the servers in pages, the next page being fetched while the current one is consumed.
+ * Keys are not necessarily returned in order.
+ *
+ * \code
+ * g_autoptr(JKVIterator) iterator = NULL;
+ *
+ * iterator = j_kv_iterator_new_range("namespace", NULL, "a", "b", 100, J_KV_ITERATOR_KEYS_ONLY);
+ * \endcode
+ *
+ * \param namespace JKV namespace to iterate over.
+ * \param prefix Prefix of keys to iterate over. Set to NULL to iterate over all KVs.
+ * \param start_key The first key to return (inclusive). Set to NULL for no lower bound.
+ * \param end_key The first key not to return (exclusive). Set to NULL for no upper bound.
+ * \param limit The maximum number of KVs to return. Set to 0 for no limit.
+ * \param flags Flags.
+ *
+ * \return A new JKVIterator.
+ **/
+JKVIterator* j_kv_iterator_new_range(gchar const* namespace, gchar const* prefix, gchar const* start_key, gchar const* end_key, guint32 limit, JKVIteratorFlags flags);
+
 /**
  * Frees the memory allocated by the JKVIterator.
  *
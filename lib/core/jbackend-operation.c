@@ -82,6 +82,14 @@ _error:
 	return FALSE;
 }
 
+gboolean
+j_backend_operation_unwrap_db_insert_many(JBackend* backend, gpointer batch, JBackendOperation* data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_backend_db_insert_many(backend, batch, data->in_param[1].ptr, data->in_param[2].ptr, data->out_param[0].ptr);
+}
+
 gboolean
 j_backend_operation_unwrap_db_update(JBackend* backend, gpointer batch, JBackendOperation* data)
 {
@@ -527,6 +527,97 @@ j_backend_object_write(JBackend* backend, gpointer data, gconstpointer buffer, g
 	return ret;
 }
 
+gboolean
+j_backend_object_register_buffer(JBackend* backend, gpointer buffer, guint64 size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(buffer != NULL, FALSE);
+
+	if (backend->object.backend_register_buffer == NULL)
+	{
+		return FALSE;
+	}
+
+	{
+		J_TRACE("backend_register_buffer", "%p, %" G_GUINT64_FORMAT, buffer, size);
+		ret = backend->object.backend_register_buffer(backend->data, buffer, size);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_read_vector(JBackend* backend, gpointer data, JBackendObjectIO* ios, guint count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(ios != NULL || count == 0, FALSE);
+
+	if (backend->object.backend_read_vector == NULL)
+	{
+		for (guint i = 0; i < count; i++)
+		{
+			ios[i].bytes = 0;
+			ret = j_backend_object_read(backend, data, ios[i].buffer, ios[i].length, ios[i].offset, &(ios[i].bytes)) && ret;
+		}
+
+		return ret;
+	}
+
+	{
+		J_TRACE("backend_read_vector", "%p, %p, %u", data, (gpointer)ios, count);
+		ret = backend->object.backend_read_vector(backend->data, data, ios, count);
+	}
+
+	return ret;
+}
+
+gboolean
+j_backend_object_write_vector(JBackend* backend, gpointer data, JBackendObjectIO* ios, guint count, gboolean sync)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_OBJECT, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(ios != NULL || count == 0, FALSE);
+
+	if (backend->object.backend_write_vector == NULL)
+	{
+		for (guint i = 0; i < count; i++)
+		{
+			ios[i].bytes = 0;
+			ret = j_backend_object_write(backend, data, ios[i].buffer, ios[i].length, ios[i].offset, &(ios[i].bytes)) && ret;
+		}
+
+		if (sync)
+		{
+			ret = j_backend_object_sync(backend, data) && ret;
+		}
+
+		return ret;
+	}
+
+	{
+		J_TRACE("backend_write_vector", "%p, %p, %u, %d", data, (gpointer)ios, count, sync);
+		ret = backend->object.backend_write_vector(backend->data, data, ios, count, sync);
+	}
+
+	return ret;
+}
+
 gboolean
 j_backend_kv_init(JBackend* backend, gchar const* path)
 {
@@ -581,6 +672,32 @@ j_backend_kv_batch_start(JBackend* backend, gchar const* namespace, JSemantics*
 	return ret;
 }
 
+gboolean
+j_backend_kv_batch_start_read_only(JBackend* backend, gchar const* namespace, JSemantics* semantics, gpointer* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_KV, FALSE);
+	g_return_val_if_fail(namespace != NULL, FALSE);
+	g_return_val_if_fail(semantics != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+
+	if (backend->kv.backend_batch_start_read_only == NULL)
+	{
+		return j_backend_kv_batch_start(backend, namespace, semantics, batch);
+	}
+
+	{
+		J_TRACE("backend_batch_start_read_only", "%s, %p, %p", namespace, (gpointer)semantics, (gpointer)batch);
+		ret = backend->kv.backend_batch_start_read_only(backend->data, namespace, semantics, batch);
+	}
+
+	return ret;
+}
+
 gboolean
 j_backend_kv_batch_execute(JBackend* backend, gpointer batch)
 {
@@ -725,6 +842,35 @@ j_backend_kv_iterate(JBackend* backend, gpointer iterator, gchar const** key, gc
 	return ret;
 }
 
+void
+j_backend_kv_iterate_abort(JBackend* backend, gpointer iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(backend != NULL);
+	g_return_if_fail(backend->type == J_BACKEND_TYPE_KV);
+	g_return_if_fail(iterator != NULL);
+
+	if (backend->kv.backend_iterate_abort == NULL)
+	{
+		gchar const* key;
+		gconstpointer value;
+		guint32 len;
+
+		// Iterators release their resources once they are exhausted
+		while (j_backend_kv_iterate(backend, iterator, &key, &value, &len))
+		{
+		}
+
+		return;
+	}
+
+	{
+		J_TRACE("backend_iterate_abort", "%p", iterator);
+		backend->kv.backend_iterate_abort(backend->data, iterator);
+	}
+}
+
 gboolean
 j_backend_db_init(JBackend* backend, gchar const* path)
 {
@@ -887,6 +1033,66 @@ j_backend_db_insert(JBackend* backend, gpointer batch, gchar const* name, bson_t
 	return ret;
 }
 
+gboolean
+j_backend_db_insert_many(JBackend* backend, gpointer batch, gchar const* name, bson_t const* entries, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(backend != NULL, FALSE);
+	g_return_val_if_fail(backend->type == J_BACKEND_TYPE_DB, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(entries != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (backend->db.backend_insert_many == NULL)
+	{
+		bson_iter_t iter;
+
+		if (!bson_iter_init(&iter, entries))
+		{
+			return FALSE;
+		}
+
+		while (ret && bson_iter_next(&iter))
+		{
+			bson_t metadata[1];
+			bson_t id[1];
+			guint8 const* data;
+			guint32 length;
+
+			if (!BSON_ITER_HOLDS_DOCUMENT(&iter))
+			{
+				ret = FALSE;
+				break;
+			}
+
+			bson_iter_document(&iter, &length, &data);
+
+			if (!bson_init_static(metadata, data, length))
+			{
+				ret = FALSE;
+				break;
+			}
+
+			bson_init(id);
+			ret = j_backend_db_insert(backend, batch, name, metadata, id, error);
+			bson_destroy(id);
+		}
+
+		return ret;
+	}
+
+	{
+		J_TRACE("backend_insert_many", "%p, %s, %p, %p", batch, name, (gconstpointer)entries, (gpointer)error);
+		ret = backend->db.backend_insert_many(backend->data, batch, name, entries, error);
+	}
+
+	return ret;
+}
+
 gboolean
 j_backend_db_update(JBackend* backend, gpointer batch, gchar const* name, bson_t const* selector, bson_t const* metadata, GError** error)
 {
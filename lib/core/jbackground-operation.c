@@ -38,6 +38,23 @@
  * @{
  **/
 
+/**
+ * The number of condition variables used for waiting.
+ * Background operations are mapped to them by their address.
+ **/
+#define J_BACKGROUND_OPERATION_WAIT_SLOTS 64
+
+/**
+ * The maximum number of background operations cached per thread.
+ * Half of them are moved to or from the global cache at once.
+ **/
+#define J_BACKGROUND_OPERATION_CACHE_SIZE 256
+
+/**
+ * The maximum number of background operations in the global cache.
+ **/
+#define J_BACKGROUND_OPERATION_GLOBAL_CACHE_SIZE 4096
+
 /**
  * A background operation.
  **/
@@ -61,17 +78,17 @@ struct JBackgroundOperation
 	/**
 	 * Whether the background operation has finished.
 	 **/
-	gboolean completed;
+	gint completed;
 
 	/**
-	 * The mutex for #completed.
-	 */
-	GMutex mutex[1];
+	 * Whether a thread is waiting for #completed.
+	 **/
+	gint waiting;
 
 	/**
-	 * The condition for #completed.
-	 */
-	GCond cond[1];
+	 * The link in a worker's deque or in a thread's cache.
+	 **/
+	GList link;
 
 	/**
 	 * The reference count.
@@ -79,54 +96,346 @@ struct JBackgroundOperation
 	gint ref_count;
 };
 
-static GThreadPool* j_thread_pool = NULL;
+/**
+ * A worker thread.
+ **/
+struct JBackgroundOperationWorker
+{
+	GThread* thread;
+
+	/**
+	 * The worker's index.
+	 **/
+	guint index;
+
+	/**
+	 * The worker's background operations.
+	 * The worker takes operations from the tail, other workers steal them from the head.
+	 **/
+	GQueue deque[1];
+
+	/**
+	 * The mutex for #deque.
+	 **/
+	GMutex mutex[1];
+};
+
+typedef struct JBackgroundOperationWorker JBackgroundOperationWorker;
 
 /**
- * Executes background operations.
+ * A thread's cache of unused background operations.
+ **/
+struct JBackgroundOperationCache
+{
+	GQueue operations[1];
+};
+
+typedef struct JBackgroundOperationCache JBackgroundOperationCache;
+
+/**
+ * A condition variable used for waiting on background operations.
+ **/
+struct JBackgroundOperationWaitSlot
+{
+	GMutex mutex[1];
+	GCond cond[1];
+};
+
+typedef struct JBackgroundOperationWaitSlot JBackgroundOperationWaitSlot;
+
+static JBackgroundOperationWorker* j_background_operation_workers = NULL;
+static guint j_background_operation_workers_n = 0;
+
+/**
+ * The number of background operations that have been queued but not taken yet.
+ **/
+static gint j_background_operation_pending = 0;
+
+/**
+ * The number of sleeping workers, protected by #j_background_operation_idle_mutex.
+ **/
+static gint j_background_operation_sleeping = 0;
+
+/**
+ * Used to distribute background operations created by threads that are not workers.
+ **/
+static guint j_background_operation_next_worker = 0;
+
+static gboolean j_background_operation_quit = FALSE;
+
+static GMutex j_background_operation_idle_mutex;
+static GCond j_background_operation_idle_cond;
+
+static JBackgroundOperationWaitSlot j_background_operation_wait_slots[J_BACKGROUND_OPERATION_WAIT_SLOTS];
+
+/**
+ * Unused background operations shared by all threads.
+ * Operations are often created by one thread and freed by another, so thread caches are balanced using this one.
+ **/
+static GQueue j_background_operation_global_cache = G_QUEUE_INIT;
+
+G_LOCK_DEFINE_STATIC(j_background_operation_global_cache);
+
+static void j_background_operation_cache_free(gpointer);
+
+/**
+ * Frees all background operations of a cache.
  *
  * \private
  *
- * \code
- * \endcode
+ * \param operations The cache's operations.
+ **/
+static void
+j_background_operation_cache_clear(GQueue* operations)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GList* link;
+
+	// The links are embedded into the operations and freed with them
+	while ((link = g_queue_pop_head_link(operations)) != NULL)
+	{
+		g_free(link->data);
+	}
+}
+
+/**
+ * The current thread's worker, if any.
+ **/
+static GPrivate j_background_operation_worker_current = G_PRIVATE_INIT(NULL);
+
+static GPrivate j_background_operation_cache = G_PRIVATE_INIT(j_background_operation_cache_free);
+
+static void
+j_background_operation_cache_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationCache* cache = data;
+
+	j_background_operation_cache_clear(cache->operations);
+	g_free(cache);
+}
+
+/**
+ * Returns the current thread's cache of unused background operations.
+ *
+ * \private
  *
- * \param data A background operations.
- * \param user_data User data.
+ * \return The cache.
+ **/
+static JBackgroundOperationCache*
+j_background_operation_cache_get(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationCache* cache;
+
+	if ((cache = g_private_get(&j_background_operation_cache)) == NULL)
+	{
+		cache = g_new(JBackgroundOperationCache, 1);
+		g_queue_init(cache->operations);
+
+		g_private_set(&j_background_operation_cache, cache);
+	}
+
+	return cache;
+}
+
+/**
+ * Moves background operations between two caches.
+ *
+ * \private
+ *
+ * \param from  The source cache.
+ * \param to    The destination cache.
+ * \param count The maximum number of operations to move.
  **/
 static void
-j_background_operation_thread(gpointer data, gpointer user_data)
+j_background_operation_cache_move(GQueue* from, GQueue* to, guint count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	for (guint i = 0; i < count; i++)
+	{
+		GList* link;
+
+		if ((link = g_queue_pop_head_link(from)) == NULL)
+		{
+			break;
+		}
+
+		g_queue_push_head_link(to, link);
+	}
+}
+
+static JBackgroundOperationWaitSlot*
+j_background_operation_wait_slot(JBackgroundOperation* background_operation)
+{
+	// Operations are allocated with malloc's 16-byte alignment, so drop the lowest four bits before taking the address modulo the number of slots
+	return &(j_background_operation_wait_slots[(GPOINTER_TO_SIZE(background_operation) >> 4) % J_BACKGROUND_OPERATION_WAIT_SLOTS]);
+}
+
+/**
+ * Takes a background operation from the worker's own deque or steals one from another worker.
+ *
+ * \private
+ *
+ * \param worker A worker.
+ *
+ * \return A background operation or NULL if there is none.
+ **/
+static JBackgroundOperation*
+j_background_operation_take(JBackgroundOperationWorker* worker)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JBackgroundOperation* background_operation = data;
+	GList* link = NULL;
+
+	if (g_atomic_int_get(&j_background_operation_pending) == 0)
+	{
+		return NULL;
+	}
+
+	// Most recently queued operations are likely to still be cached
+	g_mutex_lock(worker->mutex);
+	link = g_queue_pop_tail_link(worker->deque);
+	g_mutex_unlock(worker->mutex);
 
-	(void)user_data;
+	for (guint i = 1; link == NULL && i < j_background_operation_workers_n; i++)
+	{
+		JBackgroundOperationWorker* victim;
+
+		victim = &(j_background_operation_workers[(worker->index + i) % j_background_operation_workers_n]);
+
+		g_mutex_lock(victim->mutex);
+		link = g_queue_pop_head_link(victim->deque);
+		g_mutex_unlock(victim->mutex);
+	}
+
+	if (link == NULL)
+	{
+		return NULL;
+	}
+
+	g_atomic_int_dec_and_test(&j_background_operation_pending);
+
+	return link->data;
+}
+
+/**
+ * Executes a background operation and marks it as completed.
+ *
+ * \private
+ *
+ * \param background_operation A background operation.
+ **/
+static void
+j_background_operation_run(JBackgroundOperation* background_operation)
+{
+	J_TRACE_FUNCTION(NULL);
 
 	background_operation->result = (*(background_operation->func))(background_operation->data);
 
-	g_mutex_lock(background_operation->mutex);
-	background_operation->completed = TRUE;
-	g_cond_signal(background_operation->cond);
-	g_mutex_unlock(background_operation->mutex);
+	g_atomic_int_set(&(background_operation->completed), TRUE);
+
+	// Waiters announce themselves before checking completed, so either they see completed or we see them
+	if (g_atomic_int_get(&(background_operation->waiting)))
+	{
+		JBackgroundOperationWaitSlot* slot;
+
+		slot = j_background_operation_wait_slot(background_operation);
+
+		g_mutex_lock(slot->mutex);
+		g_cond_broadcast(slot->cond);
+		g_mutex_unlock(slot->mutex);
+	}
 
 	j_background_operation_unref(background_operation);
 }
 
+/**
+ * Executes background operations.
+ *
+ * \private
+ *
+ * \code
+ * \endcode
+ *
+ * \param data A worker.
+ *
+ * \return NULL.
+ **/
+static gpointer
+j_background_operation_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackgroundOperationWorker* worker = data;
+
+	g_private_set(&j_background_operation_worker_current, worker);
+
+	while (TRUE)
+	{
+		JBackgroundOperation* background_operation;
+
+		if ((background_operation = j_background_operation_take(worker)) != NULL)
+		{
+			j_background_operation_run(background_operation);
+			continue;
+		}
+
+		g_mutex_lock(&j_background_operation_idle_mutex);
+		g_atomic_int_inc(&j_background_operation_sleeping);
+
+		while (g_atomic_int_get(&j_background_operation_pending) == 0 && !j_background_operation_quit)
+		{
+			g_cond_wait(&j_background_operation_idle_cond, &j_background_operation_idle_mutex);
+		}
+
+		g_atomic_int_add(&j_background_operation_sleeping, -1);
+
+		// Remaining operations are executed before quitting
+		if (j_background_operation_quit && g_atomic_int_get(&j_background_operation_pending) == 0)
+		{
+			g_mutex_unlock(&j_background_operation_idle_mutex);
+			break;
+		}
+
+		g_mutex_unlock(&j_background_operation_idle_mutex);
+	}
+
+	return NULL;
+}
+
 void
 j_background_operation_init(guint count)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GThreadPool* thread_pool;
-
-	g_return_if_fail(j_thread_pool == NULL);
+	g_return_if_fail(j_background_operation_workers == NULL);
 
 	if (count == 0)
 	{
 		count = g_get_num_processors();
 	}
 
-	thread_pool = g_thread_pool_new(j_background_operation_thread, NULL, count, FALSE, NULL);
-	g_atomic_pointer_set(&j_thread_pool, thread_pool);
+	j_background_operation_quit = FALSE;
+	j_background_operation_workers_n = count;
+	j_background_operation_workers = g_new(JBackgroundOperationWorker, count);
+
+	for (guint i = 0; i < count; i++)
+	{
+		j_background_operation_workers[i].index = i;
+		g_queue_init(j_background_operation_workers[i].deque);
+		g_mutex_init(j_background_operation_workers[i].mutex);
+	}
+
+	// Start the threads only after all deques have been initialized, since they steal from each other
+	for (guint i = 0; i < count; i++)
+	{
+		j_background_operation_workers[i].thread = g_thread_new("julea-background", j_background_operation_thread, &(j_background_operation_workers[i]));
+	}
 }
 
 void
@@ -134,14 +443,26 @@ j_background_operation_fini(void)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GThreadPool* thread_pool;
+	g_return_if_fail(j_background_operation_workers != NULL);
 
-	g_return_if_fail(j_thread_pool != NULL);
+	g_mutex_lock(&j_background_operation_idle_mutex);
+	j_background_operation_quit = TRUE;
+	g_cond_broadcast(&j_background_operation_idle_cond);
+	g_mutex_unlock(&j_background_operation_idle_mutex);
 
-	thread_pool = g_atomic_pointer_get(&j_thread_pool);
-	g_atomic_pointer_set(&j_thread_pool, NULL);
+	for (guint i = 0; i < j_background_operation_workers_n; i++)
+	{
+		g_thread_join(j_background_operation_workers[i].thread);
+		g_mutex_clear(j_background_operation_workers[i].mutex);
+	}
 
-	g_thread_pool_free(thread_pool, FALSE, TRUE);
+	G_LOCK(j_background_operation_global_cache);
+	j_background_operation_cache_clear(&j_background_operation_global_cache);
+	G_UNLOCK(j_background_operation_global_cache);
+
+	g_free(j_background_operation_workers);
+	j_background_operation_workers = NULL;
+	j_background_operation_workers_n = 0;
 }
 
 guint
@@ -149,7 +470,7 @@ j_background_operation_get_num_threads(void)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return g_thread_pool_get_max_threads(j_thread_pool);
+	return j_background_operation_workers_n;
 }
 
 JBackgroundOperation*
@@ -158,20 +479,63 @@ j_background_operation_new(JBackgroundOperationFunc func, gpointer data)
 	J_TRACE_FUNCTION(NULL);
 
 	JBackgroundOperation* background_operation;
+	JBackgroundOperationCache* cache;
+	JBackgroundOperationWorker* worker;
+	GList* link;
 
 	g_return_val_if_fail(func != NULL, NULL);
 
-	background_operation = g_new(JBackgroundOperation, 1);
+	cache = j_background_operation_cache_get();
+
+	// The global cache's length is only a hint here, checking it without the lock at most causes an unnecessary allocation
+	if (cache->operations->length == 0 && j_background_operation_global_cache.length > 0)
+	{
+		G_LOCK(j_background_operation_global_cache);
+		j_background_operation_cache_move(&j_background_operation_global_cache, cache->operations, J_BACKGROUND_OPERATION_CACHE_SIZE / 2);
+		G_UNLOCK(j_background_operation_global_cache);
+	}
+
+	if ((link = g_queue_pop_head_link(cache->operations)) != NULL)
+	{
+		background_operation = link->data;
+	}
+	else
+	{
+		background_operation = g_new(JBackgroundOperation, 1);
+		background_operation->link.data = background_operation;
+	}
+
 	background_operation->func = func;
 	background_operation->data = data;
 	background_operation->result = NULL;
 	background_operation->completed = FALSE;
+	background_operation->waiting = FALSE;
+	background_operation->link.prev = NULL;
+	background_operation->link.next = NULL;
 	background_operation->ref_count = 2;
 
-	g_mutex_init(background_operation->mutex);
-	g_cond_init(background_operation->cond);
+	// Operations created by workers stay local unless they are stolen
+	if ((worker = g_private_get(&j_background_operation_worker_current)) == NULL)
+	{
+		guint index;
+
+		index = g_atomic_int_add(&j_background_operation_next_worker, 1);
+		worker = &(j_background_operation_workers[index % j_background_operation_workers_n]);
+	}
+
+	g_mutex_lock(worker->mutex);
+	g_queue_push_tail_link(worker->deque, &(background_operation->link));
+	g_mutex_unlock(worker->mutex);
 
-	g_thread_pool_push(j_thread_pool, background_operation, NULL);
+	g_atomic_int_inc(&j_background_operation_pending);
+
+	// Sleeping workers announce themselves before checking pending, so either they see the operation or we see them
+	if (g_atomic_int_get(&j_background_operation_sleeping) > 0)
+	{
+		g_mutex_lock(&j_background_operation_idle_mutex);
+		g_cond_signal(&j_background_operation_idle_cond);
+		g_mutex_unlock(&j_background_operation_idle_mutex);
+	}
 
 	return background_operation;
 }
@@ -197,10 +561,30 @@ j_background_operation_unref(JBackgroundOperation* background_operation)
 
 	if (g_atomic_int_dec_and_test(&(background_operation->ref_count)))
 	{
-		g_cond_clear(background_operation->cond);
-		g_mutex_clear(background_operation->mutex);
-
-		g_free(background_operation);
+		JBackgroundOperationCache* cache;
+
+		cache = j_background_operation_cache_get();
+
+		if (cache->operations->length == J_BACKGROUND_OPERATION_CACHE_SIZE)
+		{
+			G_LOCK(j_background_operation_global_cache);
+
+			if (j_background_operation_global_cache.length < J_BACKGROUND_OPERATION_GLOBAL_CACHE_SIZE)
+			{
+				j_background_operation_cache_move(cache->operations, &j_background_operation_global_cache, J_BACKGROUND_OPERATION_CACHE_SIZE / 2);
+			}
+
+			G_UNLOCK(j_background_operation_global_cache);
+		}
+
+		if (cache->operations->length < J_BACKGROUND_OPERATION_CACHE_SIZE)
+		{
+			g_queue_push_head_link(cache->operations, &(background_operation->link));
+		}
+		else
+		{
+			g_free(background_operation);
+		}
 	}
 }
 
@@ -209,20 +593,65 @@ j_background_operation_wait(JBackgroundOperation* background_operation)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	JBackgroundOperationWorker* worker;
+	JBackgroundOperationWaitSlot* slot;
+
 	g_return_val_if_fail(background_operation != NULL, NULL);
 
-	g_mutex_lock(background_operation->mutex);
+	// Workers waiting for other operations execute queued operations in the meantime, which also prevents deadlocks
+	if ((worker = g_private_get(&j_background_operation_worker_current)) != NULL)
+	{
+		while (!g_atomic_int_get(&(background_operation->completed)))
+		{
+			JBackgroundOperation* other_operation;
+
+			if ((other_operation = j_background_operation_take(worker)) == NULL)
+			{
+				break;
+			}
 
-	while (!background_operation->completed)
+			j_background_operation_run(other_operation);
+		}
+	}
+
+	if (g_atomic_int_get(&(background_operation->completed)))
 	{
-		g_cond_wait(background_operation->cond, background_operation->mutex);
+		return background_operation->result;
 	}
 
-	g_mutex_unlock(background_operation->mutex);
+	slot = j_background_operation_wait_slot(background_operation);
+
+	g_mutex_lock(slot->mutex);
+	g_atomic_int_set(&(background_operation->waiting), TRUE);
+
+	while (!g_atomic_int_get(&(background_operation->completed)))
+	{
+		g_cond_wait(slot->cond, slot->mutex);
+	}
+
+	g_mutex_unlock(slot->mutex);
 
 	return background_operation->result;
 }
 
+void
+j_background_operation_wait_all(JBackgroundOperation** background_operations, guint count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(background_operations != NULL || count == 0);
+
+	// Operations are not necessarily executed in creation order, since workers take their own operations LIFO
+	// Waiting for completed operations does not block, so waiting for all of them takes as long as the slowest one in any order
+	for (guint i = 0; i < count; i++)
+	{
+		if (background_operations[i] != NULL)
+		{
+			j_background_operation_wait(background_operations[i]);
+		}
+	}
+}
+
 /**
  * @}
  **/
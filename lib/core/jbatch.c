@@ -29,12 +29,13 @@
 
 #include <jbackground-operation.h>
 #include <jcache.h>
-#include <jlist.h>
-#include <jlist-iterator.h>
+#include <jhelper.h>
 #include <joperation-cache-internal.h>
 #include <joperation.h>
 #include <jsemantics.h>
+#include <jslab.h>
 #include <jtrace.h>
+#include <jvector.h>
 
 /**
  * \addtogroup JBatch Batch
@@ -48,9 +49,9 @@
 struct JBatch
 {
 	/**
-	 * The list of pending operations.
+	 * The pending operations.
 	 **/
-	JList* list;
+	JVector* operations;
 
 	/**
 	 * The semantics.
@@ -108,8 +109,8 @@ j_batch_new(JSemantics* semantics)
 
 	g_return_val_if_fail(semantics != NULL, NULL);
 
-	batch = g_new(JBatch, 1);
-	batch->list = j_list_new((JListFreeFunc)j_operation_free);
+	batch = j_slab_new(JBatch);
+	batch->operations = j_vector_new((JVectorFreeFunc)j_operation_free);
 	batch->semantics = j_semantics_ref(semantics);
 	batch->background_operation = NULL;
 	batch->ref_count = 1;
@@ -158,6 +159,9 @@ j_batch_unref(JBatch* batch)
 
 		if (is_session)
 		{
+			// Operations cached by eventual batches have to be executed first
+			j_operation_cache_flush();
+
 			// Freeing the batch ends the current session
 			j_batch_execute_internal(batch);
 		}
@@ -172,12 +176,61 @@ j_batch_unref(JBatch* batch)
 			j_semantics_unref(batch->semantics);
 		}
 
-		j_list_unref(batch->list);
+		j_vector_free(batch->operations);
 
-		g_free(batch);
+		j_slab_delete(JBatch, batch);
 	}
 }
 
+/**
+ * A group of operations that are executed together.
+ **/
+struct JBatchGroup
+{
+	/**
+	 * The batch the operations belong to.
+	 **/
+	JBatch* batch;
+
+	/**
+	 * The function executing the operations.
+	 **/
+	JOperationExecFunc exec_func;
+
+	/**
+	 * The operations' data, a slice of the data of all operations in the batch.
+	 **/
+	JVector operations[1];
+
+	/**
+	 * The index of the group's first operation within the data of all operations.
+	 **/
+	guint offset;
+
+	/**
+	 * The number of operations.
+	 **/
+	guint length;
+
+	/**
+	 * The group's level.
+	 * Groups have to be executed after all groups with a lower level.
+	 **/
+	guint level;
+};
+
+typedef struct JBatchGroup JBatchGroup;
+
+static void
+j_batch_group_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBatchGroup* group = data;
+
+	j_slab_delete(JBatchGroup, group);
+}
+
 /**
  * Executes the batch parts of a given batch type.
  *
@@ -188,35 +241,49 @@ j_batch_unref(JBatch* batch)
  *
  * \param batch A batch.
  * \param exec_func A function which executes the batch part.
- * \param list A list of batch parts.
+ * \param operations The batch parts' data.
  *
  * \return TRUE on success, FALSE if an error occurred.
  **/
 static gboolean
-j_batch_execute_same(JBatch* batch, JOperationExecFunc exec_func, JList* list)
+j_batch_execute_same(JBatch* batch, JOperationExecFunc exec_func, JVector* operations)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JOperation* operation;
 	gboolean ret = FALSE;
 
-	operation = j_list_get_first(list);
-
-	if (operation == NULL)
+	if (j_vector_length(operations) == 0)
 	{
 		return FALSE;
 	}
 
 	if (exec_func != NULL)
 	{
-		ret = exec_func(list, batch->semantics);
+		ret = exec_func(operations, batch->semantics);
 	}
 
-	j_list_delete_all(list);
-
 	return ret;
 }
 
+/**
+ * Executes a group of operations in a background operation.
+ *
+ * \private
+ *
+ * \param data A group.
+ *
+ * \return GINT_TO_POINTER(TRUE) on success, GINT_TO_POINTER(FALSE) if an error occurred.
+ **/
+static gpointer
+j_batch_execute_group(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBatchGroup* group = data;
+
+	return GINT_TO_POINTER(j_batch_execute_same(group->batch, group->exec_func, group->operations));
+}
+
 gboolean
 j_batch_execute(JBatch* batch)
 {
@@ -229,7 +296,7 @@ j_batch_execute(JBatch* batch)
 
 	consistency = j_semantics_get(batch->semantics, J_SEMANTICS_CONSISTENCY);
 
-	if (j_list_length(batch->list) == 0)
+	if (j_vector_length(batch->operations) == 0)
 	{
 		return ret;
 	}
@@ -243,7 +310,7 @@ j_batch_execute(JBatch* batch)
 				// Fallback for operations that cannot be cached
 				// Necessary flushes were handled in j_operation_cache_test
 				ret = j_batch_execute_internal(batch);
-				j_list_delete_all(batch->list);
+				j_vector_delete_all(batch->operations);
 			}
 			else
 			{
@@ -261,7 +328,7 @@ j_batch_execute(JBatch* batch)
 			j_operation_cache_flush();
 
 			ret = j_batch_execute_internal(batch);
-			j_list_delete_all(batch->list);
+			j_vector_delete_all(batch->operations);
 
 			break;
 
@@ -323,7 +390,7 @@ j_batch_add(JBatch* batch, JOperation* operation)
 	g_return_if_fail(batch != NULL);
 	g_return_if_fail(operation != NULL);
 
-	j_list_append(batch->list, operation);
+	j_vector_append(batch->operations, operation);
 }
 
 /* Internal */
@@ -337,25 +404,25 @@ j_batch_new_from_batch(JBatch* old_batch)
 
 	g_return_val_if_fail(old_batch != NULL, NULL);
 
-	batch = g_new(JBatch, 1);
-	batch->list = old_batch->list;
+	batch = j_slab_new(JBatch);
+	batch->operations = old_batch->operations;
 	batch->semantics = j_semantics_ref(old_batch->semantics);
 	batch->background_operation = NULL;
 	batch->ref_count = 1;
 
-	old_batch->list = j_list_new((JListFreeFunc)j_operation_free);
+	old_batch->operations = j_vector_new((JVectorFreeFunc)j_operation_free);
 
 	return batch;
 }
 
-JList*
+JVector*
 j_batch_get_operations(JBatch* batch)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	g_return_val_if_fail(batch != NULL, NULL);
 
-	return batch->list;
+	return batch->operations;
 }
 
 gboolean
@@ -363,43 +430,154 @@ j_batch_execute_internal(JBatch* batch)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_autoptr(JList) same_list = NULL;
-	g_autoptr(JListIterator) iterator = NULL;
-	JOperationExecFunc last_exec_func;
-	gconstpointer last_key;
+	g_autoptr(GHashTable) last_groups = NULL;
+	g_autoptr(GPtrArray) levels = NULL;
+	g_autoptr(JVector) data = NULL;
+	g_autofree JBatchGroup** operation_groups = NULL;
+	JBatchGroup* last_group = NULL;
 	gboolean ret = TRUE;
+	guint min_level = 0;
+	guint length;
+	guint offset = 0;
+
+	/**
+	 * Operations are combined into groups with the same type and the same key, which can be executed using a single call.
+	 * Operations with the same key have to be performed in order, for instance, an object has to be created before it can be written to.
+	 * Keys are compared by value because different handles can refer to the same data.
+	 * Operations with different keys are independent of each other.
+	 * Therefore, an operation is added to the last group of its key if the group has the same type.
+	 * Otherwise, a new group is started one level above the key's previous group.
+	 * This turns patterns like write(A), write(B), write(A), write(B) into two groups.
+	 * Operations without a key cannot be shown to be independent, so they get a level of their own that all later operations have to stay above.
+	 */
+	length = j_vector_length(batch->operations);
+	last_groups = g_hash_table_new(g_str_hash, g_str_equal);
+	levels = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+	operation_groups = g_new(JBatchGroup*, length);
 
-	iterator = j_list_iterator_new(batch->list);
-	same_list = j_list_new(NULL);
-	last_key = NULL;
-	last_exec_func = NULL;
+	for (guint i = 0; i < length; i++)
+	{
+		JOperation* operation = j_vector_get(batch->operations, i);
+		JBatchGroup* group;
+
+		if (operation->key != NULL)
+		{
+			group = g_hash_table_lookup(last_groups, operation->key);
+		}
+		else
+		{
+			// Only merge with the directly preceding operation if it does not have a key either
+			group = last_group;
+		}
+
+		if (group == NULL || group->exec_func != operation->exec_func || group->level < min_level)
+		{
+			JBatchGroup* new_group;
+
+			new_group = j_slab_new(JBatchGroup);
+			new_group->batch = batch;
+			new_group->exec_func = operation->exec_func;
+			new_group->offset = 0;
+			new_group->length = 0;
+
+			if (operation->key != NULL)
+			{
+				new_group->level = MAX((group != NULL) ? group->level + 1 : 0, min_level);
+			}
+			else
+			{
+				new_group->level = levels->len;
+			}
+
+			if (new_group->level == levels->len)
+			{
+				g_ptr_array_add(levels, g_ptr_array_new_with_free_func(j_batch_group_free));
+			}
+
+			g_ptr_array_add(g_ptr_array_index(levels, new_group->level), new_group);
+
+			if (operation->key != NULL)
+			{
+				g_hash_table_insert(last_groups, (gpointer)operation->key, new_group);
+			}
+
+			group = new_group;
+		}
+
+		if (operation->key == NULL)
+		{
+			min_level = group->level + 1;
+		}
 
-	/** \todo Perform some (reordering) optimizations
-		* It is important to consider dependencies:
-		* - Operations have to be performed before their dependent ones.
-		*   For example, a collection has to be created before items in it can be created.
-		*/
+		group->length++;
+		operation_groups[i] = group;
+		last_group = (operation->key == NULL) ? group : NULL;
+	}
 
 	/**
-	 * Try to combine as many operations of the same type as possible.
-	 * These are temporarily stored in same_list.
+	 * The operations' data is laid out contiguously by group, so that each group can be passed as a slice.
 	 */
-	while (j_list_iterator_next(iterator))
+	data = j_vector_new(NULL);
+	j_vector_set_length(data, length);
+
+	for (guint i = 0; i < levels->len; i++)
 	{
-		JOperation* operation = j_list_iterator_get(iterator);
+		GPtrArray* groups = g_ptr_array_index(levels, i);
 
-		/* We only combine operations with the same type and the same key. */
-		if ((operation->exec_func != last_exec_func || operation->key != last_key) && last_exec_func != NULL)
+		for (guint j = 0; j < groups->len; j++)
 		{
-			ret = j_batch_execute_same(batch, last_exec_func, same_list) && ret;
+			JBatchGroup* group = g_ptr_array_index(groups, j);
+
+			j_vector_slice(group->operations, data, offset, group->length);
+
+			group->offset = offset;
+			offset += group->length;
+			// Counts the operations that have been filled in below
+			group->length = 0;
 		}
+	}
 
-		last_key = operation->key;
-		last_exec_func = operation->exec_func;
-		j_list_append(same_list, operation->data);
+	for (guint i = 0; i < length; i++)
+	{
+		JOperation* operation = j_vector_get(batch->operations, i);
+		JBatchGroup* group = operation_groups[i];
+
+		j_vector_set(data, group->offset + group->length, operation->data);
+		group->length++;
 	}
 
-	ret = j_batch_execute_same(batch, last_exec_func, same_list) && ret;
+	/**
+	 * Groups of the same level are executed concurrently.
+	 * Each group typically sends a request to a single server and waits for its reply,
+	 * so a batch's latency is determined by the slowest server instead of the sum of all servers.
+	 */
+	for (guint i = 0; i < levels->len; i++)
+	{
+		GPtrArray* groups = g_ptr_array_index(levels, i);
+		g_autofree gpointer* results = NULL;
+
+		if (groups->len == 1)
+		{
+			JBatchGroup* group = g_ptr_array_index(groups, 0);
+
+			ret = j_batch_execute_same(batch, group->exec_func, group->operations) && ret;
+			continue;
+		}
+
+		results = g_new(gpointer, groups->len);
+
+		for (guint j = 0; j < groups->len; j++)
+		{
+			results[j] = g_ptr_array_index(groups, j);
+		}
+
+		j_helper_execute_parallel(j_batch_execute_group, results, groups->len);
+
+		for (guint j = 0; j < groups->len; j++)
+		{
+			ret = GPOINTER_TO_INT(results[j]) && ret;
+		}
+	}
 
 	return ret;
 }
@@ -36,6 +36,7 @@
 #include <jbatch-internal.h>
 #include <joperation-cache-internal.h>
 #include <joperation.h>
+#include <jread-cache-internal.h>
 #include <jtrace.h>
 
 /**
@@ -115,6 +116,7 @@ j_init(void)
 	j_distribution_init();
 	j_background_operation_init(0);
 	j_operation_cache_init();
+	j_read_cache_init(j_configuration());
 
 	j_inited = TRUE;
 
@@ -145,6 +147,7 @@ j_fini(void)
 
 	trace = j_trace_enter(G_STRFUNC, NULL);
 
+	j_read_cache_fini();
 	j_operation_cache_fini();
 	j_background_operation_fini();
 	j_connection_pool_fini();
@@ -123,15 +123,52 @@ struct JConfiguration
 		 * The path.
 		 */
 		gchar* path;
+
+		/**
+		 * The number of rows returned per query reply.
+		 */
+		guint32 query_batch_size;
 	} db;
 
 	guint64 max_operation_size;
 	guint64 max_inject_size;
 	guint16 port;
 
+	/**
+	 * The transport used for client-server communication.
+	 */
+	JConfigurationTransport transport;
+
 	guint32 max_connections;
+
+	/**
+	 * Whether multiple requests can be in flight on a single connection.
+	 */
+	gboolean multiplex;
+
 	guint64 stripe_size;
 
+	/**
+	 * The number of requests per server that distributed objects keep in flight.
+	 */
+	guint32 stripe_window;
+
+	/**
+	 * The client read cache configuration.
+	 */
+	struct
+	{
+		/**
+		 * The maximum size in bytes, 0 if the cache is disabled.
+		 */
+		guint64 size;
+
+		/**
+		 * The lease time in milliseconds.
+		 */
+		guint32 lease;
+	} read_cache;
+
 	gchar* checksum;
 
 	/**
@@ -266,20 +303,31 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	gchar* kv_path;
 	gchar* db_backend;
 	gchar* db_path;
+	guint32 db_query_batch_size;
+	g_autofree gchar* transport = NULL;
 	g_autofree gchar* key_file_str = NULL;
 	guint64 max_operation_size;
 	guint64 max_inject_size;
 	guint32 port;
 	guint32 max_connections;
+	gboolean multiplex;
 	guint64 stripe_size;
+	guint32 stripe_window;
+	guint64 read_cache_size;
+	guint32 read_cache_lease;
 
 	g_return_val_if_fail(key_file != NULL, FALSE);
 
 	max_operation_size = g_key_file_get_uint64(key_file, "core", "max-operation-size", NULL);
 	max_inject_size = g_key_file_get_uint64(key_file, "core", "max-inject-size", NULL);
 	port = g_key_file_get_integer(key_file, "core", "port", NULL);
+	transport = g_key_file_get_string(key_file, "core", "transport", NULL);
 	max_connections = g_key_file_get_integer(key_file, "clients", "max-connections", NULL);
+	multiplex = g_key_file_get_boolean(key_file, "clients", "multiplex", NULL);
 	stripe_size = g_key_file_get_uint64(key_file, "clients", "stripe-size", NULL);
+	stripe_window = g_key_file_get_integer(key_file, "clients", "stripe-window", NULL);
+	read_cache_size = g_key_file_get_uint64(key_file, "clients", "read-cache-size", NULL);
+	read_cache_lease = g_key_file_get_integer(key_file, "clients", "read-cache-lease", NULL);
 	servers_object = g_key_file_get_string_list(key_file, "servers", "object", NULL, NULL);
 	servers_kv = g_key_file_get_string_list(key_file, "servers", "kv", NULL, NULL);
 	servers_db = g_key_file_get_string_list(key_file, "servers", "db", NULL, NULL);
@@ -289,6 +337,7 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	kv_path = g_key_file_get_string(key_file, "kv", "path", NULL);
 	db_backend = g_key_file_get_string(key_file, "db", "backend", NULL);
 	db_path = g_key_file_get_string(key_file, "db", "path", NULL);
+	db_query_batch_size = g_key_file_get_integer(key_file, "db", "query-batch-size", NULL);
 
 	/// \todo check value ranges (max_operation_size, port, max_connections, stripe_size)
 	// configuration->port < 0 || configuration->port > 65535
@@ -301,7 +350,8 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	    || kv_backend == NULL
 	    || kv_path == NULL
 	    || db_backend == NULL
-	    || db_path == NULL)
+	    || db_path == NULL
+	    || (transport != NULL && g_strcmp0(transport, "tcp") != 0 && g_strcmp0(transport, "libfabric") != 0))
 	{
 		g_free(db_backend);
 		g_free(db_path);
@@ -329,11 +379,17 @@ j_configuration_new_for_data(GKeyFile* key_file)
 	configuration->kv.path = kv_path;
 	configuration->db.backend = db_backend;
 	configuration->db.path = db_path;
+	configuration->db.query_batch_size = db_query_batch_size;
 	configuration->max_operation_size = max_operation_size;
 	configuration->port = port;
+	configuration->transport = (g_strcmp0(transport, "libfabric") == 0) ? J_CONFIGURATION_TRANSPORT_LIBFABRIC : J_CONFIGURATION_TRANSPORT_TCP;
 	configuration->max_inject_size = max_inject_size;
 	configuration->max_connections = max_connections;
+	configuration->multiplex = multiplex;
 	configuration->stripe_size = stripe_size;
+	configuration->stripe_window = stripe_window;
+	configuration->read_cache.size = read_cache_size;
+	configuration->read_cache.lease = read_cache_lease;
 	configuration->checksum = NULL;
 	configuration->ref_count = 1;
 
@@ -364,6 +420,21 @@ j_configuration_new_for_data(GKeyFile* key_file)
 		configuration->stripe_size = 4 * 1024 * 1024;
 	}
 
+	if (configuration->stripe_window == 0)
+	{
+		configuration->stripe_window = 2;
+	}
+
+	if (configuration->read_cache.lease == 0)
+	{
+		configuration->read_cache.lease = 1000;
+	}
+
+	if (configuration->db.query_batch_size == 0)
+	{
+		configuration->db.query_batch_size = 1000;
+	}
+
 	key_file_str = g_key_file_to_data(key_file, NULL, NULL);
 	configuration->checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA512, key_file_str, -1);
 
@@ -531,6 +602,56 @@ j_configuration_get_max_connections(JConfiguration* configuration)
 	return configuration->max_connections;
 }
 
+gboolean
+j_configuration_get_multiplex(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, FALSE);
+
+	return configuration->multiplex;
+}
+
+guint32
+j_configuration_get_stripe_window(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->stripe_window;
+}
+
+guint64
+j_configuration_get_read_cache_size(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->read_cache.size;
+}
+
+guint32
+j_configuration_get_read_cache_lease(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->read_cache.lease;
+}
+
+guint32
+j_configuration_get_db_query_batch_size(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, 0);
+
+	return configuration->db.query_batch_size;
+}
+
 guint64
 j_configuration_get_stripe_size(JConfiguration* configuration)
 {
@@ -551,6 +672,16 @@ j_configuration_get_port(JConfiguration* configuration)
 	return configuration->port;
 }
 
+JConfigurationTransport
+j_configuration_get_transport(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(configuration != NULL, J_CONFIGURATION_TRANSPORT_TCP);
+
+	return configuration->transport;
+}
+
 gchar const*
 j_configuration_get_checksum(JConfiguration* configuration)
 {
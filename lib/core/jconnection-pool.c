@@ -30,8 +30,11 @@
 #include <jconnection-pool-internal.h>
 
 #include <jbackend.h>
+#include <jconnection.h>
+#include <jconnection-internal.h>
 #include <jhelper.h>
 #include <jmessage.h>
+#include <jnetwork.h>
 #include <jtrace.h>
 
 /**
@@ -61,6 +64,11 @@ struct JConnectionPool
 	guint kv_len;
 	guint db_len;
 	guint max_count;
+
+	/**
+	 * Whether connections are shared among threads.
+	 **/
+	gboolean multiplex;
 };
 
 typedef struct JConnectionPool JConnectionPool;
@@ -85,6 +93,8 @@ j_connection_pool_init(JConfiguration* configuration)
 	pool->db_len = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_DB);
 	pool->db_queues = g_new(JConnectionPoolQueue, pool->db_len);
 	pool->max_count = j_configuration_get_max_connections(configuration);
+	// Multiplexing is only supported for TCP.
+	pool->multiplex = j_configuration_get_multiplex(configuration) && j_configuration_get_transport(configuration) == J_CONFIGURATION_TRANSPORT_TCP;
 
 	for (guint i = 0; i < pool->object_len; i++)
 	{
@@ -121,12 +131,11 @@ j_connection_pool_fini(void)
 
 	for (guint i = 0; i < pool->object_len; i++)
 	{
-		GSocketConnection* connection;
+		JConnection* connection;
 
 		while ((connection = g_async_queue_try_pop(pool->object_queues[i].queue)) != NULL)
 		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
+			j_connection_free(connection);
 		}
 
 		g_async_queue_unref(pool->object_queues[i].queue);
@@ -134,12 +143,11 @@ j_connection_pool_fini(void)
 
 	for (guint i = 0; i < pool->kv_len; i++)
 	{
-		GSocketConnection* connection;
+		JConnection* connection;
 
 		while ((connection = g_async_queue_try_pop(pool->kv_queues[i].queue)) != NULL)
 		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
+			j_connection_free(connection);
 		}
 
 		g_async_queue_unref(pool->kv_queues[i].queue);
@@ -147,12 +155,11 @@ j_connection_pool_fini(void)
 
 	for (guint i = 0; i < pool->db_len; i++)
 	{
-		GSocketConnection* connection;
+		JConnection* connection;
 
 		while ((connection = g_async_queue_try_pop(pool->db_queues[i].queue)) != NULL)
 		{
-			g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
-			g_object_unref(connection);
+			j_connection_free(connection);
 		}
 
 		g_async_queue_unref(pool->db_queues[i].queue);
@@ -167,12 +174,65 @@ j_connection_pool_fini(void)
 	g_free(pool);
 }
 
-static GSocketConnection*
-j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* server)
+/**
+ * Connects to a server.
+ *
+ * \param backend The backend type.
+ * \param index   The server index.
+ * \param server  The server address.
+ *
+ * \return A new connection, NULL if an error occurred.
+ **/
+static JConnection*
+j_connection_pool_connect(JBackendType backend, guint32 index, gchar const* server)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GSocketConnection* connection;
+	if (j_configuration_get_transport(j_connection_pool->configuration) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		JNetworkConnection* network;
+
+		network = j_network_connection_init_client(j_connection_pool->configuration, backend, index);
+
+		if (network == NULL)
+		{
+			return NULL;
+		}
+
+		return j_connection_new_for_network(network);
+	}
+	else
+	{
+		GError* error = NULL;
+		g_autoptr(GSocketClient) client = NULL;
+		g_autoptr(GSocketConnection) socket_connection = NULL;
+
+		client = g_socket_client_new();
+		socket_connection = g_socket_client_connect_to_host(client, server, j_configuration_get_port(j_connection_pool->configuration), NULL, &error);
+
+		if (error != NULL)
+		{
+			g_critical("%s", error->message);
+			g_error_free(error);
+		}
+
+		if (socket_connection == NULL)
+		{
+			return NULL;
+		}
+
+		j_helper_set_nodelay(socket_connection, TRUE);
+
+		return j_connection_new_for_socket(socket_connection);
+	}
+}
+
+static JConnection*
+j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, JBackendType backend, guint32 index)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnection* connection;
 
 	g_return_val_if_fail(queue != NULL, NULL);
 	g_return_val_if_fail(count != NULL, NULL);
@@ -181,6 +241,12 @@ j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* se
 
 	if (connection != NULL)
 	{
+		if (j_connection_pool->multiplex)
+		{
+			// Multiplexed connections stay in the queue and are handed out round-robin.
+			g_async_queue_push(queue, connection);
+		}
+
 		return connection;
 	}
 
@@ -188,32 +254,22 @@ j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* se
 	{
 		if ((guint)g_atomic_int_add(count, 1) < j_connection_pool->max_count)
 		{
-			GError* error = NULL;
-			g_autoptr(GSocketClient) client = NULL;
-
 			g_autoptr(JMessage) message = NULL;
 			g_autoptr(JMessage) reply = NULL;
 
 			gchar const* client_checksum;
 			gchar const* server_checksum;
+			gchar const* server;
 			guint op_count;
 
-			client = g_socket_client_new();
-			connection = g_socket_client_connect_to_host(client, server, j_configuration_get_port(j_configuration()), NULL, &error);
-
-			if (error != NULL)
-			{
-				g_critical("%s", error->message);
-				g_error_free(error);
-			}
+			server = j_configuration_get_server(j_connection_pool->configuration, backend, index);
+			connection = j_connection_pool_connect(backend, index, server);
 
 			if (connection == NULL)
 			{
 				g_critical("Can not connect to %s [%d].", server, g_atomic_int_get(count));
 			}
 
-			j_helper_set_nodelay(connection, TRUE);
-
 			client_checksum = j_configuration_get_checksum(j_configuration());
 
 			message = j_message_new(J_MESSAGE_PING, strlen(client_checksum) + 1);
@@ -234,23 +290,28 @@ j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* se
 
 			for (guint i = 0; i < op_count; i++)
 			{
-				gchar const* backend;
+				gchar const* backend_name;
 
-				backend = j_message_get_string(reply);
+				backend_name = j_message_get_string(reply);
 
-				if (g_strcmp0(backend, "object") == 0)
+				if (g_strcmp0(backend_name, "object") == 0)
 				{
 					//g_print("Server has object backend.\n");
 				}
-				else if (g_strcmp0(backend, "kv") == 0)
+				else if (g_strcmp0(backend_name, "kv") == 0)
 				{
 					//g_print("Server has kv backend.\n");
 				}
-				else if (g_strcmp0(backend, "db") == 0)
+				else if (g_strcmp0(backend_name, "db") == 0)
 				{
 					//g_print("Server has db backend.\n");
 				}
 			}
+
+			if (j_connection_pool->multiplex && j_connection_start_multiplexing(connection))
+			{
+				g_async_queue_push(queue, connection);
+			}
 		}
 		else
 		{
@@ -265,17 +326,28 @@ j_connection_pool_pop_internal(GAsyncQueue* queue, guint* count, gchar const* se
 
 	connection = g_async_queue_pop(queue);
 
+	if (j_connection_pool->multiplex)
+	{
+		g_async_queue_push(queue, connection);
+	}
+
 	return connection;
 }
 
 static void
-j_connection_pool_push_internal(GAsyncQueue* queue, GSocketConnection* connection)
+j_connection_pool_push_internal(GAsyncQueue* queue, JConnection* connection)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	g_return_if_fail(queue != NULL);
 	g_return_if_fail(connection != NULL);
 
+	// Multiplexed connections are never removed from the queue.
+	if (j_connection_is_multiplexed(connection))
+	{
+		return;
+	}
+
 	g_async_queue_push(queue, connection);
 }
 
@@ -290,13 +362,13 @@ j_connection_pool_pop(JBackendType backend, guint32 index)
 	{
 		case J_BACKEND_TYPE_OBJECT:
 			g_return_val_if_fail(index < j_connection_pool->object_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->object_queues[index].queue, &(j_connection_pool->object_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_OBJECT, index));
+			return j_connection_pool_pop_internal(j_connection_pool->object_queues[index].queue, &(j_connection_pool->object_queues[index].count), J_BACKEND_TYPE_OBJECT, index);
 		case J_BACKEND_TYPE_KV:
 			g_return_val_if_fail(index < j_connection_pool->kv_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->kv_queues[index].queue, &(j_connection_pool->kv_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_KV, index));
+			return j_connection_pool_pop_internal(j_connection_pool->kv_queues[index].queue, &(j_connection_pool->kv_queues[index].count), J_BACKEND_TYPE_KV, index);
 		case J_BACKEND_TYPE_DB:
 			g_return_val_if_fail(index < j_connection_pool->db_len, NULL);
-			return j_connection_pool_pop_internal(j_connection_pool->db_queues[index].queue, &(j_connection_pool->db_queues[index].count), j_configuration_get_server(j_connection_pool->configuration, J_BACKEND_TYPE_DB, index));
+			return j_connection_pool_pop_internal(j_connection_pool->db_queues[index].queue, &(j_connection_pool->db_queues[index].count), J_BACKEND_TYPE_DB, index);
 		default:
 			g_assert_not_reached();
 	}
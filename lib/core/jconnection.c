@@ -0,0 +1,651 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include <string.h>
+
+#include <jconnection.h>
+#include <jconnection-internal.h>
+
+#include <jconfiguration.h>
+#include <jhelper.h>
+#include <jmessage-internal.h>
+#include <jnetwork.h>
+#include <jtrace.h>
+
+/**
+ * \addtogroup JConnection
+ *
+ * @{
+ **/
+
+/**
+ * The time in seconds a reply may remain unclaimed before the demultiplexer gives up on the connection.
+ **/
+#define J_CONNECTION_UNCLAIMED_TIMEOUT 60
+
+struct JConnection
+{
+	/**
+	 * The transport.
+	 **/
+	JConfigurationTransport transport;
+
+	/**
+	 * The socket connection (TCP only).
+	 **/
+	GSocketConnection* socket;
+
+	/**
+	 * The libfabric connection (libfabric only).
+	 **/
+	JNetworkConnection* network;
+
+	/**
+	 * The maximum size of a single libfabric message.
+	 * Larger reads and writes are split into multiple messages.
+	 **/
+	guint64 max_size;
+
+	/**
+	 * Serializes writes of concurrent messages.
+	 **/
+	GMutex output_mutex[1];
+
+	/**
+	 * Called when the connection's input is released.
+	 **/
+	JConnectionReleaseFunc release_func;
+
+	/**
+	 * The user data passed to #release_func.
+	 **/
+	gpointer release_data;
+
+	/**
+	 * The demultiplexer thread, NULL if the connection is not multiplexed.
+	 **/
+	GThread* demultiplexer;
+
+	/**
+	 * Protects #headers, #input_busy and #closed.
+	 **/
+	GMutex mutex[1];
+	GCond cond[1];
+
+	/**
+	 * Headers read by the demultiplexer that have not been claimed by their receivers yet.
+	 * The keys are message IDs.
+	 **/
+	GHashTable* headers;
+
+	/**
+	 * Whether a receiver currently reads from the connection.
+	 **/
+	gboolean input_busy;
+
+	/**
+	 * Whether the connection has been closed.
+	 **/
+	gboolean closed;
+};
+
+/**
+ * Initializes the members that are common to all transports.
+ *
+ * \private
+ *
+ * \param connection A connection.
+ **/
+static void
+j_connection_init(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_mutex_init(connection->output_mutex);
+	connection->release_func = NULL;
+	connection->release_data = NULL;
+	connection->demultiplexer = NULL;
+	g_mutex_init(connection->mutex);
+	g_cond_init(connection->cond);
+	connection->headers = NULL;
+	connection->input_busy = FALSE;
+	connection->closed = FALSE;
+}
+
+/**
+ * Reads headers from a multiplexed connection and hands them to their receivers.
+ *
+ * \private
+ *
+ * \param data A connection.
+ *
+ * \return NULL.
+ **/
+static gpointer
+j_connection_demultiplexer_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnection* connection = data;
+	gsize header_size;
+
+	header_size = j_message_header_size();
+
+	while (TRUE)
+	{
+		gpointer header;
+		gint64 deadline;
+		guint32 id;
+
+		header = g_malloc(header_size);
+
+		if (!j_connection_read(connection, header, header_size))
+		{
+			g_free(header);
+			break;
+		}
+
+		id = j_message_header_get_id(header);
+
+		g_mutex_lock(connection->mutex);
+
+		// The receiver reads the message's body and additional data, wait until it is done.
+		connection->input_busy = TRUE;
+		g_hash_table_insert(connection->headers, GUINT_TO_POINTER(id), header);
+		g_cond_broadcast(connection->cond);
+
+		deadline = g_get_monotonic_time() + J_CONNECTION_UNCLAIMED_TIMEOUT * G_TIME_SPAN_SECOND;
+
+		while (connection->input_busy && !connection->closed)
+		{
+			// Once the header has been claimed, the receiver may take as long as necessary to read the data.
+			if (!g_cond_wait_until(connection->cond, connection->mutex, deadline) && g_hash_table_contains(connection->headers, GUINT_TO_POINTER(id)))
+			{
+				// The reply's body cannot be skipped without knowing its additional data, so the connection is unusable.
+				g_warning("Reply %u has not been claimed by any request, closing connection.", id);
+				g_hash_table_remove(connection->headers, GUINT_TO_POINTER(id));
+				connection->closed = TRUE;
+			}
+		}
+
+		if (connection->closed)
+		{
+			g_mutex_unlock(connection->mutex);
+			break;
+		}
+
+		g_mutex_unlock(connection->mutex);
+	}
+
+	// Wake up all receivers that are still waiting for a reply.
+	g_mutex_lock(connection->mutex);
+	connection->closed = TRUE;
+	g_cond_broadcast(connection->cond);
+	g_mutex_unlock(connection->mutex);
+
+	return NULL;
+}
+
+JConnection*
+j_connection_new_for_socket(GSocketConnection* socket)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnection* connection;
+
+	g_return_val_if_fail(socket != NULL, NULL);
+
+	connection = g_new(JConnection, 1);
+	connection->transport = J_CONFIGURATION_TRANSPORT_TCP;
+	connection->socket = g_object_ref(socket);
+	connection->network = NULL;
+	connection->max_size = 0;
+	j_connection_init(connection);
+
+	return connection;
+}
+
+JConnection*
+j_connection_new_for_network(JNetworkConnection* network)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JConnection* connection;
+
+	g_return_val_if_fail(network != NULL, NULL);
+
+	connection = g_new(JConnection, 1);
+	connection->transport = J_CONFIGURATION_TRANSPORT_LIBFABRIC;
+	connection->socket = NULL;
+	connection->network = network;
+	// The connection's message buffers are sized according to the maximum operation size.
+	connection->max_size = j_configuration_get_max_operation_size(j_configuration());
+	j_connection_init(connection);
+
+	return connection;
+}
+
+void
+j_connection_free(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+
+	if (connection->demultiplexer != NULL)
+	{
+		g_mutex_lock(connection->mutex);
+		connection->closed = TRUE;
+		g_cond_broadcast(connection->cond);
+		g_mutex_unlock(connection->mutex);
+
+		// Make the demultiplexer's blocking read return.
+		g_socket_shutdown(g_socket_connection_get_socket(connection->socket), TRUE, FALSE, NULL);
+		g_thread_join(connection->demultiplexer);
+	}
+
+	if (connection->socket != NULL)
+	{
+		g_io_stream_close(G_IO_STREAM(connection->socket), NULL, NULL);
+		g_object_unref(connection->socket);
+	}
+
+	if (connection->network != NULL)
+	{
+		j_network_connection_fini(connection->network);
+	}
+
+	if (connection->headers != NULL)
+	{
+		g_hash_table_unref(connection->headers);
+	}
+
+	g_mutex_clear(connection->output_mutex);
+	g_mutex_clear(connection->mutex);
+	g_cond_clear(connection->cond);
+
+	g_free(connection);
+}
+
+JConfigurationTransport
+j_connection_get_transport(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(connection != NULL, J_CONFIGURATION_TRANSPORT_TCP);
+
+	return connection->transport;
+}
+
+GSocketConnection*
+j_connection_get_socket(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(connection != NULL, NULL);
+
+	return connection->socket;
+}
+
+JNetworkConnection*
+j_connection_get_network(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(connection != NULL, NULL);
+
+	return connection->network;
+}
+
+gboolean
+j_connection_read(JConnection* connection, gpointer data, gsize length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(data != NULL || length == 0, FALSE);
+
+	if (length == 0)
+	{
+		return TRUE;
+	}
+
+	if (connection->transport == J_CONFIGURATION_TRANSPORT_TCP)
+	{
+		GError* error = NULL;
+		GInputStream* stream;
+		gsize bytes_read;
+
+		stream = g_io_stream_get_input_stream(G_IO_STREAM(connection->socket));
+		ret = g_input_stream_read_all(stream, data, length, &bytes_read, NULL, &error) && bytes_read == length;
+
+		if (error != NULL)
+		{
+			g_critical("%s", error->message);
+			g_error_free(error);
+		}
+	}
+	else
+	{
+		gchar* position = data;
+
+		ret = TRUE;
+
+		while (length > 0 && ret)
+		{
+			gsize chunk_length;
+
+			chunk_length = MIN(length, connection->max_size);
+
+			ret = j_network_connection_recv(connection->network, chunk_length, position)
+			      && j_network_connection_wait_for_completion(connection->network);
+
+			position += chunk_length;
+			length -= chunk_length;
+		}
+	}
+
+	return ret;
+}
+
+gboolean
+j_connection_read_vectors(JConnection* connection, GInputVector const* vectors, guint count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(vectors != NULL || count == 0, FALSE);
+
+	if (count == 0)
+	{
+		return TRUE;
+	}
+
+	if (connection->transport == J_CONFIGURATION_TRANSPORT_TCP)
+	{
+		g_autofree GInputVector* remaining = NULL;
+		GSocket* socket;
+		guint current = 0;
+
+		socket = g_socket_connection_get_socket(connection->socket);
+
+		// The vectors are modified to handle partial reads.
+#if GLIB_CHECK_VERSION(2, 68, 0)
+		remaining = g_memdup2(vectors, sizeof(GInputVector) * count);
+#else
+		remaining = g_memdup(vectors, sizeof(GInputVector) * count);
+#endif
+
+		while (ret)
+		{
+			GError* error = NULL;
+			gssize bytes_read;
+			gsize bytes_left;
+
+			while (current < count && remaining[current].size == 0)
+			{
+				current++;
+			}
+
+			if (current == count)
+			{
+				break;
+			}
+
+			bytes_read = g_socket_receive_message(socket, NULL, remaining + current, MIN(count - current, 1024), NULL, NULL, NULL, NULL, &error);
+
+			if (error != NULL)
+			{
+				g_critical("%s", error->message);
+				g_error_free(error);
+			}
+
+			if (bytes_read <= 0)
+			{
+				ret = FALSE;
+				break;
+			}
+
+			bytes_left = bytes_read;
+
+			while (bytes_left > 0)
+			{
+				gsize length;
+
+				length = MIN(bytes_left, remaining[current].size);
+
+				remaining[current].buffer = (gchar*)remaining[current].buffer + length;
+				remaining[current].size -= length;
+				bytes_left -= length;
+
+				if (remaining[current].size == 0)
+				{
+					current++;
+				}
+			}
+		}
+	}
+	else
+	{
+		for (guint i = 0; i < count && ret; i++)
+		{
+			ret = j_connection_read(connection, vectors[i].buffer, vectors[i].size);
+		}
+	}
+
+	return ret;
+}
+
+gboolean
+j_connection_write(JConnection* connection, gconstpointer data, gsize length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(data != NULL || length == 0, FALSE);
+
+	if (length == 0)
+	{
+		return TRUE;
+	}
+
+	if (connection->transport == J_CONFIGURATION_TRANSPORT_TCP)
+	{
+		GError* error = NULL;
+		GOutputStream* stream;
+		gsize bytes_written;
+
+		stream = g_io_stream_get_output_stream(G_IO_STREAM(connection->socket));
+		ret = g_output_stream_write_all(stream, data, length, &bytes_written, NULL, &error) && bytes_written == length;
+
+		if (error != NULL)
+		{
+			g_critical("%s", error->message);
+			g_error_free(error);
+		}
+	}
+	else
+	{
+		gchar const* position = data;
+
+		ret = TRUE;
+
+		while (length > 0 && ret)
+		{
+			gsize chunk_length;
+
+			chunk_length = MIN(length, connection->max_size);
+
+			// j_network_connection_send() copies or injects the data, it is not modified.
+			ret = j_network_connection_send(connection->network, (gpointer)position, chunk_length)
+			      && j_network_connection_wait_for_completion(connection->network);
+
+			position += chunk_length;
+			length -= chunk_length;
+		}
+	}
+
+	return ret;
+}
+
+void
+j_connection_set_cork(JConnection* connection, gboolean enable)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+
+	if (connection->transport == J_CONFIGURATION_TRANSPORT_TCP)
+	{
+		j_helper_set_cork(connection->socket, enable);
+	}
+}
+
+void
+j_connection_set_release_func(JConnection* connection, JConnectionReleaseFunc func, gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+	g_return_if_fail(connection->demultiplexer == NULL);
+
+	connection->release_func = func;
+	connection->release_data = data;
+}
+
+void
+j_connection_release_input(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+
+	if (connection->demultiplexer != NULL)
+	{
+		g_mutex_lock(connection->mutex);
+		connection->input_busy = FALSE;
+		g_cond_broadcast(connection->cond);
+		g_mutex_unlock(connection->mutex);
+	}
+	else if (connection->release_func != NULL)
+	{
+		connection->release_func(connection, connection->release_data);
+	}
+}
+
+gboolean
+j_connection_is_multiplexed(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+
+	return (connection->demultiplexer != NULL);
+}
+
+gboolean
+j_connection_start_multiplexing(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(connection->demultiplexer == NULL, FALSE);
+
+	if (connection->transport != J_CONFIGURATION_TRANSPORT_TCP)
+	{
+		return FALSE;
+	}
+
+	connection->headers = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+	connection->demultiplexer = g_thread_new("julea-demultiplexer", j_connection_demultiplexer_thread, connection);
+
+	return TRUE;
+}
+
+gboolean
+j_connection_receive_header(JConnection* connection, guint32 id, gpointer header)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	gpointer stored_header;
+
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(connection->demultiplexer != NULL, FALSE);
+	g_return_val_if_fail(header != NULL, FALSE);
+
+	g_mutex_lock(connection->mutex);
+
+	while ((stored_header = g_hash_table_lookup(connection->headers, GUINT_TO_POINTER(id))) == NULL && !connection->closed)
+	{
+		g_cond_wait(connection->cond, connection->mutex);
+	}
+
+	if (stored_header != NULL)
+	{
+		g_hash_table_steal(connection->headers, GUINT_TO_POINTER(id));
+		memcpy(header, stored_header, j_message_header_size());
+		g_free(stored_header);
+
+		ret = TRUE;
+	}
+
+	g_mutex_unlock(connection->mutex);
+
+	return ret;
+}
+
+void
+j_connection_lock_output(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+
+	g_mutex_lock(connection->output_mutex);
+}
+
+void
+j_connection_unlock_output(JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(connection != NULL);
+
+	g_mutex_unlock(connection->output_mutex);
+}
+
+/**
+ * @}
+ **/
@@ -28,6 +28,7 @@
 
 #include <jlist.h>
 #include <jlist-internal.h>
+#include <jslab.h>
 #include <jtrace.h>
 
 /**
@@ -64,7 +65,7 @@ j_list_iterator_new(JList* list)
 
 	g_return_val_if_fail(list != NULL, NULL);
 
-	iterator = g_new(JListIterator, 1);
+	iterator = j_slab_new(JListIterator);
 	iterator->list = j_list_ref(list);
 	iterator->current = j_list_head(iterator->list);
 	iterator->first = TRUE;
@@ -81,7 +82,7 @@ j_list_iterator_free(JListIterator* iterator)
 
 	j_list_unref(iterator->list);
 
-	g_free(iterator);
+	j_slab_delete(JListIterator, iterator);
 }
 
 gboolean
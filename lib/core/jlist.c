@@ -27,6 +27,7 @@
 #include <jlist.h>
 #include <jlist-internal.h>
 
+#include <jslab.h>
 #include <jtrace.h>
 
 /**
@@ -73,7 +74,7 @@ j_list_new(JListFreeFunc free_func)
 
 	JList* list;
 
-	list = g_new(JList, 1);
+	list = j_slab_new(JList);
 	list->head = NULL;
 	list->tail = NULL;
 	list->length = 0;
@@ -106,7 +107,7 @@ j_list_unref(JList* list)
 	{
 		j_list_delete_all(list);
 
-		g_free(list);
+		j_slab_delete(JList, list);
 	}
 }
 
@@ -130,7 +131,7 @@ j_list_append(JList* list, gpointer data)
 	g_return_if_fail(list != NULL);
 	g_return_if_fail(data != NULL);
 
-	element = g_new(JListElement, 1);
+	element = j_slab_new(JListElement);
 	element->next = NULL;
 	element->data = data;
 
@@ -159,7 +160,7 @@ j_list_prepend(JList* list, gpointer data)
 	g_return_if_fail(list != NULL);
 	g_return_if_fail(data != NULL);
 
-	element = g_new(JListElement, 1);
+	element = j_slab_new(JListElement);
 	element->next = list->head;
 	element->data = data;
 
@@ -227,7 +228,7 @@ j_list_delete_all(JList* list)
 		}
 
 		next = element->next;
-		g_free(element);
+		j_slab_delete(JListElement, element);
 		element = next;
 	}
 
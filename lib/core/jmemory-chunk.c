@@ -24,10 +24,13 @@
 
 #include <glib.h>
 
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <jmemory-chunk.h>
 
+#include <jhelper.h>
 #include <jtrace.h>
 
 /**
@@ -68,7 +71,8 @@ j_memory_chunk_new(guint64 size)
 
 	cache = g_new(JMemoryChunk, 1);
 	cache->size = size;
-	cache->data = g_malloc(cache->size);
+	// Align the data to pages, allowing backends to use it for direct I/O
+	cache->data = j_helper_alloc_aligned(sysconf(_SC_PAGESIZE), size);
 	cache->current = cache->data;
 
 	return cache;
@@ -83,7 +87,7 @@ j_memory_chunk_free(JMemoryChunk* cache)
 
 	if (cache->data != NULL)
 	{
-		g_free(cache->data);
+		free(cache->data);
 	}
 
 	g_free(cache);
@@ -109,6 +113,16 @@ j_memory_chunk_get(JMemoryChunk* cache, guint64 length)
 	return ret;
 }
 
+gpointer
+j_memory_chunk_get_data(JMemoryChunk* cache)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(cache != NULL, NULL);
+
+	return cache->data;
+}
+
 void
 j_memory_chunk_reset(JMemoryChunk* cache)
 {
@@ -29,11 +29,16 @@
 #include <string.h>
 
 #include <jmessage.h>
+#include <jmessage-internal.h>
 
+#include <jconnection.h>
+#include <jconnection-internal.h>
 #include <jhelper.h>
 #include <jlist.h>
 #include <jlist-iterator.h>
+#include <jnetwork.h>
 #include <jsemantics.h>
+#include <jslab.h>
 #include <jtrace.h>
 
 /**
@@ -59,6 +64,12 @@ enum JMessageSemantics
 
 typedef enum JMessageSemantics JMessageSemantics;
 
+/**
+ * The maximum number of buffers passed to a single vectored read or write.
+ * This corresponds to IOV_MAX on Linux.
+ **/
+#define J_MESSAGE_MAX_VECTORS 1024
+
 /**
  * Additional message data.
  **/
@@ -107,12 +118,22 @@ struct JMessageHeader
 	 * The operation count.
 	 **/
 	guint32 op_count;
+
+	/**
+	 * The number of additional data buffers sent after the message.
+	 **/
+	guint32 send_count;
 };
 #pragma pack()
 
 typedef struct JMessageHeader JMessageHeader;
 
-G_STATIC_ASSERT(sizeof(JMessageHeader) == 5 * sizeof(guint32));
+G_STATIC_ASSERT(sizeof(JMessageHeader) == 6 * sizeof(guint32));
+
+/**
+ * The ID of the next message.
+ **/
+static gint j_message_next_id = 0;
 
 /**
  * A message.
@@ -145,6 +166,28 @@ struct JMessage
 	 **/
 	JList* send_list;
 
+	/**
+	 * The remote memory regions of the additional data (libfabric only).
+	 * Contains send_count elements and is filled in j_message_receive().
+	 **/
+	JNetworkConnectionMemoryID* remote_data;
+
+	/**
+	 * The number of elements allocated for #remote_data.
+	 **/
+	guint32 remote_data_size;
+
+	/**
+	 * The index of the next element of #remote_data to be read.
+	 **/
+	guint32 remote_data_current;
+
+	/**
+	 * The number of additional data buffers that still have to be received.
+	 * Once it reaches zero, the connection's input is released.
+	 **/
+	guint32 receive_pending;
+
 	/**
 	 * The original message.
 	 * Set if the message is a reply, NULL otherwise.
@@ -186,7 +229,36 @@ j_message_data_free(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	g_free(data);
+	j_slab_delete(JMessageData, data);
+}
+
+/**
+ * Resizes a message's buffer.
+ * Buffers are recycled using the slab allocator, so their size is rounded up to the next size class.
+ *
+ * \private
+ *
+ * \param message A message.
+ * \param size    The new minimum size.
+ **/
+static void
+j_message_resize(JMessage* message, gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gchar* data;
+	gsize position;
+
+	size = j_slab_get_size(size);
+	data = j_slab_alloc(size);
+	memcpy(data, message->data, MIN(message->size, size));
+
+	position = message->current - message->data;
+	j_slab_free(message->data, message->size);
+
+	message->size = size;
+	message->data = data;
+	message->current = message->data + position;
 }
 
 /**
@@ -238,7 +310,6 @@ j_message_extend(JMessage* message, gsize length)
 
 	gsize factor = 1;
 	gsize current_length;
-	gsize position;
 	guint32 count;
 
 	if (length == 0)
@@ -260,11 +331,7 @@ j_message_extend(JMessage* message, gsize length)
 		factor = pow(10, floor(log10(count)));
 	}
 
-	message->size += length * factor;
-
-	position = message->current - message->data;
-	message->data = g_realloc(message->data, message->size);
-	message->current = message->data + position;
+	j_message_resize(message, message->size + length * factor);
 }
 
 static void
@@ -272,18 +339,12 @@ j_message_ensure_size(JMessage* message, gsize length)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gsize position;
-
 	if (length <= message->size)
 	{
 		return;
 	}
 
-	message->size = length;
-
-	position = message->current - message->data;
-	message->data = g_realloc(message->data, message->size);
-	message->current = message->data + position;
+	j_message_resize(message, length);
 }
 
 JMessage*
@@ -292,26 +353,32 @@ j_message_new(JMessageType op_type, gsize length)
 	J_TRACE_FUNCTION(NULL);
 
 	JMessage* message;
-	guint32 rand;
+	guint32 id;
 
 	//g_return_val_if_fail(op_type != J_MESSAGE_NONE, NULL);
 
 	length = MAX(256, length);
-	rand = g_random_int();
+	// IDs have to be unique among the messages in flight on a multiplexed connection.
+	id = (guint32)g_atomic_int_add(&j_message_next_id, 1);
 
-	message = g_new(JMessage, 1);
-	message->size = length;
-	message->data = g_malloc(message->size);
+	message = j_slab_new(JMessage);
+	message->size = j_slab_get_size(length);
+	message->data = j_slab_alloc(message->size);
 	message->current = message->data;
 	message->send_list = j_list_new(j_message_data_free);
+	message->remote_data = NULL;
+	message->remote_data_size = 0;
+	message->remote_data_current = 0;
+	message->receive_pending = 0;
 	message->original_message = NULL;
 	message->ref_count = 1;
 
 	message->header.length = GUINT32_TO_LE(0);
-	message->header.id = GUINT32_TO_LE(rand);
+	message->header.id = GUINT32_TO_LE(id);
 	message->header.semantics = GUINT32_TO_LE(0);
 	message->header.op_type = GUINT32_TO_LE(op_type);
 	message->header.op_count = GUINT32_TO_LE(0);
+	message->header.send_count = GUINT32_TO_LE(0);
 
 	return message;
 }
@@ -325,11 +392,15 @@ j_message_new_reply(JMessage* message)
 
 	g_return_val_if_fail(message != NULL, NULL);
 
-	reply = g_new(JMessage, 1);
+	reply = j_slab_new(JMessage);
 	reply->size = 256;
-	reply->data = g_malloc(reply->size);
+	reply->data = j_slab_alloc(reply->size);
 	reply->current = reply->data;
 	reply->send_list = j_list_new(j_message_data_free);
+	reply->remote_data = NULL;
+	reply->remote_data_size = 0;
+	reply->remote_data_current = 0;
+	reply->receive_pending = 0;
 	reply->original_message = j_message_ref(message);
 	reply->ref_count = 1;
 
@@ -338,6 +409,7 @@ j_message_new_reply(JMessage* message)
 	reply->header.semantics = GUINT32_TO_LE(0);
 	reply->header.op_type = message->header.op_type;
 	reply->header.op_count = GUINT32_TO_LE(0);
+	reply->header.send_count = GUINT32_TO_LE(0);
 
 	return reply;
 }
@@ -373,9 +445,10 @@ j_message_unref(JMessage* message)
 			j_list_unref(message->send_list);
 		}
 
-		g_free(message->data);
+		g_free(message->remote_data);
+		j_slab_free(message->data, message->size);
 
-		g_free(message);
+		j_slab_delete(JMessage, message);
 	}
 }
 
@@ -585,38 +658,451 @@ j_message_get_string(JMessage* message)
 	return ret;
 }
 
+/**
+ * Returns a message's send count.
+ *
+ * \private
+ *
+ * \param message A message.
+ *
+ * \return The number of additional data buffers.
+ **/
+static guint32
+j_message_get_send_count(JMessage const* message)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 send_count;
+
+	send_count = message->header.send_count;
+
+	return GUINT32_FROM_LE(send_count);
+}
+
+/**
+ * Marks additional data of a received message as read.
+ * Releases the connection's input once all additional data has been read.
+ *
+ * \private
+ *
+ * \param message    A received message.
+ * \param connection The connection the message was received from.
+ * \param count      The number of additional data buffers that have been read.
+ **/
+static void
+j_message_consume_data(JMessage* message, JConnection* connection, guint32 count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (message->receive_pending == 0)
+	{
+		return;
+	}
+
+	message->receive_pending -= MIN(count, message->receive_pending);
+
+	if (message->receive_pending == 0)
+	{
+		j_connection_release_input(connection);
+	}
+}
+
+/**
+ * Reads a message's body from a stream.
+ * The header has to have been read already.
+ *
+ * \private
+ *
+ * \param message A message.
+ * \param stream  A stream.
+ * \param error   A return location for a GError.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_read_body(JMessage* message, GInputStream* stream, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gsize bytes_read;
+
+	j_message_ensure_size(message, j_message_length(message));
+
+	if (!g_input_stream_read_all(stream, message->data, j_message_length(message), &bytes_read, NULL, error) || bytes_read != j_message_length(message))
+	{
+		return FALSE;
+	}
+
+	message->current = message->data;
+
+	if (message->original_message != NULL)
+	{
+		g_assert(message->header.id == message->original_message->header.id);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Reads a message from a libfabric connection.
+ * The remote memory regions of the additional data are received, too.
+ *
+ * \private
+ *
+ * \param message    A message.
+ * \param connection A connection.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_receive_network(JMessage* message, JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 send_count;
+
+	if (!j_connection_read(connection, &(message->header), sizeof(JMessageHeader)))
+	{
+		return FALSE;
+	}
+
+	j_message_ensure_size(message, j_message_length(message));
+
+	if (!j_connection_read(connection, message->data, j_message_length(message)))
+	{
+		return FALSE;
+	}
+
+	message->current = message->data;
+
+	send_count = j_message_get_send_count(message);
+	message->remote_data_current = 0;
+
+	if (send_count > message->remote_data_size)
+	{
+		message->remote_data = g_renew(JNetworkConnectionMemoryID, message->remote_data, send_count);
+		message->remote_data_size = send_count;
+	}
+
+	if (send_count > 0 && !j_connection_read(connection, message->remote_data, send_count * sizeof(JNetworkConnectionMemoryID)))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Writes a message to a libfabric connection.
+ * Instead of sending the additional data, its memory is registered and the remote side reads it via RMA.
+ * Blocks until the remote side has acknowledged that all additional data has been read.
+ *
+ * \private
+ *
+ * \param message    A message.
+ * \param connection A connection.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_message_send_network(JMessage* message, JConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	JNetworkConnection* network;
+	g_autofree JNetworkConnectionMemory* memory = NULL;
+	g_autofree JNetworkConnectionMemoryID* memory_id = NULL;
+	guint32 send_count;
+	guint32 registered = 0;
+
+	network = j_connection_get_network(connection);
+	send_count = j_message_get_send_count(message);
+
+	if (send_count > 0)
+	{
+		g_autoptr(JListIterator) iterator = NULL;
+
+		memory = g_new(JNetworkConnectionMemory, send_count);
+		memory_id = g_new(JNetworkConnectionMemoryID, send_count);
+
+		iterator = j_list_iterator_new(message->send_list);
+
+		while (j_list_iterator_next(iterator))
+		{
+			JMessageData* message_data = j_list_iterator_get(iterator);
+
+			if (!j_network_connection_rma_register(network, message_data->data, message_data->length, &(memory[registered])))
+			{
+				goto end;
+			}
+
+			j_network_connection_memory_get_id(&(memory[registered]), &(memory_id[registered]));
+			registered++;
+		}
+
+		g_assert(registered == send_count);
+	}
+
+	if (!j_connection_write(connection, &(message->header), sizeof(JMessageHeader))
+	    || !j_connection_write(connection, message->data, j_message_length(message)))
+	{
+		goto end;
+	}
+
+	if (send_count > 0)
+	{
+		guint32 ack = 0;
+
+		if (!j_connection_write(connection, memory_id, send_count * sizeof(JNetworkConnectionMemoryID)))
+		{
+			goto end;
+		}
+
+		// The registered memory has to stay valid until the remote side has read it.
+		if (!j_connection_read(connection, &ack, sizeof(ack)) || ack != J_NETWORK_CONNECTION_ACK)
+		{
+			goto end;
+		}
+	}
+
+	ret = TRUE;
+
+end:
+	for (guint32 i = 0; i < registered; i++)
+	{
+		j_network_connection_rma_unregister(network, &(memory[i]));
+	}
+
+	return ret;
+}
+
+/**
+ * Returns the ID used to trace a message.
+ * Requests and replies share their message ID, so the direction is encoded into the lowest bit.
+ *
+ * \private
+ *
+ * \param message A message.
+ *
+ * \return The trace ID.
+ **/
+static guint32
+j_message_get_trace_id(JMessage* message)
+{
+	return (GUINT32_FROM_LE(message->header.id) << 1) | (message->original_message != NULL);
+}
+
 gboolean
 j_message_receive(JMessage* message, gpointer connection)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	GInputStream* stream;
+	gboolean ret;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(connection != NULL, FALSE);
 
-	stream = g_io_stream_get_input_stream(G_IO_STREAM(connection));
-	return j_message_read(message, stream);
+	if (j_connection_get_transport(connection) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		ret = j_message_receive_network(message, connection);
+
+		if (ret && message->original_message != NULL)
+		{
+			g_assert(message->header.id == message->original_message->header.id);
+		}
+	}
+	else if (j_connection_is_multiplexed(connection))
+	{
+		GError* error = NULL;
+		GInputStream* stream;
+
+		// The header has already been read by the connection's demultiplexer.
+		ret = j_connection_receive_header(connection, GUINT32_FROM_LE(message->header.id), &(message->header));
+
+		if (ret)
+		{
+			stream = g_io_stream_get_input_stream(G_IO_STREAM(j_connection_get_socket(connection)));
+			ret = j_message_read_body(message, stream, &error);
+		}
+
+		if (error != NULL)
+		{
+			g_critical("%s", error->message);
+			g_error_free(error);
+		}
+
+		if (!ret)
+		{
+			// Let the demultiplexer notice the error.
+			j_connection_release_input(connection);
+			return FALSE;
+		}
+	}
+	else
+	{
+		GInputStream* stream;
+
+		stream = g_io_stream_get_input_stream(G_IO_STREAM(j_connection_get_socket(connection)));
+		ret = j_message_read(message, stream);
+	}
+
+	if (ret)
+	{
+		j_trace_message(J_TRACE_MESSAGE_RECEIVE, j_message_get_trace_id(message));
+
+		message->receive_pending = j_message_get_send_count(message);
+
+		if (message->receive_pending == 0)
+		{
+			j_connection_release_input(connection);
+		}
+	}
+
+	return ret;
 }
 
 gboolean
-j_message_send(JMessage* message, gpointer connection)
+j_message_receive_data(JMessage* message, gpointer connection, gpointer data, guint64 length)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret;
 
-	GOutputStream* stream;
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(data != NULL, FALSE);
+
+	if (length == 0)
+	{
+		j_message_consume_data(message, connection, 1);
+		return TRUE;
+	}
+
+	if (j_connection_get_transport(connection) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		JNetworkConnection* network;
+		JNetworkConnectionMemoryID const* memory_id;
+
+		g_return_val_if_fail(message->remote_data_current < j_message_get_send_count(message), FALSE);
+
+		network = j_connection_get_network(connection);
+		memory_id = &(message->remote_data[message->remote_data_current]);
+		message->remote_data_current++;
+
+		// The acknowledgement still has to be sent, otherwise the remote side waits for it forever.
+		if (G_LIKELY(memory_id->size == length))
+		{
+			ret = j_network_connection_rma_read(network, memory_id, data)
+			      && j_network_connection_wait_for_completion(network);
+		}
+		else
+		{
+			g_critical("Remote data has size %" G_GUINT64_FORMAT " instead of %" G_GUINT64_FORMAT ".", memory_id->size, length);
+			ret = FALSE;
+		}
+
+		// Allow the remote side to release its memory after all data has been read.
+		if (message->remote_data_current == j_message_get_send_count(message))
+		{
+			guint32 ack = J_NETWORK_CONNECTION_ACK;
+
+			ret = j_connection_write(connection, &ack, sizeof(ack)) && ret;
+		}
+	}
+	else
+	{
+		ret = j_connection_read(connection, data, length);
+	}
+
+	j_message_consume_data(message, connection, 1);
+
+	return ret;
+}
+
+gboolean
+j_message_receive_data_vectors(JMessage* message, gpointer connection, GInputVector const* vectors, guint count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
 
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(connection != NULL, FALSE);
+	g_return_val_if_fail(vectors != NULL || count == 0, FALSE);
+
+	if (j_connection_get_transport(connection) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		// Every buffer is transferred using its own RMA read.
+		for (guint i = 0; i < count; i++)
+		{
+			ret = j_message_receive_data(message, connection, vectors[i].buffer, vectors[i].size) && ret;
+		}
+	}
+	else
+	{
+		ret = j_connection_read_vectors(connection, vectors, count);
+		j_message_consume_data(message, connection, count);
+	}
 
-	j_helper_set_cork(connection, TRUE);
+	return ret;
+}
 
-	stream = g_io_stream_get_output_stream(G_IO_STREAM(connection));
-	ret = j_message_write(message, stream);
+void
+j_message_finish_receive(JMessage* message, gpointer connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(message != NULL);
+	g_return_if_fail(connection != NULL);
 
-	j_helper_set_cork(connection, FALSE);
+	if (message->receive_pending > 0)
+	{
+		message->receive_pending = 0;
+		j_connection_release_input(connection);
+	}
+}
+
+gboolean
+j_message_send(JMessage* message, gpointer connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret;
+
+	g_return_val_if_fail(message != NULL, FALSE);
+	g_return_val_if_fail(connection != NULL, FALSE);
+
+	// Messages sent concurrently over the same connection must not interleave.
+	j_connection_lock_output(connection);
+
+	if (j_connection_get_transport(connection) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		ret = j_message_send_network(message, connection);
+	}
+	else
+	{
+		GOutputStream* stream;
+
+		stream = g_io_stream_get_output_stream(G_IO_STREAM(j_connection_get_socket(connection)));
+
+#if GLIB_CHECK_VERSION(2, 60, 0)
+		// The message is written using a single vectored write, so corking is not necessary.
+		ret = j_message_write(message, stream);
+#else
+		j_connection_set_cork(connection, TRUE);
+		ret = j_message_write(message, stream);
+		j_connection_set_cork(connection, FALSE);
+#endif
+	}
+
+	j_connection_unlock_output(connection);
+
+	if (ret)
+	{
+		j_trace_message(J_TRACE_MESSAGE_SEND, j_message_get_trace_id(message));
+	}
 
 	return ret;
 }
@@ -639,20 +1125,11 @@ j_message_read(JMessage* message, GInputStream* stream)
 		goto end;
 	}
 
-	j_message_ensure_size(message, j_message_length(message));
-
-	if (!g_input_stream_read_all(stream, message->data, j_message_length(message), &bytes_read, NULL, &error) || bytes_read != j_message_length(message))
+	if (!j_message_read_body(message, stream, &error))
 	{
 		goto end;
 	}
 
-	message->current = message->data;
-
-	if (message->original_message != NULL)
-	{
-		g_assert(message->header.id == message->original_message->header.id);
-	}
-
 	ret = TRUE;
 
 end:
@@ -672,13 +1149,53 @@ j_message_write(JMessage* message, GOutputStream* stream)
 
 	gboolean ret = FALSE;
 
-	g_autoptr(JListIterator) iterator = NULL;
 	GError* error = NULL;
 	gsize bytes_written;
 
+#if GLIB_CHECK_VERSION(2, 60, 0)
+	g_autofree GOutputVector* vectors = NULL;
+	guint count;
+#else
+	g_autoptr(JListIterator) iterator = NULL;
+#endif
+
 	g_return_val_if_fail(message != NULL, FALSE);
 	g_return_val_if_fail(stream != NULL, FALSE);
 
+#if GLIB_CHECK_VERSION(2, 60, 0)
+	// Header, body and additional data are written using as few (vectored) writes as possible.
+	count = 2 + j_list_length(message->send_list);
+	vectors = g_new(GOutputVector, count);
+
+	vectors[0].buffer = &(message->header);
+	vectors[0].size = sizeof(JMessageHeader);
+	vectors[1].buffer = message->data;
+	vectors[1].size = j_message_length(message);
+
+	{
+		g_autoptr(JListIterator) iterator = NULL;
+		guint i = 2;
+
+		iterator = j_list_iterator_new(message->send_list);
+
+		while (j_list_iterator_next(iterator))
+		{
+			JMessageData* message_data = j_list_iterator_get(iterator);
+
+			vectors[i].buffer = message_data->data;
+			vectors[i].size = message_data->length;
+			i++;
+		}
+	}
+
+	for (guint i = 0; i < count; i += J_MESSAGE_MAX_VECTORS)
+	{
+		if (!g_output_stream_writev_all(stream, vectors + i, MIN(count - i, J_MESSAGE_MAX_VECTORS), &bytes_written, NULL, &error))
+		{
+			goto end;
+		}
+	}
+#else
 	if (!g_output_stream_write_all(stream, &(message->header), sizeof(JMessageHeader), &bytes_written, NULL, &error) || bytes_written != sizeof(JMessageHeader))
 	{
 		goto end;
@@ -703,6 +1220,7 @@ j_message_write(JMessage* message, GOutputStream* stream)
 			}
 		}
 	}
+#endif
 
 	g_output_stream_flush(stream, NULL, NULL);
 
@@ -724,16 +1242,20 @@ j_message_add_send(JMessage* message, gconstpointer data, guint64 length)
 	J_TRACE_FUNCTION(NULL);
 
 	JMessageData* message_data;
+	guint32 new_send_count;
 
 	g_return_if_fail(message != NULL);
 	g_return_if_fail(data != NULL);
 	g_return_if_fail(length > 0);
 
-	message_data = g_new(JMessageData, 1);
+	message_data = j_slab_new(JMessageData);
 	message_data->data = data;
 	message_data->length = length;
 
 	j_list_append(message->send_list, message_data);
+
+	new_send_count = j_message_get_send_count(message) + 1;
+	message->header.send_count = GUINT32_TO_LE(new_send_count);
 }
 
 void
@@ -828,6 +1350,26 @@ j_message_get_semantics(JMessage* message)
 	return semantics;
 }
 
+gsize
+j_message_header_size(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return sizeof(JMessageHeader);
+}
+
+guint32
+j_message_header_get_id(gconstpointer header)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessageHeader const* message_header = header;
+
+	g_return_val_if_fail(header != NULL, 0);
+
+	return GUINT32_FROM_LE(message_header->id);
+}
+
 /**
  * @}
  **/
@@ -552,16 +552,7 @@ end:
 	return NULL;
 }
 
-/**
- * Closes a fabric and frees used memory.
- *
- * \pre Finish all connections created from this fabric.
- *
- * \param this A fabric.
- *
- * \return TRUE on success, FALSE if an error occurred.
- **/
-static gboolean
+gboolean
 j_network_fabric_fini(JNetworkFabric* fabric)
 {
 	J_TRACE_FUNCTION(NULL);
@@ -28,12 +28,11 @@
 
 #include <jbackground-operation-internal.h>
 #include <jcache.h>
-#include <jlist.h>
-#include <jlist-iterator.h>
 #include <jbatch.h>
 #include <jbatch-internal.h>
 #include <joperation.h>
 #include <jtrace.h>
+#include <jvector.h>
 
 #include <string.h>
 
@@ -64,17 +63,17 @@ struct JOperationCache
 	GThread* thread;
 
 	/**
-	 * Whether #thread is currently working.
+	 * The number of batches that have been queued but not executed yet.
 	 */
-	gboolean working;
+	guint pending;
 
 	/**
-	 * The mutex for #working.
+	 * The mutex for #pending.
 	 */
 	GMutex mutex[1];
 
 	/**
-	 * The condition for #working.
+	 * The condition for #pending.
 	 */
 	GCond cond[1];
 };
@@ -107,19 +106,25 @@ j_operation_cache_thread(gpointer data)
 			return NULL;
 		}
 
+		// Batches are executed one after another in the order they were added.
 		j_batch_execute_internal(cached_batch->batch);
 
 		j_batch_unref(cached_batch->batch);
-		j_cache_release(j_operation_cache->cache, cached_batch->data);
+
+		if (cached_batch->data != NULL)
+		{
+			j_cache_release(cache->cache, cached_batch->data);
+		}
+
 		g_free(cached_batch);
 
 		g_mutex_lock(cache->mutex);
 
-		cache->working = (g_async_queue_length(cache->queue) > 0);
+		cache->pending--;
 
-		if (!cache->working)
+		if (cache->pending == 0)
 		{
-			g_cond_signal(cache->cond);
+			g_cond_broadcast(cache->cond);
 		}
 
 		g_mutex_unlock(cache->mutex);
@@ -133,34 +138,10 @@ j_operation_cache_test(JOperation* operation)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gboolean ret = FALSE;
+	gboolean ret;
 
-	(void)operation;
-
-	/// \todo
-	/*
-	switch (operation->type)
-	{
-		case J_OPERATION_COLLECTION_CREATE:
-		case J_OPERATION_COLLECTION_DELETE:
-		case J_OPERATION_ITEM_CREATE:
-		case J_OPERATION_ITEM_DELETE:
-		case J_OPERATION_ITEM_WRITE:
-			ret = TRUE;
-			break;
-
-		case J_OPERATION_COLLECTION_GET:
-		case J_OPERATION_ITEM_GET:
-		case J_OPERATION_ITEM_GET_STATUS:
-		case J_OPERATION_ITEM_READ:
-			ret = FALSE;
-			break;
-
-		case J_OPERATION_NONE:
-		default:
-			g_warn_if_reached();
-	}
-	*/
+	// Only operations that can copy their input can be executed after the batch has returned.
+	ret = (operation->cache_func != NULL);
 
 	// Enforce operation order even if some operations can not be cached
 	if (!ret)
@@ -176,36 +157,7 @@ j_operation_cache_get_required_size(JOperation* operation)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	guint64 ret = 0;
-
-	(void)operation;
-
-	/// \todo
-	/*
-	switch (operation->type)
-	{
-		case J_OPERATION_ITEM_WRITE:
-			ret = operation->item_write.length;
-			break;
-
-		case J_OPERATION_COLLECTION_CREATE:
-		case J_OPERATION_COLLECTION_DELETE:
-		case J_OPERATION_ITEM_CREATE:
-		case J_OPERATION_ITEM_DELETE:
-		case J_OPERATION_COLLECTION_GET:
-		case J_OPERATION_ITEM_GET:
-		case J_OPERATION_ITEM_GET_STATUS:
-		case J_OPERATION_ITEM_READ:
-			ret = 0;
-			break;
-
-		case J_OPERATION_NONE:
-		default:
-			g_warn_if_reached();
-	}
-	*/
-
-	return ret;
+	return operation->cache_func(operation->data, NULL);
 }
 
 void
@@ -221,7 +173,7 @@ j_operation_cache_init(void)
 	cache->cache = j_cache_new(50 * 1024 * 1024);
 	cache->queue = g_async_queue_new_full(NULL);
 	cache->thread = g_thread_new("JOperationCache", j_operation_cache_thread, cache);
-	cache->working = FALSE;
+	cache->pending = 0;
 
 	g_mutex_init(cache->mutex);
 	g_cond_init(cache->cond);
@@ -265,7 +217,7 @@ j_operation_cache_flush(void)
 
 	g_mutex_lock(j_operation_cache->mutex);
 
-	while (j_operation_cache->working)
+	while (j_operation_cache->pending > 0)
 	{
 		g_cond_wait(j_operation_cache->cond, j_operation_cache->mutex);
 	}
@@ -280,78 +232,61 @@ j_operation_cache_add(JBatch* batch)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	gboolean ret = TRUE;
 	JCachedBatch* cached_batch;
-	JList* operations;
-	JListIterator* iterator;
-	gboolean can_cache = TRUE;
+	JVector* operations;
+	JVectorIterator iterator[1];
 	gchar* data;
-	gpointer buffer;
+	gpointer buffer = NULL;
 	guint64 required_size = 0;
 
 	operations = j_batch_get_operations(batch);
-	iterator = j_list_iterator_new(operations);
+	j_vector_iterator_init(iterator, operations);
 
-	while (j_list_iterator_next(iterator))
+	while (j_vector_iterator_next(iterator))
 	{
-		JOperation* operation = j_list_iterator_get(iterator);
-
-		can_cache = j_operation_cache_test(operation) && can_cache;
+		JOperation* operation = j_vector_iterator_get(iterator);
 
-		if (!can_cache)
+		if (!j_operation_cache_test(operation))
 		{
-			ret = FALSE;
-			break;
+			return FALSE;
 		}
 
 		required_size += j_operation_cache_get_required_size(operation);
 	}
 
-	j_list_iterator_free(iterator);
-
-	/// \todo never cleared
-	if ((buffer = j_cache_get(j_operation_cache->cache, required_size)) == NULL)
-	{
-		ret = FALSE;
-	}
-
-	if (!ret)
+	if (required_size > 0)
 	{
-		return FALSE;
+		if ((buffer = j_cache_get(j_operation_cache->cache, required_size)) == NULL)
+		{
+			// Wait for the queued batches to release their buffers.
+			// If the cache is still too small, the caller executes the batch, which keeps the order intact.
+			j_operation_cache_flush();
+
+			if ((buffer = j_cache_get(j_operation_cache->cache, required_size)) == NULL)
+			{
+				return FALSE;
+			}
+		}
 	}
 
+	// Copy the input so that the caller can reuse its buffers as soon as the batch returns.
 	data = buffer;
-	iterator = j_list_iterator_new(operations);
+	j_vector_iterator_init(iterator, operations);
 
-	while (j_list_iterator_next(iterator))
+	while (j_vector_iterator_next(iterator))
 	{
-		/// \todo
-		/*
-		JOperation* operation = j_list_iterator_get(iterator);
+		JOperation* operation = j_vector_iterator_get(iterator);
+		guint64 size;
 
-		if (operation->type == J_OPERATION_ITEM_WRITE)
+		if ((size = j_operation_cache_get_required_size(operation)) > 0)
 		{
-			memcpy(data, operation->item_write.data, operation->item_write.length);
-
-			operation->item_write.data = data;
-			*(operation->item_write.bytes_written) += operation->item_write.length;
-			operation->item_write.bytes_written = NULL;
-
-			data += operation->item_write.length;
+			operation->cache_func(operation->data, data);
+			data += size;
 		}
-		*/
-		(void)data;
-	}
-
-	j_list_iterator_free(iterator);
-
-	if (!ret)
-	{
-		return FALSE;
 	}
 
 	g_mutex_lock(j_operation_cache->mutex);
-	j_operation_cache->working = TRUE;
+	j_operation_cache->pending++;
 	g_mutex_unlock(j_operation_cache->mutex);
 
 	cached_batch = g_new(JCachedBatch, 1);
@@ -360,7 +295,7 @@ j_operation_cache_add(JBatch* batch)
 
 	g_async_queue_push(j_operation_cache->queue, cached_batch);
 
-	return ret;
+	return TRUE;
 }
 
 /**
@@ -26,6 +26,7 @@
 
 #include <joperation.h>
 
+#include <jslab.h>
 #include <jtrace.h>
 
 /**
@@ -41,11 +42,12 @@ j_operation_new(void)
 
 	JOperation* operation;
 
-	operation = g_new(JOperation, 1);
+	operation = j_slab_new(JOperation);
 	operation->key = NULL;
 	operation->data = NULL;
 	operation->exec_func = NULL;
 	operation->free_func = NULL;
+	operation->cache_func = NULL;
 
 	return operation;
 }
@@ -61,7 +63,7 @@ j_operation_free(JOperation* operation)
 		operation->free_func(operation->data);
 	}
 
-	g_free(operation);
+	j_slab_delete(JOperation, operation);
 }
 
 /**
@@ -0,0 +1,466 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <string.h>
+
+#include <jread-cache.h>
+#include <jread-cache-internal.h>
+
+#include <jconfiguration.h>
+#include <jtrace.h>
+
+/**
+ * \addtogroup JReadCache Read Cache
+ *
+ * @{
+ **/
+
+/**
+ * Batches with eventual consistency use entries for this many lease times.
+ * This bounds the staleness of their reads while still saving most round trips.
+ */
+#define J_READ_CACHE_EVENTUAL_LEASE_FACTOR 10
+
+/**
+ * A read cache entry.
+ */
+struct JReadCacheEntry
+{
+	/**
+	 * The key.
+	 */
+	gchar* key;
+
+	/**
+	 * The value, NULL if the entry only records an invalidation.
+	 */
+	gpointer value;
+
+	/**
+	 * The value's length.
+	 */
+	guint32 value_len;
+
+	/**
+	 * The monotonic time at which the value was read or the key was invalidated.
+	 */
+	gint64 time;
+
+	/**
+	 * Whether the entry only records an invalidation of its key.
+	 */
+	gboolean invalidated;
+
+	/**
+	 * The entry's link in the LRU queue.
+	 */
+	GList link;
+};
+
+typedef struct JReadCacheEntry JReadCacheEntry;
+
+/**
+ * A read cache.
+ */
+struct JReadCache
+{
+	/**
+	 * The maximum size.
+	 */
+	guint64 size;
+
+	/**
+	 * The used size.
+	 */
+	guint64 used;
+
+	/**
+	 * The lease time in microseconds.
+	 */
+	gint64 lease;
+
+	/**
+	 * The latest invalidation time of all invalidation entries that have been evicted.
+	 * Their keys' invalidations are not known individually anymore.
+	 */
+	gint64 evicted;
+
+	/**
+	 * The entries, indexed by key.
+	 */
+	GHashTable* entries;
+
+	/**
+	 * The entries, most recently used first.
+	 */
+	GQueue lru[1];
+
+	guint64 hits;
+	guint64 misses;
+
+	GMutex mutex[1];
+};
+
+static JReadCache* j_read_cache_global = NULL;
+
+static guint64
+j_read_cache_entry_size(JReadCacheEntry* entry)
+{
+	return strlen(entry->key) + 1 + entry->value_len;
+}
+
+static void
+j_read_cache_entry_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCacheEntry* entry = data;
+
+	g_free(entry->key);
+	g_free(entry->value);
+	g_free(entry);
+}
+
+/**
+ * Removes an entry.
+ * The cache's mutex has to be held.
+ *
+ * \param cache A read cache.
+ * \param entry An entry.
+ **/
+static void
+j_read_cache_remove(JReadCache* cache, JReadCacheEntry* entry)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	cache->used -= j_read_cache_entry_size(entry);
+
+	g_queue_unlink(cache->lru, &(entry->link));
+	g_hash_table_remove(cache->entries, entry->key);
+}
+
+/**
+ * Inserts an entry, evicting the least recently used entries if necessary.
+ * The cache's mutex has to be held and the key must not be in the cache.
+ *
+ * \param cache     A read cache.
+ * \param key       A key.
+ * \param value     A value, which is copied, or NULL to record an invalidation.
+ * \param value_len The value's length.
+ * \param timestamp The monotonic time at which the value was read or the key was invalidated.
+ **/
+static void
+j_read_cache_insert(JReadCache* cache, gchar const* key, gconstpointer value, guint32 value_len, gint64 timestamp)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCacheEntry* entry;
+	guint64 size;
+
+	size = strlen(key) + 1 + value_len;
+
+	if (size > cache->size)
+	{
+		return;
+	}
+
+	while (cache->used + size > cache->size)
+	{
+		JReadCacheEntry* last = g_queue_peek_tail(cache->lru);
+
+		// Reads started before the evicted invalidation must still not be cached
+		if (last->invalidated)
+		{
+			cache->evicted = MAX(cache->evicted, last->time);
+		}
+
+		j_read_cache_remove(cache, last);
+	}
+
+	entry = g_new(JReadCacheEntry, 1);
+	entry->key = g_strdup(key);
+	entry->value = NULL;
+
+	if (value != NULL)
+	{
+#if GLIB_CHECK_VERSION(2, 68, 0)
+		entry->value = g_memdup2(value, value_len);
+#else
+		entry->value = g_memdup(value, value_len);
+#endif
+	}
+
+	entry->value_len = value_len;
+	entry->time = timestamp;
+	entry->invalidated = (value == NULL);
+	entry->link.data = entry;
+	entry->link.prev = NULL;
+	entry->link.next = NULL;
+
+	g_hash_table_insert(cache->entries, entry->key, entry);
+	g_queue_push_head_link(cache->lru, &(entry->link));
+
+	cache->used += size;
+}
+
+JReadCache*
+j_read_cache_new(guint64 size, gint64 lease)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCache* cache;
+
+	g_return_val_if_fail(size > 0, NULL);
+	g_return_val_if_fail(lease >= 0, NULL);
+
+	cache = g_new(JReadCache, 1);
+	cache->size = size;
+	cache->used = 0;
+	cache->lease = lease;
+	cache->evicted = 0;
+	cache->entries = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, j_read_cache_entry_free);
+	cache->hits = 0;
+	cache->misses = 0;
+
+	g_queue_init(cache->lru);
+	g_mutex_init(cache->mutex);
+
+	return cache;
+}
+
+void
+j_read_cache_free(JReadCache* cache)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(cache != NULL);
+
+	// The links are embedded into the entries and freed with them
+	g_hash_table_unref(cache->entries);
+
+	g_mutex_clear(cache->mutex);
+
+	g_free(cache);
+}
+
+JReadCache*
+j_read_cache(void)
+{
+	return j_read_cache_global;
+}
+
+gboolean
+j_read_cache_get(JReadCache* cache, gchar const* key, JSemanticsConsistency consistency, gpointer* value, guint32* value_len)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = FALSE;
+
+	JReadCacheEntry* entry;
+	gint64 lease;
+
+	g_return_val_if_fail(cache != NULL, FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(value_len != NULL, FALSE);
+
+	// Immediate consistency requires reading the current value
+	if (consistency == J_SEMANTICS_CONSISTENCY_IMMEDIATE)
+	{
+		return FALSE;
+	}
+
+	g_mutex_lock(cache->mutex);
+
+	if ((entry = g_hash_table_lookup(cache->entries, key)) == NULL || entry->invalidated)
+	{
+		goto end;
+	}
+
+	lease = cache->lease;
+
+	// Eventual consistency tolerates staler entries, but modifications by other clients still have to become visible eventually
+	if (consistency == J_SEMANTICS_CONSISTENCY_EVENTUAL)
+	{
+		lease *= J_READ_CACHE_EVENTUAL_LEASE_FACTOR;
+	}
+
+	if (g_get_monotonic_time() >= entry->time + lease)
+	{
+		j_read_cache_remove(cache, entry);
+		goto end;
+	}
+
+	g_queue_unlink(cache->lru, &(entry->link));
+	g_queue_push_head_link(cache->lru, &(entry->link));
+
+#if GLIB_CHECK_VERSION(2, 68, 0)
+	*value = g_memdup2(entry->value, entry->value_len);
+#else
+	*value = g_memdup(entry->value, entry->value_len);
+#endif
+	*value_len = entry->value_len;
+
+	ret = TRUE;
+
+end:
+	if (ret)
+	{
+		cache->hits++;
+	}
+	else
+	{
+		cache->misses++;
+	}
+
+	g_mutex_unlock(cache->mutex);
+
+	return ret;
+}
+
+void
+j_read_cache_put(JReadCache* cache, gchar const* key, gconstpointer value, guint32 value_len, gint64 since)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCacheEntry* entry;
+
+	g_return_if_fail(cache != NULL);
+	g_return_if_fail(key != NULL);
+	g_return_if_fail(value != NULL || value_len == 0);
+
+	g_mutex_lock(cache->mutex);
+
+	if (since <= cache->evicted)
+	{
+		goto end;
+	}
+
+	if ((entry = g_hash_table_lookup(cache->entries, key)) != NULL)
+	{
+		// The value might have been read before a concurrent local modification
+		if (entry->invalidated && since <= entry->time)
+		{
+			goto end;
+		}
+
+		j_read_cache_remove(cache, entry);
+	}
+
+	// Empty values are copied as well to distinguish them from invalidations
+	j_read_cache_insert(cache, key, (value != NULL) ? value : "", value_len, since);
+
+end:
+	g_mutex_unlock(cache->mutex);
+}
+
+void
+j_read_cache_invalidate(JReadCache* cache, gchar const* key)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCacheEntry* entry;
+
+	g_return_if_fail(cache != NULL);
+	g_return_if_fail(key != NULL);
+
+	g_mutex_lock(cache->mutex);
+
+	if ((entry = g_hash_table_lookup(cache->entries, key)) != NULL)
+	{
+		j_read_cache_remove(cache, entry);
+	}
+
+	// Reads of this key that are still in flight must not insert their potentially outdated values
+	j_read_cache_insert(cache, key, NULL, 0, g_get_monotonic_time());
+
+	g_mutex_unlock(cache->mutex);
+}
+
+guint64
+j_read_cache_get_hits(JReadCache* cache)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 ret;
+
+	g_return_val_if_fail(cache != NULL, 0);
+
+	g_mutex_lock(cache->mutex);
+	ret = cache->hits;
+	g_mutex_unlock(cache->mutex);
+
+	return ret;
+}
+
+guint64
+j_read_cache_get_misses(JReadCache* cache)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 ret;
+
+	g_return_val_if_fail(cache != NULL, 0);
+
+	g_mutex_lock(cache->mutex);
+	ret = cache->misses;
+	g_mutex_unlock(cache->mutex);
+
+	return ret;
+}
+
+void
+j_read_cache_init(JConfiguration* configuration)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 size;
+
+	g_return_if_fail(j_read_cache_global == NULL);
+
+	size = j_configuration_get_read_cache_size(configuration);
+
+	if (size > 0)
+	{
+		j_read_cache_global = j_read_cache_new(size, (gint64)j_configuration_get_read_cache_lease(configuration) * G_TIME_SPAN_MILLISECOND);
+	}
+}
+
+void
+j_read_cache_fini(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (j_read_cache_global != NULL)
+	{
+		j_read_cache_free(j_read_cache_global);
+		j_read_cache_global = NULL;
+	}
+}
+
+/**
+ * @}
+ **/
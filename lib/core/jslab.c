@@ -0,0 +1,349 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <jslab.h>
+
+#include <jtrace.h>
+
+/**
+ * \addtogroup JSlab Slab Allocator
+ *
+ * @{
+ **/
+
+/**
+ * The binary logarithm of the smallest size class.
+ * Free blocks store a pointer to the next free block, so they have to be at least as large as a pointer.
+ **/
+#define J_SLAB_MIN_SHIFT 4
+
+/**
+ * The binary logarithm of the biggest size class.
+ **/
+#define J_SLAB_MAX_SHIFT 16
+
+/**
+ * The number of size classes.
+ **/
+#define J_SLAB_CLASSES (J_SLAB_MAX_SHIFT - J_SLAB_MIN_SHIFT + 1)
+
+/**
+ * The maximum number of bytes cached per thread and size class.
+ **/
+#define J_SLAB_CACHE_SIZE (256 * 1024)
+
+/**
+ * The maximum number of blocks cached per thread and size class.
+ * Half of them are moved to or from the global cache at once.
+ **/
+#define J_SLAB_CACHE_LENGTH 4096
+
+/**
+ * The global cache holds up to this many times as many blocks as a thread's cache.
+ **/
+#define J_SLAB_GLOBAL_CACHE_FACTOR 16
+
+G_STATIC_ASSERT((1 << J_SLAB_MIN_SHIFT) >= sizeof(gpointer));
+
+/**
+ * A list of free blocks of one size class.
+ * The blocks are linked using their first bytes.
+ **/
+struct JSlabList
+{
+	/**
+	 * The first free block.
+	 **/
+	gpointer head;
+
+	/**
+	 * The number of free blocks.
+	 **/
+	guint length;
+};
+
+typedef struct JSlabList JSlabList;
+
+/**
+ * A thread's cache of free blocks.
+ **/
+struct JSlabCache
+{
+	JSlabList lists[J_SLAB_CLASSES];
+};
+
+typedef struct JSlabCache JSlabCache;
+
+/**
+ * Blocks are often allocated by one thread and freed by another, so thread caches are balanced using this one.
+ **/
+static JSlabList j_slab_global_cache[J_SLAB_CLASSES];
+
+G_LOCK_DEFINE_STATIC(j_slab_global_cache);
+
+static void j_slab_cache_free(gpointer);
+
+static GPrivate j_slab_cache = G_PRIVATE_INIT(j_slab_cache_free);
+
+/**
+ * Returns the size class of a size.
+ *
+ * \private
+ *
+ * \param size A size, which must not be larger than the biggest size class.
+ *
+ * \return The index of the size class.
+ **/
+static guint
+j_slab_class(gsize size)
+{
+	if (size <= (1 << J_SLAB_MIN_SHIFT))
+	{
+		return 0;
+	}
+
+	return g_bit_storage(size - 1) - J_SLAB_MIN_SHIFT;
+}
+
+/**
+ * Returns the maximum number of blocks a thread caches for a size class.
+ *
+ * \private
+ *
+ * \param index The index of the size class.
+ *
+ * \return The maximum number of blocks.
+ **/
+static guint
+j_slab_cache_length(guint index)
+{
+	return MIN(J_SLAB_CACHE_LENGTH, J_SLAB_CACHE_SIZE >> (index + J_SLAB_MIN_SHIFT));
+}
+
+static gpointer
+j_slab_list_pop(JSlabList* list)
+{
+	gpointer mem;
+
+	if ((mem = list->head) != NULL)
+	{
+		list->head = *(gpointer*)mem;
+		list->length--;
+	}
+
+	return mem;
+}
+
+static void
+j_slab_list_push(JSlabList* list, gpointer mem)
+{
+	*(gpointer*)mem = list->head;
+	list->head = mem;
+	list->length++;
+}
+
+/**
+ * Moves free blocks between two lists.
+ *
+ * \private
+ *
+ * \param from  The source list.
+ * \param to    The destination list.
+ * \param count The maximum number of blocks to move.
+ **/
+static void
+j_slab_list_move(JSlabList* from, JSlabList* to, guint count)
+{
+	for (guint i = 0; i < count; i++)
+	{
+		gpointer mem;
+
+		if ((mem = j_slab_list_pop(from)) == NULL)
+		{
+			break;
+		}
+
+		j_slab_list_push(to, mem);
+	}
+}
+
+static void
+j_slab_cache_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSlabCache* cache = data;
+
+	// Short-lived threads would otherwise throw away blocks that other threads could reuse
+	G_LOCK(j_slab_global_cache);
+
+	for (guint i = 0; i < J_SLAB_CLASSES; i++)
+	{
+		guint global_length;
+
+		global_length = j_slab_cache_length(i) * J_SLAB_GLOBAL_CACHE_FACTOR;
+
+		if (j_slab_global_cache[i].length < global_length)
+		{
+			j_slab_list_move(&(cache->lists[i]), &(j_slab_global_cache[i]), global_length - j_slab_global_cache[i].length);
+		}
+	}
+
+	G_UNLOCK(j_slab_global_cache);
+
+	for (guint i = 0; i < J_SLAB_CLASSES; i++)
+	{
+		gpointer mem;
+
+		while ((mem = j_slab_list_pop(&(cache->lists[i]))) != NULL)
+		{
+			g_free(mem);
+		}
+	}
+
+	g_free(cache);
+}
+
+/**
+ * Returns the current thread's cache of free blocks.
+ *
+ * \private
+ *
+ * \return The cache.
+ **/
+static JSlabCache*
+j_slab_cache_get(void)
+{
+	JSlabCache* cache;
+
+	if (G_UNLIKELY((cache = g_private_get(&j_slab_cache)) == NULL))
+	{
+		cache = g_new0(JSlabCache, 1);
+		g_private_set(&j_slab_cache, cache);
+	}
+
+	return cache;
+}
+
+gpointer
+j_slab_alloc(gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSlabList* list;
+	gpointer mem;
+	guint index;
+
+	g_return_val_if_fail(size > 0, NULL);
+
+	if (size > (1 << J_SLAB_MAX_SHIFT))
+	{
+		return g_malloc(size);
+	}
+
+	index = j_slab_class(size);
+	list = &(j_slab_cache_get()->lists[index]);
+
+	// The global cache's length is only a hint here, checking it without the lock at most causes an unnecessary allocation
+	if (list->length == 0 && j_slab_global_cache[index].length > 0)
+	{
+		G_LOCK(j_slab_global_cache);
+		j_slab_list_move(&(j_slab_global_cache[index]), list, j_slab_cache_length(index) / 2);
+		G_UNLOCK(j_slab_global_cache);
+	}
+
+	if ((mem = j_slab_list_pop(list)) == NULL)
+	{
+		mem = g_malloc(1 << (index + J_SLAB_MIN_SHIFT));
+	}
+
+	return mem;
+}
+
+void
+j_slab_free(gpointer mem, gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSlabList* list;
+	guint index;
+	guint length;
+
+	g_return_if_fail(size > 0);
+
+	if (mem == NULL)
+	{
+		return;
+	}
+
+	if (size > (1 << J_SLAB_MAX_SHIFT))
+	{
+		g_free(mem);
+		return;
+	}
+
+	index = j_slab_class(size);
+	length = j_slab_cache_length(index);
+	list = &(j_slab_cache_get()->lists[index]);
+
+	if (list->length == length)
+	{
+		G_LOCK(j_slab_global_cache);
+
+		if (j_slab_global_cache[index].length < length * J_SLAB_GLOBAL_CACHE_FACTOR)
+		{
+			j_slab_list_move(list, &(j_slab_global_cache[index]), length / 2);
+		}
+
+		G_UNLOCK(j_slab_global_cache);
+	}
+
+	if (list->length < length)
+	{
+		j_slab_list_push(list, mem);
+	}
+	else
+	{
+		g_free(mem);
+	}
+}
+
+gsize
+j_slab_get_size(gsize size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (size > (1 << J_SLAB_MAX_SHIFT))
+	{
+		return size;
+	}
+
+	return 1 << (j_slab_class(size) + J_SLAB_MIN_SHIFT);
+}
+
+/**
+ * @}
+ **/
@@ -24,7 +24,10 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <jstatistics.h>
+#include <jhelper.h>
 #include <jtrace.h>
 
 /**
@@ -33,6 +36,34 @@
  * @{
  **/
 
+/**
+ * The number of per-message-type statistics.
+ **/
+#define J_STATISTICS_MESSAGE_VALUES (J_STATISTICS_MESSAGE_SERVICE_TIME + 1)
+
+/**
+ * The number of per-message-type histograms.
+ **/
+#define J_STATISTICS_HISTOGRAMS (J_STATISTICS_HISTOGRAM_SERVICE_TIME + 1)
+
+/**
+ * The statistics of a message type.
+ **/
+struct JStatisticsMessageData
+{
+	/**
+	 * The values, indexed by JStatisticsMessage.
+	 **/
+	guint64 values[J_STATISTICS_MESSAGE_VALUES];
+
+	/**
+	 * The histograms, indexed by JStatisticsHistogram.
+	 **/
+	guint64 histograms[J_STATISTICS_HISTOGRAMS][J_STATISTICS_HISTOGRAM_BUCKETS];
+};
+
+typedef struct JStatisticsMessageData JStatisticsMessageData;
+
 /**
  * A statistics.
  **/
@@ -82,6 +113,11 @@ struct JStatistics
 	 * The number of sent bytes.
 	 **/
 	guint64 bytes_sent;
+
+	/**
+	 * The statistics of each message type.
+	 **/
+	JStatisticsMessageData messages[J_STATISTICS_MESSAGE_TYPES];
 };
 
 static gchar const*
@@ -113,6 +149,89 @@ j_statistics_get_type_name(JStatisticsType type)
 	}
 }
 
+gchar const*
+j_statistics_get_message_type_name(JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	switch (type)
+	{
+		case J_MESSAGE_NONE:
+			return "none";
+		case J_MESSAGE_PING:
+			return "ping";
+		case J_MESSAGE_STATISTICS:
+			return "statistics";
+		case J_MESSAGE_OBJECT_CREATE:
+			return "object_create";
+		case J_MESSAGE_OBJECT_DELETE:
+			return "object_delete";
+		case J_MESSAGE_OBJECT_GET_ALL:
+			return "object_get_all";
+		case J_MESSAGE_OBJECT_GET_BY_PREFIX:
+			return "object_get_by_prefix";
+		case J_MESSAGE_OBJECT_READ:
+			return "object_read";
+		case J_MESSAGE_OBJECT_STATUS:
+			return "object_status";
+		case J_MESSAGE_OBJECT_SYNC:
+			return "object_sync";
+		case J_MESSAGE_OBJECT_WRITE:
+			return "object_write";
+		case J_MESSAGE_KV_PUT:
+			return "kv_put";
+		case J_MESSAGE_KV_DELETE:
+			return "kv_delete";
+		case J_MESSAGE_KV_GET:
+			return "kv_get";
+		case J_MESSAGE_KV_GET_ALL:
+			return "kv_get_all";
+		case J_MESSAGE_KV_GET_BY_PREFIX:
+			return "kv_get_by_prefix";
+		case J_MESSAGE_DB_SCHEMA_CREATE:
+			return "db_schema_create";
+		case J_MESSAGE_DB_SCHEMA_GET:
+			return "db_schema_get";
+		case J_MESSAGE_DB_SCHEMA_DELETE:
+			return "db_schema_delete";
+		case J_MESSAGE_DB_INSERT:
+			return "db_insert";
+		case J_MESSAGE_DB_INSERT_MANY:
+			return "db_insert_many";
+		case J_MESSAGE_DB_UPDATE:
+			return "db_update";
+		case J_MESSAGE_DB_DELETE:
+			return "db_delete";
+		case J_MESSAGE_DB_QUERY:
+			return "db_query";
+		case J_MESSAGE_DB_FETCH:
+			return "db_fetch";
+		default:
+			g_warn_if_reached();
+			return NULL;
+	}
+}
+
+/**
+ * Returns the histogram bucket of a duration.
+ *
+ * \param duration A duration in microseconds.
+ *
+ * \return The bucket.
+ **/
+static guint
+j_statistics_histogram_bucket(guint64 duration)
+{
+	// The bucket is the number of significant bits, that is, duration < 2^bucket
+	// g_bit_storage() returns 1 for 0, which would leave bucket 0 unused
+	if (duration == 0)
+	{
+		return 0;
+	}
+
+	return MIN(g_bit_storage(duration), J_STATISTICS_HISTOGRAM_BUCKETS - 1);
+}
+
 JStatistics*
 j_statistics_new(gboolean trace)
 {
@@ -131,6 +250,8 @@ j_statistics_new(gboolean trace)
 	statistics->bytes_received = 0;
 	statistics->bytes_sent = 0;
 
+	memset(statistics->messages, 0, sizeof(statistics->messages));
+
 	return statistics;
 }
 
@@ -194,31 +315,32 @@ j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value)
 
 	g_return_if_fail(statistics != NULL);
 
+	// Statistics can be updated by multiple threads concurrently, for instance, when a server processes multiple messages of a connection.
 	switch (type)
 	{
 		case J_STATISTICS_FILES_CREATED:
-			statistics->files_created += value;
+			j_helper_atomic_add(&(statistics->files_created), value);
 			break;
 		case J_STATISTICS_FILES_DELETED:
-			statistics->files_deleted += value;
+			j_helper_atomic_add(&(statistics->files_deleted), value);
 			break;
 		case J_STATISTICS_FILES_STATED:
-			statistics->files_stated += value;
+			j_helper_atomic_add(&(statistics->files_stated), value);
 			break;
 		case J_STATISTICS_SYNC:
-			statistics->sync_count += value;
+			j_helper_atomic_add(&(statistics->sync_count), value);
 			break;
 		case J_STATISTICS_BYTES_READ:
-			statistics->bytes_read += value;
+			j_helper_atomic_add(&(statistics->bytes_read), value);
 			break;
 		case J_STATISTICS_BYTES_WRITTEN:
-			statistics->bytes_written += value;
+			j_helper_atomic_add(&(statistics->bytes_written), value);
 			break;
 		case J_STATISTICS_BYTES_RECEIVED:
-			statistics->bytes_received += value;
+			j_helper_atomic_add(&(statistics->bytes_received), value);
 			break;
 		case J_STATISTICS_BYTES_SENT:
-			statistics->bytes_sent += value;
+			j_helper_atomic_add(&(statistics->bytes_sent), value);
 			break;
 		default:
 			g_warn_if_reached();
@@ -231,6 +353,221 @@ j_statistics_add(JStatistics* statistics, JStatisticsType type, guint64 value)
 	}
 }
 
+void
+j_statistics_message_begin(JStatistics* statistics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(type < J_STATISTICS_MESSAGE_TYPES);
+
+	j_helper_atomic_add(&(statistics->messages[type].values[J_STATISTICS_MESSAGE_IN_FLIGHT]), 1);
+}
+
+void
+j_statistics_message_end(JStatistics* statistics, JMessageType type, guint32 operations, guint64 queue_time, guint64 service_time)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsMessageData* data;
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(type < J_STATISTICS_MESSAGE_TYPES);
+
+	data = &(statistics->messages[type]);
+
+	// Adding the two's complement decrements the gauge
+	j_helper_atomic_add(&(data->values[J_STATISTICS_MESSAGE_IN_FLIGHT]), G_MAXUINT64);
+	j_helper_atomic_add(&(data->values[J_STATISTICS_MESSAGE_REQUESTS]), 1);
+	j_helper_atomic_add(&(data->values[J_STATISTICS_MESSAGE_OPERATIONS]), operations);
+	j_helper_atomic_add(&(data->values[J_STATISTICS_MESSAGE_QUEUE_TIME]), queue_time);
+	j_helper_atomic_add(&(data->values[J_STATISTICS_MESSAGE_SERVICE_TIME]), service_time);
+	j_helper_atomic_add(&(data->histograms[J_STATISTICS_HISTOGRAM_QUEUE_TIME][j_statistics_histogram_bucket(queue_time)]), 1);
+	j_helper_atomic_add(&(data->histograms[J_STATISTICS_HISTOGRAM_SERVICE_TIME][j_statistics_histogram_bucket(service_time)]), 1);
+}
+
+guint64
+j_statistics_get_message(JStatistics* statistics, JMessageType type, JStatisticsMessage statistic)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_MESSAGE_TYPES, 0);
+	g_return_val_if_fail(statistic < J_STATISTICS_MESSAGE_VALUES, 0);
+
+	return statistics->messages[type].values[statistic];
+}
+
+void
+j_statistics_add_message(JStatistics* statistics, JMessageType type, JStatisticsMessage statistic, guint64 value)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(type < J_STATISTICS_MESSAGE_TYPES);
+	g_return_if_fail(statistic < J_STATISTICS_MESSAGE_VALUES);
+
+	j_helper_atomic_add(&(statistics->messages[type].values[statistic]), value);
+}
+
+guint64
+j_statistics_get_histogram(JStatistics* statistics, JMessageType type, JStatisticsHistogram histogram, guint bucket)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(statistics != NULL, 0);
+	g_return_val_if_fail(type < J_STATISTICS_MESSAGE_TYPES, 0);
+	g_return_val_if_fail(histogram < J_STATISTICS_HISTOGRAMS, 0);
+	g_return_val_if_fail(bucket < J_STATISTICS_HISTOGRAM_BUCKETS, 0);
+
+	return statistics->messages[type].histograms[histogram][bucket];
+}
+
+void
+j_statistics_add_histogram(JStatistics* statistics, JMessageType type, JStatisticsHistogram histogram, guint bucket, guint64 value)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(statistics != NULL);
+	g_return_if_fail(type < J_STATISTICS_MESSAGE_TYPES);
+	g_return_if_fail(histogram < J_STATISTICS_HISTOGRAMS);
+	g_return_if_fail(bucket < J_STATISTICS_HISTOGRAM_BUCKETS);
+
+	j_helper_atomic_add(&(statistics->messages[type].histograms[histogram][bucket]), value);
+}
+
+/**
+ * Appends a histogram in the Prometheus text exposition format.
+ *
+ * \param statistics A statistics.
+ * \param histogram  A histogram.
+ * \param name       The metric's name.
+ * \param labels     Additional labels.
+ * \param text       The text to append to.
+ **/
+static void
+j_statistics_append_histogram(JStatistics* statistics, JStatisticsHistogram histogram, gchar const* name, gchar const* labels, GString* text)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JStatisticsMessage sum;
+
+	sum = (histogram == J_STATISTICS_HISTOGRAM_QUEUE_TIME) ? J_STATISTICS_MESSAGE_QUEUE_TIME : J_STATISTICS_MESSAGE_SERVICE_TIME;
+
+	g_string_append_printf(text, "# TYPE %s histogram\n", name);
+
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		JStatisticsMessageData* data = &(statistics->messages[i]);
+		gchar const* type_name;
+		gchar le[G_ASCII_DTOSTR_BUF_SIZE];
+		gchar sum_seconds[G_ASCII_DTOSTR_BUF_SIZE];
+		guint64 count = 0;
+
+		if (data->values[J_STATISTICS_MESSAGE_REQUESTS] == 0)
+		{
+			continue;
+		}
+
+		type_name = j_statistics_get_message_type_name(i);
+
+		// Prometheus buckets are cumulative, g_ascii_dtostr() makes sure the output does not depend on the locale
+		for (guint j = 0; j < J_STATISTICS_HISTOGRAM_BUCKETS - 1; j++)
+		{
+			count += data->histograms[histogram][j];
+			g_ascii_dtostr(le, sizeof(le), (gdouble)(G_GUINT64_CONSTANT(1) << j) / G_USEC_PER_SEC);
+			g_string_append_printf(text, "%s_bucket{%stype=\"%s\",le=\"%s\"} %" G_GUINT64_FORMAT "\n", name, labels, type_name, le, count);
+		}
+
+		count += data->histograms[histogram][J_STATISTICS_HISTOGRAM_BUCKETS - 1];
+		g_string_append_printf(text, "%s_bucket{%stype=\"%s\",le=\"+Inf\"} %" G_GUINT64_FORMAT "\n", name, labels, type_name, count);
+		g_ascii_dtostr(sum_seconds, sizeof(sum_seconds), (gdouble)data->values[sum] / G_USEC_PER_SEC);
+		g_string_append_printf(text, "%s_sum{%stype=\"%s\"} %s\n", name, labels, type_name, sum_seconds);
+		g_string_append_printf(text, "%s_count{%stype=\"%s\"} %" G_GUINT64_FORMAT "\n", name, labels, type_name, count);
+	}
+}
+
+gchar*
+j_statistics_to_prometheus(JStatistics* statistics, gchar const* labels)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	static JStatisticsType const types[] = {
+		J_STATISTICS_FILES_CREATED,
+		J_STATISTICS_FILES_DELETED,
+		J_STATISTICS_FILES_STATED,
+		J_STATISTICS_SYNC,
+		J_STATISTICS_BYTES_READ,
+		J_STATISTICS_BYTES_WRITTEN,
+		J_STATISTICS_BYTES_RECEIVED,
+		J_STATISTICS_BYTES_SENT
+	};
+
+	GString* text;
+	g_autofree gchar* all_labels = NULL;
+	g_autofree gchar* type_labels = NULL;
+
+	g_return_val_if_fail(statistics != NULL, NULL);
+
+	text = g_string_new(NULL);
+
+	if (labels != NULL && labels[0] != '\0')
+	{
+		all_labels = g_strdup_printf("{%s}", labels);
+		type_labels = g_strdup_printf("%s,", labels);
+	}
+	else
+	{
+		all_labels = g_strdup("");
+		type_labels = g_strdup("");
+	}
+
+	for (guint i = 0; i < G_N_ELEMENTS(types); i++)
+	{
+		gchar const* name;
+
+		name = j_statistics_get_type_name(types[i]);
+
+		g_string_append_printf(text, "# TYPE julea_%s_total counter\n", name);
+		g_string_append_printf(text, "julea_%s_total%s %" G_GUINT64_FORMAT "\n", name, all_labels, j_statistics_get(statistics, types[i]));
+	}
+
+	g_string_append(text, "# TYPE julea_requests_total counter\n");
+
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		if (statistics->messages[i].values[J_STATISTICS_MESSAGE_REQUESTS] > 0)
+		{
+			g_string_append_printf(text, "julea_requests_total{%stype=\"%s\"} %" G_GUINT64_FORMAT "\n", type_labels, j_statistics_get_message_type_name(i), statistics->messages[i].values[J_STATISTICS_MESSAGE_REQUESTS]);
+		}
+	}
+
+	g_string_append(text, "# TYPE julea_operations_total counter\n");
+
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		if (statistics->messages[i].values[J_STATISTICS_MESSAGE_REQUESTS] > 0)
+		{
+			g_string_append_printf(text, "julea_operations_total{%stype=\"%s\"} %" G_GUINT64_FORMAT "\n", type_labels, j_statistics_get_message_type_name(i), statistics->messages[i].values[J_STATISTICS_MESSAGE_OPERATIONS]);
+		}
+	}
+
+	g_string_append(text, "# TYPE julea_requests_in_flight gauge\n");
+
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		if (statistics->messages[i].values[J_STATISTICS_MESSAGE_REQUESTS] > 0 || statistics->messages[i].values[J_STATISTICS_MESSAGE_IN_FLIGHT] > 0)
+		{
+			g_string_append_printf(text, "julea_requests_in_flight{%stype=\"%s\"} %" G_GUINT64_FORMAT "\n", type_labels, j_statistics_get_message_type_name(i), statistics->messages[i].values[J_STATISTICS_MESSAGE_IN_FLIGHT]);
+		}
+	}
+
+	j_statistics_append_histogram(statistics, J_STATISTICS_HISTOGRAM_QUEUE_TIME, "julea_queue_seconds", type_labels, text);
+	j_statistics_append_histogram(statistics, J_STATISTICS_HISTOGRAM_SERVICE_TIME, "julea_service_seconds", type_labels, text);
+
+	return g_string_free(text, FALSE);
+}
+
 /**
  * @}
  **/
@@ -25,6 +25,12 @@
 #include <glib.h>
 #include <glib/gprintf.h>
 
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
 #ifdef HAVE_OTF
 #include <otf.h>
 #endif
@@ -45,26 +51,102 @@ enum JTraceFlags
 	J_TRACE_OFF = 0,
 	J_TRACE_ECHO = 1 << 0,
 	J_TRACE_OTF = 1 << 1,
-	J_TRACE_SUMMARY = 1 << 2
+	J_TRACE_SUMMARY = 1 << 2,
+	J_TRACE_CHROME = 1 << 3
 };
 
 typedef enum JTraceFlags JTraceFlags;
 
-struct JTraceStack
+/**
+ * The number of bits used to subdivide each power of two in the histograms.
+ * Durations are recorded with a relative error of at most 1/16.
+ **/
+#define J_TRACE_HISTOGRAM_SUB_BITS 4
+#define J_TRACE_HISTOGRAM_SUB_BUCKETS (1 << J_TRACE_HISTOGRAM_SUB_BITS)
+
+/**
+ * Durations of 2^36 nanoseconds (about 69 seconds) or longer are recorded in the last bucket.
+ **/
+#define J_TRACE_HISTOGRAM_MAX_EXPONENT 36
+#define J_TRACE_HISTOGRAM_BUCKETS ((J_TRACE_HISTOGRAM_MAX_EXPONENT - J_TRACE_HISTOGRAM_SUB_BITS + 1) * J_TRACE_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * The aggregated durations of a call stack.
+ **/
+struct JTraceSummary
 {
+	/**
+	 * The call stack, consisting of function names separated by slashes.
+	 * NULL for the root of a thread's summaries.
+	 **/
 	gchar* name;
+
+	/**
+	 * The summaries of called functions, indexed by function name.
+	 * NULL for merged summaries.
+	 **/
+	GHashTable* children;
+
+	guint64 count;
+
+	/**
+	 * The total duration in nanoseconds.
+	 **/
+	guint64 time;
+
+	/**
+	 * A histogram of the durations with logarithmic buckets.
+	 **/
+	guint32 histogram[J_TRACE_HISTOGRAM_BUCKETS];
+};
+
+typedef struct JTraceSummary JTraceSummary;
+
+struct JTraceStack
+{
+	JTraceSummary* summary;
 	guint64 enter_time;
 };
 
 typedef struct JTraceStack JTraceStack;
 
-struct JTraceTime
+/**
+ * The size of each thread's ring buffer for Chrome trace events in bytes.
+ * Has to be a power of two.
+ **/
+#define J_TRACE_CHROME_RING_SIZE (1024 * 1024)
+
+/**
+ * A single-producer single-consumer ring buffer of serialized trace events.
+ * Each event is stored as its length followed by its data.
+ **/
+struct JTraceRing
 {
-	gdouble time;
-	guint count;
+	gchar* data;
+
+	/**
+	 * The write position, only modified by the traced thread.
+	 **/
+	guint head;
+
+	/**
+	 * The read position, only modified by the writer thread.
+	 **/
+	guint tail;
+
+	/**
+	 * The number of events dropped because the ring buffer was full.
+	 **/
+	guint dropped;
+
+	/**
+	 * Whether the traced thread has exited.
+	 * The writer thread frees the ring buffer once it has been drained.
+	 **/
+	gint finished;
 };
 
-typedef struct JTraceTime JTraceTime;
+typedef struct JTraceRing JTraceRing;
 
 /**
  * A trace thread.
@@ -77,13 +159,46 @@ struct JTraceThread
 	 **/
 	gchar* thread_name;
 
+	/**
+	 * Thread ID.
+	 * 0 for the main process.
+	 **/
+	guint thread_id;
+
 	/**
 	 * Function depth within the current thread.
 	 **/
 	guint function_depth;
 
+	/**
+	 * The thread's summaries.
+	 * They are only modified by the thread itself and published to j_trace_summary_table when the thread exits.
+	 **/
+	JTraceSummary* summary;
+
 	GArray* stack;
 
+	/**
+	 * Traces that have been left and can be reused by j_trace_enter().
+	 **/
+	JTrace* free_traces;
+
+	/**
+	 * Chrome-specific structure.
+	 **/
+	struct
+	{
+		/**
+		 * The ring buffer drained by the writer thread.
+		 **/
+		JTraceRing* ring;
+
+		/**
+		 * The event currently being serialized.
+		 **/
+		GString* event;
+	} chrome;
+
 #ifdef HAVE_OTF
 	/**
 	 * OTF-specific structure.
@@ -102,8 +217,23 @@ typedef struct JTraceThread JTraceThread;
 
 struct JTrace
 {
-	gchar* name;
+	/**
+	 * The function name.
+	 * Points to the key of the thread's summary or to name_copy.
+	 **/
+	gchar const* name;
+
+	/**
+	 * A copy of the function name if summaries are disabled.
+	 **/
+	gchar* name_copy;
+
 	guint64 enter_time;
+
+	/**
+	 * The next unused trace of the thread.
+	 **/
+	JTrace* next;
 };
 
 static JTraceFlags j_trace_flags = J_TRACE_OFF;
@@ -133,10 +263,473 @@ static void j_trace_thread_default_free(gpointer);
 
 static GPrivate j_trace_thread_default = G_PRIVATE_INIT(j_trace_thread_default_free);
 static GHashTable* j_trace_summary_table = NULL;
+static gint j_trace_summary_threads = 0;
+
+static FILE* j_trace_chrome_file = NULL;
+static GThread* j_trace_chrome_writer = NULL;
+static GList* j_trace_chrome_rings = NULL;
+static gboolean j_trace_chrome_stop = FALSE;
+static guint j_trace_chrome_dropped = 0;
+static gint j_trace_chrome_pid = 0;
+
+static GMutex j_trace_chrome_mutex;
+static GCond j_trace_chrome_cond;
 
 G_LOCK_DEFINE_STATIC(j_trace_echo);
 G_LOCK_DEFINE_STATIC(j_trace_summary);
 
+/**
+ * Returns the current time for summaries.
+ *
+ * \private
+ *
+ * \return The monotonic time in nanoseconds.
+ **/
+static guint64
+j_trace_summary_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (guint64)ts.tv_sec * 1000 * 1000 * 1000 + ts.tv_nsec;
+}
+
+/**
+ * Returns the histogram bucket of a duration.
+ *
+ * \private
+ *
+ * \param duration A duration.
+ *
+ * \return A bucket.
+ **/
+static guint
+j_trace_histogram_bucket(guint64 duration)
+{
+	guint exponent;
+
+	if (duration < J_TRACE_HISTOGRAM_SUB_BUCKETS)
+	{
+		return duration;
+	}
+
+	exponent = 63 - __builtin_clzll(duration);
+
+	if (exponent >= J_TRACE_HISTOGRAM_MAX_EXPONENT)
+	{
+		return J_TRACE_HISTOGRAM_BUCKETS - 1;
+	}
+
+	// The highest bit selects the power of two, the following bits select the sub-bucket
+	return (exponent - J_TRACE_HISTOGRAM_SUB_BITS + 1) * J_TRACE_HISTOGRAM_SUB_BUCKETS + ((duration >> (exponent - J_TRACE_HISTOGRAM_SUB_BITS)) - J_TRACE_HISTOGRAM_SUB_BUCKETS);
+}
+
+/**
+ * Returns the highest duration recorded in a histogram bucket.
+ *
+ * \private
+ *
+ * \param bucket A bucket.
+ *
+ * \return A duration.
+ **/
+static guint64
+j_trace_histogram_duration(guint bucket)
+{
+	guint exponent;
+	guint64 sub_bucket;
+
+	if (bucket < J_TRACE_HISTOGRAM_SUB_BUCKETS)
+	{
+		return bucket;
+	}
+
+	exponent = bucket / J_TRACE_HISTOGRAM_SUB_BUCKETS + J_TRACE_HISTOGRAM_SUB_BITS - 1;
+	sub_bucket = bucket % J_TRACE_HISTOGRAM_SUB_BUCKETS + J_TRACE_HISTOGRAM_SUB_BUCKETS;
+
+	return ((sub_bucket + 1) << (exponent - J_TRACE_HISTOGRAM_SUB_BITS)) - 1;
+}
+
+/**
+ * Returns a percentile of a summary's durations.
+ *
+ * \private
+ *
+ * \param summary    A summary.
+ * \param percentile A percentile between 0 and 1.
+ *
+ * \return The duration in seconds.
+ **/
+static gdouble
+j_trace_summary_percentile(JTraceSummary* summary, gdouble percentile)
+{
+	guint64 count = 0;
+	guint64 target;
+
+	target = MAX((guint64)ceil(percentile * summary->count), 1);
+
+	for (guint i = 0; i < J_TRACE_HISTOGRAM_BUCKETS; i++)
+	{
+		count += summary->histogram[i];
+
+		if (count >= target)
+		{
+			return ((gdouble)j_trace_histogram_duration(i)) / (1000.0 * 1000.0 * 1000.0);
+		}
+	}
+
+	return 0.0;
+}
+
+static void
+j_trace_summary_free(gpointer data)
+{
+	JTraceSummary* summary = data;
+
+	if (summary->children != NULL)
+	{
+		g_hash_table_unref(summary->children);
+	}
+
+	g_free(summary->name);
+	g_free(summary);
+}
+
+/**
+ * Creates a new summary.
+ *
+ * \private
+ *
+ * \param name     A call stack, which is owned by the summary afterwards.
+ * \param children Whether the summary has children.
+ *
+ * \return A new summary. Should be freed with j_trace_summary_free().
+ **/
+static JTraceSummary*
+j_trace_summary_new(gchar* name, gboolean children)
+{
+	JTraceSummary* summary;
+
+	summary = g_new0(JTraceSummary, 1);
+	summary->name = name;
+
+	if (children)
+	{
+		summary->children = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, j_trace_summary_free);
+	}
+
+	return summary;
+}
+
+/**
+ * Returns the summary of a called function, creating it if necessary.
+ *
+ * \private
+ *
+ * \param summary    A summary.
+ * \param name       A function name.
+ * \param child_key  Returns the copy of name owned by the summary.
+ *
+ * \return The called function's summary.
+ **/
+static JTraceSummary*
+j_trace_summary_get_child(JTraceSummary* summary, gchar const* name, gchar const** child_key)
+{
+	JTraceSummary* child;
+	gpointer key;
+
+	if (G_UNLIKELY(!g_hash_table_lookup_extended(summary->children, name, &key, (gpointer*)&child)))
+	{
+		gchar* child_name;
+
+		child_name = (summary->name == NULL) ? g_strdup(name) : g_strdup_printf("%s/%s", summary->name, name);
+		child = j_trace_summary_new(child_name, TRUE);
+		key = g_strdup(name);
+
+		g_hash_table_insert(summary->children, key, child);
+	}
+
+	*child_key = key;
+
+	return child;
+}
+
+/**
+ * Merges a thread's summaries into the global summary table.
+ * The j_trace_summary lock has to be held.
+ *
+ * \private
+ *
+ * \param summary A summary.
+ **/
+static void
+j_trace_summary_merge(JTraceSummary* summary)
+{
+	GHashTableIter iter;
+	JTraceSummary* child;
+
+	if (summary->count > 0)
+	{
+		JTraceSummary* merged;
+
+		if ((merged = g_hash_table_lookup(j_trace_summary_table, summary->name)) == NULL)
+		{
+			merged = j_trace_summary_new(g_strdup(summary->name), FALSE);
+			g_hash_table_insert(j_trace_summary_table, merged->name, merged);
+		}
+
+		merged->count += summary->count;
+		merged->time += summary->time;
+
+		for (guint i = 0; i < J_TRACE_HISTOGRAM_BUCKETS; i++)
+		{
+			merged->histogram[i] += summary->histogram[i];
+		}
+
+		summary->count = 0;
+		summary->time = 0;
+		memset(summary->histogram, 0, sizeof(summary->histogram));
+	}
+
+	g_hash_table_iter_init(&iter, summary->children);
+
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer*)&child))
+	{
+		j_trace_summary_merge(child);
+	}
+}
+
+/**
+ * Copies data into a ring buffer.
+ *
+ * \private
+ *
+ * \param ring     A ring buffer.
+ * \param position A write position.
+ * \param data     The data.
+ * \param length   The data's length.
+ **/
+static void
+j_trace_ring_write(JTraceRing* ring, guint position, gconstpointer data, guint length)
+{
+	guint offset;
+	guint first;
+
+	offset = position & (J_TRACE_CHROME_RING_SIZE - 1);
+	first = MIN(length, J_TRACE_CHROME_RING_SIZE - offset);
+
+	memcpy(ring->data + offset, data, first);
+	memcpy(ring->data, (gchar const*)data + first, length - first);
+}
+
+/**
+ * Copies data out of a ring buffer.
+ *
+ * \private
+ *
+ * \param ring     A ring buffer.
+ * \param position A read position.
+ * \param data     A buffer for the data.
+ * \param length   The data's length.
+ **/
+static void
+j_trace_ring_read(JTraceRing* ring, guint position, gpointer data, guint length)
+{
+	guint offset;
+	guint first;
+
+	offset = position & (J_TRACE_CHROME_RING_SIZE - 1);
+	first = MIN(length, J_TRACE_CHROME_RING_SIZE - offset);
+
+	memcpy(data, ring->data + offset, first);
+	memcpy((gchar*)data + first, ring->data, length - first);
+}
+
+/**
+ * Writes all events of a ring buffer to the trace file.
+ * Must only be called by the writer thread.
+ *
+ * \private
+ *
+ * \param ring A ring buffer.
+ **/
+static void
+j_trace_ring_drain(JTraceRing* ring)
+{
+	guint head;
+	guint tail;
+
+	head = (guint)g_atomic_int_get((gint*)&(ring->head));
+	tail = ring->tail;
+
+	while (tail != head)
+	{
+		guint32 length;
+		guint offset;
+		guint first;
+
+		j_trace_ring_read(ring, tail, &length, sizeof(length));
+		tail += sizeof(length);
+
+		offset = tail & (J_TRACE_CHROME_RING_SIZE - 1);
+		first = MIN(length, J_TRACE_CHROME_RING_SIZE - offset);
+
+		fwrite(ring->data + offset, 1, first, j_trace_chrome_file);
+		fwrite(ring->data, 1, length - first, j_trace_chrome_file);
+
+		tail += length;
+	}
+
+	g_atomic_int_set((gint*)&(ring->tail), tail);
+}
+
+static void
+j_trace_ring_free(JTraceRing* ring)
+{
+	j_trace_chrome_dropped += ring->dropped;
+
+	g_free(ring->data);
+	g_free(ring);
+}
+
+static gpointer
+j_trace_chrome_writer_thread(gpointer data)
+{
+	(void)data;
+
+	g_mutex_lock(&j_trace_chrome_mutex);
+
+	while (TRUE)
+	{
+		gboolean stop = j_trace_chrome_stop;
+		GList* ring_link = j_trace_chrome_rings;
+
+		while (ring_link != NULL)
+		{
+			JTraceRing* ring = ring_link->data;
+			GList* next = ring_link->next;
+			gboolean finished;
+
+			// Check before draining to make sure that no events are lost
+			finished = g_atomic_int_get(&(ring->finished));
+			j_trace_ring_drain(ring);
+
+			if (finished)
+			{
+				j_trace_ring_free(ring);
+				j_trace_chrome_rings = g_list_delete_link(j_trace_chrome_rings, ring_link);
+			}
+
+			ring_link = next;
+		}
+
+		fflush(j_trace_chrome_file);
+
+		if (stop)
+		{
+			break;
+		}
+
+		g_cond_wait_until(&j_trace_chrome_cond, &j_trace_chrome_mutex, g_get_monotonic_time() + 100 * G_TIME_SPAN_MILLISECOND);
+	}
+
+	g_mutex_unlock(&j_trace_chrome_mutex);
+
+	return NULL;
+}
+
+/**
+ * Appends a JSON string.
+ *
+ * \private
+ *
+ * \param event An event.
+ * \param str   A string.
+ **/
+static void
+j_trace_chrome_append_string(GString* event, gchar const* str)
+{
+	g_string_append_c(event, '"');
+
+	for (; *str != '\0'; str++)
+	{
+		if (*str == '"' || *str == '\\')
+		{
+			g_string_append_c(event, '\\');
+			g_string_append_c(event, *str);
+		}
+		else if ((guchar)*str < 0x20)
+		{
+			g_string_append_printf(event, "\\u%04x", (guint)*str);
+		}
+		else
+		{
+			g_string_append_c(event, *str);
+		}
+	}
+
+	g_string_append_c(event, '"');
+}
+
+/**
+ * Starts serializing an event.
+ *
+ * \private
+ *
+ * \param trace_thread A trace thread.
+ * \param phase        The event's phase.
+ * \param timestamp    A timestamp.
+ *
+ * \return The event.
+ **/
+static GString*
+j_trace_chrome_event_begin(JTraceThread* trace_thread, gchar const* phase, guint64 timestamp)
+{
+	GString* event = trace_thread->chrome.event;
+
+	g_string_truncate(event, 0);
+	g_string_append_printf(event, "{\"ph\":\"%s\",\"ts\":%" G_GUINT64_FORMAT ",\"pid\":%d,\"tid\":%u", phase, timestamp, j_trace_chrome_pid, trace_thread->thread_id);
+
+	return event;
+}
+
+/**
+ * Finishes serializing an event and pushes it to the thread's ring buffer.
+ * The event is dropped if the ring buffer is full.
+ *
+ * \private
+ *
+ * \param trace_thread A trace thread.
+ **/
+static void
+j_trace_chrome_event_end(JTraceThread* trace_thread)
+{
+	JTraceRing* ring = trace_thread->chrome.ring;
+	GString* event = trace_thread->chrome.event;
+	guint32 length;
+	guint head;
+	guint tail;
+
+	g_string_append(event, "},\n");
+	length = event->len;
+
+	head = ring->head;
+	tail = (guint)g_atomic_int_get((gint*)&(ring->tail));
+
+	if (sizeof(length) + length > J_TRACE_CHROME_RING_SIZE - (head - tail))
+	{
+		ring->dropped++;
+		return;
+	}
+
+	j_trace_ring_write(ring, head, &length, sizeof(length));
+	j_trace_ring_write(ring, head + sizeof(length), event->str, length);
+
+	// Publish the event only after it has been written completely
+	g_atomic_int_set((gint*)&(ring->head), head + sizeof(length) + length);
+}
+
 /**
  * Creates a new trace thread.
  *
@@ -161,19 +754,54 @@ j_trace_thread_new(GThread* thread)
 
 	trace_thread = g_new(JTraceThread, 1);
 	trace_thread->function_depth = 0;
+	trace_thread->summary = NULL;
 	trace_thread->stack = g_array_new(FALSE, FALSE, sizeof(JTraceStack));
+	trace_thread->free_traces = NULL;
+	trace_thread->chrome.ring = NULL;
+	trace_thread->chrome.event = NULL;
 
 	if (thread == NULL)
 	{
+		trace_thread->thread_id = 0;
 		trace_thread->thread_name = g_strdup("Main process");
 	}
 	else
 	{
-		guint thread_id;
-
 		/// \todo use name?
-		thread_id = g_atomic_int_add(&j_trace_thread_id, 1);
-		trace_thread->thread_name = g_strdup_printf("Thread %d", thread_id);
+		trace_thread->thread_id = g_atomic_int_add(&j_trace_thread_id, 1);
+		trace_thread->thread_name = g_strdup_printf("Thread %d", trace_thread->thread_id);
+	}
+
+	if (j_trace_flags & J_TRACE_CHROME)
+	{
+		JTraceRing* ring;
+		GString* event;
+
+		ring = g_new(JTraceRing, 1);
+		ring->data = g_malloc(J_TRACE_CHROME_RING_SIZE);
+		ring->head = 0;
+		ring->tail = 0;
+		ring->dropped = 0;
+		ring->finished = 0;
+
+		trace_thread->chrome.ring = ring;
+		trace_thread->chrome.event = g_string_sized_new(256);
+
+		g_mutex_lock(&j_trace_chrome_mutex);
+		j_trace_chrome_rings = g_list_prepend(j_trace_chrome_rings, ring);
+		g_mutex_unlock(&j_trace_chrome_mutex);
+
+		event = j_trace_chrome_event_begin(trace_thread, "M", 0);
+		g_string_append(event, ",\"name\":\"thread_name\",\"args\":{\"name\":");
+		j_trace_chrome_append_string(event, trace_thread->thread_name);
+		g_string_append_c(event, '}');
+		j_trace_chrome_event_end(trace_thread);
+	}
+
+	if (j_trace_flags & J_TRACE_SUMMARY)
+	{
+		trace_thread->summary = j_trace_summary_new(NULL, TRUE);
+		g_atomic_int_inc(&j_trace_summary_threads);
 	}
 
 #ifdef HAVE_OTF
@@ -217,6 +845,37 @@ j_trace_thread_free(JTraceThread* trace_thread)
 	}
 #endif
 
+	if (trace_thread->chrome.ring != NULL)
+	{
+		// The writer thread frees the ring buffer
+		g_atomic_int_set(&(trace_thread->chrome.ring->finished), 1);
+		g_string_free(trace_thread->chrome.event, TRUE);
+	}
+
+	if (trace_thread->summary != NULL)
+	{
+		G_LOCK(j_trace_summary);
+
+		// j_trace_fini() might already have printed and freed the summaries
+		if (j_trace_summary_table != NULL)
+		{
+			j_trace_summary_merge(trace_thread->summary);
+		}
+
+		G_UNLOCK(j_trace_summary);
+
+		g_atomic_int_dec_and_test(&j_trace_summary_threads);
+		j_trace_summary_free(trace_thread->summary);
+	}
+
+	while (trace_thread->free_traces != NULL)
+	{
+		JTrace* trace = trace_thread->free_traces;
+
+		trace_thread->free_traces = trace->next;
+		g_free(trace);
+	}
+
 	g_free(trace_thread->thread_name);
 	g_array_free(trace_thread->stack, TRUE);
 	g_free(trace_thread);
@@ -385,6 +1044,10 @@ j_trace_init(gchar const* name)
 		{
 			j_trace_flags |= J_TRACE_SUMMARY;
 		}
+		else if (g_strcmp0(trace_parts[i], "chrome") == 0)
+		{
+			j_trace_flags |= J_TRACE_CHROME;
+		}
 	}
 
 	if (j_trace_flags == J_TRACE_OFF)
@@ -430,7 +1093,36 @@ j_trace_init(gchar const* name)
 
 	if (j_trace_flags & J_TRACE_SUMMARY)
 	{
-		j_trace_summary_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+		j_trace_summary_table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, j_trace_summary_free);
+	}
+
+	if (j_trace_flags & J_TRACE_CHROME)
+	{
+		g_autofree gchar* path = NULL;
+		g_autoptr(GString) event = NULL;
+
+		j_trace_chrome_pid = getpid();
+
+		// Include the process ID to allow tracing multiple processes at once
+		path = g_strdup_printf("%s-%d.json", name, j_trace_chrome_pid);
+
+		if ((j_trace_chrome_file = fopen(path, "w")) == NULL)
+		{
+			g_warning("Could not open trace file %s.", path);
+			j_trace_flags &= ~J_TRACE_CHROME;
+		}
+		else
+		{
+			// The closing bracket is optional, which allows concatenating traces
+			event = g_string_new("[\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":");
+			g_string_append_printf(event, "%d,\"tid\":0,\"args\":{\"name\":", j_trace_chrome_pid);
+			j_trace_chrome_append_string(event, name);
+			g_string_append(event, "}},\n");
+			fwrite(event->str, 1, event->len, j_trace_chrome_file);
+
+			j_trace_chrome_stop = FALSE;
+			j_trace_chrome_writer = g_thread_new("julea-trace", j_trace_chrome_writer_thread, NULL);
+		}
 	}
 
 	g_free(j_trace_name);
@@ -467,20 +1159,76 @@ j_trace_fini(void)
 
 	if (j_trace_flags & J_TRACE_SUMMARY)
 	{
-		GHashTableIter iter;
-		gchar* key;
-		JTraceTime* value;
+		JTraceThread* trace_thread;
+		GList* names;
+		gint running;
+
+		trace_thread = g_private_get(&j_trace_thread_default);
+		running = g_atomic_int_get(&j_trace_summary_threads);
 
-		g_hash_table_iter_init(&iter, j_trace_summary_table);
+		G_LOCK(j_trace_summary);
 
-		g_printerr("# stack duration[s] count\n");
+		// Only the calling thread's summaries are merged in addition to the ones published by exited threads
+		// Other threads might still be modifying their summaries
+		if (trace_thread != NULL && trace_thread->summary != NULL)
+		{
+			j_trace_summary_merge(trace_thread->summary);
+			running--;
+		}
 
-		while (g_hash_table_iter_next(&iter, (gpointer*)&key, (gpointer*)&value))
+		if (running > 0)
 		{
-			g_printerr("%s %f %d\n", key, value->time, value->count);
+			g_printerr("# %d threads are still running, their calls are not included\n", running);
 		}
 
+		names = g_list_sort(g_hash_table_get_keys(j_trace_summary_table), (GCompareFunc)g_strcmp0);
+
+		g_printerr("# stack duration[s] count p50[s] p99[s] p999[s]\n");
+
+		for (GList* l = names; l != NULL; l = l->next)
+		{
+			JTraceSummary* summary;
+
+			summary = g_hash_table_lookup(j_trace_summary_table, l->data);
+
+			g_printerr("%s %f %" G_GUINT64_FORMAT " %f %f %f\n", summary->name, ((gdouble)summary->time) / (1000.0 * 1000.0 * 1000.0), summary->count, j_trace_summary_percentile(summary, 0.5), j_trace_summary_percentile(summary, 0.99), j_trace_summary_percentile(summary, 0.999));
+		}
+
+		g_list_free(names);
 		g_hash_table_unref(j_trace_summary_table);
+		j_trace_summary_table = NULL;
+
+		G_UNLOCK(j_trace_summary);
+	}
+
+	if (j_trace_flags & J_TRACE_CHROME)
+	{
+		g_mutex_lock(&j_trace_chrome_mutex);
+		j_trace_chrome_stop = TRUE;
+		g_cond_signal(&j_trace_chrome_cond);
+		g_mutex_unlock(&j_trace_chrome_mutex);
+
+		g_thread_join(j_trace_chrome_writer);
+		j_trace_chrome_writer = NULL;
+
+		// The ring buffers of running threads are not freed because they might still be referenced
+		for (GList* l = j_trace_chrome_rings; l != NULL; l = l->next)
+		{
+			JTraceRing* ring = l->data;
+
+			j_trace_chrome_dropped += ring->dropped;
+		}
+
+		g_list_free(j_trace_chrome_rings);
+		j_trace_chrome_rings = NULL;
+
+		if (j_trace_chrome_dropped > 0)
+		{
+			g_warning("Dropped %u trace events because ring buffers were full.", j_trace_chrome_dropped);
+		}
+
+		fclose(j_trace_chrome_file);
+		j_trace_chrome_file = NULL;
 	}
 
 	j_trace_flags = J_TRACE_OFF;
@@ -505,7 +1253,7 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 	JTraceThread* trace_thread;
 	JTrace* trace;
 	guint64 timestamp;
-	va_list args;
+	g_autofree gchar* arguments = NULL;
 
 	if (j_trace_flags == J_TRACE_OFF)
 	{
@@ -524,22 +1272,36 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 
 	timestamp = g_get_real_time();
 
-	trace = g_new(JTrace, 1);
-	trace->name = g_strdup(name);
+	// Traces are reused to avoid allocating memory for every call
+	if (G_LIKELY((trace = trace_thread->free_traces) != NULL))
+	{
+		trace_thread->free_traces = trace->next;
+	}
+	else
+	{
+		trace = g_new(JTrace, 1);
+	}
+
+	trace->name = NULL;
+	trace->name_copy = NULL;
 	trace->enter_time = timestamp;
 
-	va_start(args, format);
+	if (format != NULL && j_trace_flags & (J_TRACE_ECHO | J_TRACE_CHROME))
+	{
+		va_list args;
+
+		va_start(args, format);
+		arguments = g_strdup_vprintf(format, args);
+		va_end(args);
+	}
 
 	if (j_trace_flags & J_TRACE_ECHO)
 	{
 		G_LOCK(j_trace_echo);
 		j_trace_echo_printerr(trace_thread, timestamp);
 
-		if (format != NULL)
+		if (arguments != NULL)
 		{
-			g_autofree gchar* arguments = NULL;
-
-			arguments = g_strdup_vprintf(format, args);
 			g_printerr("ENTER %s (%s)\n", name, arguments);
 		}
 		else
@@ -576,27 +1338,45 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 	}
 #endif
 
-	if (j_trace_flags & J_TRACE_SUMMARY)
+	if (j_trace_flags & J_TRACE_SUMMARY && trace_thread->summary != NULL)
 	{
 		JTraceStack current_stack;
+		JTraceSummary* parent = trace_thread->summary;
 
-		if (trace_thread->stack->len == 0)
+		if (trace_thread->stack->len > 0)
 		{
-			current_stack.name = g_strdup(name);
+			parent = g_array_index(trace_thread->stack, JTraceStack, trace_thread->stack->len - 1).summary;
 		}
-		else
-		{
-			JTraceStack* top_stack;
 
-			top_stack = &g_array_index(trace_thread->stack, JTraceStack, trace_thread->stack->len - 1);
-			current_stack.name = g_strdup_printf("%s/%s", top_stack->name, name);
-		}
-
-		current_stack.enter_time = timestamp;
+		// Only the first call of a call stack allocates memory
+		current_stack.summary = j_trace_summary_get_child(parent, name, &(trace->name));
+		current_stack.enter_time = j_trace_summary_time();
 		g_array_append_val(trace_thread->stack, current_stack);
 	}
 
-	va_end(args);
+	if (trace->name == NULL)
+	{
+		trace->name_copy = g_strdup(name);
+		trace->name = trace->name_copy;
+	}
+
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
+
+		event = j_trace_chrome_event_begin(trace_thread, "B", timestamp);
+		g_string_append(event, ",\"name\":");
+		j_trace_chrome_append_string(event, name);
+
+		if (arguments != NULL)
+		{
+			g_string_append(event, ",\"args\":{\"arguments\":");
+			j_trace_chrome_append_string(event, arguments);
+			g_string_append_c(event, '}');
+		}
+
+		j_trace_chrome_event_end(trace_thread);
+	}
 
 	trace_thread->function_depth++;
 
@@ -606,7 +1386,7 @@ j_trace_enter(gchar const* name, gchar const* format, ...)
 void
 j_trace_leave(JTrace* trace)
 {
-	JTraceThread* trace_thread;
+	JTraceThread* trace_thread = NULL;
 	guint64 timestamp;
 
 	if (trace == NULL)
@@ -666,44 +1446,43 @@ j_trace_leave(JTrace* trace)
 	}
 #endif
 
-	if (j_trace_flags & J_TRACE_SUMMARY)
+	if (j_trace_flags & J_TRACE_SUMMARY && trace_thread->summary != NULL && trace_thread->stack->len > 0)
 	{
-		JTraceTime* combined_duration;
 		JTraceStack* top_stack;
 		guint64 duration;
 
-		g_assert(trace_thread->stack->len > 0);
-
 		top_stack = &g_array_index(trace_thread->stack, JTraceStack, trace_thread->stack->len - 1);
-		duration = timestamp - top_stack->enter_time;
-
-		G_LOCK(j_trace_summary);
-
-		combined_duration = g_hash_table_lookup(j_trace_summary_table, top_stack->name);
+		duration = j_trace_summary_time() - top_stack->enter_time;
 
-		if (combined_duration == NULL)
-		{
-			combined_duration = g_new(JTraceTime, 1);
-			combined_duration->time = ((gdouble)duration) / ((gdouble)G_USEC_PER_SEC);
-			combined_duration->count = 1;
+		top_stack->summary->count++;
+		top_stack->summary->time += duration;
+		top_stack->summary->histogram[j_trace_histogram_bucket(duration)]++;
 
-			g_hash_table_insert(j_trace_summary_table, g_strdup(top_stack->name), combined_duration);
-		}
-		else
-		{
-			combined_duration->time += ((gdouble)duration) / ((gdouble)G_USEC_PER_SEC);
-			combined_duration->count++;
-		}
+		g_array_set_size(trace_thread->stack, trace_thread->stack->len - 1);
+	}
 
-		G_UNLOCK(j_trace_summary);
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
 
-		g_free(top_stack->name);
-		g_array_set_size(trace_thread->stack, trace_thread->stack->len - 1);
+		event = j_trace_chrome_event_begin(trace_thread, "E", timestamp);
+		g_string_append(event, ",\"name\":");
+		j_trace_chrome_append_string(event, trace->name);
+		j_trace_chrome_event_end(trace_thread);
 	}
 
 end:
-	g_free(trace->name);
-	g_free(trace);
+	g_free(trace->name_copy);
+
+	if (trace_thread != NULL)
+	{
+		trace->next = trace_thread->free_traces;
+		trace_thread->free_traces = trace;
+	}
+	else
+	{
+		g_free(trace);
+	}
 }
 
 void
@@ -756,6 +1535,17 @@ j_trace_file_begin(gchar const* path, JTraceFileOperation op)
 	}
 #endif
 
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
+
+		event = j_trace_chrome_event_begin(trace_thread, "B", timestamp);
+		g_string_append_printf(event, ",\"cat\":\"file\",\"name\":\"%s\",\"args\":{\"path\":", j_trace_file_operation_name(op));
+		j_trace_chrome_append_string(event, path);
+		g_string_append_c(event, '}');
+		j_trace_chrome_event_end(trace_thread);
+	}
+
 	return;
 }
 
@@ -841,6 +1631,21 @@ j_trace_file_end(gchar const* path, JTraceFileOperation op, guint64 length, guin
 		OTF_Writer_writeEndFileOperation(otf_writer, timestamp, trace_thread->otf.process_id, file_id, 1, 0, otf_op, length, 0);
 	}
 #endif
+
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
+
+		event = j_trace_chrome_event_begin(trace_thread, "E", timestamp);
+		g_string_append_printf(event, ",\"cat\":\"file\",\"name\":\"%s\"", j_trace_file_operation_name(op));
+
+		if (op == J_TRACE_FILE_READ || op == J_TRACE_FILE_WRITE)
+		{
+			g_string_append_printf(event, ",\"args\":{\"length\":%" G_GUINT64_FORMAT ",\"offset\":%" G_GUINT64_FORMAT "}", length, offset);
+		}
+
+		j_trace_chrome_event_end(trace_thread);
+	}
 }
 
 void
@@ -892,6 +1697,50 @@ j_trace_counter(gchar const* name, guint64 counter_value)
 		OTF_Writer_writeCounter(otf_writer, timestamp, trace_thread->otf.process_id, counter_id, counter_value);
 	}
 #endif
+
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
+
+		event = j_trace_chrome_event_begin(trace_thread, "C", timestamp);
+		g_string_append(event, ",\"name\":");
+		j_trace_chrome_append_string(event, name);
+		g_string_append_printf(event, ",\"args\":{\"value\":%" G_GUINT64_FORMAT "}", counter_value);
+		j_trace_chrome_event_end(trace_thread);
+	}
+}
+
+void
+j_trace_message(JTraceMessageOperation op, guint32 id)
+{
+	JTraceThread* trace_thread;
+	guint64 timestamp;
+
+	if (j_trace_flags == J_TRACE_OFF)
+	{
+		return;
+	}
+
+	trace_thread = j_trace_thread_get_default();
+	timestamp = g_get_real_time();
+
+	if (j_trace_flags & J_TRACE_ECHO)
+	{
+		G_LOCK(j_trace_echo);
+		j_trace_echo_printerr(trace_thread, timestamp);
+		g_printerr("%s message %u\n", (op == J_TRACE_MESSAGE_SEND) ? "SEND" : "RECEIVE", id);
+		G_UNLOCK(j_trace_echo);
+	}
+
+	if (j_trace_flags & J_TRACE_CHROME && trace_thread->chrome.ring != NULL)
+	{
+		GString* event;
+
+		// Flow events connect the sender's and the receiver's slices, even across processes
+		event = j_trace_chrome_event_begin(trace_thread, (op == J_TRACE_MESSAGE_SEND) ? "s" : "f", timestamp);
+		g_string_append_printf(event, ",\"cat\":\"message\",\"name\":\"message\",\"id\":%u,\"bp\":\"e\"", id);
+		j_trace_chrome_event_end(trace_thread);
+	}
 }
 
 /**
@@ -0,0 +1,199 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ **/
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <jvector.h>
+
+#include <jslab.h>
+#include <jtrace.h>
+
+/**
+ * \addtogroup JVector Vector
+ *
+ * @{
+ **/
+
+/**
+ * The number of elements allocated when appending to an empty vector.
+ **/
+#define J_VECTOR_MIN_SIZE 8
+
+JVector*
+j_vector_new(JVectorFreeFunc free_func)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JVector* vector;
+
+	vector = j_slab_new(JVector);
+	vector->data = NULL;
+	vector->length = 0;
+	vector->size = 0;
+	vector->free_func = free_func;
+	vector->slice = FALSE;
+
+	return vector;
+}
+
+void
+j_vector_free(JVector* vector)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(!vector->slice);
+
+	j_vector_delete_all(vector);
+
+	g_free(vector->data);
+	j_slab_delete(JVector, vector);
+}
+
+void
+j_vector_slice(JVector* slice, JVector const* vector, guint offset, guint length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(slice != NULL);
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(offset + length <= vector->length);
+
+	slice->data = vector->data + offset;
+	slice->length = length;
+	slice->size = length;
+	slice->free_func = NULL;
+	slice->slice = TRUE;
+}
+
+void
+j_vector_append(JVector* vector, gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(!vector->slice);
+
+	if (vector->length == vector->size)
+	{
+		vector->size = MAX(J_VECTOR_MIN_SIZE, vector->size * 2);
+		vector->data = g_renew(gpointer, vector->data, vector->size);
+	}
+
+	vector->data[vector->length] = data;
+	vector->length++;
+}
+
+void
+j_vector_set_length(JVector* vector, guint length)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(!vector->slice);
+
+	if (length > vector->size)
+	{
+		vector->size = MAX(J_VECTOR_MIN_SIZE, length);
+		vector->data = g_renew(gpointer, vector->data, vector->size);
+	}
+
+	for (guint i = length; i < vector->length; i++)
+	{
+		if (vector->free_func != NULL)
+		{
+			vector->free_func(vector->data[i]);
+		}
+	}
+
+	for (guint i = vector->length; i < length; i++)
+	{
+		vector->data[i] = NULL;
+	}
+
+	vector->length = length;
+}
+
+void
+j_vector_set(JVector* vector, guint index, gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(!vector->slice);
+	g_return_if_fail(index < vector->length);
+
+	vector->data[index] = data;
+}
+
+gpointer
+j_vector_get_first(JVector const* vector)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(vector != NULL, NULL);
+
+	if (vector->length == 0)
+	{
+		return NULL;
+	}
+
+	return vector->data[0];
+}
+
+void
+j_vector_delete_all(JVector* vector)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(vector != NULL);
+	g_return_if_fail(!vector->slice);
+
+	if (vector->free_func != NULL)
+	{
+		for (guint i = 0; i < vector->length; i++)
+		{
+			vector->free_func(vector->data[i]);
+		}
+	}
+
+	vector->length = 0;
+}
+
+void
+j_vector_iterator_init(JVectorIterator* iterator, JVector const* vector)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(iterator != NULL);
+	g_return_if_fail(vector != NULL);
+
+	iterator->vector = vector;
+	iterator->index = 0;
+	iterator->current = NULL;
+}
+
+/**
+ * @}
+ **/
@@ -56,6 +56,18 @@ sql_generic_init(JSQLSpecifics* specifics)
 		goto _error;
 	}
 
+	// Stores the field used to distribute a schema's entries across multiple servers, see j_db_schema_set_shard_key()
+	if (G_UNLIKELY(!specs->func.sql_exec(connection,
+					     "CREATE TABLE IF NOT EXISTS schema_shard_key ("
+					     "namespace VARCHAR(255),"
+					     "name VARCHAR(255),"
+					     "varname VARCHAR(255)"
+					     ")",
+					     NULL)))
+	{
+		goto _error;
+	}
+
 	ret = TRUE;
 
 _error:
@@ -31,12 +31,15 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 	gboolean equals;
 	guint counter = 0;
 	gboolean found_index = FALSE;
+	gchar const* shard_key = NULL;
 	JDBTypeValue value;
 	bson_iter_t iter;
 	JSqlBatch* batch = _batch;
 	JThreadVariables* thread_variables = NULL;
 	JSqlStatement* metadata_insert_query = NULL;
+	JSqlStatement* shard_key_insert_query = NULL;
 	const gchar* metadata_insert_sql = "INSERT INTO schema_structure(namespace, name, varname, vartype) VALUES (?, ?, ?, ?)";
+	const gchar* shard_key_insert_sql = "INSERT INTO schema_shard_key(namespace, name, varname) VALUES (?, ?, ?)";
 	g_autoptr(GString) create_sql = g_string_new(NULL);
 
 	g_return_val_if_fail(name != NULL, FALSE);
@@ -74,6 +77,30 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 		}
 	}
 
+	shard_key_insert_query = g_hash_table_lookup(thread_variables->query_cache, shard_key_insert_sql);
+
+	if (!shard_key_insert_query)
+	{
+		g_autoptr(GArray) arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+
+		if (!(shard_key_insert_query = j_sql_statement_new(shard_key_insert_sql, arr_types_in, NULL, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(shard_key_insert_sql), shard_key_insert_query))
+		{
+			// in all other error cases shard_key_insert_query is already owned by the hash table
+			j_sql_statement_free(shard_key_insert_query);
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!_backend_batch_execute(backend_data, batch, error)))
 	{
 		//no ddl in transaction - most databases won't support that - continue without any open transaction
@@ -109,6 +136,22 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 		if (equals)
 		{
 			found_index = TRUE;
+			continue;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_key_equals(&iter, "_shard_key", &equals, error)))
+		{
+			goto _error;
+		}
+
+		if (equals)
+		{
+			if (G_UNLIKELY(!j_bson_iter_value(&iter, J_DB_TYPE_STRING, &value, error)))
+			{
+				goto _error;
+			}
+
+			shard_key = value.val_string;
 		}
 		else
 		{
@@ -315,6 +358,14 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 			goto _error;
 		}
 
+		if (!equals)
+		{
+			if (G_UNLIKELY(!j_bson_iter_key_equals(&iter, "_shard_key", &equals, error)))
+			{
+				goto _error;
+			}
+		}
+
 		if (!equals)
 		{
 			value.val_string = batch->namespace;
@@ -360,6 +411,35 @@ sql_generic_schema_create(gpointer backend_data, gpointer _batch, gchar const* n
 		}
 	}
 
+	if (shard_key != NULL)
+	{
+		value.val_string = batch->namespace;
+
+		if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_insert_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		value.val_string = name;
+
+		if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_insert_query->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		value.val_string = shard_key;
+
+		if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_insert_query->stmt, 3, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!specs->func.statement_step_and_reset_check_done(thread_variables->db_connection, shard_key_insert_query->stmt, error)))
+		{
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!_backend_batch_start(backend_data, batch, error)))
 	{
 		goto _error;
@@ -389,7 +469,9 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 	JSqlBatch* batch = _batch;
 	g_autoptr(GString) table_drop_sql = NULL;
 	JSqlStatement* metadata_delete_query = NULL;
+	JSqlStatement* shard_key_delete_query = NULL;
 	const gchar* metadata_delete_sql = "DELETE FROM schema_structure WHERE namespace=? AND name=?";
+	const gchar* shard_key_delete_sql = "DELETE FROM schema_shard_key WHERE namespace=? AND name=?";
 
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(batch != NULL, FALSE);
@@ -426,6 +508,30 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 		}
 	}
 
+	shard_key_delete_query = g_hash_table_lookup(thread_variables->query_cache, shard_key_delete_sql);
+
+	if (!shard_key_delete_query)
+	{
+		JDBType type;
+		g_autoptr(GArray) arr_types_in = NULL;
+		arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+
+		if (!(shard_key_delete_query = j_sql_statement_new(shard_key_delete_sql, arr_types_in, NULL, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(shard_key_delete_sql), shard_key_delete_query))
+		{
+			// in all other error cases shard_key_delete_query is already owned by the hash table
+			j_sql_statement_free(shard_key_delete_query);
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!_backend_batch_execute(backend_data, batch, error)))
 	{
 		//no ddl in transaction - most databases wont support that - continue without any open transaction
@@ -451,6 +557,25 @@ sql_generic_schema_delete(gpointer backend_data, gpointer _batch, gchar const* n
 		goto _error;
 	}
 
+	value.val_string = batch->namespace;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_delete_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = name;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_delete_query->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_step_and_reset_check_done(thread_variables->db_connection, shard_key_delete_query->stmt, error)))
+	{
+		goto _error;
+	}
+
 	if (G_UNLIKELY(!specs->func.sql_exec(thread_variables->db_connection, table_drop_sql->str, error)))
 	{
 		goto _error;
@@ -261,6 +261,295 @@ _error2:
 	return FALSE;
 }
 
+/**
+ * SQLite only supports 999 variables per statement in versions before 3.32.0.
+ * Multi-row inserts are split accordingly.
+ **/
+#define J_SQL_MAX_VARIABLES 999
+
+/**
+ * Appends the quoted column names of an entry to \p sql and their types to \p types.
+ *
+ * \param batch   A batch.
+ * \param name    The schema name.
+ * \param schema  The schema.
+ * \param entry   An iterator over the entry.
+ * \param sql     The column list.
+ * \param types   The column types.
+ * \param[out] error An uninitialized GError* for error code passing.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+build_insert_columns(JSqlBatch* batch, gchar const* name, GHashTable* schema, bson_iter_t const* entry, GString* sql, GArray* types, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t iter = *entry;
+
+	while (TRUE)
+	{
+		g_autoptr(GString) full_name = NULL;
+		gchar const* field;
+		gboolean has_next;
+		JDBType type;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			return FALSE;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY(!(field = j_bson_iter_key(&iter, error))))
+		{
+			return FALSE;
+		}
+
+		full_name = j_sql_get_full_field_name(batch->namespace, name, field);
+		type = GPOINTER_TO_INT(g_hash_table_lookup(schema, full_name->str));
+
+		if (types->len > 0)
+		{
+			g_string_append(sql, ", ");
+		}
+
+		g_string_append_printf(sql, "%s%s%s", specs->sql.quote, field, specs->sql.quote);
+		g_array_append_val(types, type);
+	}
+
+	if (G_UNLIKELY(types->len == 0))
+	{
+		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_NO_VARIABLE_SET, "no variable set");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Inserts multiple entries with the same columns using a single statement.
+ *
+ * \param thread_variables The thread-local variables.
+ * \param batch   A batch.
+ * \param name    The schema name.
+ * \param columns The column list shared by all entries.
+ * \param types   The column types.
+ * \param first   An iterator positioned before the first entry.
+ * \param count   The number of entries.
+ * \param[out] error An uninitialized GError* for error code passing.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+insert_rows(JThreadVariables* thread_variables, JSqlBatch* batch, gchar const* name, GString const* columns, GArray const* types, bson_iter_t const* first, guint count, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JSqlStatement* insert_query;
+	bson_iter_t iter = *first;
+	guint position = 0;
+	g_autoptr(GString) insert_sql = g_string_new(NULL);
+
+	g_string_append_printf(insert_sql, "INSERT INTO %s%s_%s%s (%s) VALUES", specs->sql.quote, batch->namespace, name, specs->sql.quote, columns->str);
+
+	for (guint i = 0; i < count; i++)
+	{
+		g_string_append(insert_sql, (i == 0) ? " ( ?" : ", ( ?");
+
+		for (guint j = 1; j < types->len; j++)
+		{
+			g_string_append(insert_sql, ", ?");
+		}
+
+		g_string_append(insert_sql, " )");
+	}
+
+	insert_query = g_hash_table_lookup(thread_variables->query_cache, insert_sql->str);
+
+	if (!insert_query)
+	{
+		g_autoptr(GArray) arr_types_in = NULL;
+
+		arr_types_in = g_array_sized_new(FALSE, FALSE, sizeof(JDBType), count * types->len);
+
+		for (guint i = 0; i < count; i++)
+		{
+			g_array_append_vals(arr_types_in, types->data, types->len);
+		}
+
+		if (!(insert_query = j_sql_statement_new(insert_sql->str, arr_types_in, NULL, NULL, NULL, error)))
+		{
+			return FALSE;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(insert_sql->str), insert_query))
+		{
+			// in all other error cases insert_query is already owned by the hash table
+			j_sql_statement_free(insert_query);
+			return FALSE;
+		}
+	}
+
+	// bind the values of all rows, every column is set because all entries have the same columns
+	for (guint i = 0; i < count; i++)
+	{
+		bson_iter_t row;
+		gboolean has_next;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			return FALSE;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &row, error)))
+		{
+			return FALSE;
+		}
+
+		for (guint j = 0; j < types->len; j++)
+		{
+			JDBType type = g_array_index(types, JDBType, j);
+			JDBTypeValue value;
+
+			if (G_UNLIKELY(!j_bson_iter_next(&row, &has_next, error)))
+			{
+				return FALSE;
+			}
+
+			if (G_UNLIKELY(!j_bson_iter_value(&row, type, &value, error)))
+			{
+				return FALSE;
+			}
+
+			// increment first s.t. position starts at 1 for in-variables
+			position++;
+
+			if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, insert_query->stmt, position, type, &value, error)))
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return specs->func.statement_step_and_reset_check_done(thread_variables->db_connection, insert_query->stmt, error);
+}
+
+gboolean
+sql_generic_insert_many(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* entries, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t iter;
+	bson_iter_t first;
+	guint count = 0;
+	JThreadVariables* thread_variables = NULL;
+	g_autoptr(GHashTable) schema = NULL;
+	JSqlBatch* batch = _batch;
+	g_autoptr(GString) columns = g_string_new(NULL);
+	g_autoptr(GString) entry_columns = g_string_new(NULL);
+	g_autoptr(GArray) types = NULL;
+	g_autoptr(GArray) entry_types = NULL;
+
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(entries != NULL, FALSE);
+
+	types = g_array_new(FALSE, FALSE, sizeof(JDBType));
+	entry_types = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+	if (G_UNLIKELY(!(thread_variables = thread_variables_get(backend_data, error))))
+	{
+		goto _error;
+	}
+
+	if (!(schema = get_schema(backend_data, batch->namespace, name, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!j_bson_iter_init(&iter, entries, error)))
+	{
+		goto _error;
+	}
+
+	// Consecutive entries with the same columns are inserted using multi-row statements.
+	while (TRUE)
+	{
+		bson_iter_t position = iter;
+		bson_iter_t entry;
+		gboolean has_next;
+
+		if (G_UNLIKELY(!j_bson_iter_next(&iter, &has_next, error)))
+		{
+			goto _error;
+		}
+
+		if (!has_next)
+		{
+			break;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_recurse_document(&iter, &entry, error)))
+		{
+			goto _error;
+		}
+
+		g_string_truncate(entry_columns, 0);
+		g_array_set_size(entry_types, 0);
+
+		if (G_UNLIKELY(!build_insert_columns(batch, name, schema, &entry, entry_columns, entry_types, error)))
+		{
+			goto _error;
+		}
+
+		if (count > 0 && (!g_string_equal(columns, entry_columns) || (count + 1) * types->len > J_SQL_MAX_VARIABLES))
+		{
+			if (G_UNLIKELY(!insert_rows(thread_variables, batch, name, columns, types, &first, count, error)))
+			{
+				goto _error;
+			}
+
+			count = 0;
+		}
+
+		if (count == 0)
+		{
+			first = position;
+			g_string_assign(columns, entry_columns->str);
+			g_array_set_size(types, 0);
+			g_array_append_vals(types, entry_types->data, entry_types->len);
+		}
+
+		count++;
+	}
+
+	if (count > 0)
+	{
+		if (G_UNLIKELY(!insert_rows(thread_variables, batch, name, columns, types, &first, count, error)))
+		{
+			goto _error;
+		}
+	}
+
+	return TRUE;
+
+_error:
+	if (G_UNLIKELY(!_backend_batch_abort(backend_data, batch, NULL)))
+	{
+		goto _error2;
+	}
+
+	return FALSE;
+
+_error2:
+	/*something failed very hard*/
+	return FALSE;
+}
+
 gboolean
 sql_generic_update(gpointer backend_data, gpointer _batch, gchar const* name, bson_t const* selector, bson_t const* entry_updates, GError** error)
 {
@@ -284,6 +284,110 @@ _error:
 	return NULL;
 }
 
+/**
+ * Appends a schema's shard key to its description, if it has one.
+ *
+ * \param backend_data The backend data.
+ * \param namespace    The namespace.
+ * \param name         The schema's name.
+ * \param schema       The schema's description.
+ * \param error        A GError.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+_backend_schema_get_shard_key(gpointer backend_data, gchar const* namespace, gchar const* name, bson_t* schema, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBTypeValue value;
+	gboolean sql_found;
+	JThreadVariables* thread_variables = NULL;
+	JSqlStatement* shard_key_query = NULL;
+	const gchar* shard_key_query_sql = "SELECT varname FROM schema_shard_key WHERE namespace=? AND name=?";
+
+	if (G_UNLIKELY(!(thread_variables = thread_variables_get(backend_data, error))))
+	{
+		goto _error;
+	}
+
+	shard_key_query = g_hash_table_lookup(thread_variables->query_cache, shard_key_query_sql);
+
+	if (G_UNLIKELY(!shard_key_query))
+	{
+		JDBType type;
+
+		g_autoptr(GArray) arr_types_in = NULL;
+		g_autoptr(GArray) arr_types_out = NULL;
+		arr_types_in = g_array_new(FALSE, FALSE, sizeof(JDBType));
+		arr_types_out = g_array_new(FALSE, FALSE, sizeof(JDBType));
+
+		type = J_DB_TYPE_STRING;
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_in, type);
+		g_array_append_val(arr_types_out, type);
+
+		if (!(shard_key_query = j_sql_statement_new(shard_key_query_sql, arr_types_in, arr_types_out, NULL, NULL, error)))
+		{
+			goto _error;
+		}
+
+		if (!g_hash_table_insert(thread_variables->query_cache, g_strdup(shard_key_query_sql), shard_key_query))
+		{
+			// in all other error cases shard_key_query is already owned by the hash table
+			j_sql_statement_free(shard_key_query);
+			goto _error;
+		}
+	}
+
+	value.val_string = namespace;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_query->stmt, 1, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	value.val_string = name;
+
+	if (G_UNLIKELY(!specs->func.statement_bind_value(thread_variables->db_connection, shard_key_query->stmt, 2, J_DB_TYPE_STRING, &value, error)))
+	{
+		goto _error;
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_step(thread_variables->db_connection, shard_key_query->stmt, &sql_found, error)))
+	{
+		goto _error;
+	}
+
+	if (sql_found)
+	{
+		if (G_UNLIKELY(!specs->func.statement_column(thread_variables->db_connection, shard_key_query->stmt, 0, J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_append_value(schema, "_shard_key", J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+	}
+
+	if (G_UNLIKELY(!specs->func.statement_reset(thread_variables->db_connection, shard_key_query->stmt, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	if (thread_variables != NULL && shard_key_query != NULL)
+	{
+		specs->func.statement_reset(thread_variables->db_connection, shard_key_query->stmt, NULL);
+	}
+
+	return FALSE;
+}
+
 gboolean
 sql_generic_schema_get(gpointer backend_data, gpointer _batch, gchar const* name, bson_t* schema, GError** error)
 {
@@ -294,6 +398,12 @@ sql_generic_schema_get(gpointer backend_data, gpointer _batch, gchar const* name
 
 	ret = _backend_schema_get(backend_data, batch->namespace, name, schema, error);
 
+	if (ret && schema != NULL && !_backend_schema_get_shard_key(backend_data, batch->namespace, name, schema, error))
+	{
+		j_bson_destroy(schema);
+		ret = FALSE;
+	}
+
 	if (!ret)
 	{
 		_backend_batch_abort(backend_data, _batch, NULL);
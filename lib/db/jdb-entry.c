@@ -190,6 +190,26 @@ _error:
 	return FALSE;
 }
 
+gboolean
+j_db_entry_insert_bulk(JDBEntry* entry, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_val_if_fail(entry != NULL, FALSE);
+	g_return_val_if_fail(batch != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (G_UNLIKELY(!j_db_internal_insert_many(entry, batch, error)))
+	{
+		goto _error;
+	}
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
 gboolean
 j_db_entry_update(JDBEntry* entry, JDBSelector* selector, JBatch* batch, GError** error)
 {
@@ -212,6 +232,13 @@ j_db_entry_update(JDBEntry* entry, JDBSelector* selector, JBatch* batch, GError*
 		goto _error;
 	}
 
+	// Changing the shard key would require moving the entries to another server.
+	if (G_UNLIKELY(entry->schema->shard_key != NULL && bson_has_field(&entry->bson, entry->schema->shard_key)))
+	{
+		g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_SHARD_KEY_IMMUTABLE, "shard key must not be updated");
+		goto _error;
+	}
+
 	if (G_UNLIKELY(!j_db_internal_update(entry, selector, batch, error)))
 	{
 		goto _error;
@@ -34,15 +34,74 @@
 #include <julea.h>
 #include <julea-db.h>
 
+/**
+ * A server-side cursor holding the remaining rows of a query result.
+ **/
+struct JDBCursor
+{
+	/**
+	 * The index of the DB server.
+	 **/
+	guint32 server;
+
+	/**
+	 * The cursor's ID.
+	 **/
+	guint64 id;
+};
+
+typedef struct JDBCursor JDBCursor;
+
 struct JDBIteratorHelper
 {
+	/**
+	 * The current page of the query result.
+	 **/
 	bson_t bson;
 	bson_iter_t iter;
 	gboolean initialized;
+
+	/**
+	 * The cursors that still have rows, see JDBCursor.
+	 * Their pages are fetched in order once the current page has been consumed.
+	 **/
+	GArray* cursors;
+
+	/**
+	 * The index of the DB server that returned the current page.
+	 * J_DB_ALL_SERVERS if the page's IDs are already globally unique.
+	 **/
+	gint server;
+
+	/**
+	 * The name of the ID field in the query result if IDs have to be made globally unique, NULL otherwise.
+	 **/
+	gchar* id_key;
 };
 
 typedef struct JDBIteratorHelper JDBIteratorHelper;
 
+/**
+ * A DB operation and the server it has to be sent to.
+ * The backend operation has to be the first member because the operation's data is also used as a JBackendOperation.
+ **/
+struct JDBOperation
+{
+	JBackendOperation backend_operation;
+
+	/**
+	 * The index of the DB server or J_DB_ALL_SERVERS.
+	 **/
+	gint server;
+
+	/**
+	 * The iterator helper of a query, NULL for all other operations.
+	 **/
+	JDBIteratorHelper* helper;
+};
+
+typedef struct JDBOperation JDBOperation;
+
 GQuark
 j_db_error_quark(void)
 {
@@ -51,86 +110,576 @@ j_db_error_quark(void)
 	return g_quark_from_static_string("j-db-error-quark");
 }
 
+static guint32
+j_db_internal_get_server_count(void)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_DB);
+}
+
+/**
+ * Returns the server that stores a schema.
+ * All schemas of a namespace are stored on the same server to allow joins.
+ *
+ * \param schema A schema.
+ *
+ * \return The server's index.
+ **/
+static gint
+j_db_internal_get_home_server(JDBSchema* schema)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return j_helper_hash(schema->namespace) % j_db_internal_get_server_count();
+}
+
+/**
+ * Returns the server that stores entries with the given shard key value.
+ *
+ * \param iter A BSON iterator pointing to the shard key value.
+ *
+ * \return The server's index.
+ **/
+static gint
+j_db_internal_get_value_server(bson_iter_t const* iter)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_value_t const* value;
+	guint8 const* bytes = NULL;
+	gsize length = 0;
+	guint32 hash = 5381;
+
+	value = bson_iter_value((bson_iter_t*)iter);
+
+	switch (value->value_type)
+	{
+		case BSON_TYPE_UTF8:
+			bytes = (guint8 const*)value->value.v_utf8.str;
+			length = value->value.v_utf8.len;
+			break;
+		case BSON_TYPE_BINARY:
+			bytes = value->value.v_binary.data;
+			length = value->value.v_binary.data_len;
+			break;
+		case BSON_TYPE_INT32:
+			bytes = (guint8 const*)&(value->value.v_int32);
+			length = sizeof(value->value.v_int32);
+			break;
+		case BSON_TYPE_INT64:
+			bytes = (guint8 const*)&(value->value.v_int64);
+			length = sizeof(value->value.v_int64);
+			break;
+		case BSON_TYPE_DOUBLE:
+			bytes = (guint8 const*)&(value->value.v_double);
+			length = sizeof(value->value.v_double);
+			break;
+		default:
+			break;
+	}
+
+	// Same as j_helper_hash() but for arbitrary data.
+	for (gsize i = 0; i < length; i++)
+	{
+		hash = ((hash << 5) + hash) + bytes[i];
+	}
+
+	return hash % j_db_internal_get_server_count();
+}
+
+/**
+ * Returns whether the IDs of a schema's entries have to be made globally unique.
+ * This is only necessary if the entries are distributed across multiple servers, not if the backend is used directly.
+ *
+ * \param schema A schema.
+ *
+ * \return TRUE if IDs have to be translated, FALSE otherwise.
+ **/
 static gboolean
-j_backend_db_func_exec(JList* operations, JSemantics* semantics, JMessageType type)
+j_db_internal_has_global_ids(JDBSchema* schema)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JBackendOperation* data = NULL;
-	gboolean ret = TRUE;
-	GSocketConnection* db_connection;
-	g_autoptr(JListIterator) iter_send = NULL;
-	g_autoptr(JListIterator) iter_recieve = NULL;
-	g_autoptr(JMessage) message = NULL;
-	g_autoptr(JMessage) reply = NULL;
-	JBackend* db_backend = j_db_get_backend();
-	gpointer batch = NULL;
-	GError* error = NULL;
+	return schema->shard_key != NULL && j_db_get_backend() == NULL;
+}
 
-	if (db_backend == NULL)
+/**
+ * Makes an ID returned by a server globally unique by encoding the server's index into it.
+ *
+ * \param id     The ID returned by the server.
+ * \param server The server's index.
+ *
+ * \return The globally unique ID.
+ **/
+static guint64
+j_db_internal_encode_id(guint64 id, guint32 server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	return id * j_db_internal_get_server_count() + server;
+}
+
+gboolean
+j_db_internal_decode_id(JDBSchema* schema, guint64 id, guint64* local_id, gint* server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 server_count;
+
+	g_return_val_if_fail(schema != NULL, FALSE);
+	g_return_val_if_fail(local_id != NULL, FALSE);
+	g_return_val_if_fail(server != NULL, FALSE);
+
+	if (!j_db_internal_has_global_ids(schema))
+	{
+		return FALSE;
+	}
+
+	server_count = j_db_internal_get_server_count();
+
+	*local_id = id / server_count;
+	*server = id % server_count;
+
+	return TRUE;
+}
+
+/**
+ * Makes the ID of an inserted entry globally unique.
+ *
+ * \param entry  An entry.
+ * \param server The index of the server the entry has been inserted on.
+ **/
+static void
+j_db_internal_encode_entry_id(JDBEntry* entry, guint32 server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t iter;
+	guint64 id;
+
+	// IDs are stored as `{"_value" : <id>, "_value_type" : <type>}`.
+	if (!bson_iter_init_find(&iter, &(entry->id), "_value") || !BSON_ITER_HOLDS_INT64(&iter))
+	{
+		return;
+	}
+
+	id = j_db_internal_encode_id(bson_iter_int64(&iter), server);
+
+	bson_destroy(&(entry->id));
+	bson_init(&(entry->id));
+	bson_append_int64(&(entry->id), "_value", -1, id);
+	bson_append_int32(&(entry->id), "_value_type", -1, J_DB_TYPE_UINT64);
+}
+
+/**
+ * Returns the server a schema operation has to be sent to.
+ *
+ * \param schema A schema.
+ *
+ * \return The server's index or J_DB_ALL_SERVERS if the schema is sharded.
+ **/
+static gint
+j_db_internal_get_schema_server(JDBSchema* schema)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (schema->shard_key != NULL)
+	{
+		return J_DB_ALL_SERVERS;
+	}
+
+	return j_db_internal_get_home_server(schema);
+}
+
+/**
+ * Returns the server an entry has to be inserted on.
+ *
+ * \param entry An entry.
+ *
+ * \return The server's index.
+ **/
+static gint
+j_db_internal_get_entry_server(JDBEntry* entry)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t iter;
+
+	if (entry->schema->shard_key != NULL && bson_iter_init_find(&iter, &(entry->bson), entry->schema->shard_key))
 	{
-		message = j_message_new(type, 0);
+		return j_db_internal_get_value_server(&iter);
 	}
 
-	iter_send = j_list_iterator_new(operations);
+	return j_db_internal_get_home_server(entry->schema);
+}
+
+/**
+ * Returns the server an operation using a selector has to be sent to.
+ * Selectors of sharded schemas are only sent to a single server if they require the shard key to have a specific value.
+ *
+ * \param schema   A schema.
+ * \param selector A selector, might be NULL.
+ *
+ * \return The server's index or J_DB_ALL_SERVERS.
+ **/
+static gint
+j_db_internal_get_selector_server(JDBSchema* schema, JDBSelector* selector)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t iter;
+	bson_iter_t child;
+
+	if (schema->shard_key == NULL)
+	{
+		return j_db_internal_get_home_server(schema);
+	}
+
+	// Globally unique IDs determine the server storing the entry.
+	if (selector != NULL && selector->id_server != J_DB_ALL_SERVERS)
+	{
+		return selector->id_server;
+	}
+
+	if (selector == NULL || selector->mode != J_DB_SELECTOR_MODE_AND)
+	{
+		return J_DB_ALL_SERVERS;
+	}
+
+	// Conditions are stored as `"name" : {"t" : <table_name>, "o" : <operator>, "v" : <value>}`.
+	if (bson_iter_init_find(&iter, &(selector->selection), schema->shard_key) && BSON_ITER_HOLDS_DOCUMENT(&iter))
+	{
+		if (!bson_iter_recurse(&iter, &child) || !bson_iter_find(&child, "t") || !BSON_ITER_HOLDS_UTF8(&child)
+		    || g_strcmp0(bson_iter_utf8(&child, NULL), schema->name) != 0)
+		{
+			return J_DB_ALL_SERVERS;
+		}
+
+		if (!bson_iter_recurse(&iter, &child) || !bson_iter_find(&child, "o") || bson_iter_as_int64(&child) != J_DB_SELECTOR_OPERATOR_EQ)
+		{
+			return J_DB_ALL_SERVERS;
+		}
+
+		if (bson_iter_recurse(&iter, &child) && bson_iter_find(&child, "v"))
+		{
+			return j_db_internal_get_value_server(&child);
+		}
+	}
+
+	return J_DB_ALL_SERVERS;
+}
+
+/**
+ * Reads a cursor ID from a reply and remembers the cursor if it still has rows.
+ *
+ * \param helper An iterator helper.
+ * \param reply  A reply.
+ * \param server The index of the DB server that sent \p reply.
+ **/
+static void
+j_db_internal_receive_cursor(JDBIteratorHelper* helper, JMessage* reply, guint32 server)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBCursor cursor;
+
+	cursor.server = server;
+	cursor.id = j_message_get_8(reply);
+
+	if (cursor.id != 0)
+	{
+		g_array_append_val(helper->cursors, cursor);
+	}
+}
+
+/**
+ * Appends the fields of a query result's row to a BSON document and makes its ID globally unique.
+ *
+ * \param helper An iterator helper.
+ * \param row    A BSON iterator pointing to the row.
+ * \param server The index of the DB server that returned the row.
+ * \param bson   A BSON document.
+ **/
+static void
+j_db_internal_copy_row(JDBIteratorHelper* helper, bson_iter_t const* row, guint32 server, bson_t* bson)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t field;
 
-	while (j_list_iterator_next(iter_send))
+	if (!bson_iter_recurse(row, &field))
 	{
-		data = j_list_iterator_get(iter_send);
+		return;
+	}
 
-		if (db_backend == NULL)
+	while (bson_iter_next(&field))
+	{
+		if (BSON_ITER_HOLDS_INT64(&field) && g_strcmp0(bson_iter_key(&field), helper->id_key) == 0)
 		{
-			ret = j_backend_operation_to_message(message, data->in_param, data->in_param_count) && ret;
+			bson_append_int64(bson, helper->id_key, -1, j_db_internal_encode_id(bson_iter_int64(&field), server));
 		}
 		else
 		{
-			if (!batch)
+			bson_append_iter(bson, NULL, 0, &field);
+		}
+	}
+}
+
+/**
+ * Reads the results of an operation that has been sent to all servers and merges them.
+ * Query results are concatenated, the first error is reported.
+ *
+ * \param operation    An operation.
+ * \param replies      The servers' replies.
+ * \param server_count The number of servers.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_db_internal_gather(JDBOperation* operation, JMessage** replies, guint32 server_count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackendOperation* data = &(operation->backend_operation);
+	gboolean ret = TRUE;
+	GError** error;
+	bson_t* result = NULL;
+	guint32 count = 0;
+
+	error = data->out_param[data->out_param_count - 1].ptr;
+
+	// Queries return their results in the first output parameter, all other operations only return an error.
+	if (data->out_param_count > 1 && data->out_param[0].type == J_BACKEND_OPERATION_PARAM_TYPE_BSON)
+	{
+		result = data->out_param[0].ptr;
+		bson_init(result);
+	}
+
+	for (guint32 i = 0; i < server_count; i++)
+	{
+		JBackendOperationParam out_param[G_N_ELEMENTS(data->out_param)];
+		GError* server_error = NULL;
+
+		memcpy(out_param, data->out_param, sizeof(out_param));
+		out_param[data->out_param_count - 1].ptr = &server_error;
+
+		if (result != NULL)
+		{
+			// Merge from the message directly instead of copying the results first.
+			out_param[0].ptr = NULL;
+		}
+
+		ret = j_backend_operation_from_message(replies[i], out_param, data->out_param_count) && ret;
+
+		if (operation->helper != NULL)
+		{
+			j_db_internal_receive_cursor(operation->helper, replies[i], i);
+		}
+
+		if (result != NULL && out_param[0].len > 0)
+		{
+			bson_iter_t iter;
+
+			if (bson_iter_init(&iter, &(out_param[0].bson)))
 			{
-				ret = j_backend_db_batch_start(db_backend, data->in_param[0].ptr, semantics, &batch, &error) && ret;
+				while (bson_iter_next(&iter))
+				{
+					gchar buf[16];
+					gchar const* key;
+
+					// Results are stored using consecutive keys.
+					bson_uint32_to_string(count, &key, buf, sizeof(buf));
+
+					if (operation->helper != NULL && operation->helper->id_key != NULL)
+					{
+						bson_t row;
+
+						bson_append_document_begin(result, key, -1, &row);
+						j_db_internal_copy_row(operation->helper, &iter, i, &row);
+						bson_append_document_end(result, &row);
+					}
+					else
+					{
+						bson_append_iter(result, key, -1, &iter);
+					}
+
+					count++;
+				}
 			}
+		}
 
-			if (data->out_param[data->out_param_count - 1].ptr && error)
+		if (server_error != NULL)
+		{
+			if (error != NULL && *error == NULL)
 			{
-				*((void**)data->out_param[data->out_param_count - 1].ptr) = g_error_copy(error);
+				g_propagate_error(error, server_error);
 			}
 			else
 			{
-				ret = data->backend_func(db_backend, batch, data) && ret;
+				g_error_free(server_error);
 			}
 		}
 	}
 
-	if (db_backend == NULL)
+	return ret;
+}
+
+/**
+ * Sends operations to the DB servers and receives their results.
+ * Every server receives one message containing all of its operations.
+ *
+ * \param operations A list of operations.
+ * \param type       The message type.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_backend_db_func_exec_remote(JVector* operations, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean ret = TRUE;
+	guint32 server_count;
+	g_autofree JMessage** messages = NULL;
+	g_autofree JMessage** replies = NULL;
+	g_autofree gpointer* connections = NULL;
+	JVectorIterator iter_send[1];
+	JVectorIterator iter_recieve[1];
+
+	server_count = j_db_internal_get_server_count();
+	messages = g_new0(JMessage*, server_count);
+	replies = g_new0(JMessage*, server_count);
+	connections = g_new0(gpointer, server_count);
+
+	j_vector_iterator_init(iter_send, operations);
+
+	while (j_vector_iterator_next(iter_send))
 	{
-		db_connection = j_connection_pool_pop(J_BACKEND_TYPE_DB, 0);
-		j_message_send(message, db_connection);
-		reply = j_message_new_reply(message);
-		j_message_receive(reply, db_connection);
-		iter_recieve = j_list_iterator_new(operations);
+		JDBOperation* operation = j_vector_iterator_get(iter_send);
+		JBackendOperation* data = &(operation->backend_operation);
+
+		for (guint32 i = 0; i < server_count; i++)
+		{
+			if (operation->server != J_DB_ALL_SERVERS && (guint32)operation->server != i)
+			{
+				continue;
+			}
+
+			if (messages[i] == NULL)
+			{
+				messages[i] = j_message_new(type, 0);
+			}
+
+			ret = j_backend_operation_to_message(messages[i], data->in_param, data->in_param_count) && ret;
+		}
+	}
 
-		while (j_list_iterator_next(iter_recieve))
+	// Send all messages before receiving any reply to allow the servers to work concurrently.
+	for (guint32 i = 0; i < server_count; i++)
+	{
+		if (messages[i] != NULL)
 		{
-			data = j_list_iterator_get(iter_recieve);
-			ret = j_backend_operation_from_message(reply, data->out_param, data->out_param_count) && ret;
+			connections[i] = j_connection_pool_pop(J_BACKEND_TYPE_DB, i);
+			j_message_send(messages[i], connections[i]);
 		}
+	}
 
-		j_connection_pool_push(J_BACKEND_TYPE_DB, 0, db_connection);
+	for (guint32 i = 0; i < server_count; i++)
+	{
+		if (messages[i] != NULL)
+		{
+			replies[i] = j_message_new_reply(messages[i]);
+			j_message_receive(replies[i], connections[i]);
+		}
 	}
-	else
+
+	j_vector_iterator_init(iter_recieve, operations);
+
+	while (j_vector_iterator_next(iter_recieve))
 	{
-		if (data != NULL)
+		JDBOperation* operation = j_vector_iterator_get(iter_recieve);
+		JBackendOperation* data = &(operation->backend_operation);
+
+		if (operation->server == J_DB_ALL_SERVERS)
 		{
-			if (!error)
-			{
-				ret = j_backend_db_batch_execute(db_backend, batch, NULL) && ret;
-			}
-			else
+			ret = j_db_internal_gather(operation, replies, server_count) && ret;
+		}
+		else
+		{
+			ret = j_backend_operation_from_message(replies[operation->server], data->out_param, data->out_param_count) && ret;
+
+			if (operation->helper != NULL)
 			{
-				g_error_free(error);
+				j_db_internal_receive_cursor(operation->helper, replies[operation->server], operation->server);
 			}
 		}
 	}
 
+	for (guint32 i = 0; i < server_count; i++)
+	{
+		if (messages[i] != NULL)
+		{
+			j_connection_pool_push(J_BACKEND_TYPE_DB, i, connections[i]);
+
+			j_message_unref(replies[i]);
+			j_message_unref(messages[i]);
+		}
+	}
+
+	return ret;
+}
+
+static gboolean
+j_backend_db_func_exec(JVector* operations, JSemantics* semantics, JMessageType type)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackendOperation* data = NULL;
+	gboolean ret = TRUE;
+	JVectorIterator iter_send[1];
+	JBackend* db_backend = j_db_get_backend();
+	gpointer batch = NULL;
+	GError* error = NULL;
+
+	if (db_backend == NULL)
+	{
+		return j_backend_db_func_exec_remote(operations, type);
+	}
+
+	j_vector_iterator_init(iter_send, operations);
+
+	while (j_vector_iterator_next(iter_send))
+	{
+		data = j_vector_iterator_get(iter_send);
+
+		if (!batch)
+		{
+			ret = j_backend_db_batch_start(db_backend, data->in_param[0].ptr, semantics, &batch, &error) && ret;
+		}
+
+		if (data->out_param[data->out_param_count - 1].ptr && error)
+		{
+			*((void**)data->out_param[data->out_param_count - 1].ptr) = g_error_copy(error);
+		}
+		else
+		{
+			ret = data->backend_func(db_backend, batch, data) && ret;
+		}
+	}
+
+	if (data != NULL)
+	{
+		if (!error)
+		{
+			ret = j_backend_db_batch_execute(db_backend, batch, NULL) && ret;
+		}
+		else
+		{
+			g_error_free(error);
+		}
+	}
+
 	return ret;
 }
 
@@ -156,7 +705,7 @@ j_backend_db_func_free(gpointer _data)
 }
 
 static gboolean
-j_db_schema_create_exec(JList* operations, JSemantics* semantics)
+j_db_schema_create_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -169,11 +718,14 @@ j_db_internal_schema_create(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_schema_server(j_db_schema);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_schema_create, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
 	data->in_param[1].ptr_const = j_db_schema->name;
@@ -196,11 +748,35 @@ j_db_internal_schema_create(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 }
 
 static gboolean
-j_db_schema_get_exec(JList* operations, JSemantics* semantics)
+j_db_schema_get_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_GET);
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_SCHEMA_GET);
+
+	if (!ret)
+	{
+		// The schemas' BSON documents might not have been received
+		return ret;
+	}
+
+	// Restore the shard keys, so that sharded schemas are not accessed like unsharded ones
+	for (guint i = 0; i < j_vector_length(operations); i++)
+	{
+		JBackendOperation* data = j_vector_get(operations, i);
+		JDBSchema* schema = data->unref_values[0];
+		bson_iter_t iter;
+
+		if (bson_iter_init_find(&iter, &(schema->bson), "_shard_key") && BSON_ITER_HOLDS_UTF8(&iter))
+		{
+			g_free(schema->shard_key);
+			schema->shard_key = g_strdup(bson_iter_utf8(&iter, NULL));
+		}
+	}
+
+	return ret;
 }
 
 gboolean
@@ -209,11 +785,14 @@ j_db_internal_schema_get(JDBSchema* j_db_schema, JBatch* batch, GError** error)
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_home_server(j_db_schema);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_schema_get, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
 	data->in_param[1].ptr_const = j_db_schema->name;
@@ -236,7 +815,7 @@ j_db_internal_schema_get(JDBSchema* j_db_schema, JBatch* batch, GError** error)
 }
 
 static gboolean
-j_db_schema_delete_exec(JList* operations, JSemantics* semantics)
+j_db_schema_delete_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -249,11 +828,14 @@ j_db_internal_schema_delete(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_schema_server(j_db_schema);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_schema_delete, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
 	data->in_param[1].ptr_const = j_db_schema->name;
@@ -275,11 +857,27 @@ j_db_internal_schema_delete(JDBSchema* j_db_schema, JBatch* batch, GError** erro
 }
 
 static gboolean
-j_db_insert_exec(JList* operations, JSemantics* semantics)
+j_db_insert_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	return j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_INSERT);
+	gboolean ret;
+
+	ret = j_backend_db_func_exec(operations, semantics, J_MESSAGE_DB_INSERT);
+
+	for (guint i = 0; i < j_vector_length(operations); i++)
+	{
+		JDBOperation* operation = j_vector_get(operations, i);
+		JDBEntry* entry = operation->backend_operation.unref_values[0];
+
+		// The ID is only received if the insert succeeded.
+		if (j_db_internal_has_global_ids(entry->schema) && operation->backend_operation.out_param[0].len > 0)
+		{
+			j_db_internal_encode_entry_id(entry, operation->server);
+		}
+	}
+
+	return ret;
 }
 
 gboolean
@@ -288,11 +886,14 @@ j_db_internal_insert(JDBEntry* j_db_entry, JBatch* batch, GError** error)
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_entry_server(j_db_entry);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_insert, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
 	data->in_param[1].ptr_const = j_db_entry->schema->name;
@@ -315,8 +916,156 @@ j_db_internal_insert(JDBEntry* j_db_entry, JBatch* batch, GError** error)
 	return TRUE;
 }
 
+/**
+ * Bulk inserts of the same schema combined into one operation.
+ * The DB operation has to be the first member because it is also used as a JDBOperation.
+ **/
+struct JDBInsertMany
+{
+	JDBOperation operation;
+
+	/**
+	 * The entries, stored using consecutive keys.
+	 **/
+	bson_t entries;
+
+	/**
+	 * The error of the combined operation.
+	 **/
+	GError* error;
+
+	/**
+	 * The index of the first combined operation.
+	 **/
+	guint first;
+
+	/**
+	 * The number of combined operations.
+	 **/
+	guint count;
+};
+
+typedef struct JDBInsertMany JDBInsertMany;
+
+static void
+j_db_insert_many_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBInsertMany* insert_many = data;
+
+	bson_destroy(&(insert_many->entries));
+	g_clear_error(&(insert_many->error));
+	g_free(insert_many);
+}
+
+static gboolean
+j_db_insert_many_exec(JVector* operations, JSemantics* semantics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JVector) combined = NULL;
+	JDBInsertMany* insert_many = NULL;
+	gboolean ret;
+
+	combined = j_vector_new(j_db_insert_many_free);
+
+	// Consecutive inserts into the same schema on the same server are sent as one operation.
+	for (guint i = 0; i < j_vector_length(operations); i++)
+	{
+		JDBOperation* operation = j_vector_get(operations, i);
+		JBackendOperation* data = &(operation->backend_operation);
+		gchar buf[16];
+		gchar const* key;
+
+		if (insert_many == NULL
+		    || insert_many->operation.server != operation->server
+		    || g_strcmp0(insert_many->operation.backend_operation.in_param[0].ptr, data->in_param[0].ptr) != 0
+		    || g_strcmp0(insert_many->operation.backend_operation.in_param[1].ptr, data->in_param[1].ptr) != 0)
+		{
+			insert_many = g_new0(JDBInsertMany, 1);
+			insert_many->operation.server = operation->server;
+			insert_many->first = i;
+			bson_init(&(insert_many->entries));
+
+			memcpy(&(insert_many->operation.backend_operation), &j_backend_operation_db_insert_many, sizeof(JBackendOperation));
+			insert_many->operation.backend_operation.in_param[0].ptr = data->in_param[0].ptr;
+			insert_many->operation.backend_operation.in_param[1].ptr = data->in_param[1].ptr;
+			insert_many->operation.backend_operation.in_param[2].ptr = &(insert_many->entries);
+			insert_many->operation.backend_operation.out_param[0].ptr = &(insert_many->error);
+
+			j_vector_append(combined, insert_many);
+		}
+
+		bson_uint32_to_string(insert_many->count, &key, buf, sizeof(buf));
+		bson_append_document(&(insert_many->entries), key, -1, data->in_param[2].ptr);
+		insert_many->count++;
+	}
+
+	ret = j_backend_db_func_exec(combined, semantics, J_MESSAGE_DB_INSERT_MANY);
+
+	for (guint i = 0; i < j_vector_length(combined); i++)
+	{
+		insert_many = j_vector_get(combined, i);
+
+		if (insert_many->error == NULL)
+		{
+			continue;
+		}
+
+		// Report the error to all inserts that have been combined.
+		for (guint j = insert_many->first; j < insert_many->first + insert_many->count; j++)
+		{
+			JDBOperation* operation = j_vector_get(operations, j);
+			GError** error = operation->backend_operation.out_param[0].ptr;
+
+			if (error != NULL && *error == NULL)
+			{
+				*error = g_error_copy(insert_many->error);
+			}
+		}
+	}
+
+	return ret;
+}
+
+gboolean
+j_db_internal_insert_many(JDBEntry* j_db_entry, JBatch* batch, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JOperation* op;
+	JDBOperation* operation;
+	JBackendOperation* data;
+
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_entry_server(j_db_entry);
+	data = &(operation->backend_operation);
+	memcpy(data, &j_backend_operation_db_insert_many, sizeof(JBackendOperation));
+	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
+	data->in_param[1].ptr_const = j_db_entry->schema->name;
+	data->in_param[2].ptr_const = &j_db_entry->bson;
+	data->out_param[0].ptr_const = error;
+
+	data->unref_func_count = 1;
+	data->unref_funcs[0] = (GDestroyNotify)j_db_entry_unref;
+	data->unref_values[0] = j_db_entry_ref(j_db_entry);
+
+	op = j_operation_new();
+	op->key = j_db_entry->schema->namespace;
+	op->data = data;
+	op->exec_func = j_db_insert_many_exec;
+	op->free_func = j_backend_db_func_free;
+
+	j_batch_add(batch, op);
+
+	return TRUE;
+}
+
 static gboolean
-j_db_update_exec(JList* operations, JSemantics* semantics)
+j_db_update_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -329,11 +1078,14 @@ j_db_internal_update(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_selector_server(j_db_entry->schema, j_db_selector);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_update, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
 	data->in_param[1].ptr_const = j_db_entry->schema->name;
@@ -359,7 +1111,7 @@ j_db_internal_update(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 }
 
 static gboolean
-j_db_delete_exec(JList* operations, JSemantics* semantics)
+j_db_delete_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -372,11 +1124,14 @@ j_db_internal_delete(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 	J_TRACE_FUNCTION(NULL);
 
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	data = g_new(JBackendOperation, 1);
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_selector_server(j_db_entry->schema, j_db_selector);
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_delete, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_entry->schema->namespace;
 	data->in_param[1].ptr_const = j_db_entry->schema->name;
@@ -401,7 +1156,7 @@ j_db_internal_delete(JDBEntry* j_db_entry, JDBSelector* j_db_selector, JBatch* b
 }
 
 static gboolean
-j_db_query_exec(JList* operations, JSemantics* semantics)
+j_db_query_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -415,16 +1170,29 @@ j_db_internal_query(JDBSchema* j_db_schema, JDBSelector* j_db_selector, JDBItera
 
 	JDBIteratorHelper* helper;
 	JOperation* op;
+	JDBOperation* operation;
 	JBackendOperation* data;
 
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	helper = j_helper_alloc_aligned(128, sizeof(JDBIteratorHelper));
 	helper->initialized = FALSE;
+	helper->cursors = g_array_new(FALSE, FALSE, sizeof(JDBCursor));
+	helper->id_key = NULL;
 	memset(&helper->bson, 0, sizeof(bson_t));
 	j_db_iterator->iterator = helper;
 
-	data = g_new(JBackendOperation, 1);
+	if (j_db_internal_has_global_ids(j_db_schema))
+	{
+		// Query results use the full field names, see j_db_iterator_get_field().
+		helper->id_key = g_strdup_printf("%s_%s._id", j_db_schema->namespace, j_db_schema->name);
+	}
+
+	operation = g_new0(JDBOperation, 1);
+	operation->server = j_db_internal_get_selector_server(j_db_schema, j_db_selector);
+	operation->helper = helper;
+	helper->server = operation->server;
+	data = &(operation->backend_operation);
 	memcpy(data, &j_backend_operation_db_query, sizeof(JBackendOperation));
 	data->in_param[0].ptr_const = j_db_schema->namespace;
 	data->in_param[1].ptr_const = j_db_schema->name;
@@ -451,6 +1219,91 @@ j_db_internal_query(JDBSchema* j_db_schema, JDBSelector* j_db_selector, JDBItera
 	return TRUE;
 }
 
+/**
+ * Fetches the next page of the first remaining cursor into the helper's BSON document.
+ * A \p count of 0 closes the cursor instead.
+ *
+ * \param helper An iterator helper.
+ * \param count  The maximum number of rows.
+ * \param error  A GError.
+ *
+ * \return TRUE on success, FALSE if an error occurred.
+ **/
+static gboolean
+j_db_internal_fetch(JDBIteratorHelper* helper, guint32 count, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JBackendOperationParam out_param[2];
+	JDBCursor* cursor;
+	gpointer connection;
+	g_autoptr(JMessage) message = NULL;
+	g_autoptr(JMessage) reply = NULL;
+	gboolean ret;
+
+	cursor = &g_array_index(helper->cursors, JDBCursor, 0);
+
+	message = j_message_new(J_MESSAGE_DB_FETCH, 12);
+	j_message_add_operation(message, 12);
+	j_message_append_8(message, &(cursor->id));
+	j_message_append_4(message, &count);
+
+	connection = j_connection_pool_pop(J_BACKEND_TYPE_DB, cursor->server);
+	j_message_send(message, connection);
+
+	helper->server = cursor->server;
+
+	reply = j_message_new_reply(message);
+	j_message_receive(reply, connection);
+
+	// Pages are sent like query results.
+	memcpy(out_param, j_backend_operation_db_query.out_param, sizeof(out_param));
+	out_param[0].ptr = (count > 0) ? &helper->bson : NULL;
+	out_param[1].ptr = error;
+
+	ret = j_backend_operation_from_message(reply, out_param, G_N_ELEMENTS(out_param));
+	cursor->id = j_message_get_8(reply);
+
+	j_connection_pool_push(J_BACKEND_TYPE_DB, cursor->server, connection);
+
+	if (cursor->id == 0)
+	{
+		g_array_remove_index(helper->cursors, 0);
+	}
+
+	return ret;
+}
+
+/**
+ * Frees an iterator helper.
+ * Cursors that still have rows are closed.
+ *
+ * \param helper An iterator helper.
+ **/
+static void
+j_db_internal_helper_free(JDBIteratorHelper* helper)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_t zerobson;
+
+	memset(&zerobson, 0, sizeof(bson_t));
+
+	if (memcmp(&helper->bson, &zerobson, sizeof(bson_t)))
+	{
+		j_bson_destroy(&helper->bson);
+	}
+
+	while (helper->cursors->len > 0)
+	{
+		j_db_internal_fetch(helper, 0, NULL);
+	}
+
+	g_array_free(helper->cursors, TRUE);
+	g_free(helper->id_key);
+	g_free(helper);
+}
+
 gboolean
 j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error)
 {
@@ -469,7 +1322,7 @@ j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error)
 		if (G_UNLIKELY(!memcmp(&helper->bson, &zerobson, sizeof(bson_t))))
 		{
 			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_INVALID, "iterator invalid");
-			goto error2;
+			goto _error;
 		}
 
 		if (G_UNLIKELY(!j_bson_iter_init(&helper->iter, &helper->bson, error)))
@@ -485,13 +1338,41 @@ j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error)
 		goto _error;
 	}
 
+	// The current page has been consumed, fetch the next one from the servers.
+	while (!has_next && helper->cursors->len > 0)
+	{
+		j_bson_destroy(&helper->bson);
+		memset(&helper->bson, 0, sizeof(bson_t));
+
+		if (G_UNLIKELY(!j_db_internal_fetch(helper, j_configuration_get_db_query_batch_size(j_configuration()), error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_init(&helper->iter, &helper->bson, error)))
+		{
+			goto _error;
+		}
+
+		if (G_UNLIKELY(!j_bson_iter_next(&helper->iter, &has_next, error)))
+		{
+			goto _error;
+		}
+	}
+
 	if (G_UNLIKELY(!has_next))
 	{
 		g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_NO_MORE_ELEMENTS, "no more elements");
 		goto _error;
 	}
 
-	if (G_UNLIKELY(!j_bson_iter_copy_document(&helper->iter, &j_db_iterator->bson, error)))
+	if (helper->id_key != NULL && helper->server != J_DB_ALL_SERVERS)
+	{
+		// Rows of pages returned by a single server still contain the server's IDs.
+		bson_init(&j_db_iterator->bson);
+		j_db_internal_copy_row(helper, &helper->iter, helper->server, &j_db_iterator->bson);
+	}
+	else if (G_UNLIKELY(!j_bson_iter_copy_document(&helper->iter, &j_db_iterator->bson, error)))
 	{
 		goto _error;
 	}
@@ -499,14 +1380,22 @@ j_db_internal_iterate(JDBIterator* j_db_iterator, GError** error)
 	return TRUE;
 
 _error:
-	j_bson_destroy(&helper->bson);
-
-error2:
-	g_free(helper);
+	j_db_internal_helper_free(helper);
 
 	return FALSE;
 }
 
+void
+j_db_internal_iterate_close(JDBIterator* j_db_iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_return_if_fail(j_db_iterator != NULL);
+
+	j_db_internal_helper_free(j_db_iterator->iterator);
+	j_db_iterator->iterator = NULL;
+}
+
 gboolean
 j_db_selector_finalize(JDBSelector* selector, GError** error)
 {
@@ -91,10 +91,7 @@ j_db_iterator_new(JDBSchema* schema, JDBSelector* selector, GError** error)
 _error:
 	if (ret2)
 	{
-		while (j_db_internal_iterate(iterator, NULL))
-		{
-			/*do nothing*/
-		}
+		j_db_internal_iterate_close(iterator);
 	}
 
 	j_db_iterator_unref(iterator);
@@ -123,9 +120,10 @@ j_db_iterator_unref(JDBIterator* iterator)
 
 	if (g_atomic_int_dec_and_test(&iterator->ref_count))
 	{
-		while (iterator->valid)
+		// Closes the remaining server-side cursors instead of fetching all rows.
+		if (iterator->valid)
 		{
-			j_db_iterator_next(iterator, NULL);
+			j_db_internal_iterate_close(iterator);
 		}
 
 		j_db_schema_unref(iterator->schema);
@@ -48,6 +48,7 @@ j_db_schema_new(gchar const* namespace, gchar const* name, GError** error)
 	schema = j_helper_alloc_aligned(128, sizeof(JDBSchema));
 	schema->namespace = g_strdup(namespace);
 	schema->name = g_strdup(name);
+	schema->shard_key = NULL;
 	schema->variables = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	schema->index = g_array_new(FALSE, FALSE, sizeof(JDBSchemaIndex));
 	schema->bson_initialized = FALSE;
@@ -86,6 +87,7 @@ j_db_schema_unref(JDBSchema* schema)
 	{
 		g_free(schema->namespace);
 		g_free(schema->name);
+		g_free(schema->shard_key);
 		g_hash_table_unref(schema->variables);
 
 		for (i = 0; i < schema->index->len; i++)
@@ -169,6 +171,7 @@ j_db_schema_get_field(JDBSchema* schema, gchar const* name, JDBType* type, GErro
 	g_return_val_if_fail(name != NULL, FALSE);
 	g_return_val_if_fail(type != NULL, FALSE);
 	g_return_val_if_fail(g_strcmp0(name, "_index"), FALSE);
+	g_return_val_if_fail(g_strcmp0(name, "_shard_key"), FALSE);
 	g_return_val_if_fail(schema->bson_initialized, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
@@ -238,7 +241,7 @@ j_db_schema_get_all_fields(JDBSchema* schema, gchar*** names, JDBType** types, G
 			goto _error;
 		}
 
-		if (g_strcmp0(key, "_index"))
+		if (g_strcmp0(key, "_index") && g_strcmp0(key, "_shard_key"))
 		{
 			if (G_UNLIKELY(!j_bson_iter_value(&iter, J_DB_TYPE_UINT32, &val, error)))
 			{
@@ -398,6 +401,32 @@ _error:
 	return FALSE;
 }
 
+gboolean
+j_db_schema_set_shard_key(JDBSchema* schema, gchar const* name, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JDBType type;
+
+	g_return_val_if_fail(schema != NULL, FALSE);
+	g_return_val_if_fail(name != NULL, FALSE);
+	g_return_val_if_fail(!schema->server_side, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (G_UNLIKELY(!j_db_schema_get_field(schema, name, &type, error)))
+	{
+		goto _error;
+	}
+
+	g_free(schema->shard_key);
+	schema->shard_key = g_strdup(name);
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
 gboolean
 j_db_schema_create(JDBSchema* schema, JBatch* batch, GError** error)
 {
@@ -417,6 +446,19 @@ j_db_schema_create(JDBSchema* schema, JBatch* batch, GError** error)
 		}
 	}
 
+	if (schema->shard_key != NULL)
+	{
+		JDBTypeValue value;
+
+		// Stored by the backend, so that j_db_schema_get() can restore it
+		value.val_string = schema->shard_key;
+
+		if (G_UNLIKELY(!j_bson_append_value(&schema->bson, "_shard_key", J_DB_TYPE_STRING, &value, error)))
+		{
+			goto _error;
+		}
+	}
+
 	schema->server_side = TRUE;
 
 	if (G_UNLIKELY(!j_db_internal_schema_create(schema, batch, error)))
@@ -501,6 +543,7 @@ j_db_schema_equals(JDBSchema* schema1, JDBSchema* schema2, gboolean* equal, GErr
 		*equal = *equal && !g_strcmp0(schema1->namespace, schema2->namespace);
 		*equal = *equal && !g_strcmp0(schema1->name, schema2->name);
 		*equal = *equal && (schema1->bson_initialized == schema2->bson_initialized);
+		*equal = *equal && !g_strcmp0(schema1->shard_key, schema2->shard_key);
 
 		if (*equal && schema1->bson_initialized)
 		{
@@ -531,7 +574,7 @@ j_db_schema_equals(JDBSchema* schema1, JDBSchema* schema2, gboolean* equal, GErr
 					goto _error;
 				}
 
-				if (g_strcmp0(key, "_index") && g_strcmp0(key, "_id"))
+				if (g_strcmp0(key, "_index") && g_strcmp0(key, "_id") && g_strcmp0(key, "_shard_key"))
 				{
 					schema1_count++;
 
@@ -586,6 +629,11 @@ j_db_schema_equals(JDBSchema* schema1, JDBSchema* schema2, gboolean* equal, GErr
 				schema2_count--;
 			}
 
+			if (bson_has_field(&schema2->bson, "_shard_key"))
+			{
+				schema2_count--;
+			}
+
 			*equal = *equal && schema1_count == schema2_count;
 		}
 	}
@@ -47,6 +47,7 @@ j_db_selector_new(JDBSchema* schema, JDBSelectorMode mode, GError** error)
 	selector->ref_count = 1;
 	selector->mode = mode;
 	selector->selection_count = 0;
+	selector->id_server = J_DB_ALL_SERVERS;
 	selector->join_schema = NULL;
 	selector->schema = j_db_schema_ref(schema);
 	selector->final_valid = FALSE;
@@ -104,6 +105,43 @@ j_db_selector_unref(JDBSelector* selector)
 	}
 }
 
+/**
+ * \brief Restrict a selector to the server storing the entries selected by an ID.
+ *
+ * \param selector The selector.
+ * \param server The server's index or J_DB_ALL_SERVERS.
+ * \param error A GError.
+ * \return TRUE on success, FALSE otherwise.
+ */
+static gboolean
+j_db_selector_set_id_server(JDBSelector* selector, gint server, GError** error)
+{
+	if (server == J_DB_ALL_SERVERS)
+	{
+		return TRUE;
+	}
+
+	// Entries on other servers could be selected using the same server-local IDs.
+	if (G_UNLIKELY(selector->mode != J_DB_SELECTOR_MODE_AND))
+	{
+		g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_MODE_INVALID, "IDs of sharded schemas can only be used in conjunctions");
+		goto _error;
+	}
+
+	if (G_UNLIKELY(selector->id_server != J_DB_ALL_SERVERS && selector->id_server != server))
+	{
+		g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_OPERATOR_INVALID, "IDs of sharded schemas must be stored on the same server");
+		goto _error;
+	}
+
+	selector->id_server = server;
+
+	return TRUE;
+
+_error:
+	return FALSE;
+}
+
 gboolean
 j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOperator operator_, gconstpointer value, guint64 length, GError** error)
 {
@@ -182,6 +220,29 @@ j_db_selector_add_field(JDBSelector* selector, gchar const* name, JDBSelectorOpe
 			g_assert_not_reached();
 	}
 
+	if (type == J_DB_TYPE_UINT64 && g_strcmp0(name, "_id") == 0)
+	{
+		guint64 local_id;
+		gint server;
+
+		// Sharded schemas use globally unique IDs that determine the server storing the entry.
+		if (j_db_internal_decode_id(selector->schema, val.val_uint64, &local_id, &server))
+		{
+			if (G_UNLIKELY(operator_ != J_DB_SELECTOR_OPERATOR_EQ))
+			{
+				g_set_error_literal(error, J_DB_ERROR, J_DB_ERROR_OPERATOR_INVALID, "IDs of sharded schemas can only be compared for equality");
+				goto _error;
+			}
+
+			if (G_UNLIKELY(!j_db_selector_set_id_server(selector, server, error)))
+			{
+				goto _error;
+			}
+
+			val.val_uint64 = local_id;
+		}
+	}
+
 	// Add value.
 	if (G_UNLIKELY(!j_bson_append_value(&child, "v", type, &val, error)))
 	{
@@ -258,6 +319,11 @@ j_db_selector_add_sub_selection(JDBSelector* selector, JDBSelector* sub_selector
 		return TRUE;
 	}
 
+	if (G_UNLIKELY(!j_db_selector_set_id_server(selector, sub_selector->id_server, error)))
+	{
+		goto _error;
+	}
+
 	// append the sub selector's selection logic
 	if (G_UNLIKELY(!j_bson_append_document(&selector->selection, "_s", &sub_selector->selection, error)))
 	{
@@ -51,6 +51,9 @@
 
 #define JULEA 520
 
+/// The number of selection sequences that are retrieved from HDF5 at once
+#define J_HDF5_MAX_SEQUENCES 64
+
 #define H5VL_JULEA_KV_CAP_FLAGS \
 	(H5VL_CAP_FLAG_ATTR_BASIC | H5VL_CAP_FLAG_DATASET_BASIC | H5VL_CAP_FLAG_FILE_BASIC | H5VL_CAP_FLAG_GROUP_BASIC | H5VL_CAP_FLAG_LINK_BASIC | H5VL_CAP_FLAG_STORAGE_SIZE)
 
@@ -87,6 +90,9 @@ struct JHD_t
 	char* location;
 	char* name;
 	size_t data_size;
+	/* the stored type and space (with all elements selected) */
+	hid_t type_id;
+	hid_t space_id;
 	JDistribution* distribution;
 	JDistributedObject* object;
 	JKV* kv;
@@ -106,6 +112,30 @@ struct JHA_t
 
 typedef struct JHA_t JHA_t;
 
+/* structure for a contiguous run of bytes within a buffer or dataset */
+struct JHDF5Run
+{
+	guint64 offset;
+	guint64 length;
+};
+
+typedef struct JHDF5Run JHDF5Run;
+
+/* structure for the transfer of one dataset's selection */
+struct JHDF5DatasetIO
+{
+	/* the number of selected elements */
+	hssize_t count;
+	/* the selected runs of the memory buffer */
+	GArray* mem_runs;
+	/* the selected runs of the dataset */
+	GArray* file_runs;
+	/* a packed buffer for type conversion, NULL if memory and file types match */
+	gchar* conversion_buf;
+};
+
+typedef struct JHDF5DatasetIO JHDF5DatasetIO;
+
 static JSemantics* j_hdf5_semantics;
 
 /**
@@ -1200,6 +1230,9 @@ H5VL_julea_dataset_create(void* obj, const H5VL_loc_params_t* loc_params, const
 	g_free(dims);
 
 	dset->data_size = data_size;
+	dset->type_id = H5Tcopy(type_id);
+	dset->space_id = H5Scopy(space_id);
+	H5Sselect_all(dset->space_id);
 
 	batch = j_batch_new(j_hdf5_semantics);
 
@@ -1286,6 +1319,8 @@ H5VL_julea_dataset_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 
 	dset = g_new(JHD_t, 1);
 	dset->name = g_strdup(name);
+	dset->type_id = H5I_INVALID_HID;
+	dset->space_id = H5I_INVALID_HID;
 
 	switch (loc_params->obj_type)
 	{
@@ -1334,9 +1369,21 @@ H5VL_julea_dataset_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 	if (j_batch_execute(batch))
 	{
 		bson_t kvdata[1];
+		void* type;
+		void* space;
 
 		bson_init_static(kvdata, value, len);
 		j_hdf5_deserialize_dataset(kvdata, dset, &(dset->data_size));
+
+		type = j_hdf5_deserialize_type(kvdata);
+		dset->type_id = H5Tdecode(type);
+		free(type);
+
+		space = j_hdf5_deserialize_space(kvdata);
+		dset->space_id = H5Sdecode(space);
+		H5Sselect_all(dset->space_id);
+		free(space);
+
 		g_free(value);
 	}
 
@@ -1345,8 +1392,203 @@ H5VL_julea_dataset_open(void* obj, const H5VL_loc_params_t* loc_params, const ch
 	return dset;
 }
 
+/**
+ * Translates a selection into runs of bytes, in the order in which HDF5 maps elements between selections.
+ * Adjacent runs are merged.
+ *
+ * \param space_id  A dataspace with a selection.
+ * \param type_size The size of an element.
+ *
+ * \return The runs, NULL on error. Should be freed with g_array_unref().
+ **/
+static GArray*
+j_hdf5_selection_to_runs(hid_t space_id, gsize type_size)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GArray* runs;
+	hid_t iter_id;
+	hsize_t offsets[J_HDF5_MAX_SEQUENCES];
+	size_t lengths[J_HDF5_MAX_SEQUENCES];
+	size_t nseq;
+	size_t nbytes;
+
+	if ((iter_id = H5Ssel_iter_create(space_id, type_size, 0)) < 0)
+	{
+		return NULL;
+	}
+
+	runs = g_array_new(FALSE, FALSE, sizeof(JHDF5Run));
+
+	do
+	{
+		if (H5Ssel_iter_get_seq_list(iter_id, J_HDF5_MAX_SEQUENCES, G_MAXSIZE, &nseq, &nbytes, offsets, lengths) < 0)
+		{
+			g_array_unref(runs);
+			runs = NULL;
+			break;
+		}
+
+		for (gsize i = 0; i < nseq; i++)
+		{
+			JHDF5Run* last = (runs->len > 0) ? &g_array_index(runs, JHDF5Run, runs->len - 1) : NULL;
+
+			if (last != NULL && last->offset + last->length == offsets[i])
+			{
+				last->length += lengths[i];
+			}
+			else
+			{
+				JHDF5Run run = { offsets[i], lengths[i] };
+
+				g_array_append_val(runs, run);
+			}
+		}
+	} while (nseq > 0);
+
+	H5Ssel_iter_close(iter_id);
+
+	return runs;
+}
+
+/**
+ * Prepares the transfer of a dataset's selection.
+ *
+ * \param io            The transfer to initialize.
+ * \param d             The dataset.
+ * \param mem_type_id   The memory type.
+ * \param mem_space_id  The memory space, H5S_ALL to use the file space.
+ * \param file_space_id The file space, H5S_ALL to use the whole dataset.
+ *
+ * \return TRUE on success, FALSE otherwise.
+ **/
+static gboolean
+j_hdf5_dataset_io_init(JHDF5DatasetIO* io, JHD_t* d, hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	hid_t file_space = (file_space_id == H5S_ALL) ? d->space_id : file_space_id;
+	hid_t mem_space = (mem_space_id == H5S_ALL) ? file_space : mem_space_id;
+	gsize mem_type_size;
+	gsize file_type_size;
+	htri_t types_equal;
+
+	if ((io->count = H5Sget_select_npoints(file_space)) < 0 || H5Sget_select_npoints(mem_space) != io->count)
+	{
+		return FALSE;
+	}
+
+	mem_type_size = H5Tget_size(mem_type_id);
+	file_type_size = H5Tget_size(d->type_id);
+
+	if (mem_type_size == 0 || file_type_size == 0 || (types_equal = H5Tequal(mem_type_id, d->type_id)) < 0)
+	{
+		return FALSE;
+	}
+
+	if ((io->mem_runs = j_hdf5_selection_to_runs(mem_space, mem_type_size)) == NULL)
+	{
+		return FALSE;
+	}
+
+	if ((io->file_runs = j_hdf5_selection_to_runs(file_space, file_type_size)) == NULL)
+	{
+		return FALSE;
+	}
+
+	if (!types_equal)
+	{
+		// Conversion happens in place, so the buffer has to fit the larger type
+		io->conversion_buf = g_malloc(io->count * MAX(mem_type_size, file_type_size));
+	}
+
+	return TRUE;
+}
+
+static void
+j_hdf5_dataset_io_fini(JHDF5DatasetIO* io)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (io->mem_runs != NULL)
+	{
+		g_array_unref(io->mem_runs);
+	}
+
+	if (io->file_runs != NULL)
+	{
+		g_array_unref(io->file_runs);
+	}
+
+	g_free(io->conversion_buf);
+}
+
+/**
+ * Adds the reads or writes for the selected runs to a batch.
+ * Memory and file runs are paired in order, each pair resulting in one object operation.
+ *
+ * \param d         The dataset.
+ * \param read_buf  The buffer to read into, NULL for writes.
+ * \param write_buf The buffer to write from, NULL for reads.
+ * \param mem_runs  The runs of the buffer, NULL if the buffer is packed.
+ * \param file_runs The runs of the dataset.
+ * \param bytes     Returns the number of bytes transferred.
+ * \param batch     A batch.
+ **/
+static void
+j_hdf5_dataset_transfer(JHD_t* d, gpointer read_buf, gconstpointer write_buf, GArray* mem_runs, GArray* file_runs, guint64* bytes, JBatch* batch)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint mem_index = 0;
+	guint64 mem_position = 0;
+	guint64 packed_position = 0;
+
+	for (guint i = 0; i < file_runs->len; i++)
+	{
+		JHDF5Run* file_run = &g_array_index(file_runs, JHDF5Run, i);
+		guint64 file_position = 0;
+
+		while (file_position < file_run->length)
+		{
+			guint64 length = file_run->length - file_position;
+			guint64 mem_offset = packed_position;
+
+			if (mem_runs != NULL)
+			{
+				JHDF5Run* mem_run = &g_array_index(mem_runs, JHDF5Run, mem_index);
+
+				mem_offset = mem_run->offset + mem_position;
+				length = MIN(length, mem_run->length - mem_position);
+				mem_position += length;
+
+				if (mem_position == mem_run->length)
+				{
+					mem_index++;
+					mem_position = 0;
+				}
+			}
+
+			if (write_buf != NULL)
+			{
+				j_distributed_object_write(d->object, (gchar const*)write_buf + mem_offset, length, file_run->offset + file_position, bytes, batch);
+			}
+			else
+			{
+				j_distributed_object_read(d->object, (gchar*)read_buf + mem_offset, length, file_run->offset + file_position, bytes, batch);
+			}
+
+			file_position += length;
+			packed_position += length;
+		}
+	}
+}
+
 /**
  * Reads the data from the dataset
+ *
+ * Only the selected elements are read and converted.
+ * If no conversion is necessary, they are read directly into the memory buffer.
  **/
 static herr_t
 H5VL_julea_dataset_read(size_t count, void* dset[], hid_t mem_type_id[], hid_t mem_space_id[], hid_t file_space_id[], hid_t dxpl_id, void* buf[], void** req)
@@ -1354,36 +1596,79 @@ H5VL_julea_dataset_read(size_t count, void* dset[], hid_t mem_type_id[], hid_t m
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JBatch) batch = NULL;
+	g_autofree JHDF5DatasetIO* io = NULL;
 	guint64 bytes_read;
-	/// \todo support multi-read
-	void* buf0 = buf[0];
-	JHD_t* d = (JHD_t*)dset[0];
+	herr_t ret = -1;
 
-	(void)mem_type_id;
-	(void)mem_space_id;
-	(void)file_space_id;
-	(void)dxpl_id;
 	(void)req;
 
-	/// \todo support multi-read
-	g_return_val_if_fail(count == 1, -1);
+	g_return_val_if_fail(buf != NULL, -1);
 
+	io = g_new0(JHDF5DatasetIO, count);
 	batch = j_batch_new(j_hdf5_semantics);
 
 	bytes_read = 0;
 
-	g_assert(buf != NULL);
+	for (gsize i = 0; i < count; i++)
+	{
+		JHD_t* d = dset[i];
+
+		g_assert(d->object != NULL);
 
-	g_assert(d->object != NULL);
+		if (!j_hdf5_dataset_io_init(&(io[i]), d, mem_type_id[i], mem_space_id[i], file_space_id[i]))
+		{
+			goto end;
+		}
 
-	j_distributed_object_read(d->object, buf0, d->data_size, 0, &bytes_read, batch);
+		if (io[i].conversion_buf == NULL)
+		{
+			j_hdf5_dataset_transfer(d, buf[i], NULL, io[i].mem_runs, io[i].file_runs, &bytes_read, batch);
+		}
+		else
+		{
+			j_hdf5_dataset_transfer(d, io[i].conversion_buf, NULL, NULL, io[i].file_runs, &bytes_read, batch);
+		}
+	}
 
 	if (!j_batch_execute(batch))
 	{
-		/// \todo check return value properly
+		goto end;
 	}
 
-	return 1;
+	for (gsize i = 0; i < count; i++)
+	{
+		JHD_t* d = dset[i];
+		guint64 position = 0;
+
+		if (io[i].conversion_buf == NULL)
+		{
+			continue;
+		}
+
+		if (H5Tconvert(d->type_id, mem_type_id[i], io[i].count, io[i].conversion_buf, NULL, dxpl_id) < 0)
+		{
+			goto end;
+		}
+
+		// Scatter the converted elements into the memory selection
+		for (guint j = 0; j < io[i].mem_runs->len; j++)
+		{
+			JHDF5Run* run = &g_array_index(io[i].mem_runs, JHDF5Run, j);
+
+			memcpy((gchar*)buf[i] + run->offset, io[i].conversion_buf + position, run->length);
+			position += run->length;
+		}
+	}
+
+	ret = 1;
+
+end:
+	for (gsize i = 0; i < count; i++)
+	{
+		j_hdf5_dataset_io_fini(&(io[i]));
+	}
+
+	return ret;
 }
 
 /**
@@ -1463,6 +1748,9 @@ H5VL_julea_dataset_get(void* dset, H5VL_dataset_get_args_t* args, hid_t dxpl_id,
 
 /**
  * Writes the data to the dataset
+ *
+ * Only the selected elements are converted and written.
+ * If no conversion is necessary, they are written directly from the memory buffer.
  **/
 static herr_t
 H5VL_julea_dataset_write(size_t count, void* dset[], hid_t mem_type_id[], hid_t mem_space_id[],
@@ -1471,32 +1759,66 @@ H5VL_julea_dataset_write(size_t count, void* dset[], hid_t mem_type_id[], hid_t
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JBatch) batch = NULL;
+	g_autofree JHDF5DatasetIO* io = NULL;
 	guint64 bytes_written;
-	/// \todo support multi-write
-	JHD_t* d = (JHD_t*)dset[0];
-	const void* buf0 = buf[0];
+	herr_t ret = -1;
 
-	(void)mem_type_id;
-	(void)mem_space_id;
-	(void)file_space_id;
-	(void)dxpl_id;
 	(void)req;
 
-	/// \todo support multi-write
-	g_return_val_if_fail(count == 1, -1);
+	g_return_val_if_fail(buf != NULL, -1);
 
+	io = g_new0(JHDF5DatasetIO, count);
 	batch = j_batch_new(j_hdf5_semantics);
 
 	bytes_written = 0;
 
-	j_distributed_object_write(d->object, buf0, d->data_size, 0, &bytes_written, batch);
+	for (gsize i = 0; i < count; i++)
+	{
+		JHD_t* d = dset[i];
+		guint64 position = 0;
+
+		if (!j_hdf5_dataset_io_init(&(io[i]), d, mem_type_id[i], mem_space_id[i], file_space_id[i]))
+		{
+			goto end;
+		}
+
+		if (io[i].conversion_buf == NULL)
+		{
+			j_hdf5_dataset_transfer(d, NULL, buf[i], io[i].mem_runs, io[i].file_runs, &bytes_written, batch);
+			continue;
+		}
+
+		// Gather the selected elements so that only they are converted
+		for (guint j = 0; j < io[i].mem_runs->len; j++)
+		{
+			JHDF5Run* run = &g_array_index(io[i].mem_runs, JHDF5Run, j);
+
+			memcpy(io[i].conversion_buf + position, (gchar const*)buf[i] + run->offset, run->length);
+			position += run->length;
+		}
+
+		if (H5Tconvert(mem_type_id[i], d->type_id, io[i].count, io[i].conversion_buf, NULL, dxpl_id) < 0)
+		{
+			goto end;
+		}
+
+		j_hdf5_dataset_transfer(d, NULL, io[i].conversion_buf, NULL, io[i].file_runs, &bytes_written, batch);
+	}
 
 	if (!j_batch_execute(batch))
 	{
-		/// \todo check return value properly
+		goto end;
 	}
 
-	return 1;
+	ret = 1;
+
+end:
+	for (gsize i = 0; i < count; i++)
+	{
+		j_hdf5_dataset_io_fini(&(io[i]));
+	}
+
+	return ret;
 }
 
 /**
@@ -1521,6 +1843,16 @@ H5VL_julea_dataset_close(void* dset, hid_t dxpl_id __attribute__((unused)), void
 		j_distributed_object_unref(d->object);
 	}
 
+	if (d->type_id != H5I_INVALID_HID)
+	{
+		H5Tclose(d->type_id);
+	}
+
+	if (d->space_id != H5I_INVALID_HID)
+	{
+		H5Sclose(d->space_id);
+	}
+
 	g_free(d->name);
 	free(d->location);
 	free(d);
@@ -24,6 +24,8 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <kv/jkv-iterator.h>
 
 #include <kv/jkv.h>
@@ -31,6 +33,53 @@
 
 #include <julea.h>
 
+/**
+ * The number of entries requested per page.
+ **/
+#define J_KV_ITERATOR_PAGE_SIZE 1000
+
+/**
+ * An entry of a page, pointing into the page's reply.
+ **/
+struct JKVIteratorEntry
+{
+	gchar const* key;
+	gconstpointer value;
+	guint32 len;
+};
+
+typedef struct JKVIteratorEntry JKVIteratorEntry;
+
+/**
+ * A page of entries received from a server.
+ **/
+struct JKVIteratorPage
+{
+	/**
+	 * The server the page was fetched from.
+	 **/
+	guint32 index;
+
+	/**
+	 * The server-side cursor for the remaining entries, 0 if there are none.
+	 **/
+	guint64 cursor_id;
+
+	JMessage* reply;
+
+	/**
+	 * The page's entries.
+	 **/
+	GArray* entries;
+
+	/**
+	 * The next entry to return.
+	 **/
+	guint current;
+};
+
+typedef struct JKVIteratorPage JKVIteratorPage;
+
 /**
  * \ingroup JKVIterator
  **/
@@ -54,28 +103,116 @@ struct JKVIterator
 	gconstpointer value;
 	guint32 len;
 
-	JMessage** replies;
-	guint32 replies_n;
-	guint32 replies_cur;
+	gchar* namespace;
+	gchar* prefix;
+
+	/**
+	 * The first key to return, NULL for no lower bound.
+	 **/
+	gchar* start_key;
+
+	/**
+	 * The first key not to return, NULL for no upper bound.
+	 **/
+	gchar* end_key;
+
+	/**
+	 * The maximum number of entries to return, 0 for no limit.
+	 **/
+	guint32 limit;
+
+	JKVIteratorFlags flags;
+
+	/**
+	 * The number of entries returned so far.
+	 **/
+	guint32 returned;
+
+	/**
+	 * The number of entries received so far.
+	 **/
+	guint32 received;
+
+	/**
+	 * The first server not to query.
+	 **/
+	guint32 index_end;
+
+	/**
+	 * The page entries are currently returned from.
+	 **/
+	JKVIteratorPage* page;
+
+	/**
+	 * The background operation fetching the next page, NULL if there is none.
+	 **/
+	JBackgroundOperation* prefetch;
 
 	gboolean done;
 };
 
-static JMessage*
-fetch_reply(guint32 index, gchar const* namespace, gchar const* prefix)
+/**
+ * A request for a page.
+ **/
+struct JKVIteratorFetch
+{
+	JKVIterator* iterator;
+	guint32 index;
+	guint64 cursor_id;
+	guint32 count;
+};
+
+typedef struct JKVIteratorFetch JKVIteratorFetch;
+
+static void
+j_kv_iterator_page_free(JKVIteratorPage* page)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (page == NULL)
+	{
+		return;
+	}
+
+	g_array_unref(page->entries);
+	j_message_unref(page->reply);
+	g_free(page);
+}
+
+/**
+ * Fetches a page from a server.
+ * A count of 0 closes the server-side cursor.
+ *
+ * \private
+ *
+ * \param iterator  An iterator.
+ * \param index     The server.
+ * \param cursor_id The server-side cursor, 0 to start a new scan.
+ * \param count     The maximum number of entries.
+ *
+ * \return The page. Should be freed with j_kv_iterator_page_free().
+ **/
+static JKVIteratorPage*
+fetch_page(JKVIterator* iterator, guint32 index, guint64 cursor_id, guint32 count)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	g_autoptr(JMessage) message = NULL;
-	JMessage* reply;
+	JKVIteratorPage* page;
 	JMessageType message_type;
 	gpointer kv_connection;
+	gchar const* start_key;
+	gchar const* end_key;
 	gsize namespace_len;
 	gsize prefix_len;
+	gsize start_key_len;
+	gsize end_key_len;
+	guint32 keys_only;
+	guint32 marker;
 
-	namespace_len = strlen(namespace) + 1;
+	namespace_len = strlen(iterator->namespace) + 1;
 
-	if (prefix == NULL)
+	if (iterator->prefix == NULL)
 	{
 		message_type = J_MESSAGE_KV_GET_ALL;
 		prefix_len = 0;
@@ -83,38 +220,183 @@ fetch_reply(guint32 index, gchar const* namespace, gchar const* prefix)
 	else
 	{
 		message_type = J_MESSAGE_KV_GET_BY_PREFIX;
-		prefix_len = strlen(prefix) + 1;
+		prefix_len = strlen(iterator->prefix) + 1;
 	}
 
-	message = j_message_new(message_type, namespace_len + prefix_len);
-	j_message_append_n(message, namespace, namespace_len);
+	// Empty strings are used for missing bounds
+	start_key = (iterator->start_key != NULL) ? iterator->start_key : "";
+	end_key = (iterator->end_key != NULL) ? iterator->end_key : "";
+	start_key_len = strlen(start_key) + 1;
+	end_key_len = strlen(end_key) + 1;
+	keys_only = (iterator->flags & J_KV_ITERATOR_KEYS_ONLY) ? 1 : 0;
+
+	message = j_message_new(message_type, namespace_len + prefix_len + 8 + 4 + 4 + start_key_len + end_key_len);
+	j_message_append_n(message, iterator->namespace, namespace_len);
 
-	if (prefix != NULL)
+	if (iterator->prefix != NULL)
 	{
-		j_message_append_n(message, prefix, prefix_len);
+		j_message_append_n(message, iterator->prefix, prefix_len);
 	}
 
+	j_message_append_8(message, &cursor_id);
+	j_message_append_4(message, &count);
+	j_message_append_4(message, &keys_only);
+	j_message_append_n(message, start_key, start_key_len);
+	j_message_append_n(message, end_key, end_key_len);
+
 	kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
 	j_message_send(message, kv_connection);
 
-	reply = j_message_new_reply(message);
-	j_message_receive(reply, kv_connection);
+	page = g_new(JKVIteratorPage, 1);
+	page->index = index;
+	page->reply = j_message_new_reply(message);
+	page->entries = g_array_sized_new(FALSE, FALSE, sizeof(JKVIteratorEntry), count);
+	page->current = 0;
+
+	j_message_receive(page->reply, kv_connection);
 
 	j_connection_pool_push(J_BACKEND_TYPE_KV, index, kv_connection);
 
-	return reply;
+	// Parse the whole page up front, the cursor ID is only known at its end
+	while ((marker = j_message_get_4(page->reply)) == 1)
+	{
+		JKVIteratorEntry entry;
+
+		entry.key = j_message_get_string(page->reply);
+		entry.len = j_message_get_4(page->reply);
+		entry.value = (keys_only) ? NULL : j_message_get_n(page->reply, entry.len);
+
+		g_array_append_val(page->entries, entry);
+	}
+
+	if (marker == 2)
+	{
+		g_warning("Cursor of key-value iterator on server %u has expired, entries are missing.", index);
+	}
+
+	page->cursor_id = j_message_get_8(page->reply);
+
+	return page;
 }
 
-JKVIterator*
-j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
+static gpointer
+j_kv_iterator_fetch(gpointer data)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JKVIterator* iterator;
+	JKVIteratorFetch* fetch = data;
+	JKVIteratorPage* page;
 
-	JConfiguration* configuration = j_configuration();
+	page = fetch_page(fetch->iterator, fetch->index, fetch->cursor_id, fetch->count);
+	g_free(fetch);
 
-	g_return_val_if_fail(namespace != NULL, NULL);
+	return page;
+}
+
+/**
+ * Starts fetching a page in the background.
+ *
+ * \private
+ *
+ * \param iterator  An iterator.
+ * \param index     The server.
+ * \param cursor_id The server-side cursor, 0 to start a new scan.
+ * \param count     The maximum number of entries.
+ **/
+static void
+j_kv_iterator_prefetch(JKVIterator* iterator, guint32 index, guint64 cursor_id, guint32 count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVIteratorFetch* fetch;
+
+	g_return_if_fail(iterator->prefetch == NULL);
+
+	fetch = g_new(JKVIteratorFetch, 1);
+	fetch->iterator = iterator;
+	fetch->index = index;
+	fetch->cursor_id = cursor_id;
+	fetch->count = count;
+
+	iterator->prefetch = j_background_operation_new(j_kv_iterator_fetch, fetch);
+}
+
+/**
+ * Closes a server-side cursor that will not be read anymore.
+ *
+ * \private
+ *
+ * \param iterator  An iterator.
+ * \param index     The server.
+ * \param cursor_id The server-side cursor.
+ **/
+static void
+j_kv_iterator_close(JKVIterator* iterator, guint32 index, guint64 cursor_id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (cursor_id != 0)
+	{
+		j_kv_iterator_page_free(fetch_page(iterator, index, cursor_id, 0));
+	}
+}
+
+/**
+ * Waits for the page being prefetched and starts prefetching the one after it.
+ *
+ * \private
+ *
+ * \param iterator An iterator.
+ *
+ * \return The page.
+ **/
+static JKVIteratorPage*
+j_kv_iterator_take_page(JKVIterator* iterator)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVIteratorPage* page;
+	guint32 count = J_KV_ITERATOR_PAGE_SIZE;
+
+	page = j_background_operation_wait(iterator->prefetch);
+	j_background_operation_unref(iterator->prefetch);
+	iterator->prefetch = NULL;
+
+	iterator->received += page->entries->len;
+
+	if (iterator->limit > 0)
+	{
+		count = MIN(count, iterator->limit - MIN(iterator->limit, iterator->received));
+	}
+
+	// Request the next page while the caller consumes this one
+	if (count == 0)
+	{
+		j_kv_iterator_close(iterator, page->index, page->cursor_id);
+	}
+	else if (page->cursor_id != 0)
+	{
+		j_kv_iterator_prefetch(iterator, page->index, page->cursor_id, count);
+	}
+	else if (page->index + 1 < iterator->index_end)
+	{
+		j_kv_iterator_prefetch(iterator, page->index + 1, 0, count);
+	}
+
+	return page;
+}
+
+/**
+ * Creates a new iterator for the servers in [\p index_begin, \p index_end).
+ *
+ * \private
+ **/
+static JKVIterator*
+j_kv_iterator_new_internal(guint32 index_begin, guint32 index_end, gchar const* namespace, gchar const* prefix, gchar const* start_key, gchar const* end_key, guint32 limit, JKVIteratorFlags flags)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVIterator* iterator;
 
 	/// \todo still necessary?
 	//j_operation_cache_flush();
@@ -125,17 +407,22 @@ j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
 	iterator->key = NULL;
 	iterator->value = NULL;
 	iterator->len = 0;
-	iterator->replies_n = j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV);
-	iterator->replies = g_new0(JMessage*, iterator->replies_n);
-	iterator->replies_cur = 0;
+	iterator->namespace = g_strdup(namespace);
+	iterator->prefix = g_strdup(prefix);
+	iterator->start_key = g_strdup(start_key);
+	iterator->end_key = g_strdup(end_key);
+	iterator->limit = limit;
+	iterator->flags = flags;
+	iterator->returned = 0;
+	iterator->received = 0;
+	iterator->index_end = index_end;
+	iterator->page = NULL;
+	iterator->prefetch = NULL;
 	iterator->done = (iterator->kv_backend == NULL);
 
 	if (iterator->kv_backend == NULL)
 	{
-		for (guint32 i = 0; i < iterator->replies_n; i++)
-		{
-			iterator->replies[i] = fetch_reply(i, namespace, prefix);
-		}
+		j_kv_iterator_prefetch(iterator, index_begin, 0, (limit > 0) ? MIN(limit, J_KV_ITERATOR_PAGE_SIZE) : J_KV_ITERATOR_PAGE_SIZE);
 	}
 	else
 	{
@@ -153,48 +440,40 @@ j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
 }
 
 JKVIterator*
-j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const* prefix)
+j_kv_iterator_new(gchar const* namespace, gchar const* prefix)
 {
 	J_TRACE_FUNCTION(NULL);
 
-	JKVIterator* iterator;
+	JConfiguration* configuration = j_configuration();
+
+	g_return_val_if_fail(namespace != NULL, NULL);
+
+	return j_kv_iterator_new_internal(0, j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), namespace, prefix, NULL, NULL, 0, J_KV_ITERATOR_NONE);
+}
+
+JKVIterator*
+j_kv_iterator_new_for_index(guint32 index, gchar const* namespace, gchar const* prefix)
+{
+	J_TRACE_FUNCTION(NULL);
 
 	JConfiguration* configuration = j_configuration();
 
 	g_return_val_if_fail(namespace != NULL, NULL);
 	g_return_val_if_fail(index < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), NULL);
 
-	/// \todo still necessary?
-	//j_operation_cache_flush();
+	return j_kv_iterator_new_internal(index, index + 1, namespace, prefix, NULL, NULL, 0, J_KV_ITERATOR_NONE);
+}
 
-	iterator = g_new(JKVIterator, 1);
-	iterator->kv_backend = j_kv_get_backend();
-	iterator->cursor = NULL;
-	iterator->key = NULL;
-	iterator->value = NULL;
-	iterator->len = 0;
-	iterator->replies_n = 1;
-	iterator->replies = g_new0(JMessage*, 1);
-	iterator->replies_cur = 0;
-	iterator->done = (iterator->kv_backend == NULL);
+JKVIterator*
+j_kv_iterator_new_range(gchar const* namespace, gchar const* prefix, gchar const* start_key, gchar const* end_key, guint32 limit, JKVIteratorFlags flags)
+{
+	J_TRACE_FUNCTION(NULL);
 
-	if (iterator->kv_backend == NULL)
-	{
-		iterator->replies[0] = fetch_reply(index, namespace, prefix);
-	}
-	else
-	{
-		if (prefix == NULL)
-		{
-			j_backend_kv_get_all(iterator->kv_backend, namespace, &(iterator->cursor));
-		}
-		else
-		{
-			j_backend_kv_get_by_prefix(iterator->kv_backend, namespace, prefix, &(iterator->cursor));
-		}
-	}
+	JConfiguration* configuration = j_configuration();
 
-	return iterator;
+	g_return_val_if_fail(namespace != NULL, NULL);
+
+	return j_kv_iterator_new_internal(0, j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), namespace, prefix, start_key, end_key, limit, flags);
 }
 
 void
@@ -204,23 +483,29 @@ j_kv_iterator_free(JKVIterator* iterator)
 
 	g_return_if_fail(iterator != NULL);
 
-	if (!iterator->done)
+	if (!iterator->done && iterator->kv_backend != NULL)
 	{
-		// There is currently no way to cancel an iterator, so drain it.
-		while (j_kv_iterator_next(iterator))
-		{
-		}
+		j_backend_kv_iterate_abort(iterator->kv_backend, iterator->cursor);
 	}
 
-	for (guint32 i = 0; i < iterator->replies_n; i++)
+	if (iterator->prefetch != NULL)
 	{
-		if (iterator->replies[i] != NULL)
-		{
-			j_message_unref(iterator->replies[i]);
-		}
+		JKVIteratorPage* page;
+
+		page = j_background_operation_wait(iterator->prefetch);
+		j_background_operation_unref(iterator->prefetch);
+
+		// Remote cursors can be closed, so there is no need to fetch the remaining entries
+		j_kv_iterator_close(iterator, page->index, page->cursor_id);
+		j_kv_iterator_page_free(page);
 	}
 
-	g_free(iterator->replies);
+	j_kv_iterator_page_free(iterator->page);
+
+	g_free(iterator->namespace);
+	g_free(iterator->prefix);
+	g_free(iterator->start_key);
+	g_free(iterator->end_key);
 
 	g_free(iterator);
 }
@@ -234,30 +519,64 @@ j_kv_iterator_next(JKVIterator* iterator)
 
 	g_return_val_if_fail(iterator != NULL, FALSE);
 
-	if (iterator->kv_backend == NULL)
+	if (iterator->limit > 0 && iterator->returned >= iterator->limit)
 	{
-	retry:
-		iterator->len = j_message_get_4(iterator->replies[iterator->replies_cur]);
+		return FALSE;
+	}
 
-		if (iterator->len > 0)
+	if (iterator->kv_backend == NULL)
+	{
+		while (TRUE)
 		{
-			iterator->value = j_message_get_n(iterator->replies[iterator->replies_cur], iterator->len);
-			iterator->key = j_message_get_string(iterator->replies[iterator->replies_cur]);
+			if (iterator->page != NULL && iterator->page->current < iterator->page->entries->len)
+			{
+				JKVIteratorEntry* entry;
 
-			ret = TRUE;
-		}
-		else if (iterator->replies_cur < iterator->replies_n - 1)
-		{
-			iterator->replies_cur++;
-			goto retry;
+				entry = &g_array_index(iterator->page->entries, JKVIteratorEntry, iterator->page->current);
+				iterator->page->current++;
+
+				iterator->key = entry->key;
+				iterator->value = entry->value;
+				iterator->len = entry->len;
+
+				ret = TRUE;
+				break;
+			}
+
+			if (iterator->prefetch == NULL)
+			{
+				break;
+			}
+
+			j_kv_iterator_page_free(iterator->page);
+			iterator->page = j_kv_iterator_take_page(iterator);
 		}
 	}
 	else
 	{
-		ret = j_backend_kv_iterate(iterator->kv_backend, iterator->cursor, &(iterator->key), &(iterator->value), &(iterator->len));
+		while ((ret = j_backend_kv_iterate(iterator->kv_backend, iterator->cursor, &(iterator->key), &(iterator->value), &(iterator->len))))
+		{
+			if ((iterator->start_key != NULL && g_strcmp0(iterator->key, iterator->start_key) < 0) || (iterator->end_key != NULL && g_strcmp0(iterator->key, iterator->end_key) >= 0))
+			{
+				continue;
+			}
+
+			if (iterator->flags & J_KV_ITERATOR_KEYS_ONLY)
+			{
+				iterator->value = NULL;
+			}
+
+			break;
+		}
+
 		iterator->done = !ret;
 	}
 
+	if (ret)
+	{
+		iterator->returned++;
+	}
+
 	return ret;
 }
 
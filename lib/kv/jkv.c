@@ -82,6 +82,11 @@ struct JKV
 	 **/
 	gchar* key;
 
+	/**
+	 * Identifies the data accessed by the kv's operations in a batch, see JOperation.
+	 **/
+	gchar* batch_key;
+
 	/**
 	 * The reference count.
 	 **/
@@ -160,7 +165,7 @@ j_kv_put_free(gpointer data)
 		operation->put.value_destroy(operation->put.value);
 	}
 
-	g_free(operation);
+	j_slab_delete(JKVOperation, operation);
 }
 
 static void
@@ -182,18 +187,89 @@ j_kv_get_free(gpointer data)
 
 	j_kv_unref(operation->get.kv);
 
-	g_free(operation);
+	j_slab_delete(JKVOperation, operation);
+}
+
+static void
+j_kv_read_cache_invalidate(JKV* kv)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCache* read_cache;
+
+	if ((read_cache = j_read_cache()) != NULL)
+	{
+		// The batch key identifies the kv unambiguously and is used for the read cache as well
+		j_read_cache_invalidate(read_cache, kv->batch_key);
+	}
+}
+
+/**
+ * Hands a value to a get operation.
+ *
+ * \param kop       A get operation.
+ * \param value     The value, which is owned by the operation afterwards.
+ * \param value_len The value's length.
+ **/
+static void
+j_kv_get_return(JKVOperation* kop, gpointer value, guint32 value_len)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	// We need to call the callback even if the key is not found
+	if (kop->get.func != NULL)
+	{
+		kop->get.func(value, value_len, kop->get.data);
+	}
+	else
+	{
+		*(kop->get.value) = value;
+		*(kop->get.value_len) = value_len;
+	}
+}
+
+static guint64
+j_kv_put_cache(gpointer data, gpointer buffer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JKVOperation* operation = data;
+
+	// The value is already owned by the operation
+	if (operation->put.value_destroy != NULL)
+	{
+		return 0;
+	}
+
+	if (buffer != NULL)
+	{
+		memcpy(buffer, operation->put.value, operation->put.value_len);
+		operation->put.value = buffer;
+	}
+
+	return operation->put.value_len;
+}
+
+static guint64
+j_kv_delete_cache(gpointer data, gpointer buffer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	(void)data;
+	(void)buffer;
+
+	return 0;
 }
 
 static gboolean
-j_kv_put_exec(JList* operations, JSemantics* semantics)
+j_kv_put_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret = TRUE;
 
 	JBackend* kv_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	JSemanticsPersistency persistency;
 	gchar const* namespace;
@@ -207,7 +283,7 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 	{
 		JKVOperation* kop;
 
-		kop = j_list_get_first(operations);
+		kop = j_vector_get_first(operations);
 		g_assert(kop != NULL);
 
 		namespace = kop->put.kv->namespace;
@@ -216,7 +292,7 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 	}
 
 	persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	kv_backend = j_kv_get_backend();
 
 	if (kv_backend == NULL)
@@ -238,9 +314,9 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 		ret = j_backend_kv_batch_start(kv_backend, namespace, semantics, &kv_batch);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JKVOperation* kop = j_list_iterator_get(it);
+		JKVOperation* kop = j_vector_iterator_get(it);
 
 		if (kv_backend == NULL)
 		{
@@ -283,18 +359,33 @@ j_kv_put_exec(JList* operations, JSemantics* semantics)
 		ret = j_backend_kv_batch_execute(kv_backend, kv_batch) && ret;
 	}
 
+	if (j_read_cache() != NULL)
+	{
+		JVectorIterator iter[1];
+
+		// Gets executed after j_kv_put() might have cached the previous value
+		j_vector_iterator_init(iter, operations);
+
+		while (j_vector_iterator_next(iter))
+		{
+			JKVOperation* kop = j_vector_iterator_get(iter);
+
+			j_kv_read_cache_invalidate(kop->put.kv);
+		}
+	}
+
 	return ret;
 }
 
 static gboolean
-j_kv_delete_exec(JList* operations, JSemantics* semantics)
+j_kv_delete_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret = TRUE;
 
 	JBackend* kv_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	JSemanticsPersistency persistency;
 	gchar const* namespace;
@@ -308,7 +399,7 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 	{
 		JKV* object;
 
-		object = j_list_get_first(operations);
+		object = j_vector_get_first(operations);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
@@ -317,7 +408,7 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 	}
 
 	persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	kv_backend = j_kv_get_backend();
 
 	if (kv_backend == NULL)
@@ -331,9 +422,9 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 		ret = j_backend_kv_batch_start(kv_backend, namespace, semantics, &kv_batch);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JKV* kv = j_list_iterator_get(it);
+		JKV* kv = j_vector_iterator_get(it);
 
 		if (kv_backend == NULL)
 		{
@@ -374,22 +465,41 @@ j_kv_delete_exec(JList* operations, JSemantics* semantics)
 		ret = j_backend_kv_batch_execute(kv_backend, kv_batch) && ret;
 	}
 
+	if (j_read_cache() != NULL)
+	{
+		JVectorIterator iter[1];
+
+		// Gets executed after j_kv_delete() might have cached the previous value
+		j_vector_iterator_init(iter, operations);
+
+		while (j_vector_iterator_next(iter))
+		{
+			JKV* kv = j_vector_iterator_get(iter);
+
+			j_kv_read_cache_invalidate(kv);
+		}
+	}
+
 	return ret;
 }
 
 static gboolean
-j_kv_get_exec(JList* operations, JSemantics* semantics)
+j_kv_get_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret = TRUE;
 
 	JBackend* kv_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JReadCache* read_cache;
+	JSemanticsConsistency consistency;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
+	g_autoptr(GPtrArray) fetches = NULL;
 	gchar const* namespace;
 	gpointer kv_batch = NULL;
 	gsize namespace_len;
+	gint64 since;
 	guint32 index;
 
 	g_return_val_if_fail(operations != NULL, FALSE);
@@ -398,7 +508,7 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 	{
 		JKVOperation* kop;
 
-		kop = j_list_get_first(operations);
+		kop = j_vector_get_first(operations);
 		g_assert(kop != NULL);
 
 		namespace = kop->get.kv->namespace;
@@ -406,7 +516,15 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 		index = kop->get.kv->index;
 	}
 
-	it = j_list_iterator_new(operations);
+	consistency = j_semantics_get(semantics, J_SEMANTICS_CONSISTENCY);
+	read_cache = j_read_cache();
+	// Has to be determined before fetching any values
+	since = g_get_monotonic_time();
+
+	// Operations that could not be answered from the read cache
+	fetches = g_ptr_array_new();
+
+	j_vector_iterator_init(it, operations);
 	kv_backend = j_kv_get_backend();
 
 	if (kv_backend == NULL)
@@ -425,12 +543,26 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 	}
 	else
 	{
-		ret = j_backend_kv_batch_start(kv_backend, namespace, semantics, &kv_batch);
+		ret = j_backend_kv_batch_start_read_only(kv_backend, namespace, semantics, &kv_batch);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JKVOperation* kop = j_list_iterator_get(it);
+		JKVOperation* kop = j_vector_iterator_get(it);
+
+		if (read_cache != NULL)
+		{
+			gpointer value = NULL;
+			guint32 len = 0;
+
+			if (j_read_cache_get(read_cache, kop->get.kv->batch_key, consistency, &value, &len))
+			{
+				j_kv_get_return(kop, value, len);
+				continue;
+			}
+		}
+
+		g_ptr_array_add(fetches, kop);
 
 		if (kv_backend == NULL)
 		{
@@ -449,36 +581,35 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 			// j_backend_kv_get returns a new copy, pass it along
 			ret = j_backend_kv_get(kv_backend, kv_batch, kop->get.kv->key, &value, &len) && ret;
 
-			// We need to call the callback even if the key is not found
-			if (kop->get.func != NULL)
+			if (read_cache != NULL && len > 0)
 			{
-				kop->get.func(value, len, kop->get.data);
-			}
-			else
-			{
-				*(kop->get.value) = value;
-				*(kop->get.value_len) = len;
+				j_read_cache_put(read_cache, kop->get.kv->batch_key, value, len, since);
 			}
+
+			j_kv_get_return(kop, value, len);
 		}
 	}
 
 	if (kv_backend == NULL)
 	{
-		g_autoptr(JListIterator) iter = NULL;
 		g_autoptr(JMessage) reply = NULL;
 		gpointer kv_connection;
 
+		// All values have been found in the read cache
+		if (fetches->len == 0)
+		{
+			return ret;
+		}
+
 		kv_connection = j_connection_pool_pop(J_BACKEND_TYPE_KV, index);
 		j_message_send(message, kv_connection);
 
 		reply = j_message_new_reply(message);
 		j_message_receive(reply, kv_connection);
 
-		iter = j_list_iterator_new(operations);
-
-		while (j_list_iterator_next(iter))
+		for (guint i = 0; i < fetches->len; i++)
 		{
-			JKVOperation* kop = j_list_iterator_get(iter);
+			JKVOperation* kop = g_ptr_array_index(fetches, i);
 			guint32 len;
 			gpointer value = NULL;
 
@@ -497,18 +628,14 @@ j_kv_get_exec(JList* operations, JSemantics* semantics)
 #else
 				value = g_memdup(data, len);
 #endif
-			}
 
-			// We need to call the callback even if the key is not found
-			if (kop->get.func != NULL)
-			{
-				kop->get.func(value, len, kop->get.data);
-			}
-			else
-			{
-				*(kop->get.value) = value;
-				*(kop->get.value_len) = len;
+				if (read_cache != NULL)
+				{
+					j_read_cache_put(read_cache, kop->get.kv->batch_key, data, len, since);
+				}
 			}
+
+			j_kv_get_return(kop, value, len);
 		}
 
 		j_connection_pool_push(J_BACKEND_TYPE_KV, index, kv_connection);
@@ -532,10 +659,11 @@ j_kv_new(gchar const* namespace, gchar const* key)
 	g_return_val_if_fail(namespace != NULL, NULL);
 	g_return_val_if_fail(key != NULL, NULL);
 
-	kv = g_new(JKV, 1);
+	kv = j_slab_new(JKV);
 	kv->index = j_helper_hash(key) % j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV);
 	kv->namespace = g_strdup(namespace);
 	kv->key = g_strdup(key);
+	kv->batch_key = g_strdup_printf("kv:%u:%zu:%s:%s", kv->index, strlen(namespace), namespace, key);
 	kv->ref_count = 1;
 
 	return kv;
@@ -553,10 +681,11 @@ j_kv_new_for_index(guint32 index, gchar const* namespace, gchar const* key)
 	g_return_val_if_fail(key != NULL, NULL);
 	g_return_val_if_fail(index < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_KV), NULL);
 
-	kv = g_new(JKV, 1);
+	kv = j_slab_new(JKV);
 	kv->index = index;
 	kv->namespace = g_strdup(namespace);
 	kv->key = g_strdup(key);
+	kv->batch_key = g_strdup_printf("kv:%u:%zu:%s:%s", kv->index, strlen(namespace), namespace, key);
 	kv->ref_count = 1;
 
 	return kv;
@@ -583,10 +712,11 @@ j_kv_unref(JKV* kv)
 
 	if (g_atomic_int_dec_and_test(&(kv->ref_count)))
 	{
+		g_free(kv->batch_key);
 		g_free(kv->key);
 		g_free(kv->namespace);
 
-		g_free(kv);
+		j_slab_delete(JKV, kv);
 	}
 }
 
@@ -600,18 +730,20 @@ j_kv_put(JKV* kv, gpointer value, guint32 value_len, GDestroyNotify value_destro
 
 	g_return_if_fail(kv != NULL);
 
-	kop = g_new(JKVOperation, 1);
+	j_kv_read_cache_invalidate(kv);
+
+	kop = j_slab_new(JKVOperation);
 	kop->put.kv = j_kv_ref(kv);
 	kop->put.value = value;
 	kop->put.value_len = value_len;
 	kop->put.value_destroy = value_destroy;
 
 	operation = j_operation_new();
-	/// \todo key = index + namespace
-	operation->key = kv;
+	operation->key = kv->batch_key;
 	operation->data = kop;
 	operation->exec_func = j_kv_put_exec;
 	operation->free_func = j_kv_put_free;
+	operation->cache_func = j_kv_put_cache;
 
 	j_batch_add(batch, operation);
 }
@@ -625,11 +757,14 @@ j_kv_delete(JKV* kv, JBatch* batch)
 
 	g_return_if_fail(kv != NULL);
 
+	j_kv_read_cache_invalidate(kv);
+
 	operation = j_operation_new();
-	operation->key = kv;
+	operation->key = kv->batch_key;
 	operation->data = j_kv_ref(kv);
 	operation->exec_func = j_kv_delete_exec;
 	operation->free_func = j_kv_delete_free;
+	operation->cache_func = j_kv_delete_cache;
 
 	j_batch_add(batch, operation);
 }
@@ -644,7 +779,7 @@ j_kv_get(JKV* kv, gpointer* value, guint32* value_len, JBatch* batch)
 
 	g_return_if_fail(kv != NULL);
 
-	kop = g_new(JKVOperation, 1);
+	kop = j_slab_new(JKVOperation);
 	kop->get.kv = j_kv_ref(kv);
 	kop->get.value = value;
 	kop->get.value_len = value_len;
@@ -652,7 +787,7 @@ j_kv_get(JKV* kv, gpointer* value, guint32* value_len, JBatch* batch)
 	kop->get.data = NULL;
 
 	operation = j_operation_new();
-	operation->key = kv;
+	operation->key = kv->batch_key;
 	operation->data = kop;
 	operation->exec_func = j_kv_get_exec;
 	operation->free_func = j_kv_get_free;
@@ -671,7 +806,7 @@ j_kv_get_callback(JKV* kv, JKVGetFunc func, gpointer data, JBatch* batch)
 	g_return_if_fail(kv != NULL);
 	g_return_if_fail(func != NULL);
 
-	kop = g_new(JKVOperation, 1);
+	kop = j_slab_new(JKVOperation);
 	kop->get.kv = j_kv_ref(kv);
 	kop->get.value = NULL;
 	kop->get.value_len = NULL;
@@ -679,7 +814,7 @@ j_kv_get_callback(JKV* kv, JKVGetFunc func, gpointer data, JBatch* batch)
 	kop->get.data = data;
 
 	operation = j_operation_new();
-	operation->key = kv;
+	operation->key = kv->batch_key;
 	operation->data = kop;
 	operation->exec_func = j_kv_get_exec;
 	operation->free_func = j_kv_get_free;
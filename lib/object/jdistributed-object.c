@@ -139,6 +139,12 @@ struct JDistributedObject
 	 **/
 	gchar* name;
 
+	/**
+	 * Identifies the data accessed by the object's operations in a batch, see JOperation.
+	 * Objects with the same namespace and name share it because the distributed object uses the same backend objects.
+	 **/
+	gchar* batch_key;
+
 	JDistribution* distribution;
 
 	/**
@@ -348,11 +354,15 @@ j_distributed_object_read_background_operation(gpointer data)
 	while (operations_done < operation_count)
 	{
 		guint32 reply_operation_count;
+		g_autoptr(GArray) vectors = NULL;
 
 		j_message_receive(reply, object_connection);
 
 		reply_operation_count = j_message_get_count(reply);
 
+		// All payloads of a reply are received using a single vectored read.
+		vectors = g_array_sized_new(FALSE, FALSE, sizeof(GInputVector), reply_operation_count);
+
 		if (reply_operation_count == 0)
 		{
 			background_data->ret = FALSE;
@@ -372,13 +382,14 @@ j_distributed_object_read_background_operation(gpointer data)
 
 			if (nbytes > 0)
 			{
-				GInputStream* input;
+				GInputVector vector = { read_data, nbytes };
 
-				input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-				g_input_stream_read_all(input, read_data, nbytes, NULL, NULL, NULL);
+				g_array_append_val(vectors, vector);
 			}
 		}
 
+		j_message_receive_data_vectors(reply, object_connection, (GInputVector*)vectors->data, vectors->len);
+
 		operations_done += reply_operation_count;
 	}
 
@@ -553,7 +564,7 @@ j_distributed_object_sync_background_operation(gpointer data)
 }
 
 static gboolean
-j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_create_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -561,7 +572,7 @@ j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
@@ -573,14 +584,14 @@ j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
 	{
 		JDistributedObject* object;
 
-		object = j_list_get_first(operations);
+		object = j_vector_get_first(operations);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
 		namespace_len = strlen(namespace) + 1;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -605,9 +616,9 @@ j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
 		}
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObject* object = j_list_iterator_get(it);
+		JDistributedObject* object = j_vector_iterator_get(it);
 
 		if (object_backend == NULL)
 		{
@@ -658,14 +669,14 @@ j_distributed_object_create_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_delete_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
@@ -677,14 +688,14 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 	{
 		JDistributedObject* object;
 
-		object = j_list_get_first(operations);
+		object = j_vector_get_first(operations);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
 		namespace_len = strlen(namespace) + 1;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -701,9 +712,9 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 		}
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObject* object = j_list_iterator_get(it);
+		JDistributedObject* object = j_vector_iterator_get(it);
 
 		if (object_backend == NULL)
 		{
@@ -770,7 +781,7 @@ j_distributed_object_delete_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_read_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -779,13 +790,15 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 
 	JBackend* object_backend;
 	g_autofree JList** br_lists = NULL;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	JDistributedObject* object = NULL;
 	gpointer object_handle;
 	gsize name_len = 0;
 	gsize namespace_len = 0;
+	guint32 message_count = 0;
 	guint32 server_count = 0;
+	guint32 window = 0;
 
 	/// \todo
 	//JLock* lock = NULL;
@@ -794,26 +807,29 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObjectOperation* operation = j_vector_get_first(operations);
 		g_assert(operation != NULL);
 
 		object = operation->read.object;
 		g_assert(object != NULL);
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
-		br_lists = g_new(JList*, server_count);
+		// Each server gets up to window messages that are in flight concurrently
+		window = j_configuration_get_stripe_window(j_configuration());
+		message_count = server_count * window;
+		messages = g_new(JMessage*, message_count);
+		br_lists = g_new(JList*, message_count);
 
 		namespace_len = strlen(object->namespace) + 1;
 		name_len = strlen(object->name) + 1;
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			messages[i] = NULL;
 			br_lists[i] = NULL;
@@ -831,9 +847,9 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 	}
 	*/
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObjectOperation* operation = j_vector_iterator_get(it);
 		gpointer data = operation->read.data;
 		guint64 length = operation->read.length;
 		guint64 offset = operation->read.offset;
@@ -855,26 +871,30 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 			while (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
 			{
 				JDistributedObjectReadBuffer* buffer;
+				guint32 slot;
 
-				if (messages[index] == NULL && br_lists[index] == NULL)
+				// Spread consecutive blocks of a server across its messages, each block always uses the same message to keep overlapping operations in order
+				slot = index * window + ((block_id / server_count) % window);
+
+				if (messages[slot] == NULL && br_lists[slot] == NULL)
 				{
-					messages[index] = j_message_new(J_MESSAGE_OBJECT_READ, namespace_len + name_len);
-					j_message_set_semantics(messages[index], semantics);
-					j_message_append_n(messages[index], object->namespace, namespace_len);
-					j_message_append_n(messages[index], object->name, name_len);
+					messages[slot] = j_message_new(J_MESSAGE_OBJECT_READ, namespace_len + name_len);
+					j_message_set_semantics(messages[slot], semantics);
+					j_message_append_n(messages[slot], object->namespace, namespace_len);
+					j_message_append_n(messages[slot], object->name, name_len);
 
-					br_lists[index] = j_list_new(g_free);
+					br_lists[slot] = j_list_new(g_free);
 				}
 
-				j_message_add_operation(messages[index], sizeof(guint64) + sizeof(guint64));
-				j_message_append_8(messages[index], &new_length);
-				j_message_append_8(messages[index], &new_offset);
+				j_message_add_operation(messages[slot], sizeof(guint64) + sizeof(guint64));
+				j_message_append_8(messages[slot], &new_length);
+				j_message_append_8(messages[slot], &new_offset);
 
 				buffer = g_new(JDistributedObjectReadBuffer, 1);
 				buffer->data = new_data;
 				buffer->bytes_read = bytes_read;
 
-				j_list_append(br_lists[index], buffer);
+				j_list_append(br_lists[slot], buffer);
 
 				/*
 				if (lock != NULL)
@@ -901,9 +921,9 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		background_data = g_new(gpointer, message_count);
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
@@ -914,7 +934,7 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 			}
 
 			data = g_new(JDistributedObjectBackgroundData, 1);
-			data->index = i;
+			data->index = i / window;
 			data->message = messages[i];
 			data->operations = NULL;
 			data->semantics = semantics;
@@ -924,9 +944,9 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 			background_data[i] = data;
 		}
 
-		j_helper_execute_parallel(j_distributed_object_read_background_operation, background_data, server_count);
+		j_helper_execute_parallel(j_distributed_object_read_background_operation, background_data, message_count);
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
@@ -960,7 +980,7 @@ j_distributed_object_read_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_write_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -969,13 +989,15 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 
 	JBackend* object_backend;
 	g_autofree JList** bw_lists = NULL;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	JDistributedObject* object = NULL;
 	gpointer object_handle;
 	gsize name_len = 0;
 	gsize namespace_len = 0;
+	guint32 message_count = 0;
 	guint32 server_count = 0;
+	guint32 window = 0;
 
 	/// \todo
 	//JLock* lock = NULL;
@@ -984,26 +1006,29 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObjectOperation* operation = j_vector_get_first(operations);
 		g_assert(operation != NULL);
 
 		object = operation->write.object;
 		g_assert(object != NULL);
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
 	{
 		server_count = j_configuration_get_server_count(j_configuration(), J_BACKEND_TYPE_OBJECT);
-		messages = g_new(JMessage*, server_count);
-		bw_lists = g_new(JList*, server_count);
+		// Each server gets up to window messages that are in flight concurrently
+		window = j_configuration_get_stripe_window(j_configuration());
+		message_count = server_count * window;
+		messages = g_new(JMessage*, message_count);
+		bw_lists = g_new(JList*, message_count);
 
 		namespace_len = strlen(object->namespace) + 1;
 		name_len = strlen(object->name) + 1;
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			messages[i] = NULL;
 			bw_lists[i] = NULL;
@@ -1021,9 +1046,9 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 	}
 	*/
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObjectOperation* operation = j_vector_iterator_get(it);
 		gconstpointer data = operation->write.data;
 		guint64 length = operation->write.length;
 		guint64 offset = operation->write.offset;
@@ -1044,22 +1069,27 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 
 			while (j_distribution_distribute(object->distribution, &index, &new_length, &new_offset, &block_id))
 			{
-				if (messages[index] == NULL && bw_lists[index] == NULL)
+				guint32 slot;
+
+				// Spread consecutive blocks of a server across its messages, each block always uses the same message to keep overlapping operations in order
+				slot = index * window + ((block_id / server_count) % window);
+
+				if (messages[slot] == NULL && bw_lists[slot] == NULL)
 				{
-					messages[index] = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len);
-					j_message_set_semantics(messages[index], semantics);
-					j_message_append_n(messages[index], object->namespace, namespace_len);
-					j_message_append_n(messages[index], object->name, name_len);
+					messages[slot] = j_message_new(J_MESSAGE_OBJECT_WRITE, namespace_len + name_len);
+					j_message_set_semantics(messages[slot], semantics);
+					j_message_append_n(messages[slot], object->namespace, namespace_len);
+					j_message_append_n(messages[slot], object->name, name_len);
 
-					bw_lists[index] = j_list_new(NULL);
+					bw_lists[slot] = j_list_new(NULL);
 				}
 
-				j_message_add_operation(messages[index], sizeof(guint64) + sizeof(guint64));
-				j_message_append_8(messages[index], &new_length);
-				j_message_append_8(messages[index], &new_offset);
-				j_message_add_send(messages[index], new_data, new_length);
+				j_message_add_operation(messages[slot], sizeof(guint64) + sizeof(guint64));
+				j_message_append_8(messages[slot], &new_length);
+				j_message_append_8(messages[slot], &new_offset);
+				j_message_add_send(messages[slot], new_data, new_length);
 
-				j_list_append(bw_lists[index], bytes_written);
+				j_list_append(bw_lists[slot], bytes_written);
 
 				/*
 				if (lock != NULL)
@@ -1092,9 +1122,9 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 	{
 		g_autofree gpointer* background_data = NULL;
 
-		background_data = g_new(gpointer, server_count);
+		background_data = g_new(gpointer, message_count);
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
@@ -1105,7 +1135,7 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 			}
 
 			data = g_new(JDistributedObjectBackgroundData, 1);
-			data->index = i;
+			data->index = i / window;
 			data->message = messages[i];
 			data->operations = NULL;
 			data->semantics = semantics;
@@ -1115,9 +1145,9 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 			background_data[i] = data;
 		}
 
-		j_helper_execute_parallel(j_distributed_object_write_background_operation, background_data, server_count);
+		j_helper_execute_parallel(j_distributed_object_write_background_operation, background_data, message_count);
 
-		for (guint i = 0; i < server_count; i++)
+		for (guint i = 0; i < message_count; i++)
 		{
 			JDistributedObjectBackgroundData* data;
 
@@ -1151,7 +1181,7 @@ j_distributed_object_write_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_status_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -1159,7 +1189,7 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
@@ -1169,7 +1199,7 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObjectOperation* operation = j_vector_get_first(operations);
 		JDistributedObject* object = operation->status.object;
 
 		g_assert(operation != NULL);
@@ -1179,7 +1209,7 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 		namespace_len = strlen(namespace) + 1;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -1196,9 +1226,9 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 		}
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObjectOperation* operation = j_vector_iterator_get(it);
 		JDistributedObject* object = operation->status.object;
 		gint64* modification_time = operation->status.modification_time;
 		guint64* size = operation->status.size;
@@ -1263,7 +1293,7 @@ j_distributed_object_status_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
+j_distributed_object_sync_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -1271,7 +1301,7 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autofree JMessage** messages = NULL;
 	gchar const* namespace = NULL;
 	gsize namespace_len = 0;
@@ -1281,7 +1311,7 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JDistributedObjectOperation* operation = j_list_get_first(operations);
+		JDistributedObjectOperation* operation = j_vector_get_first(operations);
 		JDistributedObject* object = operation->sync.object;
 
 		g_assert(operation != NULL);
@@ -1291,7 +1321,7 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 		namespace_len = strlen(namespace) + 1;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -1308,9 +1338,9 @@ j_distributed_object_sync_exec(JList* operations, JSemantics* semantics)
 		}
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JDistributedObjectOperation* operation = j_list_iterator_get(it);
+		JDistributedObjectOperation* operation = j_vector_iterator_get(it);
 		JDistributedObject* object = operation->sync.object;
 
 		if (object_backend == NULL)
@@ -1376,6 +1406,7 @@ j_distributed_object_new(gchar const* namespace, gchar const* name, JDistributio
 	object = g_new(JDistributedObject, 1);
 	object->namespace = g_strdup(namespace);
 	object->name = g_strdup(name);
+	object->batch_key = g_strdup_printf("object:%zu:%s:%s", strlen(namespace), namespace, name);
 	object->distribution = j_distribution_ref(distribution);
 	object->ref_count = 1;
 
@@ -1403,6 +1434,7 @@ j_distributed_object_unref(JDistributedObject* object)
 
 	if (g_atomic_int_dec_and_test(&(object->ref_count)))
 	{
+		g_free(object->batch_key);
 		g_free(object->name);
 		g_free(object->namespace);
 
@@ -1423,7 +1455,7 @@ j_distributed_object_create(JDistributedObject* object, JBatch* batch)
 
 	operation = j_operation_new();
 	/// \todo key = index + namespace
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = j_distributed_object_ref(object);
 	operation->exec_func = j_distributed_object_create_exec;
 	operation->free_func = j_distributed_object_create_free;
@@ -1441,7 +1473,7 @@ j_distributed_object_delete(JDistributedObject* object, JBatch* batch)
 	g_return_if_fail(object != NULL);
 
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = j_distributed_object_ref(object);
 	operation->exec_func = j_distributed_object_delete_exec;
 	operation->free_func = j_distributed_object_delete_free;
@@ -1480,7 +1512,7 @@ j_distributed_object_read(JDistributedObject* object, gpointer data, guint64 len
 		iop->read.bytes_read = bytes_read;
 
 		operation = j_operation_new();
-		operation->key = object;
+		operation->key = object->batch_key;
 		operation->data = iop;
 		operation->exec_func = j_distributed_object_read_exec;
 		operation->free_func = j_distributed_object_read_free;
@@ -1526,7 +1558,7 @@ j_distributed_object_write(JDistributedObject* object, gconstpointer data, guint
 		iop->write.bytes_written = bytes_written;
 
 		operation = j_operation_new();
-		operation->key = object;
+		operation->key = object->batch_key;
 		operation->data = iop;
 		operation->exec_func = j_distributed_object_write_exec;
 		operation->free_func = j_distributed_object_write_free;
@@ -1557,7 +1589,7 @@ j_distributed_object_status(JDistributedObject* object, gint64* modification_tim
 	iop->status.size = size;
 
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = iop;
 	operation->exec_func = j_distributed_object_status_exec;
 	operation->free_func = j_distributed_object_status_free;
@@ -1579,7 +1611,7 @@ j_distributed_object_sync(JDistributedObject* object, JBatch* batch)
 	iop->sync.object = j_distributed_object_ref(object);
 
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = iop;
 	operation->exec_func = j_distributed_object_sync_exec;
 	operation->free_func = j_distributed_object_sync_free;
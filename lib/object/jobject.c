@@ -95,6 +95,12 @@ struct JObject
 	 **/
 	gchar* name;
 
+	/**
+	 * Identifies the data accessed by the object's operations in a batch, see JOperation.
+	 * Distributed objects with the same namespace and name share it because they use the same backend objects.
+	 **/
+	gchar* batch_key;
+
 	/**
 	 * The reference count.
 	 **/
@@ -227,8 +233,102 @@ j_object_write_free(gpointer data)
 	g_free(operation);
 }
 
+/**
+ * Returns the key used for an object's status in the read cache.
+ *
+ * \param object An object.
+ *
+ * \return The key. Should be freed with g_free().
+ **/
+static gchar*
+j_object_read_cache_key(JObject* object)
+{
+	// Include the namespace's length to make the key unambiguous
+	return g_strdup_printf("object:%u:%zu:%s:%s", object->index, strlen(object->namespace), object->namespace, object->name);
+}
+
+static void
+j_object_read_cache_invalidate(JObject* object)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCache* read_cache;
+
+	if ((read_cache = j_read_cache()) != NULL)
+	{
+		g_autofree gchar* cache_key = NULL;
+
+		cache_key = j_object_read_cache_key(object);
+		j_read_cache_invalidate(read_cache, cache_key);
+	}
+}
+
+static void
+j_object_read_cache_invalidate_all(JVector* objects)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JVectorIterator it[1];
+
+	if (j_read_cache() == NULL)
+	{
+		return;
+	}
+
+	j_vector_iterator_init(it, objects);
+
+	while (j_vector_iterator_next(it))
+	{
+		JObject* object = j_vector_iterator_get(it);
+
+		j_object_read_cache_invalidate(object);
+	}
+}
+
+static guint64
+j_object_create_cache(gpointer data, gpointer buffer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	(void)data;
+	(void)buffer;
+
+	return 0;
+}
+
+static guint64
+j_object_delete_cache(gpointer data, gpointer buffer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	(void)data;
+	(void)buffer;
+
+	return 0;
+}
+
+static guint64
+j_object_write_cache(gpointer data, gpointer buffer)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JObjectOperation* operation = data;
+
+	if (buffer != NULL)
+	{
+		memcpy(buffer, operation->write.data, operation->write.length);
+		operation->write.data = buffer;
+
+		// The caller's variable might not exist anymore when the write is executed
+		j_helper_atomic_add(operation->write.bytes_written, operation->write.length);
+		operation->write.bytes_written = NULL;
+	}
+
+	return operation->write.length;
+}
+
 static gboolean
-j_object_create_exec(JList* operations, JSemantics* semantics)
+j_object_create_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -236,7 +336,7 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	gchar const* namespace;
 	gsize namespace_len;
@@ -248,7 +348,7 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 	{
 		JObject* object;
 
-		object = j_list_get_first(operations);
+		object = j_vector_get_first(operations);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
@@ -256,7 +356,7 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 		index = object->index;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -274,9 +374,9 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 		j_message_append_n(message, namespace, namespace_len);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JObject* object = j_list_iterator_get(it);
+		JObject* object = j_vector_iterator_get(it);
 
 		if (object_backend == NULL)
 		{
@@ -319,18 +419,21 @@ j_object_create_exec(JList* operations, JSemantics* semantics)
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, index, object_connection);
 	}
 
+	// Status operations executed after j_object_create() might have cached outdated information
+	j_object_read_cache_invalidate_all(operations);
+
 	return ret;
 }
 
 static gboolean
-j_object_delete_exec(JList* operations, JSemantics* semantics)
+j_object_delete_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	g_autoptr(JListIterator) it = NULL;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	gchar const* namespace;
 	gsize namespace_len;
@@ -342,7 +445,7 @@ j_object_delete_exec(JList* operations, JSemantics* semantics)
 	{
 		JObject* object;
 
-		object = j_list_get_first(operations);
+		object = j_vector_get_first(operations);
 		g_assert(object != NULL);
 
 		namespace = object->namespace;
@@ -350,7 +453,7 @@ j_object_delete_exec(JList* operations, JSemantics* semantics)
 		index = object->index;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -360,9 +463,9 @@ j_object_delete_exec(JList* operations, JSemantics* semantics)
 		j_message_append_n(message, namespace, namespace_len);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JObject* object = j_list_iterator_get(it);
+		JObject* object = j_vector_iterator_get(it);
 
 		if (object_backend == NULL)
 		{
@@ -420,11 +523,14 @@ j_object_delete_exec(JList* operations, JSemantics* semantics)
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, index, object_connection);
 	}
 
+	// Status operations executed after j_object_delete() might have cached outdated information
+	j_object_read_cache_invalidate_all(operations);
+
 	return ret;
 }
 
 static gboolean
-j_object_read_exec(JList* operations, JSemantics* semantics)
+j_object_read_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -432,7 +538,7 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	JListIterator* it;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	JObject* object;
 	gpointer object_handle;
@@ -444,7 +550,7 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JObjectOperation* operation = j_list_get_first(operations);
+		JObjectOperation* operation = j_vector_get_first(operations);
 
 		object = operation->read.object;
 
@@ -452,7 +558,7 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		g_assert(object != NULL);
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -480,9 +586,9 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 	}
 	*/
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JObjectOperation* operation = j_list_iterator_get(it);
+		JObjectOperation* operation = j_vector_iterator_get(it);
 		gpointer data = operation->read.data;
 		guint64 length = operation->read.length;
 		guint64 offset = operation->read.offset;
@@ -507,8 +613,6 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		j_trace_file_end(object->name, J_TRACE_FILE_READ, length, offset);
 	}
 
-	j_list_iterator_free(it);
-
 	if (object_backend == NULL)
 	{
 		g_autoptr(JMessage) reply = NULL;
@@ -524,7 +628,7 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		operations_done = 0;
 		operation_count = j_message_get_count(message);
 
-		it = j_list_iterator_new(operations);
+		j_vector_iterator_init(it, operations);
 
 		/**
 		 * This extra loop is necessary because the server might send multiple
@@ -534,20 +638,24 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 		while (operations_done < operation_count)
 		{
 			guint32 reply_operation_count;
+			g_autoptr(GArray) vectors = NULL;
 
 			j_message_receive(reply, object_connection);
 
 			reply_operation_count = j_message_get_count(reply);
 
+			// All payloads of a reply are received using a single vectored read.
+			vectors = g_array_sized_new(FALSE, FALSE, sizeof(GInputVector), reply_operation_count);
+
 			if (reply_operation_count == 0)
 			{
 				ret = FALSE;
 				break;
 			}
 
-			for (guint i = 0; i < reply_operation_count && j_list_iterator_next(it); i++)
+			for (guint i = 0; i < reply_operation_count && j_vector_iterator_next(it); i++)
 			{
-				JObjectOperation* operation = j_list_iterator_get(it);
+				JObjectOperation* operation = j_vector_iterator_get(it);
 				gpointer data = operation->read.data;
 				guint64* bytes_read = operation->read.bytes_read;
 
@@ -558,18 +666,17 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 
 				if (nbytes > 0)
 				{
-					GInputStream* input;
+					GInputVector vector = { data, nbytes };
 
-					input = g_io_stream_get_input_stream(G_IO_STREAM(object_connection));
-					g_input_stream_read_all(input, data, nbytes, NULL, NULL, NULL);
+					g_array_append_val(vectors, vector);
 				}
 			}
 
+			j_message_receive_data_vectors(reply, object_connection, (GInputVector*)vectors->data, vectors->len);
+
 			operations_done += reply_operation_count;
 		}
 
-		j_list_iterator_free(it);
-
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, object->index, object_connection);
 	}
 	else
@@ -591,7 +698,7 @@ j_object_read_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_object_write_exec(JList* operations, JSemantics* semantics)
+j_object_write_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -599,10 +706,12 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	JListIterator* it;
+	JVectorIterator it[1];
+	g_autoptr(GArray) writes = NULL;
 	g_autoptr(JMessage) message = NULL;
 	JObject* object;
 	gpointer object_handle;
+	guint64 max_operation_size;
 
 	/// \todo
 	//JLock* lock = NULL;
@@ -611,7 +720,7 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JObjectOperation* operation = j_list_get_first(operations);
+		JObjectOperation* operation = j_vector_get_first(operations);
 
 		object = operation->write.object;
 
@@ -619,7 +728,34 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 		g_assert(object != NULL);
 	}
 
-	it = j_list_iterator_new(operations);
+	writes = g_array_sized_new(FALSE, FALSE, sizeof(JObjectOperation), j_vector_length(operations));
+	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
+	j_vector_iterator_init(it, operations);
+
+	while (j_vector_iterator_next(it))
+	{
+		JObjectOperation* operation = j_vector_iterator_get(it);
+		JObjectOperation* last = NULL;
+
+		if (writes->len > 0)
+		{
+			last = &g_array_index(writes, JObjectOperation, writes->len - 1);
+		}
+
+		// Coalesce adjacent writes whose data is contiguous, for instance, after being copied by the operation cache
+		if (last != NULL
+		    && last->write.bytes_written == operation->write.bytes_written
+		    && (gchar const*)last->write.data + last->write.length == operation->write.data
+		    && last->write.offset + last->write.length == operation->write.offset
+		    && last->write.length + operation->write.length <= max_operation_size)
+		{
+			last->write.length += operation->write.length;
+			continue;
+		}
+
+		g_array_append_val(writes, *operation);
+	}
+
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -647,9 +783,9 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	}
 	*/
 
-	while (j_list_iterator_next(it))
+	for (guint i = 0; i < writes->len; i++)
 	{
-		JObjectOperation* operation = j_list_iterator_get(it);
+		JObjectOperation* operation = &g_array_index(writes, JObjectOperation, i);
 		gconstpointer data = operation->write.data;
 		guint64 length = operation->write.length;
 		guint64 offset = operation->write.offset;
@@ -672,7 +808,7 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 			j_message_add_send(message, data, length);
 
 			// Fake bytes_written here instead of doing another loop further down
-			if (j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY) == J_SEMANTICS_PERSISTENCY_NONE)
+			if (j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY) == J_SEMANTICS_PERSISTENCY_NONE && bytes_written != NULL)
 			{
 				j_helper_atomic_add(bytes_written, length);
 			}
@@ -682,14 +818,16 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 			guint64 nbytes = 0;
 
 			ret = j_backend_object_write(object_backend, object_handle, data, length, offset, &nbytes) && ret;
-			j_helper_atomic_add(bytes_written, nbytes);
+
+			if (bytes_written != NULL)
+			{
+				j_helper_atomic_add(bytes_written, nbytes);
+			}
 		}
 
 		j_trace_file_end(object->name, J_TRACE_FILE_WRITE, length, offset);
 	}
 
-	j_list_iterator_free(it);
-
 	if (object_backend == NULL)
 	{
 		JSemanticsPersistency persistency;
@@ -710,18 +848,19 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 
 			if (j_message_get_count(reply) > 0)
 			{
-				it = j_list_iterator_new(operations);
-
-				while (j_list_iterator_next(it))
+				for (guint i = 0; i < writes->len; i++)
 				{
-					JObjectOperation* operation = j_list_iterator_get(it);
+					JObjectOperation* operation = &g_array_index(writes, JObjectOperation, i);
 					guint64* bytes_written = operation->write.bytes_written;
 
 					nbytes = j_message_get_8(reply);
-					j_helper_atomic_add(bytes_written, nbytes);
-				}
 
-				j_list_iterator_free(it);
+					// Cached writes have already reported their bytes
+					if (bytes_written != NULL)
+					{
+						j_helper_atomic_add(bytes_written, nbytes);
+					}
+				}
 			}
 			else
 			{
@@ -746,11 +885,52 @@ j_object_write_exec(JList* operations, JSemantics* semantics)
 	}
 	*/
 
+	// Status operations executed after j_object_write() might have cached outdated information
+	j_object_read_cache_invalidate(object);
+
 	return ret;
 }
 
+/**
+ * Hands status information to a status operation and caches it.
+ *
+ * \param operation         A status operation.
+ * \param modification_time The modification time.
+ * \param size              The size.
+ * \param since             The monotonic time at which the status was requested, -1 if it should not be cached.
+ **/
+static void
+j_object_status_return(JObjectOperation* operation, gint64 modification_time, guint64 size, gint64 since)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JReadCache* read_cache;
+
+	if (operation->status.modification_time != NULL)
+	{
+		*(operation->status.modification_time) = modification_time;
+	}
+
+	if (operation->status.size != NULL)
+	{
+		*(operation->status.size) = size;
+	}
+
+	if (since >= 0 && (read_cache = j_read_cache()) != NULL)
+	{
+		g_autofree gchar* cache_key = NULL;
+		guint64 status[2];
+
+		status[0] = modification_time;
+		status[1] = size;
+
+		cache_key = j_object_read_cache_key(operation->status.object);
+		j_read_cache_put(read_cache, cache_key, status, sizeof(status), since);
+	}
+}
+
 static gboolean
-j_object_status_exec(JList* operations, JSemantics* semantics)
+j_object_status_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -758,17 +938,21 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	JListIterator* it;
+	JReadCache* read_cache;
+	JSemanticsConsistency consistency;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
+	g_autoptr(GPtrArray) fetches = NULL;
 	gchar const* namespace;
 	gsize namespace_len;
+	gint64 since;
 	guint32 index;
 
 	g_return_val_if_fail(operations != NULL, FALSE);
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JObjectOperation* operation = j_list_get_first(operations);
+		JObjectOperation* operation = j_vector_get_first(operations);
 		JObject* object = operation->status.object;
 
 		g_assert(operation != NULL);
@@ -779,7 +963,15 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 		index = object->index;
 	}
 
-	it = j_list_iterator_new(operations);
+	consistency = j_semantics_get(semantics, J_SEMANTICS_CONSISTENCY);
+	read_cache = j_read_cache();
+	// Has to be determined before requesting any status information
+	since = g_get_monotonic_time();
+
+	// Operations that could not be answered from the read cache
+	fetches = g_ptr_array_new();
+
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -789,12 +981,33 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 		j_message_append_n(message, namespace, namespace_len);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JObjectOperation* operation = j_list_iterator_get(it);
+		JObjectOperation* operation = j_vector_iterator_get(it);
 		JObject* object = operation->status.object;
-		gint64* modification_time = operation->status.modification_time;
-		guint64* size = operation->status.size;
+
+		if (read_cache != NULL)
+		{
+			g_autofree gchar* cache_key = NULL;
+			gpointer value = NULL;
+			guint32 len = 0;
+
+			cache_key = j_object_read_cache_key(object);
+
+			if (j_read_cache_get(read_cache, cache_key, consistency, &value, &len))
+			{
+				guint64* status = value;
+
+				g_assert(len == 2 * sizeof(guint64));
+
+				j_object_status_return(operation, status[0], status[1], -1);
+				g_free(value);
+
+				continue;
+			}
+		}
+
+		g_ptr_array_add(fetches, operation);
 
 		if (object_backend == NULL)
 		{
@@ -807,17 +1020,25 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 		}
 		else
 		{
-			gpointer object_handle;
+			gpointer object_handle = NULL;
+			gint64 modification_time = 0;
+			guint64 size = 0;
+			gboolean lret;
 
-			ret = j_backend_object_open(object_backend, object->namespace, object->name, &object_handle) && ret;
-			ret = j_backend_object_status(object_backend, object_handle, modification_time, size) && ret;
-			ret = j_backend_object_close(object_backend, object_handle) && ret;
+			lret = j_backend_object_open(object_backend, object->namespace, object->name, &object_handle);
+			lret = lret && j_backend_object_status(object_backend, object_handle, &modification_time, &size);
+			ret = lret && ret;
+
+			if (object_handle != NULL)
+			{
+				ret = j_backend_object_close(object_backend, object_handle) && ret;
+			}
+
+			j_object_status_return(operation, modification_time, size, (lret) ? since : -1);
 		}
 	}
 
-	j_list_iterator_free(it);
-
-	if (object_backend == NULL)
+	if (object_backend == NULL && fetches->len > 0)
 	{
 		g_autoptr(JMessage) reply = NULL;
 		gpointer object_connection;
@@ -828,32 +1049,19 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 		reply = j_message_new_reply(message);
 		j_message_receive(reply, object_connection);
 
-		it = j_list_iterator_new(operations);
-
-		while (j_list_iterator_next(it))
+		for (guint i = 0; i < fetches->len; i++)
 		{
-			JObjectOperation* operation = j_list_iterator_get(it);
-			gint64* modification_time = operation->status.modification_time;
-			guint64* size = operation->status.size;
-			gint64 modification_time_;
-			guint64 size_;
+			JObjectOperation* operation = g_ptr_array_index(fetches, i);
+			gint64 modification_time;
+			guint64 size;
 
-			modification_time_ = j_message_get_8(reply);
-			size_ = j_message_get_8(reply);
+			modification_time = j_message_get_8(reply);
+			size = j_message_get_8(reply);
 
-			if (modification_time != NULL)
-			{
-				*modification_time = modification_time_;
-			}
-
-			if (size != NULL)
-			{
-				*size = size_;
-			}
+			// The server reports a modification time of 0 for objects that do not exist
+			j_object_status_return(operation, modification_time, size, (modification_time != 0) ? since : -1);
 		}
 
-		j_list_iterator_free(it);
-
 		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, index, object_connection);
 	}
 
@@ -861,7 +1069,7 @@ j_object_status_exec(JList* operations, JSemantics* semantics)
 }
 
 static gboolean
-j_object_sync_exec(JList* operations, JSemantics* semantics)
+j_object_sync_exec(JVector* operations, JSemantics* semantics)
 {
 	J_TRACE_FUNCTION(NULL);
 
@@ -869,7 +1077,7 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 	gboolean ret = TRUE;
 
 	JBackend* object_backend;
-	JListIterator* it;
+	JVectorIterator it[1];
 	g_autoptr(JMessage) message = NULL;
 	gchar const* namespace;
 	gsize namespace_len;
@@ -879,7 +1087,7 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 	g_return_val_if_fail(semantics != NULL, FALSE);
 
 	{
-		JObjectOperation* operation = j_list_get_first(operations);
+		JObjectOperation* operation = j_vector_get_first(operations);
 		JObject* object = operation->sync.object;
 
 		g_assert(operation != NULL);
@@ -890,7 +1098,7 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 		index = object->index;
 	}
 
-	it = j_list_iterator_new(operations);
+	j_vector_iterator_init(it, operations);
 	object_backend = j_object_get_backend();
 
 	if (object_backend == NULL)
@@ -900,9 +1108,9 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 		j_message_append_n(message, namespace, namespace_len);
 	}
 
-	while (j_list_iterator_next(it))
+	while (j_vector_iterator_next(it))
 	{
-		JObjectOperation* operation = j_list_iterator_get(it);
+		JObjectOperation* operation = j_vector_iterator_get(it);
 		JObject* object = operation->sync.object;
 
 		if (object_backend == NULL)
@@ -924,8 +1132,6 @@ j_object_sync_exec(JList* operations, JSemantics* semantics)
 		}
 	}
 
-	j_list_iterator_free(it);
-
 	if (object_backend == NULL)
 	{
 		JSemanticsPersistency persistency;
@@ -966,6 +1172,7 @@ j_object_new(gchar const* namespace, gchar const* name)
 	object->index = j_helper_hash(name) % j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT);
 	object->namespace = g_strdup(namespace);
 	object->name = g_strdup(name);
+	object->batch_key = g_strdup_printf("object:%zu:%s:%s", strlen(namespace), namespace, name);
 	object->ref_count = 1;
 
 	return object;
@@ -987,6 +1194,7 @@ j_object_new_for_index(guint32 index, gchar const* namespace, gchar const* name)
 	object->index = index;
 	object->namespace = g_strdup(namespace);
 	object->name = g_strdup(name);
+	object->batch_key = g_strdup_printf("object:%zu:%s:%s", strlen(namespace), namespace, name);
 	object->ref_count = 1;
 
 	return object;
@@ -1013,6 +1221,7 @@ j_object_unref(JObject* object)
 
 	if (g_atomic_int_dec_and_test(&(object->ref_count)))
 	{
+		g_free(object->batch_key);
 		g_free(object->name);
 		g_free(object->namespace);
 
@@ -1029,12 +1238,15 @@ j_object_create(JObject* object, JBatch* batch)
 
 	g_return_if_fail(object != NULL);
 
+	j_object_read_cache_invalidate(object);
+
 	operation = j_operation_new();
 	/// \todo key = index + namespace
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = j_object_ref(object);
 	operation->exec_func = j_object_create_exec;
 	operation->free_func = j_object_create_free;
+	operation->cache_func = j_object_create_cache;
 
 	j_batch_add(batch, operation);
 }
@@ -1048,11 +1260,14 @@ j_object_delete(JObject* object, JBatch* batch)
 
 	g_return_if_fail(object != NULL);
 
+	j_object_read_cache_invalidate(object);
+
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = j_object_ref(object);
 	operation->exec_func = j_object_delete_exec;
 	operation->free_func = j_object_delete_free;
+	operation->cache_func = j_object_delete_cache;
 
 	j_batch_add(batch, operation);
 }
@@ -1088,7 +1303,7 @@ j_object_read(JObject* object, gpointer data, guint64 length, guint64 offset, gu
 		iop->read.bytes_read = bytes_read;
 
 		operation = j_operation_new();
-		operation->key = object;
+		operation->key = object->batch_key;
 		operation->data = iop;
 		operation->exec_func = j_object_read_exec;
 		operation->free_func = j_object_read_free;
@@ -1119,6 +1334,8 @@ j_object_write(JObject* object, gconstpointer data, guint64 length, guint64 offs
 
 	max_operation_size = j_configuration_get_max_operation_size(j_configuration());
 
+	j_object_read_cache_invalidate(object);
+
 	// Chunk operation if necessary
 	while (length > 0)
 	{
@@ -1134,10 +1351,11 @@ j_object_write(JObject* object, gconstpointer data, guint64 length, guint64 offs
 		iop->write.bytes_written = bytes_written;
 
 		operation = j_operation_new();
-		operation->key = object;
+		operation->key = object->batch_key;
 		operation->data = iop;
 		operation->exec_func = j_object_write_exec;
 		operation->free_func = j_object_write_free;
+		operation->cache_func = j_object_write_cache;
 
 		j_batch_add(batch, operation);
 
@@ -1165,7 +1383,7 @@ j_object_status(JObject* object, gint64* modification_time, guint64* size, JBatc
 	iop->status.size = size;
 
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = iop;
 	operation->exec_func = j_object_status_exec;
 	operation->free_func = j_object_status_free;
@@ -1187,7 +1405,7 @@ j_object_sync(JObject* object, JBatch* batch)
 	iop->sync.object = j_object_ref(object);
 
 	operation = j_operation_new();
-	operation->key = object;
+	operation->key = object->batch_key;
 	operation->data = iop;
 	operation->exec_func = j_object_sync_exec;
 	operation->free_func = j_object_sync_free;
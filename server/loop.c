@@ -28,11 +28,463 @@
 
 static guint jd_thread_num = 0;
 
+/**
+ * Cursors that have not been fetched for this many seconds are dropped.
+ **/
+#define JD_DB_CURSOR_TIMEOUT (5 * 60)
+
+/**
+ * The remaining rows of a query result.
+ **/
+struct JdDBCursor
+{
+	/**
+	 * The cursor's ID.
+	 **/
+	guint64 id;
+
+	/**
+	 * All rows of the query result.
+	 **/
+	bson_t rows;
+
+	/**
+	 * Points to the last row that has been sent.
+	 **/
+	bson_iter_t iter;
+
+	/**
+	 * The monotonic time of the last fetch.
+	 **/
+	gint64 last_used;
+};
+
+typedef struct JdDBCursor JdDBCursor;
+
+static GHashTable* jd_db_cursors = NULL;
+static guint64 jd_db_cursor_next_id = 1;
+
+G_LOCK_DEFINE_STATIC(jd_db_cursors);
+
+static void
+jd_db_cursor_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdDBCursor* cursor = data;
+
+	bson_destroy(&(cursor->rows));
+	g_free(cursor);
+}
+
+/**
+ * Copies up to \p count rows from a cursor into \p page.
+ *
+ * \param cursor A cursor.
+ * \param count  The maximum number of rows.
+ * \param page   An initialized BSON document.
+ *
+ * \return TRUE if the cursor has more rows, FALSE otherwise.
+ **/
+static gboolean
+jd_db_cursor_read(JdDBCursor* cursor, guint32 count, bson_t* page)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	bson_iter_t next;
+
+	for (guint32 i = 0; i < count; i++)
+	{
+		gchar buf[16];
+		gchar const* key;
+
+		if (!bson_iter_next(&(cursor->iter)))
+		{
+			return FALSE;
+		}
+
+		// Pages are numbered from zero like complete query results.
+		bson_uint32_to_string(i, &key, buf, sizeof(buf));
+		bson_append_iter(page, key, -1, &(cursor->iter));
+	}
+
+	// Peek at the next row so that exhausted cursors can be dropped immediately.
+	next = cursor->iter;
+
+	return bson_iter_next(&next);
+}
+
+/**
+ * Pages a query result.
+ * If \p rows contains more than \p count rows, the remaining ones are stored in a new cursor.
+ *
+ * \param rows  A query result. Will be replaced with its first \p count rows.
+ * \param count The number of rows per page.
+ *
+ * \return The cursor's ID, 0 if all rows fit into the first page.
+ **/
+static guint64
+jd_db_cursor_new(bson_t* rows, guint32 count)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdDBCursor* cursor;
+	GHashTableIter iter;
+	gpointer value;
+	gint64 now;
+
+	if (bson_count_keys(rows) <= count)
+	{
+		return 0;
+	}
+
+	cursor = g_new(JdDBCursor, 1);
+	bson_steal(&(cursor->rows), rows);
+	bson_iter_init(&(cursor->iter), &(cursor->rows));
+
+	bson_init(rows);
+	jd_db_cursor_read(cursor, count, rows);
+
+	now = g_get_monotonic_time();
+	cursor->last_used = now;
+
+	G_LOCK(jd_db_cursors);
+
+	if (G_UNLIKELY(jd_db_cursors == NULL))
+	{
+		jd_db_cursors = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, jd_db_cursor_free);
+	}
+
+	// Drop cursors of clients that never finished iterating.
+	g_hash_table_iter_init(&iter, jd_db_cursors);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		JdDBCursor* old_cursor = value;
+
+		if (now - old_cursor->last_used > JD_DB_CURSOR_TIMEOUT * G_USEC_PER_SEC)
+		{
+			g_hash_table_iter_remove(&iter);
+		}
+	}
+
+	cursor->id = jd_db_cursor_next_id++;
+	g_hash_table_insert(jd_db_cursors, &(cursor->id), cursor);
+
+	G_UNLOCK(jd_db_cursors);
+
+	return cursor->id;
+}
+
+/**
+ * Fetches the next page of a cursor.
+ * A \p count of 0 closes the cursor.
+ *
+ * \param id    The cursor's ID.
+ * \param count The maximum number of rows.
+ * \param page  An initialized BSON document.
+ * \param error A GError.
+ *
+ * \return The cursor's ID if it has more rows, 0 otherwise.
+ **/
+static guint64
+jd_db_cursor_fetch(guint64 id, guint32 count, bson_t* page, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdDBCursor* cursor = NULL;
+
+	G_LOCK(jd_db_cursors);
+
+	// The cursor is taken out of the table while it is read from to avoid holding the lock.
+	if (jd_db_cursors != NULL && g_hash_table_steal_extended(jd_db_cursors, &id, NULL, (gpointer*)&cursor))
+	{
+		cursor->last_used = g_get_monotonic_time();
+	}
+
+	G_UNLOCK(jd_db_cursors);
+
+	if (cursor == NULL)
+	{
+		if (count > 0)
+		{
+			g_set_error_literal(error, J_BACKEND_DB_ERROR, J_BACKEND_DB_ERROR_ITERATOR_INVALID, "cursor invalid");
+		}
+
+		return 0;
+	}
+
+	if (count == 0 || !jd_db_cursor_read(cursor, count, page))
+	{
+		jd_db_cursor_free(cursor);
+
+		return 0;
+	}
+
+	G_LOCK(jd_db_cursors);
+	g_hash_table_insert(jd_db_cursors, &(cursor->id), cursor);
+	G_UNLOCK(jd_db_cursors);
+
+	return id;
+}
+
+/**
+ * Pages of key-value scans are cut off once they exceed this many bytes.
+ **/
+#define JD_KV_CURSOR_PAGE_SIZE (4 * 1024 * 1024)
+
+/**
+ * Key-value cursors that have not been fetched for this many seconds are dropped.
+ * Their backend iterators hold resources like read transactions, so they time out sooner than DB cursors.
+ * Clients fetch the next page in the background, so this only affects clients that stop iterating.
+ **/
+#define JD_KV_CURSOR_TIMEOUT 30
+
+/**
+ * The remaining entries of a key-value scan.
+ **/
+struct JdKVCursor
+{
+	/**
+	 * The cursor's ID.
+	 **/
+	guint64 id;
+
+	/**
+	 * The backend iterator, NULL if it has been exhausted.
+	 **/
+	gpointer iterator;
+
+	/**
+	 * The first key to return, NULL for no lower bound.
+	 **/
+	gchar* start_key;
+
+	/**
+	 * The first key not to return, NULL for no upper bound.
+	 **/
+	gchar* end_key;
+
+	/**
+	 * Whether values are omitted.
+	 **/
+	gboolean keys_only;
+
+	/**
+	 * The monotonic time of the last fetch.
+	 **/
+	gint64 last_used;
+};
+
+typedef struct JdKVCursor JdKVCursor;
+
+static GHashTable* jd_kv_cursors = NULL;
+
+G_LOCK_DEFINE_STATIC(jd_kv_cursors);
+
+static void
+jd_kv_cursor_free(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdKVCursor* cursor = data;
+
+	if (cursor->iterator != NULL)
+	{
+		j_backend_kv_iterate_abort(jd_kv_backend, cursor->iterator);
+	}
+
+	g_free(cursor->start_key);
+	g_free(cursor->end_key);
+	g_free(cursor);
+}
+
+/**
+ * Appends up to \p count entries from a cursor to \p reply.
+ * Each entry consists of a marker, the key, the value's length and the value (unless only keys are requested).
+ * The page is terminated by a zero marker.
+ *
+ * \param cursor A cursor.
+ * \param count  The maximum number of entries.
+ * \param reply  A reply.
+ **/
+static void
+jd_kv_cursor_read(JdKVCursor* cursor, guint32 count, JMessage* reply)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint32 const one = 1;
+	guint32 const zero = 0;
+	gsize page_size = 0;
+
+	for (guint32 i = 0; i < count && page_size < JD_KV_CURSOR_PAGE_SIZE && cursor->iterator != NULL;)
+	{
+		gchar const* key;
+		gconstpointer value;
+		gsize key_len;
+		gsize entry_len;
+		guint32 len;
+
+		if (!j_backend_kv_iterate(jd_kv_backend, cursor->iterator, &key, &value, &len))
+		{
+			cursor->iterator = NULL;
+			break;
+		}
+
+		// Backends do not necessarily iterate in key order, so the bounds are applied as a filter
+		if ((cursor->start_key != NULL && g_strcmp0(key, cursor->start_key) < 0) || (cursor->end_key != NULL && g_strcmp0(key, cursor->end_key) >= 0))
+		{
+			continue;
+		}
+
+		key_len = strlen(key) + 1;
+		entry_len = 4 + key_len + 4 + ((cursor->keys_only) ? 0 : len);
+
+		j_message_add_operation(reply, entry_len);
+		j_message_append_4(reply, &one);
+		j_message_append_n(reply, key, key_len);
+		j_message_append_4(reply, &len);
+
+		if (!cursor->keys_only)
+		{
+			j_message_append_n(reply, value, len);
+		}
+
+		page_size += entry_len;
+		i++;
+	}
+
+	j_message_add_operation(reply, 4);
+	j_message_append_4(reply, &zero);
+}
+
+/**
+ * Stores a cursor so that its remaining entries can be fetched later.
+ * Exhausted cursors are freed instead.
+ *
+ * \param cursor A cursor.
+ *
+ * \return The cursor's ID, 0 if it has been exhausted.
+ **/
+static guint64
+jd_kv_cursor_store(JdKVCursor* cursor)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GHashTableIter iter;
+	GSList* expired = NULL;
+	gpointer value;
+	gint64 now;
+
+	if (cursor->iterator == NULL)
+	{
+		jd_kv_cursor_free(cursor);
+
+		return 0;
+	}
+
+	now = g_get_monotonic_time();
+	cursor->last_used = now;
+
+	G_LOCK(jd_kv_cursors);
+
+	if (G_UNLIKELY(jd_kv_cursors == NULL))
+	{
+		jd_kv_cursors = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, jd_kv_cursor_free);
+	}
+
+	// Drop cursors of clients that never finished iterating.
+	// They are only unlinked here because freeing their backend iterators might take a while.
+	g_hash_table_iter_init(&iter, jd_kv_cursors);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value))
+	{
+		JdKVCursor* old_cursor = value;
+
+		if (now - old_cursor->last_used > JD_KV_CURSOR_TIMEOUT * G_USEC_PER_SEC)
+		{
+			g_hash_table_iter_steal(&iter);
+			expired = g_slist_prepend(expired, old_cursor);
+		}
+	}
+
+	// IDs are random so that clients cannot guess the cursors of other clients.
+	// Pages are fetched using any pooled connection, so cursors cannot be tied to the connection they have been created on.
+	while (cursor->id == 0 || g_hash_table_contains(jd_kv_cursors, &(cursor->id)))
+	{
+		cursor->id = ((guint64)g_random_int() << 32) | g_random_int();
+	}
+
+	g_hash_table_insert(jd_kv_cursors, &(cursor->id), cursor);
+
+	G_UNLOCK(jd_kv_cursors);
+
+	g_slist_free_full(expired, jd_kv_cursor_free);
+
+	return cursor->id;
+}
+
+/**
+ * Takes a cursor out of the table while it is read from.
+ *
+ * \param id The cursor's ID.
+ *
+ * \return The cursor, NULL if it does not exist.
+ **/
+static JdKVCursor*
+jd_kv_cursor_take(guint64 id)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdKVCursor* cursor = NULL;
+
+	G_LOCK(jd_kv_cursors);
+
+	if (jd_kv_cursors != NULL)
+	{
+		g_hash_table_steal_extended(jd_kv_cursors, &id, NULL, (gpointer*)&cursor);
+	}
+
+	G_UNLOCK(jd_kv_cursors);
+
+	return cursor;
+}
+
 gboolean
-jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk* memory_chunk, guint64 memory_chunk_size, JStatistics* statistics)
+jd_message_has_reply(JMessage* message)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	g_autoptr(JSemantics) semantics = NULL;
+	JSemanticsPersistency persistency;
+	JMessageType type;
+
+	type = j_message_get_type(message);
+
+	if (type == J_MESSAGE_NONE)
+	{
+		return FALSE;
+	}
+
+	// These messages are only answered if the client waits for their persistency
+	if (type != J_MESSAGE_OBJECT_CREATE && type != J_MESSAGE_OBJECT_DELETE && type != J_MESSAGE_OBJECT_SYNC && type != J_MESSAGE_OBJECT_WRITE && type != J_MESSAGE_KV_PUT && type != J_MESSAGE_KV_DELETE)
+	{
+		return TRUE;
+	}
+
+	semantics = j_message_get_semantics(message);
+	persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
+
+	return (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE);
+}
+
+gboolean
+jd_handle_message(JMessage* message, JConnection* connection, JMemoryChunk* memory_chunk, guint64 memory_chunk_size, guint64 queue_time, JStatistics* statistics)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JMessageType type;
+	gint64 start_time;
 	gchar const* key;
 	gchar const* namespace;
 	gchar const* path;
@@ -47,7 +499,16 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 	semantics = j_message_get_semantics(message);
 	persistency = j_semantics_get(semantics, J_SEMANTICS_PERSISTENCY);
 
-	switch (j_message_get_type(message))
+	type = j_message_get_type(message);
+	start_time = g_get_monotonic_time();
+
+	// Message statistics are recorded globally, so they are visible while connections are still open.
+	if (type < J_STATISTICS_MESSAGE_TYPES)
+	{
+		j_statistics_message_begin(jd_statistics, type);
+	}
+
+	switch (type)
 	{
 		case J_MESSAGE_NONE:
 			break;
@@ -191,6 +652,9 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_OBJECT_READ:
 		{
 			JMessage* reply;
+			g_autofree guint64* lengths = NULL;
+			g_autofree guint64* offsets = NULL;
+			g_autofree JBackendObjectIO* ios = NULL;
 			gpointer object;
 			gboolean ret;
 
@@ -201,33 +665,83 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			ret = j_backend_object_open(jd_object_backend, namespace, path, &object);
 
+			lengths = g_new(guint64, operation_count);
+			offsets = g_new(guint64, operation_count);
+			ios = g_new(JBackendObjectIO, operation_count);
+
 			for (i = 0; i < operation_count; i++)
 			{
-				gchar* buf;
-				guint64 length;
-				guint64 offset;
-				guint64 bytes_read = 0;
+				lengths[i] = j_message_get_8(message);
+				offsets[i] = j_message_get_8(message);
+			}
 
-				length = j_message_get_8(message);
-				offset = j_message_get_8(message);
+			if (G_LIKELY(ret))
+			{
+				j_backend_object_register_buffer(jd_object_backend, j_memory_chunk_get_data(memory_chunk), memory_chunk_size);
+			}
 
-				if (G_UNLIKELY(!ret))
-				{
-					break;
-				}
+			i = 0;
+
+			while (G_LIKELY(ret) && i < operation_count)
+			{
+				guint count = 0;
 
-				if (length > memory_chunk_size)
+				if (lengths[i] > memory_chunk_size)
 				{
+					guint64 bytes_read = 0;
+
 					/// \todo return proper error
 					j_message_add_operation(reply, sizeof(guint64));
 					j_message_append_8(reply, &bytes_read);
+
+					i++;
 					continue;
 				}
 
-				buf = j_memory_chunk_get(memory_chunk, length);
+				// Read as many consecutive operations as fit into memory_chunk using a single vectored read
+				for (; i < operation_count && lengths[i] <= memory_chunk_size; i++)
+				{
+					gchar* buf;
+
+					buf = j_memory_chunk_get(memory_chunk, lengths[i]);
 
-				if (buf == NULL)
+					if (buf == NULL)
+					{
+						break;
+					}
+
+					ios[count].buffer = buf;
+					ios[count].length = lengths[i];
+					ios[count].offset = offsets[i];
+					ios[count].bytes = 0;
+					count++;
+				}
+
+				if (count > 0)
+				{
+					j_backend_object_read_vector(jd_object_backend, object, ios, count);
+				}
+
+				for (guint j = 0; j < count; j++)
 				{
+					guint64 bytes_read = ios[j].bytes;
+
+					j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_read);
+
+					j_message_add_operation(reply, sizeof(guint64));
+					j_message_append_8(reply, &bytes_read);
+
+					if (bytes_read > 0)
+					{
+						j_message_add_send(reply, ios[j].buffer, bytes_read);
+					}
+
+					j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, bytes_read);
+				}
+
+				if (i < operation_count && lengths[i] <= memory_chunk_size)
+				{
+					// memory_chunk is full, send the data read so far
 					/// \todo ugly
 					j_message_send(reply, connection);
 					j_message_unref(reply);
@@ -235,21 +749,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 					reply = j_message_new_reply(message);
 
 					j_memory_chunk_reset(memory_chunk);
-					buf = j_memory_chunk_get(memory_chunk, length);
 				}
-
-				j_backend_object_read(jd_object_backend, object, buf, length, offset, &bytes_read);
-				j_statistics_add(statistics, J_STATISTICS_BYTES_READ, bytes_read);
-
-				j_message_add_operation(reply, sizeof(guint64));
-				j_message_append_8(reply, &bytes_read);
-
-				if (bytes_read > 0)
-				{
-					j_message_add_send(reply, buf, bytes_read);
-				}
-
-				j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, bytes_read);
 			}
 
 			if (ret)
@@ -266,8 +766,13 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		case J_MESSAGE_OBJECT_WRITE:
 		{
 			g_autoptr(JMessage) reply = NULL;
+			g_autofree guint64* lengths = NULL;
+			g_autofree guint64* offsets = NULL;
+			g_autofree GInputVector* vectors = NULL;
+			g_autofree JBackendObjectIO* ios = NULL;
 			gpointer object;
 			gboolean ret;
+			gboolean synced = FALSE;
 
 			if (persistency == J_SEMANTICS_PERSISTENCY_NETWORK || persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
 			{
@@ -279,51 +784,111 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			ret = j_backend_object_open(jd_object_backend, namespace, path, &object);
 
+			lengths = g_new(guint64, operation_count);
+			offsets = g_new(guint64, operation_count);
+			vectors = g_new(GInputVector, operation_count);
+			ios = g_new(JBackendObjectIO, operation_count);
+
 			for (i = 0; i < operation_count; i++)
 			{
-				GInputStream* input;
-				gchar* buf;
-				guint64 length;
-				guint64 offset;
-				guint64 bytes_written = 0;
+				lengths[i] = j_message_get_8(message);
+				offsets[i] = j_message_get_8(message);
+			}
+
+			if (G_LIKELY(ret))
+			{
+				j_backend_object_register_buffer(jd_object_backend, j_memory_chunk_get_data(memory_chunk), memory_chunk_size);
+			}
 
-				length = j_message_get_8(message);
-				offset = j_message_get_8(message);
+			i = 0;
 
-				if (length > memory_chunk_size && reply != NULL && G_LIKELY(ret))
+			while (i < operation_count)
+			{
+				guint first = i;
+				guint count = 0;
+				guint64 bytes_received = 0;
+
+				if (lengths[i] > memory_chunk_size)
 				{
-					/// \todo return proper error
-					j_message_add_operation(reply, sizeof(guint64));
-					j_message_append_8(reply, &bytes_written);
+					if (reply != NULL && G_LIKELY(ret))
+					{
+						guint64 bytes_written = 0;
+
+						/// \todo return proper error
+						j_message_add_operation(reply, sizeof(guint64));
+						j_message_append_8(reply, &bytes_written);
+					}
+
+					i++;
 					continue;
 				}
 
-				// Guaranteed to work because memory_chunk is reset below
-				buf = j_memory_chunk_get(memory_chunk, length);
-				g_assert(buf != NULL);
+				// Receive the data of as many consecutive operations as fit into memory_chunk using a single vectored read
+				for (; i < operation_count && lengths[i] <= memory_chunk_size; i++)
+				{
+					gchar* buf;
 
-				input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
-				g_input_stream_read_all(input, buf, length, NULL, NULL, NULL);
-				j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, length);
+					buf = j_memory_chunk_get(memory_chunk, lengths[i]);
+
+					if (buf == NULL)
+					{
+						break;
+					}
+
+					vectors[count].buffer = buf;
+					vectors[count].size = lengths[i];
+					bytes_received += lengths[i];
+					count++;
+				}
+
+				// Guaranteed to contain at least one operation because memory_chunk is reset below
+				g_assert(count > 0);
+
+				j_message_receive_data_vectors(message, connection, vectors, count);
+				j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, bytes_received);
 
 				if (G_LIKELY(ret))
 				{
-					j_backend_object_write(jd_object_backend, object, buf, length, offset, &bytes_written);
-					j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_written);
+					gboolean sync;
 
-					if (reply != NULL)
+					for (guint j = 0; j < count; j++)
 					{
-						j_message_add_operation(reply, sizeof(guint64));
-						j_message_append_8(reply, &bytes_written);
+						ios[j].buffer = vectors[j].buffer;
+						ios[j].length = lengths[first + j];
+						ios[j].offset = offsets[first + j];
+						ios[j].bytes = 0;
+					}
+
+					// Let the backend sync together with the last writes
+					sync = (persistency == J_SEMANTICS_PERSISTENCY_STORAGE && i == operation_count);
+
+					j_backend_object_write_vector(jd_object_backend, object, ios, count, sync);
+					synced = sync;
+
+					for (guint j = 0; j < count; j++)
+					{
+						guint64 bytes_written = ios[j].bytes;
+
+						j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, bytes_written);
+
+						if (reply != NULL)
+						{
+							j_message_add_operation(reply, sizeof(guint64));
+							j_message_append_8(reply, &bytes_written);
+						}
 					}
 				}
 
 				j_memory_chunk_reset(memory_chunk);
 			}
 
-			if (persistency == J_SEMANTICS_PERSISTENCY_STORAGE)
+			if (persistency == J_SEMANTICS_PERSISTENCY_STORAGE && G_LIKELY(ret))
 			{
-				j_backend_object_sync(jd_object_backend, object);
+				if (!synced)
+				{
+					j_backend_object_sync(jd_object_backend, object);
+				}
+
 				j_statistics_add(statistics, J_STATISTICS_SYNC, 1);
 			}
 
@@ -426,7 +991,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			}
 
 			reply = j_message_new_reply(message);
-			j_message_add_operation(reply, 8 * sizeof(guint64));
+			j_message_add_operation(reply, (8 + J_STATISTICS_MESSAGE_TYPES * (5 + 2 * J_STATISTICS_HISTOGRAM_BUCKETS)) * sizeof(guint64));
 
 			value = j_statistics_get(r_statistics, J_STATISTICS_FILES_CREATED);
 			j_message_append_8(reply, &value);
@@ -445,6 +1010,33 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 			value = j_statistics_get(r_statistics, J_STATISTICS_BYTES_SENT);
 			j_message_append_8(reply, &value);
 
+			// Message statistics are always server-wide.
+			for (guint j = 0; j < J_STATISTICS_MESSAGE_TYPES; j++)
+			{
+				value = j_statistics_get_message(jd_statistics, j, J_STATISTICS_MESSAGE_REQUESTS);
+				j_message_append_8(reply, &value);
+				value = j_statistics_get_message(jd_statistics, j, J_STATISTICS_MESSAGE_OPERATIONS);
+				j_message_append_8(reply, &value);
+				value = j_statistics_get_message(jd_statistics, j, J_STATISTICS_MESSAGE_IN_FLIGHT);
+				j_message_append_8(reply, &value);
+				value = j_statistics_get_message(jd_statistics, j, J_STATISTICS_MESSAGE_QUEUE_TIME);
+				j_message_append_8(reply, &value);
+				value = j_statistics_get_message(jd_statistics, j, J_STATISTICS_MESSAGE_SERVICE_TIME);
+				j_message_append_8(reply, &value);
+
+				for (guint k = 0; k < J_STATISTICS_HISTOGRAM_BUCKETS; k++)
+				{
+					value = j_statistics_get_histogram(jd_statistics, j, J_STATISTICS_HISTOGRAM_QUEUE_TIME, k);
+					j_message_append_8(reply, &value);
+				}
+
+				for (guint k = 0; k < J_STATISTICS_HISTOGRAM_BUCKETS; k++)
+				{
+					value = j_statistics_get_histogram(jd_statistics, j, J_STATISTICS_HISTOGRAM_SERVICE_TIME, k);
+					j_message_append_8(reply, &value);
+				}
+			}
+
 			if (get_all != 0)
 			{
 				g_mutex_unlock(jd_statistics_mutex);
@@ -585,7 +1177,7 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 			reply = j_message_new_reply(message);
 			namespace = j_message_get_string(message);
-			j_backend_kv_batch_start(jd_kv_backend, namespace, semantics, &batch);
+			j_backend_kv_batch_start_read_only(jd_kv_backend, namespace, semantics, &batch);
 
 			for (i = 0; i < operation_count; i++)
 			{
@@ -617,65 +1209,85 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 		}
 		break;
 		case J_MESSAGE_KV_GET_ALL:
+		case J_MESSAGE_KV_GET_BY_PREFIX:
 		{
 			g_autoptr(JMessage) reply = NULL;
-			gpointer iterator;
-			gconstpointer value;
-			guint32 len;
-			guint32 zero = 0;
+			JdKVCursor* cursor = NULL;
+			gchar const* prefix = NULL;
+			gchar const* start_key;
+			gchar const* end_key;
+			guint64 cursor_id;
+			guint32 count;
+			guint32 keys_only;
 
 			reply = j_message_new_reply(message);
 			namespace = j_message_get_string(message);
 
-			j_backend_kv_get_all(jd_kv_backend, namespace, &iterator);
-
-			while (j_backend_kv_iterate(jd_kv_backend, iterator, &key, &value, &len))
+			if (type == J_MESSAGE_KV_GET_BY_PREFIX)
 			{
-				gsize key_len;
-
-				key_len = strlen(key) + 1;
-
-				j_message_add_operation(reply, 4 + len + key_len);
-				j_message_append_4(reply, &len);
-				j_message_append_n(reply, value, len);
-				j_message_append_string(reply, key);
+				prefix = j_message_get_string(message);
 			}
 
-			j_message_add_operation(reply, 4);
-			j_message_append_4(reply, &zero);
-
-			j_message_send(reply, connection);
-		}
-		break;
-		case J_MESSAGE_KV_GET_BY_PREFIX:
-		{
-			g_autoptr(JMessage) reply = NULL;
-			gchar const* prefix;
-			gpointer iterator;
-			gconstpointer value;
-			guint32 len;
-			guint32 zero = 0;
+			cursor_id = j_message_get_8(message);
+			count = j_message_get_4(message);
+			keys_only = j_message_get_4(message);
+			start_key = j_message_get_string(message);
+			end_key = j_message_get_string(message);
 
-			reply = j_message_new_reply(message);
-			namespace = j_message_get_string(message);
-			prefix = j_message_get_string(message);
+			if (cursor_id != 0)
+			{
+				cursor = jd_kv_cursor_take(cursor_id);
+			}
+			else if (count > 0)
+			{
+				cursor = g_new(JdKVCursor, 1);
+				cursor->id = 0;
+				cursor->iterator = NULL;
+				cursor->start_key = (start_key[0] != '\0') ? g_strdup(start_key) : NULL;
+				cursor->end_key = (end_key[0] != '\0') ? g_strdup(end_key) : NULL;
+				cursor->keys_only = (keys_only != 0);
+
+				if (prefix == NULL)
+				{
+					j_backend_kv_get_all(jd_kv_backend, namespace, &(cursor->iterator));
+				}
+				else
+				{
+					j_backend_kv_get_by_prefix(jd_kv_backend, namespace, prefix, &(cursor->iterator));
+				}
+			}
 
-			j_backend_kv_get_by_prefix(jd_kv_backend, namespace, prefix, &iterator);
+			if (cursor == NULL && cursor_id != 0 && count > 0)
+			{
+				// The cursor has timed out, let the client know that entries are missing
+				guint32 const invalid = 2;
 
-			while (j_backend_kv_iterate(jd_kv_backend, iterator, &key, &value, &len))
+				j_message_add_operation(reply, 4);
+				j_message_append_4(reply, &invalid);
+				cursor_id = 0;
+			}
+			else if (cursor == NULL || count == 0)
 			{
-				gsize key_len;
+				// A count of 0 closes the cursor
+				guint32 const zero = 0;
 
-				key_len = strlen(key) + 1;
+				j_message_add_operation(reply, 4);
+				j_message_append_4(reply, &zero);
+				cursor_id = 0;
 
-				j_message_add_operation(reply, 4 + len + key_len);
-				j_message_append_4(reply, &len);
-				j_message_append_n(reply, value, len);
-				j_message_append_string(reply, key);
+				if (cursor != NULL)
+				{
+					jd_kv_cursor_free(cursor);
+				}
+			}
+			else
+			{
+				jd_kv_cursor_read(cursor, count, reply);
+				cursor_id = jd_kv_cursor_store(cursor);
 			}
 
-			j_message_add_operation(reply, 4);
-			j_message_append_4(reply, &zero);
+			j_message_add_operation(reply, 8);
+			j_message_append_8(reply, &cursor_id);
 
 			j_message_send(reply, connection);
 		}
@@ -708,6 +1320,13 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				message_matched = TRUE;
 			}
 			// fallthrough
+		case J_MESSAGE_DB_INSERT_MANY:
+			if (!message_matched)
+			{
+				memcpy(&backend_operation, &j_backend_operation_db_insert_many, sizeof(JBackendOperation));
+				message_matched = TRUE;
+			}
+			// fallthrough
 		case J_MESSAGE_DB_UPDATE:
 			if (!message_matched)
 			{
@@ -769,6 +1388,8 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 
 				for (i = 0; i < operation_count; i++)
 				{
+					guint64 cursor_id = 0;
+
 					backend_operation.out_param[backend_operation.out_param_count - 1].error_ptr = NULL;
 
 					if (i)
@@ -831,8 +1452,20 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 						backend_operation.out_param[backend_operation.out_param_count - 1].error_ptr = g_error_copy(error);
 					}
 
+					if (j_message_get_type(message) == J_MESSAGE_DB_QUERY && ret && !backend_operation.out_param[backend_operation.out_param_count - 1].error_ptr)
+					{
+						// Only the first page is sent, clients fetch the remaining rows using the cursor.
+						cursor_id = jd_db_cursor_new(backend_operation.out_param[0].ptr, j_configuration_get_db_query_batch_size(jd_configuration));
+					}
+
 					j_backend_operation_to_message(reply, backend_operation.out_param, backend_operation.out_param_count);
 
+					if (j_message_get_type(message) == J_MESSAGE_DB_QUERY)
+					{
+						j_message_add_operation(reply, 8);
+						j_message_append_8(reply, &cursor_id);
+					}
+
 					if (ret)
 					{
 						for (guint j = 0; j < backend_operation.out_param_count; j++)
@@ -867,10 +1500,51 @@ jd_handle_message(JMessage* message, GSocketConnection* connection, JMemoryChunk
 				j_message_send(reply, connection);
 			}
 			break;
+		case J_MESSAGE_DB_FETCH:
+		{
+			g_autoptr(JMessage) reply = NULL;
+
+			reply = j_message_new_reply(message);
+
+			for (i = 0; i < operation_count; i++)
+			{
+				JBackendOperationParam out_param[2];
+				GError* error = NULL;
+				bson_t page[1];
+				guint64 cursor_id;
+				guint32 count;
+
+				cursor_id = j_message_get_8(message);
+				count = j_message_get_4(message);
+
+				bson_init(page);
+				cursor_id = jd_db_cursor_fetch(cursor_id, count, page, &error);
+
+				// Pages are sent like query results.
+				memcpy(out_param, j_backend_operation_db_query.out_param, sizeof(out_param));
+				out_param[0].ptr = page;
+				out_param[1].ptr = &error;
+
+				j_backend_operation_to_message(reply, out_param, G_N_ELEMENTS(out_param));
+
+				j_message_add_operation(reply, 8);
+				j_message_append_8(reply, &cursor_id);
+
+				bson_destroy(page);
+			}
+
+			j_message_send(reply, connection);
+		}
+		break;
 		default:
 			g_warn_if_reached();
 			break;
 	}
 
+	if (type < J_STATISTICS_MESSAGE_TYPES)
+	{
+		j_statistics_message_end(jd_statistics, type, operation_count, queue_time, g_get_monotonic_time() - start_time);
+	}
+
 	return message_matched;
 }
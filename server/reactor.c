@@ -0,0 +1,714 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Required for pthread_setaffinity_np and the CPU_* macros.
+#define _GNU_SOURCE
+
+#include <julea-config.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include <julea.h>
+
+#include "server.h"
+
+#ifdef HAVE_EPOLL
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * A client connection that is managed by the reactor.
+ *
+ * A connection is registered with EPOLLONESHOT.
+ * Therefore, at most one worker reads from it at any time and it has to be re-armed after each message.
+ * Messages that are answered re-arm the connection as soon as they and their additional data have been read,
+ * that is, multiple workers might process messages of the same connection concurrently and reply out of order.
+ * This is safe because clients wait for the reply, so later messages on the connection cannot depend on them.
+ * Messages without a reply re-arm the connection only after they have been handled, so that they are processed in order.
+ **/
+struct JdConnection
+{
+	JdReactor* reactor;
+
+	/**
+	 * The connection.
+	 **/
+	JConnection* connection;
+
+	/**
+	 * The connection's file descriptor.
+	 **/
+	gint fd;
+
+	/**
+	 * The connection's statistics.
+	 **/
+	JStatistics* statistics;
+
+	/**
+	 * The monotonic time at which the connection was queued.
+	 * Only valid while the connection is queued, since it is not re-armed before a worker has read the message.
+	 **/
+	gint64 queue_time;
+
+	/**
+	 * Whether the current message re-arms the connection as soon as it has been read.
+	 * Only accessed by the worker holding the connection.
+	 **/
+	gboolean rearm_early;
+
+	/**
+	 * Whether the current message has been read completely.
+	 * Only accessed by the worker holding the connection.
+	 **/
+	gboolean released;
+
+	/**
+	 * The reference count.
+	 * The reactor holds one reference while the connection is open, each worker processing a message holds another one.
+	 **/
+	gint ref_count;
+};
+
+typedef struct JdConnection JdConnection;
+
+/**
+ * A worker thread.
+ **/
+struct JdWorker
+{
+	JdReactor* reactor;
+
+	GThread* thread;
+
+	/**
+	 * The worker's index, also used to select the CPU it is pinned to.
+	 **/
+	guint index;
+
+	/**
+	 * The memory chunk shared by all connections handled by this worker.
+	 **/
+	JMemoryChunk* memory_chunk;
+};
+
+typedef struct JdWorker JdWorker;
+
+struct JdReactor
+{
+	/**
+	 * The listening socket.
+	 **/
+	GSocket* socket;
+
+	gint epoll_fd;
+
+	/**
+	 * Used to wake up the reactor thread on shutdown.
+	 **/
+	gint event_fd;
+
+	GThread* thread;
+
+	/**
+	 * Connections that are ready to be read from.
+	 **/
+	GAsyncQueue* queue;
+
+	JdWorker* workers;
+	guint workers_n;
+
+	/**
+	 * All open connections, protected by mutex.
+	 **/
+	GHashTable* connections;
+	GMutex mutex[1];
+};
+
+// Pushed to the queue to make the workers exit.
+static JdConnection jd_reactor_quit[1];
+
+static void
+jd_connection_unref(JdConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	if (g_atomic_int_dec_and_test(&(connection->ref_count)))
+	{
+		jd_statistics_merge(connection->statistics);
+		j_statistics_free(connection->statistics);
+
+		j_connection_free(connection->connection);
+
+		g_free(connection);
+	}
+}
+
+static void
+jd_reactor_close(JdReactor* reactor, JdConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	gboolean removed;
+
+	epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+
+	g_mutex_lock(reactor->mutex);
+	removed = g_hash_table_remove(reactor->connections, connection);
+	g_mutex_unlock(reactor->mutex);
+
+	// The connection might have been closed by another worker already.
+	if (removed)
+	{
+		jd_connection_unref(connection);
+	}
+}
+
+/**
+ * Re-arms a connection, so that the next message can be read.
+ *
+ * \param connection The connection.
+ **/
+static void
+jd_connection_rearm(JdConnection* connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	struct epoll_event event;
+
+	event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	event.data.ptr = connection;
+
+	// The connection might be handled by another worker as soon as it is re-armed.
+	if (epoll_ctl(connection->reactor->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) == -1)
+	{
+		g_warning("Could not re-arm connection: %s", g_strerror(errno));
+		jd_reactor_close(connection->reactor, connection);
+	}
+}
+
+/**
+ * Called by j_connection_release_input() after a message and its additional data have been read.
+ *
+ * \param j_connection The connection.
+ * \param data         The reactor's connection.
+ **/
+static void
+jd_connection_release(JConnection* j_connection, gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdConnection* connection = data;
+
+	(void)j_connection;
+
+	if (connection->rearm_early)
+	{
+		jd_connection_rearm(connection);
+	}
+	else
+	{
+		connection->released = TRUE;
+	}
+}
+
+static gpointer
+jd_network_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GSocketConnection) socket_connection = data;
+
+	jd_handle_network_connection(socket_connection);
+
+	return NULL;
+}
+
+static void
+jd_reactor_accept(JdReactor* reactor)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	while (TRUE)
+	{
+		g_autoptr(GError) error = NULL;
+		g_autoptr(GSocket) socket = NULL;
+		g_autoptr(GSocketConnection) socket_connection = NULL;
+		JdConnection* connection;
+		struct epoll_event event;
+
+		socket = g_socket_accept(reactor->socket, NULL, &error);
+
+		if (socket == NULL)
+		{
+			if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+			{
+				g_warning("Could not accept connection: %s", error->message);
+			}
+
+			break;
+		}
+
+		// Workers use blocking I/O once a connection has become readable.
+		g_socket_set_blocking(socket, TRUE);
+
+		socket_connection = g_socket_connection_factory_create_connection(socket);
+
+		if (jd_network_fabric != NULL)
+		{
+			// libfabric connections are not driven by the reactor, they are handled by a dedicated thread.
+			g_thread_unref(g_thread_new("julea-network", jd_network_thread, g_steal_pointer(&socket_connection)));
+			continue;
+		}
+
+		j_helper_set_nodelay(socket_connection, TRUE);
+
+		connection = g_new(JdConnection, 1);
+		connection->reactor = reactor;
+		connection->connection = j_connection_new_for_socket(socket_connection);
+		connection->fd = g_socket_get_fd(socket);
+		connection->statistics = j_statistics_new(TRUE);
+		connection->queue_time = 0;
+		connection->rearm_early = FALSE;
+		connection->released = FALSE;
+		connection->ref_count = 1;
+
+		j_connection_set_release_func(connection->connection, jd_connection_release, connection);
+
+		g_mutex_lock(reactor->mutex);
+		g_hash_table_add(reactor->connections, connection);
+		g_mutex_unlock(reactor->mutex);
+
+		event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+		event.data.ptr = connection;
+
+		if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, connection->fd, &event) == -1)
+		{
+			g_warning("Could not register connection: %s", g_strerror(errno));
+
+			g_mutex_lock(reactor->mutex);
+			g_hash_table_remove(reactor->connections, connection);
+			g_mutex_unlock(reactor->mutex);
+
+			jd_connection_unref(connection);
+		}
+	}
+}
+
+static gpointer
+jd_reactor_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdReactor* reactor = data;
+	struct epoll_event events[64];
+	gboolean running = TRUE;
+
+	while (running)
+	{
+		gint n;
+
+		n = epoll_wait(reactor->epoll_fd, events, G_N_ELEMENTS(events), -1);
+
+		if (n == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			g_critical("Could not wait for events: %s", g_strerror(errno));
+			break;
+		}
+
+		for (gint i = 0; i < n; i++)
+		{
+			if (events[i].data.ptr == NULL)
+			{
+				jd_reactor_accept(reactor);
+			}
+			else if (events[i].data.ptr == reactor)
+			{
+				running = FALSE;
+			}
+			else
+			{
+				JdConnection* connection = events[i].data.ptr;
+
+				// Closed and erroneous connections are also handed to the workers, which will notice when reading.
+				connection->queue_time = g_get_monotonic_time();
+				g_async_queue_push(reactor->queue, connection);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void
+jd_worker_pin(JdWorker* worker)
+{
+	J_TRACE_FUNCTION(NULL);
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+	cpu_set_t allowed;
+	cpu_set_t cpu;
+	guint count;
+	guint target;
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+	{
+		return;
+	}
+
+	count = CPU_COUNT(&allowed);
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Pin the worker to the n-th CPU the server is allowed to run on.
+	target = worker->index % count;
+	CPU_ZERO(&cpu);
+
+	for (guint i = 0; i < CPU_SETSIZE; i++)
+	{
+		if (!CPU_ISSET(i, &allowed))
+		{
+			continue;
+		}
+
+		if (target == 0)
+		{
+			CPU_SET(i, &cpu);
+			break;
+		}
+
+		target--;
+	}
+
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpu), &cpu) != 0)
+	{
+		g_debug("Could not pin worker %u.", worker->index);
+	}
+#else
+	(void)worker;
+#endif
+}
+
+static gpointer
+jd_worker_thread(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdWorker* worker = data;
+	JdReactor* reactor = worker->reactor;
+	g_autoptr(JMessage) message = NULL;
+	guint64 memory_chunk_size;
+
+	jd_worker_pin(worker);
+
+	memory_chunk_size = j_configuration_get_max_operation_size(jd_configuration);
+	message = j_message_new(J_MESSAGE_NONE, 0);
+
+	while (TRUE)
+	{
+		JdConnection* connection;
+		gboolean rearm_early;
+		guint64 queue_time;
+
+		connection = g_async_queue_pop(reactor->queue);
+
+		if (connection == jd_reactor_quit)
+		{
+			break;
+		}
+
+		queue_time = g_get_monotonic_time() - connection->queue_time;
+
+		g_atomic_int_inc(&(connection->ref_count));
+
+		// The message type is not known yet, so jd_connection_release() only records that the message has been read.
+		connection->rearm_early = FALSE;
+		connection->released = FALSE;
+
+		if (!j_message_receive(message, connection->connection))
+		{
+			jd_reactor_close(reactor, connection);
+			jd_connection_unref(connection);
+			continue;
+		}
+
+		rearm_early = jd_message_has_reply(message);
+
+		if (rearm_early)
+		{
+			// Re-arms the connection via jd_connection_release() once the message has been read completely.
+			connection->rearm_early = TRUE;
+
+			if (connection->released)
+			{
+				jd_connection_rearm(connection);
+			}
+		}
+
+		jd_handle_message(message, connection->connection, worker->memory_chunk, memory_chunk_size, queue_time, connection->statistics);
+
+		// Make sure the input is released even if not all additional data has been read.
+		j_message_finish_receive(message, connection->connection);
+
+		// The connection must not be accessed after being re-armed because another worker might be using it already.
+		if (!rearm_early)
+		{
+			jd_connection_rearm(connection);
+		}
+
+		jd_connection_unref(connection);
+	}
+
+	return NULL;
+}
+
+static GSocket*
+jd_reactor_listen(guint16 port, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(GInetAddress) inet_address = NULL;
+	g_autoptr(GSocketAddress) address = NULL;
+	GSocket* socket;
+	GSocketFamily family = G_SOCKET_FAMILY_IPV6;
+
+	// IPv6 sockets also accept IPv4 connections, fall back to IPv4 if IPv6 is not available.
+	socket = g_socket_new(family, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, NULL);
+
+	if (socket == NULL)
+	{
+		family = G_SOCKET_FAMILY_IPV4;
+		socket = g_socket_new(family, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, error);
+	}
+
+	if (socket == NULL)
+	{
+		return NULL;
+	}
+
+	inet_address = g_inet_address_new_any(family);
+	address = g_inet_socket_address_new(inet_address, port);
+
+	g_socket_set_listen_backlog(socket, 128);
+
+	if (!g_socket_bind(socket, address, TRUE, error) || !g_socket_listen(socket, error))
+	{
+		g_object_unref(socket);
+		return NULL;
+	}
+
+	g_socket_set_blocking(socket, FALSE);
+
+	return socket;
+}
+
+JdReactor*
+jd_reactor_new(guint16 port, guint threads, GError** error)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdReactor* reactor;
+	GSocket* socket;
+
+	socket = jd_reactor_listen(port, error);
+
+	if (socket == NULL)
+	{
+		return NULL;
+	}
+
+	if (threads == 0)
+	{
+		threads = g_get_num_processors();
+	}
+
+	reactor = g_new(JdReactor, 1);
+	reactor->socket = socket;
+	reactor->epoll_fd = -1;
+	reactor->event_fd = -1;
+	reactor->thread = NULL;
+	reactor->queue = g_async_queue_new();
+	reactor->workers = g_new0(JdWorker, threads);
+	reactor->workers_n = threads;
+	reactor->connections = g_hash_table_new(NULL, NULL);
+	g_mutex_init(reactor->mutex);
+
+	return reactor;
+}
+
+gboolean
+jd_reactor_start(JdReactor* reactor)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	struct epoll_event event;
+	guint64 memory_chunk_size;
+
+	g_return_val_if_fail(reactor != NULL, FALSE);
+	g_return_val_if_fail(reactor->thread == NULL, FALSE);
+
+	reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	reactor->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	if (reactor->epoll_fd == -1 || reactor->event_fd == -1)
+	{
+		g_critical("Could not create reactor: %s", g_strerror(errno));
+		return FALSE;
+	}
+
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+
+	if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, g_socket_get_fd(reactor->socket), &event) == -1)
+	{
+		g_critical("Could not register listening socket: %s", g_strerror(errno));
+		return FALSE;
+	}
+
+	event.events = EPOLLIN;
+	event.data.ptr = reactor;
+
+	if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->event_fd, &event) == -1)
+	{
+		g_critical("Could not register event file descriptor: %s", g_strerror(errno));
+		return FALSE;
+	}
+
+	memory_chunk_size = j_configuration_get_max_operation_size(jd_configuration);
+
+	for (guint i = 0; i < reactor->workers_n; i++)
+	{
+		g_autofree gchar* name = NULL;
+		JdWorker* worker = &(reactor->workers[i]);
+
+		name = g_strdup_printf("julea-worker-%u", i);
+
+		worker->reactor = reactor;
+		worker->index = i;
+		worker->memory_chunk = j_memory_chunk_new(memory_chunk_size);
+		worker->thread = g_thread_new(name, jd_worker_thread, worker);
+	}
+
+	reactor->thread = g_thread_new("julea-reactor", jd_reactor_thread, reactor);
+
+	g_debug("Started reactor with %u workers.", reactor->workers_n);
+
+	return TRUE;
+}
+
+void
+jd_reactor_stop(JdReactor* reactor)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	guint64 value = 1;
+
+	g_return_if_fail(reactor != NULL);
+
+	if (reactor->thread == NULL)
+	{
+		return;
+	}
+
+	if (write(reactor->event_fd, &value, sizeof(value)) != sizeof(value))
+	{
+		g_warning("Could not wake up reactor: %s", g_strerror(errno));
+	}
+
+	g_thread_join(reactor->thread);
+	reactor->thread = NULL;
+
+	// The reactor does not queue any more connections, so the quit markers are the last elements each worker sees.
+	for (guint i = 0; i < reactor->workers_n; i++)
+	{
+		g_async_queue_push(reactor->queue, jd_reactor_quit);
+	}
+
+	for (guint i = 0; i < reactor->workers_n; i++)
+	{
+		g_thread_join(reactor->workers[i].thread);
+		reactor->workers[i].thread = NULL;
+	}
+}
+
+void
+jd_reactor_free(JdReactor* reactor)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	GHashTableIter iter;
+	gpointer key;
+
+	g_return_if_fail(reactor != NULL);
+
+	jd_reactor_stop(reactor);
+
+	g_hash_table_iter_init(&iter, reactor->connections);
+
+	while (g_hash_table_iter_next(&iter, &key, NULL))
+	{
+		jd_connection_unref(key);
+	}
+
+	for (guint i = 0; i < reactor->workers_n; i++)
+	{
+		if (reactor->workers[i].memory_chunk != NULL)
+		{
+			j_memory_chunk_free(reactor->workers[i].memory_chunk);
+		}
+	}
+
+	if (reactor->event_fd != -1)
+	{
+		close(reactor->event_fd);
+	}
+
+	if (reactor->epoll_fd != -1)
+	{
+		close(reactor->epoll_fd);
+	}
+
+	g_socket_close(reactor->socket, NULL);
+	g_object_unref(reactor->socket);
+
+	g_hash_table_unref(reactor->connections);
+	g_async_queue_unref(reactor->queue);
+	g_mutex_clear(reactor->mutex);
+
+	g_free(reactor->workers);
+	g_free(reactor);
+}
+
+#endif
@@ -42,6 +42,11 @@ JBackend* jd_db_backend = NULL;
 
 JConfiguration* jd_configuration = NULL;
 
+JNetworkFabric* jd_network_fabric = NULL;
+
+// Serializes connection setup, since connection requests are received via the fabric's shared passive endpoint.
+static GMutex jd_network_mutex[1];
+
 static gboolean
 jd_signal(gpointer data)
 {
@@ -57,21 +62,63 @@ jd_signal(gpointer data)
 	return FALSE;
 }
 
-static gboolean
-jd_on_run(GThreadedSocketService* service, GSocketConnection* connection, GObject* source_object, gpointer user_data)
+void
+jd_statistics_merge(JStatistics* statistics)
 {
 	J_TRACE_FUNCTION(NULL);
 
+	guint64 value;
+
+	g_mutex_lock(jd_statistics_mutex);
+
+	value = j_statistics_get(statistics, J_STATISTICS_FILES_CREATED);
+	j_statistics_add(jd_statistics, J_STATISTICS_FILES_CREATED, value);
+	value = j_statistics_get(statistics, J_STATISTICS_FILES_DELETED);
+	j_statistics_add(jd_statistics, J_STATISTICS_FILES_DELETED, value);
+	value = j_statistics_get(statistics, J_STATISTICS_FILES_STATED);
+	j_statistics_add(jd_statistics, J_STATISTICS_FILES_STATED, value);
+	value = j_statistics_get(statistics, J_STATISTICS_SYNC);
+	j_statistics_add(jd_statistics, J_STATISTICS_SYNC, value);
+	value = j_statistics_get(statistics, J_STATISTICS_BYTES_READ);
+	j_statistics_add(jd_statistics, J_STATISTICS_BYTES_READ, value);
+	value = j_statistics_get(statistics, J_STATISTICS_BYTES_WRITTEN);
+	j_statistics_add(jd_statistics, J_STATISTICS_BYTES_WRITTEN, value);
+	value = j_statistics_get(statistics, J_STATISTICS_BYTES_RECEIVED);
+	j_statistics_add(jd_statistics, J_STATISTICS_BYTES_RECEIVED, value);
+	value = j_statistics_get(statistics, J_STATISTICS_BYTES_SENT);
+	j_statistics_add(jd_statistics, J_STATISTICS_BYTES_SENT, value);
+
+	g_mutex_unlock(jd_statistics_mutex);
+}
+
+void
+jd_handle_network_connection(GSocketConnection* socket_connection)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JConnection) connection = NULL;
 	JMemoryChunk* memory_chunk;
 	g_autoptr(JMessage) message = NULL;
+	JNetworkConnection* network;
 	JStatistics* statistics;
 	guint64 memory_chunk_size;
 
-	(void)service;
-	(void)source_object;
-	(void)user_data;
+	g_return_if_fail(jd_network_fabric != NULL);
 
-	j_helper_set_nodelay(connection, TRUE);
+	// The socket connection is only used to exchange the fabric's address.
+	g_mutex_lock(jd_network_mutex);
+	network = j_network_connection_init_server(jd_network_fabric, socket_connection);
+	g_mutex_unlock(jd_network_mutex);
+
+	g_io_stream_close(G_IO_STREAM(socket_connection), NULL, NULL);
+
+	if (network == NULL)
+	{
+		g_warning("Could not establish libfabric connection.");
+		return;
+	}
+
+	connection = j_connection_new_for_network(network);
 
 	statistics = j_statistics_new(TRUE);
 	memory_chunk_size = j_configuration_get_max_operation_size(jd_configuration);
@@ -81,37 +128,101 @@ jd_on_run(GThreadedSocketService* service, GSocketConnection* connection, GObjec
 
 	while (j_message_receive(message, connection))
 	{
-		jd_handle_message(message, connection, memory_chunk, memory_chunk_size, statistics);
+		jd_handle_message(message, connection, memory_chunk, memory_chunk_size, 0, statistics);
 	}
 
+	jd_statistics_merge(statistics);
+
+	j_memory_chunk_free(memory_chunk);
+	j_statistics_free(statistics);
+}
+
+#ifndef HAVE_EPOLL
+static gboolean
+jd_on_run(GThreadedSocketService* service, GSocketConnection* socket_connection, GObject* source_object, gpointer user_data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	g_autoptr(JConnection) connection = NULL;
+	JMemoryChunk* memory_chunk;
+	g_autoptr(JMessage) message = NULL;
+	JStatistics* statistics;
+	guint64 memory_chunk_size;
+
+	(void)service;
+	(void)source_object;
+	(void)user_data;
+
+	if (jd_network_fabric != NULL)
 	{
-		guint64 value;
+		jd_handle_network_connection(socket_connection);
+		return TRUE;
+	}
 
-		g_mutex_lock(jd_statistics_mutex);
+	j_helper_set_nodelay(socket_connection, TRUE);
 
-		value = j_statistics_get(statistics, J_STATISTICS_FILES_CREATED);
-		j_statistics_add(jd_statistics, J_STATISTICS_FILES_CREATED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_FILES_DELETED);
-		j_statistics_add(jd_statistics, J_STATISTICS_FILES_DELETED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_SYNC);
-		j_statistics_add(jd_statistics, J_STATISTICS_SYNC, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_READ);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_READ, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_WRITTEN);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_WRITTEN, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_RECEIVED);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_RECEIVED, value);
-		value = j_statistics_get(statistics, J_STATISTICS_BYTES_SENT);
-		j_statistics_add(jd_statistics, J_STATISTICS_BYTES_SENT, value);
+	connection = j_connection_new_for_socket(socket_connection);
+	statistics = j_statistics_new(TRUE);
+	memory_chunk_size = j_configuration_get_max_operation_size(jd_configuration);
+	memory_chunk = j_memory_chunk_new(memory_chunk_size);
 
-		g_mutex_unlock(jd_statistics_mutex);
+	message = j_message_new(J_MESSAGE_NONE, 0);
+
+	while (j_message_receive(message, connection))
+	{
+		jd_handle_message(message, connection, memory_chunk, memory_chunk_size, 0, statistics);
 	}
 
+	jd_statistics_merge(statistics);
+
 	j_memory_chunk_free(memory_chunk);
 	j_statistics_free(statistics);
 
 	return TRUE;
 }
+#endif
+
+/**
+ * The state of the Prometheus metrics export.
+ **/
+struct JdMetrics
+{
+	/**
+	 * The file to write to.
+	 **/
+	gchar* path;
+
+	/**
+	 * Labels identifying the server.
+	 **/
+	gchar* labels;
+};
+
+typedef struct JdMetrics JdMetrics;
+
+static gboolean
+jd_metrics_write(gpointer data)
+{
+	J_TRACE_FUNCTION(NULL);
+
+	JdMetrics* metrics = data;
+	g_autofree gchar* text = NULL;
+	GError* error = NULL;
+
+	// Per-connection statistics are only merged when connections are closed, per-message statistics are always up to date.
+	g_mutex_lock(jd_statistics_mutex);
+	text = j_statistics_to_prometheus(jd_statistics, metrics->labels);
+	g_mutex_unlock(jd_statistics_mutex);
+
+	// The file is replaced atomically, so readers never see partial contents.
+	if (!g_file_set_contents(metrics->path, text, -1, &error))
+	{
+		g_warning("Could not write metrics: %s", error->message);
+		g_error_free(error);
+	}
+
+	return G_SOURCE_CONTINUE;
+}
 
 static gboolean
 jd_daemon(void)
@@ -266,21 +377,32 @@ main(int argc, char** argv)
 	gboolean opt_daemon = FALSE;
 	g_autofree gchar* opt_host = NULL;
 	gint opt_port = 0;
+	gint opt_threads = 0;
+	g_autofree gchar* opt_metrics = NULL;
+	gint opt_metrics_interval = 10;
 
 	JTrace* trace;
+	JdMetrics metrics = { NULL, NULL };
 	GError* error = NULL;
 	g_autoptr(GMainLoop) main_loop = NULL;
 	GModule* object_module = NULL;
 	GModule* kv_module = NULL;
 	GModule* db_module = NULL;
 	g_autoptr(GOptionContext) context = NULL;
+#ifdef HAVE_EPOLL
+	JdReactor* reactor = NULL;
+#else
 	g_autoptr(GSocketService) socket_service = NULL;
+#endif
 	guint listen_retries = 0;
 
 	GOptionEntry entries[] = {
 		{ "daemon", 0, 0, G_OPTION_ARG_NONE, &opt_daemon, "Run as daemon", NULL },
 		{ "host", 0, 0, G_OPTION_ARG_STRING, &opt_host, "Override host name", "hostname" },
 		{ "port", 0, 0, G_OPTION_ARG_INT, &opt_port, "Port to use", "0" },
+		{ "threads", 0, 0, G_OPTION_ARG_INT, &opt_threads, "Number of worker threads (0 for number of processors)", "0" },
+		{ "metrics", 0, 0, G_OPTION_ARG_FILENAME, &opt_metrics, "Periodically write statistics to a file in the Prometheus text format", "path" },
+		{ "metrics-interval", 0, 0, G_OPTION_ARG_INT, &opt_metrics_interval, "Interval for writing statistics in seconds", "10" },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
 
@@ -327,12 +449,32 @@ main(int argc, char** argv)
 		opt_port = j_configuration_get_port(jd_configuration);
 	}
 
+	if (opt_threads < 0)
+	{
+		g_warning("Number of worker threads must not be negative.");
+		return 1;
+	}
+
+	if (opt_metrics_interval <= 0)
+	{
+		g_warning("Metrics interval must be positive.");
+		return 1;
+	}
+
+#ifndef HAVE_EPOLL
 	socket_service = g_threaded_socket_service_new(-1);
 	g_socket_listener_set_backlog(G_SOCKET_LISTENER(socket_service), 128);
+#endif
 
 	while (TRUE)
 	{
+#ifdef HAVE_EPOLL
+		reactor = jd_reactor_new(opt_port, opt_threads, &error);
+
+		if (reactor == NULL)
+#else
 		if (!g_socket_listener_add_inet_port(G_SOCKET_LISTENER(socket_service), opt_port, NULL, &error))
+#endif
 		{
 			if (error != NULL)
 			{
@@ -383,8 +525,27 @@ main(int argc, char** argv)
 	jd_statistics = j_statistics_new(FALSE);
 	g_mutex_init(jd_statistics_mutex);
 
+	if (j_configuration_get_transport(jd_configuration) == J_CONFIGURATION_TRANSPORT_LIBFABRIC)
+	{
+		g_mutex_init(jd_network_mutex);
+		jd_network_fabric = j_network_fabric_init_server(jd_configuration);
+
+		if (jd_network_fabric == NULL)
+		{
+			g_critical("Could not initialize libfabric.");
+			return 1;
+		}
+	}
+
+#ifdef HAVE_EPOLL
+	if (!jd_reactor_start(reactor))
+	{
+		return 1;
+	}
+#else
 	g_socket_service_start(socket_service);
 	g_signal_connect(socket_service, "run", G_CALLBACK(jd_on_run), NULL);
+#endif
 
 	main_loop = g_main_loop_new(NULL, FALSE);
 
@@ -392,9 +553,34 @@ main(int argc, char** argv)
 	g_unix_signal_add(SIGINT, jd_signal, main_loop);
 	g_unix_signal_add(SIGTERM, jd_signal, main_loop);
 
+	if (opt_metrics != NULL)
+	{
+		metrics.path = opt_metrics;
+		metrics.labels = g_strdup_printf("host=\"%s\",port=\"%d\"", opt_host, opt_port);
+
+		g_timeout_add_seconds(opt_metrics_interval, jd_metrics_write, &metrics);
+	}
+
 	g_main_loop_run(main_loop);
 
+	if (opt_metrics != NULL)
+	{
+		// Make sure the final statistics are exported.
+		jd_metrics_write(&metrics);
+		g_free(metrics.labels);
+	}
+
+#ifdef HAVE_EPOLL
+	jd_reactor_free(reactor);
+#else
 	g_socket_service_stop(socket_service);
+#endif
+
+	if (jd_network_fabric != NULL)
+	{
+		j_network_fabric_fini(jd_network_fabric);
+		g_mutex_clear(jd_network_mutex);
+	}
 
 	g_mutex_clear(jd_statistics_mutex);
 	j_statistics_free(jd_statistics);
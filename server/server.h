@@ -24,8 +24,10 @@
 
 #include <jbackend.h>
 #include <jconfiguration.h>
+#include <jconnection.h>
 #include <jmemory-chunk.h>
 #include <jmessage.h>
+#include <jnetwork.h>
 #include <jstatistics.h>
 
 G_GNUC_INTERNAL extern JStatistics* jd_statistics;
@@ -37,6 +39,24 @@ G_GNUC_INTERNAL extern JBackend* jd_db_backend;
 
 G_GNUC_INTERNAL extern JConfiguration* jd_configuration;
 
-G_GNUC_INTERNAL gboolean jd_handle_message(JMessage*, GSocketConnection*, JMemoryChunk*, guint64, JStatistics*);
+G_GNUC_INTERNAL extern JNetworkFabric* jd_network_fabric;
+
+G_GNUC_INTERNAL gboolean jd_message_has_reply(JMessage*);
+G_GNUC_INTERNAL gboolean jd_handle_message(JMessage*, JConnection*, JMemoryChunk*, guint64, guint64, JStatistics*);
+
+G_GNUC_INTERNAL void jd_statistics_merge(JStatistics*);
+
+G_GNUC_INTERNAL void jd_handle_network_connection(GSocketConnection*);
+
+#ifdef HAVE_EPOLL
+struct JdReactor;
+
+typedef struct JdReactor JdReactor;
+
+G_GNUC_INTERNAL JdReactor* jd_reactor_new(guint16, guint, GError**);
+G_GNUC_INTERNAL gboolean jd_reactor_start(JdReactor*);
+G_GNUC_INTERNAL void jd_reactor_stop(JdReactor*);
+G_GNUC_INTERNAL void jd_reactor_free(JdReactor*);
+#endif
 
 #endif
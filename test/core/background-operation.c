@@ -34,6 +34,36 @@ on_background_operation_completed(gpointer data)
 	return NULL;
 }
 
+static gpointer
+on_background_operation_identity(gpointer data)
+{
+	return data;
+}
+
+static gpointer
+on_background_operation_nested(gpointer data)
+{
+	JBackgroundOperation* background_operations[16];
+	guint sum = 0;
+
+	(void)data;
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		background_operations[i] = j_background_operation_new(on_background_operation_identity, GUINT_TO_POINTER(i));
+	}
+
+	j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		sum += GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i]));
+		j_background_operation_unref(background_operations[i]);
+	}
+
+	return GUINT_TO_POINTER(sum);
+}
+
 static void
 test_background_operation_new_ref_unref(void)
 {
@@ -60,9 +90,52 @@ test_background_operation_wait(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_background_operation_wait_all(void)
+{
+	JBackgroundOperation* background_operations[100];
+
+	J_TEST_TRAP_START;
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		background_operations[i] = j_background_operation_new(on_background_operation_identity, GUINT_TO_POINTER(i));
+	}
+
+	j_background_operation_wait_all(background_operations, G_N_ELEMENTS(background_operations));
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i])), ==, i);
+		j_background_operation_unref(background_operations[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_background_operation_nested(void)
+{
+	JBackgroundOperation* background_operations[64];
+
+	J_TEST_TRAP_START;
+	// More operations than threads that wait for operations themselves
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		background_operations[i] = j_background_operation_new(on_background_operation_nested, NULL);
+	}
+
+	for (guint i = 0; i < G_N_ELEMENTS(background_operations); i++)
+	{
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_background_operation_wait(background_operations[i])), ==, 120);
+		j_background_operation_unref(background_operations[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
 void
 test_core_background_operation(void)
 {
 	g_test_add_func("/core/background_operation/new_ref_unref", test_background_operation_new_ref_unref);
 	g_test_add_func("/core/background_operation/wait", test_background_operation_wait);
+	g_test_add_func("/core/background_operation/wait_all", test_background_operation_wait_all);
+	g_test_add_func("/core/background_operation/nested", test_background_operation_nested);
 }
@@ -27,6 +27,79 @@
 
 static gint test_batch_flag;
 
+/**
+ * Records the calls of exec functions in the order they are made.
+ * Each call is recorded as the concatenation of its operations' data.
+ **/
+static GPtrArray* test_batch_executed = NULL;
+
+G_LOCK_DEFINE_STATIC(test_batch_executed);
+
+static gboolean
+test_batch_exec(JVector* operations, JSemantics* semantics)
+{
+	JVectorIterator iterator[1];
+	GString* call;
+
+	(void)semantics;
+
+	call = g_string_new(NULL);
+	j_vector_iterator_init(iterator, operations);
+
+	while (j_vector_iterator_next(iterator))
+	{
+		g_string_append(call, j_vector_iterator_get(iterator));
+	}
+
+	// Independent groups are executed concurrently
+	G_LOCK(test_batch_executed);
+	g_ptr_array_add(test_batch_executed, g_string_free(call, FALSE));
+	G_UNLOCK(test_batch_executed);
+
+	return TRUE;
+}
+
+static gboolean
+test_batch_exec_other(JVector* operations, JSemantics* semantics)
+{
+	return test_batch_exec(operations, semantics);
+}
+
+static gboolean
+test_batch_exec_third(JVector* operations, JSemantics* semantics)
+{
+	return test_batch_exec(operations, semantics);
+}
+
+static void
+test_batch_add_operation(JBatch* batch, gchar const* key, JOperationExecFunc exec_func, gchar const* data)
+{
+	JOperation* operation;
+
+	operation = j_operation_new();
+	operation->key = key;
+	operation->data = (gpointer)data;
+	operation->exec_func = exec_func;
+
+	j_batch_add(batch, operation);
+}
+
+static guint
+test_batch_get_call(gchar const* call)
+{
+	for (guint i = 0; i < test_batch_executed->len; i++)
+	{
+		if (g_strcmp0(g_ptr_array_index(test_batch_executed, i), call) == 0)
+		{
+			return i;
+		}
+	}
+
+	g_assert_not_reached();
+
+	return 0;
+}
+
 static void
 on_operation_completed(JBatch* batch, gboolean ret, gpointer user_data)
 {
@@ -138,6 +211,130 @@ test_batch_execute_async(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_batch_execute_merge(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_batch_executed = g_ptr_array_new_with_free_func(g_free);
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	// Interleaved operations on different keys are combined
+	test_batch_add_operation(batch, "a", test_batch_exec, "a1");
+	test_batch_add_operation(batch, "b", test_batch_exec, "b1");
+	test_batch_add_operation(batch, "a", test_batch_exec, "a2");
+	test_batch_add_operation(batch, "b", test_batch_exec, "b2");
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	g_assert_cmpuint(test_batch_executed->len, ==, 2);
+	test_batch_get_call("a1a2");
+	test_batch_get_call("b1b2");
+
+	g_ptr_array_unref(test_batch_executed);
+	test_batch_executed = NULL;
+	J_TEST_TRAP_END;
+}
+
+static void
+test_batch_execute_order(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_batch_executed = g_ptr_array_new_with_free_func(g_free);
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	// Operations of different types on the same key keep their order
+	test_batch_add_operation(batch, "a", test_batch_exec_other, "a1");
+	test_batch_add_operation(batch, "a", test_batch_exec, "a2");
+	test_batch_add_operation(batch, "b", test_batch_exec_other, "b1");
+	test_batch_add_operation(batch, "a", test_batch_exec, "a3");
+	test_batch_add_operation(batch, "b", test_batch_exec, "b2");
+	test_batch_add_operation(batch, "a", test_batch_exec_other, "a4");
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	g_assert_cmpuint(test_batch_executed->len, ==, 5);
+	g_assert_cmpuint(test_batch_get_call("a1"), <, test_batch_get_call("a2a3"));
+	g_assert_cmpuint(test_batch_get_call("a2a3"), <, test_batch_get_call("a4"));
+	g_assert_cmpuint(test_batch_get_call("b1"), <, test_batch_get_call("b2"));
+
+	g_ptr_array_unref(test_batch_executed);
+	test_batch_executed = NULL;
+	J_TEST_TRAP_END;
+}
+
+static void
+test_batch_execute_unkeyed(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_batch_executed = g_ptr_array_new_with_free_func(g_free);
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	// Operations without a key are ordered with respect to all other operations
+	test_batch_add_operation(batch, "a", test_batch_exec, "a1");
+	test_batch_add_operation(batch, NULL, test_batch_exec, "x1");
+	test_batch_add_operation(batch, NULL, test_batch_exec, "x2");
+	test_batch_add_operation(batch, "a", test_batch_exec, "a2");
+	test_batch_add_operation(batch, "b", test_batch_exec, "b1");
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	g_assert_cmpuint(test_batch_executed->len, ==, 4);
+	g_assert_cmpuint(test_batch_get_call("a1"), <, test_batch_get_call("x1x2"));
+	g_assert_cmpuint(test_batch_get_call("x1x2"), <, test_batch_get_call("a2"));
+	g_assert_cmpuint(test_batch_get_call("x1x2"), <, test_batch_get_call("b1"));
+
+	g_ptr_array_unref(test_batch_executed);
+	test_batch_executed = NULL;
+	J_TEST_TRAP_END;
+}
+
+static void
+test_batch_execute_aliased(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autofree gchar* handle_a = NULL;
+	g_autofree gchar* handle_b = NULL;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	test_batch_executed = g_ptr_array_new_with_free_func(g_free);
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	// Distinct handles for the same key, like two JKVs for the same namespace and key
+	handle_a = g_strdup("kv:0:4:test:key");
+	handle_b = g_strdup("kv:0:4:test:key");
+	g_assert_true(handle_a != handle_b);
+
+	// put(a), delete(a), get(b) must not return the deleted value
+	test_batch_add_operation(batch, handle_a, test_batch_exec, "put");
+	test_batch_add_operation(batch, handle_a, test_batch_exec_other, "delete");
+	test_batch_add_operation(batch, handle_b, test_batch_exec_third, "get");
+	test_batch_add_operation(batch, "other", test_batch_exec_third, "other");
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	g_assert_cmpuint(test_batch_executed->len, ==, 4);
+	g_assert_cmpuint(test_batch_get_call("put"), <, test_batch_get_call("delete"));
+	g_assert_cmpuint(test_batch_get_call("delete"), <, test_batch_get_call("get"));
+
+	g_ptr_array_unref(test_batch_executed);
+	test_batch_executed = NULL;
+	J_TEST_TRAP_END;
+}
+
 void
 test_core_batch(void)
 {
@@ -146,4 +343,8 @@ test_core_batch(void)
 	g_test_add_func("/core/batch/execute_empty", test_batch_execute_empty);
 	g_test_add_func("/core/batch/execute", test_batch_execute);
 	g_test_add_func("/core/batch/execute_async", test_batch_execute_async);
+	g_test_add_func("/core/batch/execute_merge", test_batch_execute_merge);
+	g_test_add_func("/core/batch/execute_order", test_batch_execute_order);
+	g_test_add_func("/core/batch/execute_unkeyed", test_batch_execute_unkeyed);
+	g_test_add_func("/core/batch/execute_aliased", test_batch_execute_aliased);
 }
@@ -87,6 +87,11 @@ test_configuration_get(void)
 	g_key_file_set_string(key_file, "kv", "path", "NULL2");
 	g_key_file_set_string(key_file, "db", "backend", "null3");
 	g_key_file_set_string(key_file, "db", "path", "NULL3");
+	g_key_file_set_boolean(key_file, "clients", "multiplex", TRUE);
+	g_key_file_set_integer(key_file, "clients", "stripe-window", 3);
+	g_key_file_set_uint64(key_file, "clients", "read-cache-size", 4096);
+	g_key_file_set_integer(key_file, "clients", "read-cache-lease", 250);
+	g_key_file_set_integer(key_file, "db", "query-batch-size", 42);
 
 	configuration = j_configuration_new_for_data(key_file);
 	g_assert_true(configuration != NULL);
@@ -111,6 +116,12 @@ test_configuration_get(void)
 	g_assert_cmpstr(j_configuration_get_backend(configuration, J_BACKEND_TYPE_DB), ==, "null3");
 	g_assert_cmpstr(j_configuration_get_backend_path(configuration, J_BACKEND_TYPE_DB), ==, "NULL3");
 
+	g_assert_true(j_configuration_get_multiplex(configuration));
+	g_assert_cmpuint(j_configuration_get_stripe_window(configuration), ==, 3);
+	g_assert_cmpuint(j_configuration_get_read_cache_size(configuration), ==, 4096);
+	g_assert_cmpuint(j_configuration_get_read_cache_lease(configuration), ==, 250);
+	g_assert_cmpuint(j_configuration_get_db_query_batch_size(configuration), ==, 42);
+
 	j_configuration_unref(configuration);
 
 	g_key_file_free(key_file);
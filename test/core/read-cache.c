@@ -0,0 +1,201 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+static void
+test_read_cache_new_free(void)
+{
+	JReadCache* cache;
+
+	J_TEST_TRAP_START;
+	cache = j_read_cache_new(42, G_USEC_PER_SEC);
+	g_assert_true(cache != NULL);
+
+	j_read_cache_free(cache);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_read_cache_get_put(void)
+{
+	JReadCache* cache;
+	gpointer value = NULL;
+	guint32 value_len = 0;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	cache = j_read_cache_new(1024, G_USEC_PER_SEC);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_false(ret);
+
+	j_read_cache_put(cache, "key", "value", 6, g_get_monotonic_time());
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_true(ret);
+	g_assert_cmpuint(value_len, ==, 6);
+	g_assert_cmpstr(value, ==, "value");
+	g_free(value);
+
+	// Immediate consistency bypasses the cache
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_IMMEDIATE, &value, &value_len);
+	g_assert_false(ret);
+
+	g_assert_cmpuint(j_read_cache_get_hits(cache), ==, 1);
+	g_assert_cmpuint(j_read_cache_get_misses(cache), ==, 1);
+
+	j_read_cache_free(cache);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_read_cache_lease(void)
+{
+	JReadCache* cache;
+	gpointer value = NULL;
+	guint32 value_len = 0;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	cache = j_read_cache_new(1024, G_USEC_PER_SEC);
+
+	// Pretend the value was read two seconds ago
+	j_read_cache_put(cache, "key", "value", 6, g_get_monotonic_time() - 2 * G_USEC_PER_SEC);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_false(ret);
+
+	// Expired entries are removed
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_false(ret);
+
+	// Eventual consistency does not use entries forever
+	j_read_cache_put(cache, "key", "value", 6, g_get_monotonic_time() - 20 * G_USEC_PER_SEC);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_false(ret);
+
+	j_read_cache_free(cache);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_read_cache_invalidate(void)
+{
+	JReadCache* cache;
+	gpointer value = NULL;
+	guint32 value_len = 0;
+	gint64 since;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	cache = j_read_cache_new(1024, G_USEC_PER_SEC);
+
+	since = g_get_monotonic_time();
+	j_read_cache_put(cache, "key", "value", 6, since);
+	j_read_cache_put(cache, "other", "value", 6, since);
+	j_read_cache_invalidate(cache, "key");
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_false(ret);
+
+	// Other keys are not affected
+	ret = j_read_cache_get(cache, "other", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	// A read started before the invalidation must not be cached
+	j_read_cache_put(cache, "key", "value", 6, since);
+	j_read_cache_put(cache, "new", "value", 6, since);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_false(ret);
+
+	// Unless it reads another key
+	ret = j_read_cache_get(cache, "new", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	// Reads started after the invalidation are cached again
+	j_read_cache_put(cache, "key", "value", 6, g_get_monotonic_time() + 1);
+
+	ret = j_read_cache_get(cache, "key", J_SEMANTICS_CONSISTENCY_EVENTUAL, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	j_read_cache_free(cache);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_read_cache_evict(void)
+{
+	JReadCache* cache;
+	gpointer value = NULL;
+	guint32 value_len = 0;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	// Each entry needs 4 bytes for the key and 4 bytes for the value
+	cache = j_read_cache_new(16, G_USEC_PER_SEC);
+
+	j_read_cache_put(cache, "ka1", "va1", 4, g_get_monotonic_time());
+	j_read_cache_put(cache, "ka2", "va2", 4, g_get_monotonic_time());
+
+	// Make ka2 the least recently used entry
+	ret = j_read_cache_get(cache, "ka1", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	j_read_cache_put(cache, "ka3", "va3", 4, g_get_monotonic_time());
+
+	ret = j_read_cache_get(cache, "ka2", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_false(ret);
+
+	ret = j_read_cache_get(cache, "ka1", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	ret = j_read_cache_get(cache, "ka3", J_SEMANTICS_CONSISTENCY_SESSION, &value, &value_len);
+	g_assert_true(ret);
+	g_free(value);
+
+	j_read_cache_free(cache);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_read_cache(void)
+{
+	g_test_add_func("/core/read-cache/new_free", test_read_cache_new_free);
+	g_test_add_func("/core/read-cache/get_put", test_read_cache_get_put);
+	g_test_add_func("/core/read-cache/lease", test_read_cache_lease);
+	g_test_add_func("/core/read-cache/invalidate", test_read_cache_invalidate);
+	g_test_add_func("/core/read-cache/evict", test_read_cache_evict);
+}
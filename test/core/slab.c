@@ -0,0 +1,150 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <string.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+static void
+test_slab_alloc_free(void)
+{
+	gsize const sizes[] = { 1, 8, 16, 17, 100, 256, 4096, 65536, 65537, 1024 * 1024 };
+
+	J_TEST_TRAP_START;
+	for (guint i = 0; i < G_N_ELEMENTS(sizes); i++)
+	{
+		gchar* mem;
+
+		mem = j_slab_alloc(sizes[i]);
+		g_assert_true(mem != NULL);
+
+		// The whole block has to be usable
+		memset(mem, 42, j_slab_get_size(sizes[i]));
+
+		j_slab_free(mem, sizes[i]);
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_slab_get_size(void)
+{
+	J_TEST_TRAP_START;
+	g_assert_cmpuint(j_slab_get_size(1), ==, 16);
+	g_assert_cmpuint(j_slab_get_size(16), ==, 16);
+	g_assert_cmpuint(j_slab_get_size(17), ==, 32);
+	g_assert_cmpuint(j_slab_get_size(256), ==, 256);
+	g_assert_cmpuint(j_slab_get_size(257), ==, 512);
+	g_assert_cmpuint(j_slab_get_size(65536), ==, 65536);
+	g_assert_cmpuint(j_slab_get_size(65537), ==, 65537);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_slab_reuse(void)
+{
+	gpointer mem;
+	gpointer mem2;
+
+	J_TEST_TRAP_START;
+	mem = j_slab_alloc(100);
+	j_slab_free(mem, 100);
+
+	// Blocks of the same size class are reused by the same thread
+	mem2 = j_slab_alloc(128);
+	g_assert_true(mem == mem2);
+
+	// The size passed to j_slab_free() may be the block's usable size
+	j_slab_free(mem2, j_slab_get_size(128));
+	J_TEST_TRAP_END;
+}
+
+static void
+test_slab_new_delete(void)
+{
+	JSemantics** semantics;
+
+	J_TEST_TRAP_START;
+	semantics = j_slab_new(JSemantics*);
+	*semantics = NULL;
+	j_slab_delete(JSemantics*, semantics);
+	J_TEST_TRAP_END;
+}
+
+static gpointer
+test_slab_thread(gpointer data)
+{
+	gpointer* blocks = data;
+
+	// Free blocks allocated by the main thread
+	for (guint i = 0; i < 10000; i++)
+	{
+		j_slab_free(blocks[i], 64);
+	}
+
+	return NULL;
+}
+
+static void
+test_slab_thread_free(void)
+{
+	GThread* thread;
+	gpointer* blocks;
+
+	J_TEST_TRAP_START;
+	blocks = g_new(gpointer, 10000);
+
+	for (guint i = 0; i < 10000; i++)
+	{
+		blocks[i] = j_slab_alloc(64);
+	}
+
+	thread = g_thread_new("test-slab", test_slab_thread, blocks);
+	g_thread_join(thread);
+
+	// Blocks cached by the exited thread are handed to the global cache
+	for (guint i = 0; i < 10000; i++)
+	{
+		blocks[i] = j_slab_alloc(64);
+		memset(blocks[i], 0, 64);
+	}
+
+	for (guint i = 0; i < 10000; i++)
+	{
+		j_slab_free(blocks[i], 64);
+	}
+
+	g_free(blocks);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_slab(void)
+{
+	g_test_add_func("/core/slab/alloc_free", test_slab_alloc_free);
+	g_test_add_func("/core/slab/get_size", test_slab_get_size);
+	g_test_add_func("/core/slab/reuse", test_slab_reuse);
+	g_test_add_func("/core/slab/new_delete", test_slab_new_delete);
+	g_test_add_func("/core/slab/thread_free", test_slab_thread_free);
+}
@@ -0,0 +1,128 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <string.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+static void
+test_statistics_new_free(void)
+{
+	JStatistics* statistics;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+	g_assert_true(statistics != NULL);
+
+	j_statistics_free(statistics);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_statistics_add_get(void)
+{
+	JStatistics* statistics;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+
+	g_assert_cmpuint(j_statistics_get(statistics, J_STATISTICS_BYTES_READ), ==, 0);
+
+	j_statistics_add(statistics, J_STATISTICS_BYTES_READ, 42);
+	j_statistics_add(statistics, J_STATISTICS_BYTES_READ, 23);
+	g_assert_cmpuint(j_statistics_get(statistics, J_STATISTICS_BYTES_READ), ==, 65);
+	g_assert_cmpuint(j_statistics_get(statistics, J_STATISTICS_BYTES_WRITTEN), ==, 0);
+
+	j_statistics_free(statistics);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_statistics_message(void)
+{
+	JStatistics* statistics;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+
+	j_statistics_message_begin(statistics, J_MESSAGE_KV_PUT);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_IN_FLIGHT), ==, 1);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_REQUESTS), ==, 0);
+
+	j_statistics_message_end(statistics, J_MESSAGE_KV_PUT, 10, 3, 100);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_IN_FLIGHT), ==, 0);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_REQUESTS), ==, 1);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_OPERATIONS), ==, 10);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_QUEUE_TIME), ==, 3);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_MESSAGE_SERVICE_TIME), ==, 100);
+	g_assert_cmpuint(j_statistics_get_message(statistics, J_MESSAGE_KV_GET, J_STATISTICS_MESSAGE_REQUESTS), ==, 0);
+
+	// 3 < 2^2 and 100 < 2^7
+	g_assert_cmpuint(j_statistics_get_histogram(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_HISTOGRAM_QUEUE_TIME, 2), ==, 1);
+	g_assert_cmpuint(j_statistics_get_histogram(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_HISTOGRAM_SERVICE_TIME, 7), ==, 1);
+	g_assert_cmpuint(j_statistics_get_histogram(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_HISTOGRAM_SERVICE_TIME, 6), ==, 0);
+
+	// Overly long durations end up in the last bucket
+	j_statistics_message_begin(statistics, J_MESSAGE_KV_PUT);
+	j_statistics_message_end(statistics, J_MESSAGE_KV_PUT, 1, 0, G_MAXUINT64);
+	g_assert_cmpuint(j_statistics_get_histogram(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_HISTOGRAM_QUEUE_TIME, 0), ==, 1);
+	g_assert_cmpuint(j_statistics_get_histogram(statistics, J_MESSAGE_KV_PUT, J_STATISTICS_HISTOGRAM_SERVICE_TIME, J_STATISTICS_HISTOGRAM_BUCKETS - 1), ==, 1);
+
+	j_statistics_free(statistics);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_statistics_prometheus(void)
+{
+	JStatistics* statistics;
+	g_autofree gchar* text = NULL;
+
+	J_TEST_TRAP_START;
+	statistics = j_statistics_new(FALSE);
+
+	j_statistics_add(statistics, J_STATISTICS_SYNC, 2);
+	j_statistics_message_begin(statistics, J_MESSAGE_DB_QUERY);
+	j_statistics_message_end(statistics, J_MESSAGE_DB_QUERY, 1, 1, 1);
+
+	text = j_statistics_to_prometheus(statistics, "server=\"test\"");
+
+	g_assert_nonnull(strstr(text, "julea_sync_total{server=\"test\"} 2\n"));
+	g_assert_nonnull(strstr(text, "julea_requests_total{server=\"test\",type=\"db_query\"} 1\n"));
+	g_assert_nonnull(strstr(text, "julea_service_seconds_bucket{server=\"test\",type=\"db_query\",le=\"+Inf\"} 1\n"));
+	g_assert_nonnull(strstr(text, "julea_service_seconds_count{server=\"test\",type=\"db_query\"} 1\n"));
+	g_assert_null(strstr(text, "type=\"kv_put\""));
+
+	j_statistics_free(statistics);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_statistics(void)
+{
+	g_test_add_func("/core/statistics/new_free", test_statistics_new_free);
+	g_test_add_func("/core/statistics/add_get", test_statistics_add_get);
+	g_test_add_func("/core/statistics/message", test_statistics_message);
+	g_test_add_func("/core/statistics/prometheus", test_statistics_prometheus);
+}
@@ -0,0 +1,144 @@
+/*
+ * JULEA - Flexible storage framework
+ * Copyright (C) 2010-2024 Michael Kuhn
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <julea-config.h>
+
+#include <glib.h>
+
+#include <julea.h>
+
+#include "test.h"
+
+static void
+test_vector_new_free(void)
+{
+	guint const n = 100000;
+
+	J_TEST_TRAP_START;
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JVector) vector = NULL;
+
+		vector = j_vector_new(NULL);
+		g_assert_true(vector != NULL);
+	}
+	J_TEST_TRAP_END;
+}
+
+static void
+test_vector_append_get(void)
+{
+	g_autoptr(JVector) vector = NULL;
+
+	J_TEST_TRAP_START;
+	vector = j_vector_new(g_free);
+
+	g_assert_cmpuint(j_vector_length(vector), ==, 0);
+	g_assert_null(j_vector_get_first(vector));
+
+	for (guint i = 0; i < 100; i++)
+	{
+		j_vector_append(vector, g_strdup_printf("%u", i));
+	}
+
+	g_assert_cmpuint(j_vector_length(vector), ==, 100);
+	g_assert_cmpstr(j_vector_get_first(vector), ==, "0");
+	g_assert_cmpstr(j_vector_get(vector, 42), ==, "42");
+
+	j_vector_delete_all(vector);
+	g_assert_cmpuint(j_vector_length(vector), ==, 0);
+
+	j_vector_set_length(vector, 3);
+	g_assert_null(j_vector_get(vector, 2));
+
+	j_vector_set(vector, 2, g_strdup("2"));
+	g_assert_cmpstr(j_vector_get(vector, 2), ==, "2");
+	J_TEST_TRAP_END;
+}
+
+static void
+test_vector_iterator(void)
+{
+	g_autoptr(JVector) vector = NULL;
+	JVectorIterator iterator[1];
+	guint i = 0;
+
+	J_TEST_TRAP_START;
+	vector = j_vector_new(NULL);
+
+	j_vector_iterator_init(iterator, vector);
+	g_assert_false(j_vector_iterator_next(iterator));
+
+	for (guint j = 0; j < 10; j++)
+	{
+		j_vector_append(vector, GUINT_TO_POINTER(j));
+	}
+
+	j_vector_iterator_init(iterator, vector);
+
+	while (j_vector_iterator_next(iterator))
+	{
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_vector_iterator_get(iterator)), ==, i);
+		i++;
+	}
+
+	g_assert_cmpuint(i, ==, 10);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_vector_slice(void)
+{
+	g_autoptr(JVector) vector = NULL;
+	JVector slice[1];
+	JVectorIterator iterator[1];
+	guint i = 3;
+
+	J_TEST_TRAP_START;
+	vector = j_vector_new(NULL);
+
+	for (guint j = 0; j < 10; j++)
+	{
+		j_vector_append(vector, GUINT_TO_POINTER(j));
+	}
+
+	j_vector_slice(slice, vector, 3, 4);
+
+	g_assert_cmpuint(j_vector_length(slice), ==, 4);
+	g_assert_cmpuint(GPOINTER_TO_UINT(j_vector_get_first(slice)), ==, 3);
+
+	j_vector_iterator_init(iterator, slice);
+
+	while (j_vector_iterator_next(iterator))
+	{
+		g_assert_cmpuint(GPOINTER_TO_UINT(j_vector_iterator_get(iterator)), ==, i);
+		i++;
+	}
+
+	g_assert_cmpuint(i, ==, 7);
+	J_TEST_TRAP_END;
+}
+
+void
+test_core_vector(void)
+{
+	g_test_add_func("/core/vector/new_free", test_vector_new_free);
+	g_test_add_func("/core/vector/append_get", test_vector_append_get);
+	g_test_add_func("/core/vector/iterator", test_vector_iterator);
+	g_test_add_func("/core/vector/slice", test_vector_slice);
+}
@@ -242,6 +242,382 @@ test_db_entry_insert_update_delete(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_db_paged(void)
+{
+	// Larger than the default query batch size to make the servers page the results.
+	guint const n = 2500;
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	g_autoptr(JDBEntry) delete_entry = NULL;
+	g_autoptr(JDBIterator) iterator = NULL;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	gboolean ret;
+	guint entries;
+
+	J_TEST_TRAP_START;
+	schema = j_db_schema_new("test-ns", "test-paged", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_add_field(schema, "key", J_DB_TYPE_UINT64, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_create(schema, batch, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	for (guint64 i = 0; i < n; i++)
+	{
+		g_autoptr(JDBEntry) entry = NULL;
+
+		entry = j_db_entry_new(schema, &error);
+		g_assert_nonnull(entry);
+		g_assert_no_error(error);
+
+		ret = j_db_entry_set_field(entry, "key", &i, sizeof(i), &error);
+		g_assert_true(ret);
+		g_assert_no_error(error);
+
+		ret = j_db_entry_insert(entry, batch, NULL);
+		g_assert_true(ret);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	for (entries = 0; j_db_iterator_next(iterator, NULL); entries++)
+	{
+	}
+
+	g_assert_cmpuint(entries, ==, n);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	// Stop iterating early, the remaining rows are discarded.
+	iterator = j_db_iterator_new(schema, selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	for (entries = 0; entries < 10; entries++)
+	{
+		ret = j_db_iterator_next(iterator, &error);
+		g_assert_true(ret);
+		g_assert_no_error(error);
+	}
+
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	delete_entry = j_db_entry_new(schema, &error);
+	g_assert_nonnull(delete_entry);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_delete(delete_entry, selector, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_db_schema_delete(schema, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_db_bulk(void)
+{
+	guint const n = 2500;
+	// The first entries all have the same fields, so they form a single run that has to be split into several multi-row statements (at most 999 variables each).
+	guint const n_uniform = 1200;
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	g_autoptr(JDBEntry) delete_entry = NULL;
+	g_autoptr(JDBIterator) iterator = NULL;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	gboolean ret;
+	guint entries;
+
+	J_TEST_TRAP_START;
+	schema = j_db_schema_new("test-ns", "test-bulk", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_add_field(schema, "key", J_DB_TYPE_UINT64, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_add_field(schema, "name", J_DB_TYPE_STRING, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_create(schema, batch, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	for (guint64 i = 0; i < n; i++)
+	{
+		g_autoptr(JDBEntry) entry = NULL;
+
+		entry = j_db_entry_new(schema, &error);
+		g_assert_nonnull(entry);
+		g_assert_no_error(error);
+
+		ret = j_db_entry_set_field(entry, "key", &i, sizeof(i), &error);
+		g_assert_true(ret);
+		g_assert_no_error(error);
+
+		// Afterwards, entries with different fields cannot share a statement.
+		if (i < n_uniform || i % 3 == 0)
+		{
+			ret = j_db_entry_set_field(entry, "name", "bulk", 0, &error);
+			g_assert_true(ret);
+			g_assert_no_error(error);
+		}
+
+		ret = j_db_entry_insert_bulk(entry, batch, NULL);
+		g_assert_true(ret);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	for (entries = 0; j_db_iterator_next(iterator, NULL); entries++)
+	{
+	}
+
+	g_assert_cmpuint(entries, ==, n);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	delete_entry = j_db_entry_new(schema, &error);
+	g_assert_nonnull(delete_entry);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_delete(delete_entry, selector, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_db_schema_delete(schema, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
+static void
+test_db_sharded(void)
+{
+	guint const n = 100;
+
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JBatch) batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	g_autoptr(JDBEntry) delete_entry = NULL;
+	g_autoptr(JDBIterator) iterator = NULL;
+	g_autoptr(JDBSchema) schema = NULL;
+	g_autoptr(JDBSchema) stored_schema = NULL;
+	g_autoptr(JDBSelector) selector = NULL;
+	g_autoptr(JDBSelector) key_selector = NULL;
+	g_autoptr(JDBSelector) id_selector = NULL;
+	g_autoptr(JDBEntry) id_entry = NULL;
+	g_autoptr(JDBEntry) update_entry = NULL;
+	g_autofree gpointer id = NULL;
+	g_autofree gpointer value = NULL;
+	guint64 id_length;
+	guint64 value_length;
+	JDBType type;
+	gboolean equal;
+	gboolean ret;
+	guint64 key = 42;
+	guint64 id_key = n;
+	guint entries;
+
+	J_TEST_TRAP_START;
+	schema = j_db_schema_new("test-ns", "test-sharded", &error);
+	g_assert_nonnull(schema);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_add_field(schema, "key", J_DB_TYPE_UINT64, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_set_shard_key(schema, "key", &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_create(schema, batch, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// The shard key is restored when retrieving the schema.
+	stored_schema = j_db_schema_new("test-ns", "test-sharded", &error);
+	g_assert_nonnull(stored_schema);
+	g_assert_no_error(error);
+
+	ret = j_db_schema_get(stored_schema, batch, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	ret = j_db_schema_equals(schema, stored_schema, &equal, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+	g_assert_true(equal);
+
+	for (guint64 i = 0; i < n; i++)
+	{
+		g_autoptr(JDBEntry) entry = NULL;
+
+		entry = j_db_entry_new(schema, &error);
+		g_assert_nonnull(entry);
+		g_assert_no_error(error);
+
+		ret = j_db_entry_set_field(entry, "key", &i, sizeof(i), &error);
+		g_assert_true(ret);
+		g_assert_no_error(error);
+
+		ret = j_db_entry_insert(entry, batch, NULL);
+		g_assert_true(ret);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// Without a condition on the shard key, all servers are queried.
+	selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(selector);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	for (entries = 0; j_db_iterator_next(iterator, NULL); entries++)
+	{
+	}
+
+	g_assert_cmpuint(entries, ==, n);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	key_selector = j_db_selector_new(schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(key_selector);
+	g_assert_no_error(error);
+
+	ret = j_db_selector_add_field(key_selector, "key", J_DB_SELECTOR_OPERATOR_EQ, &key, sizeof(key), &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(schema, key_selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	for (entries = 0; j_db_iterator_next(iterator, NULL); entries++)
+	{
+	}
+
+	g_assert_cmpuint(entries, ==, 1);
+	g_clear_pointer(&iterator, j_db_iterator_unref);
+
+	// IDs are globally unique and determine the server storing the entry.
+	id_entry = j_db_entry_new(stored_schema, &error);
+	g_assert_nonnull(id_entry);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_set_field(id_entry, "key", &id_key, sizeof(id_key), &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_insert(id_entry, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	ret = j_db_entry_get_id(id_entry, &id, &id_length, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	id_selector = j_db_selector_new(stored_schema, J_DB_SELECTOR_MODE_AND, &error);
+	g_assert_nonnull(id_selector);
+	g_assert_no_error(error);
+
+	ret = j_db_selector_add_field(id_selector, "_id", J_DB_SELECTOR_OPERATOR_EQ, id, id_length, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	iterator = j_db_iterator_new(stored_schema, id_selector, &error);
+	g_assert_nonnull(iterator);
+	g_assert_no_error(error);
+
+	ret = j_db_iterator_next(iterator, NULL);
+	g_assert_true(ret);
+
+	ret = j_db_iterator_get_field(iterator, NULL, "key", &type, &value, &value_length, &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+	g_assert_cmpuint(*(guint64*)value, ==, id_key);
+
+	ret = j_db_iterator_next(iterator, NULL);
+	g_assert_false(ret);
+
+	// The shard key cannot be updated.
+	update_entry = j_db_entry_new(stored_schema, &error);
+	g_assert_nonnull(update_entry);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_set_field(update_entry, "key", &key, sizeof(key), &error);
+	g_assert_true(ret);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_update(update_entry, id_selector, batch, &error);
+	g_assert_false(ret);
+	g_assert_error(error, J_DB_ERROR, J_DB_ERROR_SHARD_KEY_IMMUTABLE);
+	g_clear_error(&error);
+
+	delete_entry = j_db_entry_new(schema, &error);
+	g_assert_nonnull(delete_entry);
+	g_assert_no_error(error);
+
+	ret = j_db_entry_delete(delete_entry, selector, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_db_schema_delete(schema, batch, NULL);
+	g_assert_true(ret);
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
 static void
 schema_create(void)
 {
@@ -551,5 +927,8 @@ test_db_db(void)
 	g_test_add_func("/db/schema/create_delete", test_db_schema_create_delete);
 	g_test_add_func("/db/entry/new_free", test_db_entry_new_free);
 	g_test_add_func("/db/entry/insert_update_delete", test_db_entry_insert_update_delete);
+	g_test_add_func("/db/sharded", test_db_sharded);
+	g_test_add_func("/db/paged", test_db_paged);
+	g_test_add_func("/db/bulk", test_db_bulk);
 	g_test_add_func("/db/all", test_db_all);
 }
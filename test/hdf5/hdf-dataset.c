@@ -344,7 +344,6 @@ test_hdf_dataset_write_read_selection(hid_t* file_fixture, gconstpointer udata)
 	J_TEST_TRAP_END;
 
 	j_expect_vol_db_fail();
-	j_expect_vol_kv_fail();
 }
 
 static void
@@ -471,7 +470,74 @@ test_hdf_dataset_write_read_single(hid_t* file_fixture, gconstpointer udata)
 	J_TEST_TRAP_END;
 
 	j_expect_vol_db_fail();
-	j_expect_vol_kv_fail();
+}
+
+static void
+test_hdf_dataset_write_read_conversion(hid_t* file_fixture, gconstpointer udata)
+{
+	hid_t file = *file_fixture;
+	hid_t space, set, hyperslab, mem_space;
+	hsize_t rank = 2;
+	hsize_t dim[] = { 100, 100 };
+	hsize_t start[] = { 20, 30 };
+	hsize_t count[] = { 10, 10 };
+	g_autofree int* data = NULL;
+	double read_data[100];
+	herr_t error;
+
+	(void)udata;
+
+	J_TEST_TRAP_START;
+
+	// create dataspace and set
+	space = H5Screate_simple(rank, dim, dim);
+	g_assert_cmpint(space, !=, H5I_INVALID_HID);
+
+	set = H5Dcreate(file, "write_read_conversion_test", H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	g_assert_cmpint(set, !=, H5I_INVALID_HID);
+
+	// generate data
+	data = g_malloc(10000 * sizeof(int));
+	for (int i = 0; i < 10000; ++i)
+		data[i] = i;
+
+	// write data
+	error = H5Dwrite(set, H5T_NATIVE_INT, space, space, H5P_DEFAULT, data);
+	g_assert_cmpint(error, >=, 0);
+
+	// select a block in the middle of the dataset
+	hyperslab = H5Scopy(space);
+	g_assert_cmpint(hyperslab, !=, H5I_INVALID_HID);
+
+	error = H5Sselect_hyperslab(hyperslab, H5S_SELECT_SET, start, NULL, count, NULL);
+	g_assert_cmpint(error, >=, 0);
+
+	mem_space = H5Screate_simple(rank, count, count);
+	g_assert_cmpint(mem_space, !=, H5I_INVALID_HID);
+
+	// read the block as doubles
+	error = H5Dread(set, H5T_NATIVE_DOUBLE, mem_space, hyperslab, H5P_DEFAULT, read_data);
+	g_assert_cmpint(error, >=, 0);
+
+	// check data
+	for (int i = 0; i < 100; ++i)
+		g_assert_cmpint((int)read_data[i], ==, (20 + i / 10) * 100 + 30 + i % 10);
+
+	error = H5Dclose(set);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(mem_space);
+	g_assert_cmpint(error, >=, 0);
+
+	error = H5Sclose(hyperslab);
+	g_assert_cmpint(error, >=, 0);
+
+	J_TEST_TRAP_END;
+
+	j_expect_vol_db_fail();
 }
 
 #endif
@@ -492,6 +558,7 @@ test_hdf_dataset(void)
 	g_test_add("/hdf5/dataset/write_read_selection", hid_t, "set_write_read_sel.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_selection, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read_chunked", hid_t, "set_write_read_chunked.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_chunked, j_test_hdf_file_fixture_teardown);
 	g_test_add("/hdf5/dataset/write_read_single", hid_t, "set_write_read_single.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_single, j_test_hdf_file_fixture_teardown);
+	g_test_add("/hdf5/dataset/write_read_conversion", hid_t, "set_write_read_conversion.h5", j_test_hdf_file_fixture_setup, test_hdf_dataset_write_read_conversion, j_test_hdf_file_fixture_teardown);
 
 #endif
 }
@@ -184,9 +184,116 @@ test_kv_iterator_next_get(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_kv_iterator_range(void)
+{
+	guint const n = 3000;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) delete_batch = NULL;
+	gboolean ret;
+
+	guint kvs = 0;
+
+	J_TEST_TRAP_START;
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	delete_batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+
+	for (guint i = 0; i < n; i++)
+	{
+		g_autoptr(JKV) kv = NULL;
+
+		g_autofree gchar* key = NULL;
+		gchar* value = NULL;
+
+		key = g_strdup_printf("test-key-range-%04d", i);
+		value = g_strdup_printf("test-value-%d", i);
+		kv = j_kv_new("test-ns", key);
+		j_kv_put(kv, value, strlen(value) + 1, g_free, batch);
+		j_kv_delete(kv, delete_batch);
+	}
+
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+
+	// Spans multiple pages
+	{
+		g_autoptr(JKVIterator) iterator = NULL;
+
+		iterator = j_kv_iterator_new_range("test-ns", "test-key-range-", "test-key-range-0500", "test-key-range-2000", 0, J_KV_ITERATOR_NONE);
+
+		while (j_kv_iterator_next(iterator))
+		{
+			gchar const* key;
+			gconstpointer value;
+			guint32 len;
+
+			key = j_kv_iterator_get(iterator, &value, &len);
+			g_assert_cmpstr(key, >=, "test-key-range-0500");
+			g_assert_cmpstr(key, <, "test-key-range-2000");
+			g_assert_true(g_str_has_prefix(value, "test-value-"));
+			kvs++;
+		}
+
+		g_assert_cmpuint(kvs, ==, 1500);
+	}
+
+	kvs = 0;
+
+	{
+		g_autoptr(JKVIterator) iterator = NULL;
+
+		iterator = j_kv_iterator_new_range("test-ns", "test-key-range-", NULL, NULL, 0, J_KV_ITERATOR_KEYS_ONLY);
+
+		while (j_kv_iterator_next(iterator))
+		{
+			gchar const* key;
+			gconstpointer value;
+			guint32 len;
+
+			key = j_kv_iterator_get(iterator, &value, &len);
+			g_assert_true(g_str_has_prefix(key, "test-key-range-"));
+			g_assert_null(value);
+			g_assert_cmpuint(len, >, 0);
+			kvs++;
+		}
+
+		g_assert_cmpuint(kvs, ==, n);
+	}
+
+	kvs = 0;
+
+	{
+		g_autoptr(JKVIterator) iterator = NULL;
+
+		iterator = j_kv_iterator_new_range("test-ns", "test-key-range-", NULL, NULL, 1234, J_KV_ITERATOR_NONE);
+
+		while (j_kv_iterator_next(iterator))
+		{
+			kvs++;
+		}
+
+		g_assert_cmpuint(kvs, ==, 1234);
+	}
+
+	// Freeing an iterator that has not been consumed closes its cursors
+	for (guint i = 0; i < 100; i++)
+	{
+		g_autoptr(JKVIterator) iterator = NULL;
+
+		iterator = j_kv_iterator_new_range("test-ns", "test-key-range-", NULL, NULL, 0, J_KV_ITERATOR_KEYS_ONLY);
+		g_assert_true(j_kv_iterator_next(iterator));
+	}
+
+	ret = j_batch_execute(delete_batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
 void
 test_kv_kv_iterator(void)
 {
 	g_test_add_func("/kv/kv-iterator/new_free", test_kv_iterator_new_free);
 	g_test_add_func("/kv/kv-iterator/next_get", test_kv_iterator_next_get);
+	g_test_add_func("/kv/kv-iterator/range", test_kv_iterator_range);
 }
@@ -188,6 +188,57 @@ test_object_read_write(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_object_striped(void)
+{
+	guint64 const block_size = 4 * 1024;
+	guint64 const length = 64 * block_size;
+
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JDistribution) distribution = NULL;
+	g_autoptr(JDistributedObject) object = NULL;
+	g_autofree gchar* buffer = NULL;
+	g_autofree gchar* buffer2 = NULL;
+	guint64 nbytes = 0;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	buffer = g_malloc(length);
+	buffer2 = g_malloc0(length);
+
+	for (guint64 i = 0; i < length; i++)
+	{
+		buffer[i] = i % 251;
+	}
+
+	// Use many small stripes to have multiple requests per server in flight
+	distribution = j_distribution_new(J_DISTRIBUTION_ROUND_ROBIN);
+	j_distribution_set_block_size(distribution, block_size);
+	object = j_distributed_object_new("test", "test-distributed-object-striped", distribution);
+	g_assert_true(object != NULL);
+
+	j_distributed_object_create(object, batch);
+	j_distributed_object_write(object, buffer, length, 0, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, length);
+
+	nbytes = 0;
+
+	// Start in the middle of a stripe
+	j_distributed_object_read(object, buffer2, length - block_size, block_size / 2, &nbytes, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, length - block_size);
+	g_assert_cmpmem(buffer2, length - block_size, buffer + block_size / 2, length - block_size);
+
+	j_distributed_object_delete(object, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
 static void
 test_object_status(void)
 {
@@ -272,6 +323,7 @@ test_object_distributed_object(void)
 	g_test_add_func("/object/distributed-object/new_free", test_object_new_free);
 	g_test_add_func("/object/distributed-object/create_delete", test_object_create_delete);
 	g_test_add_func("/object/distributed-object/read_write", test_object_read_write);
+	g_test_add_func("/object/distributed-object/striped", test_object_striped);
 	g_test_add_func("/object/distributed-object/status", test_object_status);
 	g_test_add_func("/object/distributed-object/sync", test_object_sync);
 }
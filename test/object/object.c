@@ -255,6 +255,61 @@ test_object_sync(void)
 	J_TEST_TRAP_END;
 }
 
+static void
+test_object_eventual(void)
+{
+	g_autoptr(JBatch) batch = NULL;
+	g_autoptr(JBatch) eventual_batch = NULL;
+	g_autoptr(JObject) object = NULL;
+	g_autoptr(JSemantics) semantics = NULL;
+	g_autofree gchar* buffer = NULL;
+	g_autofree gchar* expected = NULL;
+	guint64 nbytes = 0;
+	guint64 nbytes_read = 0;
+	gboolean ret;
+
+	J_TEST_TRAP_START;
+	semantics = j_semantics_new(J_SEMANTICS_TEMPLATE_DEFAULT);
+	j_semantics_set(semantics, J_SEMANTICS_CONSISTENCY, J_SEMANTICS_CONSISTENCY_EVENTUAL);
+
+	batch = j_batch_new_for_template(J_SEMANTICS_TEMPLATE_DEFAULT);
+	eventual_batch = j_batch_new(semantics);
+	buffer = g_malloc(42);
+	expected = g_malloc(42);
+
+	memset(buffer, 'j', 42);
+	memset(expected, 'j', 42);
+
+	object = j_object_new("test", "test-object-eventual");
+	g_assert_true(object != NULL);
+
+	j_object_create(object, eventual_batch);
+	ret = j_batch_execute(eventual_batch);
+	g_assert_true(ret);
+
+	// Adjacent writes are coalesced
+	j_object_write(object, buffer, 21, 0, &nbytes, eventual_batch);
+	j_object_write(object, buffer + 21, 21, 21, &nbytes, eventual_batch);
+	ret = j_batch_execute(eventual_batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes, ==, 42);
+
+	// The data has been copied, so the buffer can be reused immediately
+	memset(buffer, 0, 42);
+
+	// Immediate batches wait for all cached operations
+	j_object_read(object, buffer, 42, 0, &nbytes_read, batch);
+	ret = j_batch_execute(batch);
+	g_assert_true(ret);
+	g_assert_cmpuint(nbytes_read, ==, 42);
+	g_assert_cmpmem(buffer, 42, expected, 42);
+
+	j_object_delete(object, eventual_batch);
+	ret = j_batch_execute(eventual_batch);
+	g_assert_true(ret);
+	J_TEST_TRAP_END;
+}
+
 void
 test_object_object(void)
 {
@@ -263,4 +318,5 @@ test_object_object(void)
 	g_test_add_func("/object/object/read_write", test_object_read_write);
 	g_test_add_func("/object/object/status", test_object_status);
 	g_test_add_func("/object/object/sync", test_object_sync);
+	g_test_add_func("/object/object/eventual", test_object_eventual);
 }
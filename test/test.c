@@ -52,7 +52,11 @@ main(int argc, char** argv)
 	test_core_list_iterator();
 	test_core_memory_chunk();
 	test_core_message();
+	test_core_read_cache();
 	test_core_semantics();
+	test_core_slab();
+	test_core_statistics();
+	test_core_vector();
 
 	// Object client
 	test_object_distributed_object();
@@ -47,7 +47,11 @@ void test_core_list(void);
 void test_core_list_iterator(void);
 void test_core_memory_chunk(void);
 void test_core_message(void);
+void test_core_read_cache(void);
 void test_core_semantics(void);
+void test_core_slab(void);
+void test_core_statistics(void);
+void test_core_vector(void);
 
 void test_object_distributed_object(void);
 void test_object_object(void);
@@ -38,11 +38,17 @@ static gchar const* opt_kv_backend = NULL;
 static gchar const* opt_kv_path = NULL;
 static gchar const* opt_db_backend = NULL;
 static gchar const* opt_db_path = NULL;
+static gint opt_db_query_batch_size = 0;
 static gint64 opt_max_operation_size = 0;
 static gint64 opt_max_inject_size = 0;
 static gint opt_port = 0;
+static gchar const* opt_transport = NULL;
 static gint opt_max_connections = 0;
+static gboolean opt_multiplex = FALSE;
 static gint64 opt_stripe_size = 0;
+static gint opt_stripe_window = 0;
+static gint64 opt_read_cache_size = 0;
+static gint opt_read_cache_lease = 0;
 
 static gchar**
 string_split(gchar const* string)
@@ -106,8 +112,18 @@ write_config(gchar* path)
 	g_key_file_set_int64(key_file, "core", "max-operation-size", opt_max_operation_size);
 	g_key_file_set_int64(key_file, "core", "max-inject-size", opt_max_inject_size);
 	g_key_file_set_integer(key_file, "core", "port", opt_port);
+
+	if (opt_transport != NULL)
+	{
+		g_key_file_set_string(key_file, "core", "transport", opt_transport);
+	}
+
 	g_key_file_set_integer(key_file, "clients", "max-connections", opt_max_connections);
+	g_key_file_set_boolean(key_file, "clients", "multiplex", opt_multiplex);
 	g_key_file_set_int64(key_file, "clients", "stripe-size", opt_stripe_size);
+	g_key_file_set_integer(key_file, "clients", "stripe-window", opt_stripe_window);
+	g_key_file_set_int64(key_file, "clients", "read-cache-size", opt_read_cache_size);
+	g_key_file_set_integer(key_file, "clients", "read-cache-lease", opt_read_cache_lease);
 	g_key_file_set_string_list(key_file, "servers", "object", (gchar const* const*)servers_object, g_strv_length(servers_object));
 	g_key_file_set_string_list(key_file, "servers", "kv", (gchar const* const*)servers_kv, g_strv_length(servers_kv));
 	g_key_file_set_string_list(key_file, "servers", "db", (gchar const* const*)servers_db, g_strv_length(servers_db));
@@ -117,6 +133,7 @@ write_config(gchar* path)
 	g_key_file_set_string(key_file, "kv", "path", opt_kv_path);
 	g_key_file_set_string(key_file, "db", "backend", opt_db_backend);
 	g_key_file_set_string(key_file, "db", "path", opt_db_path);
+	g_key_file_set_integer(key_file, "db", "query-batch-size", opt_db_query_batch_size);
 	key_file_data = g_key_file_to_data(key_file, &key_file_data_len, NULL);
 
 	if (path != NULL)
@@ -159,11 +176,17 @@ main(gint argc, gchar** argv)
 		{ "kv-path", 0, 0, G_OPTION_ARG_STRING, &opt_kv_path, "Key-value path to use", "/path/to/storage" },
 		{ "db-backend", 0, 0, G_OPTION_ARG_STRING, &opt_db_backend, "Database backend to use", "sqlite|null|…" },
 		{ "db-path", 0, 0, G_OPTION_ARG_STRING, &opt_db_path, "Database path to use", "/path/to/storage" },
+		{ "db-query-batch-size", 0, 0, G_OPTION_ARG_INT, &opt_db_query_batch_size, "Number of rows returned per database query reply", "0" },
 		{ "max-operation-size", 0, 0, G_OPTION_ARG_INT64, &opt_max_operation_size, "Maximum size of an operation", "0" },
 		{ "max-inject-size", 0, 0, G_OPTION_ARG_INT64, &opt_max_inject_size, "Maximum inject size", "0" },
 		{ "port", 0, 0, G_OPTION_ARG_INT, &opt_port, "Default network port", "0" },
+		{ "transport", 0, 0, G_OPTION_ARG_STRING, &opt_transport, "Transport to use", "tcp|libfabric" },
 		{ "max-connections", 0, 0, G_OPTION_ARG_INT, &opt_max_connections, "Maximum number of connections", "0" },
+		{ "multiplex", 0, 0, G_OPTION_ARG_NONE, &opt_multiplex, "Send multiple requests over each connection concurrently", NULL },
 		{ "stripe-size", 0, 0, G_OPTION_ARG_INT64, &opt_stripe_size, "Default stripe size", "0" },
+		{ "stripe-window", 0, 0, G_OPTION_ARG_INT, &opt_stripe_window, "Number of requests per server kept in flight for distributed objects", "0" },
+		{ "read-cache-size", 0, 0, G_OPTION_ARG_INT64, &opt_read_cache_size, "Size of the client read cache (0 disables it)", "0" },
+		{ "read-cache-lease", 0, 0, G_OPTION_ARG_INT, &opt_read_cache_lease, "Lease time of client read cache entries in milliseconds", "0" },
 		{ NULL, 0, 0, 0, NULL, NULL, NULL }
 	};
 
@@ -192,6 +215,10 @@ main(gint argc, gchar** argv)
 	    || opt_max_inject_size < 0
 	    || opt_max_connections < 0
 	    || opt_stripe_size < 0
+	    || opt_stripe_window < 0
+	    || opt_read_cache_size < 0
+	    || opt_read_cache_lease < 0
+	    || (opt_transport != NULL && g_strcmp0(opt_transport, "tcp") != 0 && g_strcmp0(opt_transport, "libfabric") != 0)
 	    || opt_port < 0 || opt_port > 65535)
 	{
 		g_autofree gchar* help = NULL;
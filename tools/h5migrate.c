@@ -24,14 +24,54 @@
 
 #include <hdf5.h>
 
+static gint opt_memory = 64;
+static gint opt_workers = 1;
+static gboolean opt_progress = FALSE;
+
 struct JHDF5CopyParam_t
 {
+	hid_t src_file;
+	hid_t dst_file;
 	hid_t dest_curr_group;
+	/* absolute path of the current group, empty for the root group */
+	gchar* curr_path;
 	hid_t dxpl;
+	/* datasets whose data still has to be copied */
+	GPtrArray* jobs;
 };
 
 typedef struct JHDF5CopyParam_t JHDF5CopyParam_t;
 
+/* the data of one dataset to be copied */
+struct JHDF5CopyJob_t
+{
+	/* the files are not owned by the job, the datasets are only opened while copying */
+	hid_t src_file;
+	hid_t dst_file;
+	hid_t dxpl;
+	/* absolute path of the dataset, identical in both files */
+	gchar* path;
+};
+
+typedef struct JHDF5CopyJob_t JHDF5CopyJob_t;
+
+/* the progress of all copy jobs */
+struct JHDF5CopyProgress_t
+{
+	GMutex mutex;
+	guint64 bytes_total;
+	guint64 bytes_copied;
+	guint datasets_total;
+	guint datasets_copied;
+	gint64 start;
+	gint64 last_report;
+	gint failed;
+};
+
+typedef struct JHDF5CopyProgress_t JHDF5CopyProgress_t;
+
+static JHDF5CopyProgress_t progress;
+
 static herr_t iterate_copy(hid_t group, const char* name, const H5L_info2_t* info, void* op_data);
 static herr_t copy_attributes(hid_t src, hid_t dst);
 
@@ -129,6 +169,366 @@ create_fapl_for_vol(const gchar* vol)
 	return fapl;
 }
 
+/**
+ * Free a copy job.
+ *
+ * \param data The job to free.
+ */
+static void
+copy_job_free(gpointer data)
+{
+	JHDF5CopyJob_t* job = data;
+
+	g_free(job->path);
+	g_free(job);
+}
+
+/**
+ * Print the progress and throughput of the copy.
+ *
+ * The progress mutex has to be held.
+ *
+ * \param now The current monotonic time.
+ */
+static void
+print_progress(gint64 now)
+{
+	g_autofree gchar* copied = NULL;
+	g_autofree gchar* total = NULL;
+	g_autofree gchar* throughput = NULL;
+	gdouble seconds;
+
+	seconds = (gdouble)(now - progress.start) / G_USEC_PER_SEC;
+
+	copied = g_format_size(progress.bytes_copied);
+	total = g_format_size(progress.bytes_total);
+	throughput = g_format_size((seconds > 0.0) ? (guint64)(progress.bytes_copied / seconds) : 0);
+
+	g_print("%s of %s copied, %u of %u datasets, %s/s\n", copied, total, progress.datasets_copied, progress.datasets_total, throughput);
+}
+
+/**
+ * Account for copied data and report the progress at most once per second.
+ *
+ * \param bytes The number of bytes copied.
+ * \param dataset_done Whether a dataset has been copied completely.
+ */
+static void
+update_progress(guint64 bytes, gboolean dataset_done)
+{
+	gint64 now;
+
+	g_mutex_lock(&(progress.mutex));
+
+	progress.bytes_copied += bytes;
+
+	if (dataset_done)
+	{
+		progress.datasets_copied++;
+	}
+
+	now = g_get_monotonic_time();
+
+	if (opt_progress && now - progress.last_report >= G_USEC_PER_SEC)
+	{
+		print_progress(now);
+		progress.last_report = now;
+	}
+
+	g_mutex_unlock(&(progress.mutex));
+}
+
+/**
+ * Determine the shape of the hyperslab blocks a dataset is copied in.
+ *
+ * Blocks contain as many elements as fit into the memory budget, cover the innermost dimensions completely if possible
+ * and are aligned to the dataset's chunks.
+ *
+ * \param set The dataset.
+ * \param rank The rank of the dataset.
+ * \param dims The dimensions of the dataset.
+ * \param type_size The size of an element.
+ * \param budget The memory budget in bytes.
+ * \param block Returns the dimensions of a block.
+ */
+static void
+compute_block(hid_t set, gint rank, hsize_t const* dims, gsize type_size, gsize budget, hsize_t* block)
+{
+	g_auto(hid_t) dcpl = H5I_INVALID_HID;
+	g_autofree hsize_t* chunk = NULL;
+	hsize_t elements;
+
+	elements = MAX(budget / type_size, 1);
+
+	for (gint i = rank - 1; i >= 0; i--)
+	{
+		if (dims[i] <= elements)
+		{
+			block[i] = dims[i];
+			elements /= dims[i];
+		}
+		else
+		{
+			block[i] = elements;
+			elements = 1;
+		}
+	}
+
+	if ((dcpl = H5Dget_create_plist(set)) == H5I_INVALID_HID || H5Pget_layout(dcpl) != H5D_CHUNKED)
+	{
+		return;
+	}
+
+	chunk = g_new(hsize_t, rank);
+
+	if (H5Pget_chunk(dcpl, rank, chunk) != rank)
+	{
+		return;
+	}
+
+	// Avoid reading and writing chunks partially
+	for (gint i = 0; i < rank; i++)
+	{
+		if (block[i] < dims[i] && block[i] > chunk[i])
+		{
+			block[i] -= block[i] % chunk[i];
+		}
+	}
+}
+
+/**
+ * Copy the data of a dataset block by block.
+ *
+ * \param src The source dataset.
+ * \param dst The destination dataset.
+ * \param dxpl The data transfer property list.
+ * \param budget The memory budget in bytes.
+ *
+ * \return A negative value on error.
+ */
+static herr_t
+copy_dataset_data(hid_t src, hid_t dst, hid_t dxpl, gsize budget)
+{
+	g_auto(hid_t) space = H5I_INVALID_HID;
+	g_auto(hid_t) dtype = H5I_INVALID_HID;
+	g_autofree hsize_t* dims = NULL;
+	g_autofree hsize_t* block = NULL;
+	g_autofree hsize_t* start = NULL;
+	g_autofree hsize_t* count = NULL;
+	g_autofree gchar* buf = NULL;
+	hssize_t npoints;
+	hsize_t block_elements;
+	gsize type_size;
+	gint rank;
+	herr_t retval = -1;
+
+	if ((space = H5Dget_space(src)) == H5I_INVALID_HID)
+	{
+		return retval;
+	}
+
+	if ((dtype = H5Dget_type(src)) == H5I_INVALID_HID)
+	{
+		return retval;
+	}
+
+	if ((type_size = H5Tget_size(dtype)) == 0)
+	{
+		return retval;
+	}
+
+	if ((npoints = H5Sget_simple_extent_npoints(space)) < 0)
+	{
+		return retval;
+	}
+
+	if (npoints == 0)
+	{
+		update_progress(0, TRUE);
+		retval = 0;
+		return retval;
+	}
+
+	if ((rank = H5Sget_simple_extent_ndims(space)) < 0)
+	{
+		return retval;
+	}
+
+	// Scalar datasets consist of a single element
+	if (rank == 0)
+	{
+		buf = g_malloc(type_size);
+
+		if (H5Dread(src, dtype, H5S_ALL, H5S_ALL, dxpl, buf) < 0 || H5Dwrite(dst, dtype, H5S_ALL, H5S_ALL, dxpl, buf) < 0)
+		{
+			return retval;
+		}
+
+		update_progress(type_size, TRUE);
+		retval = 0;
+		return retval;
+	}
+
+	dims = g_new(hsize_t, rank);
+	block = g_new(hsize_t, rank);
+	start = g_new0(hsize_t, rank);
+	count = g_new(hsize_t, rank);
+
+	H5Sget_simple_extent_dims(space, dims, NULL);
+	compute_block(src, rank, dims, type_size, budget, block);
+
+	block_elements = 1;
+
+	for (gint i = 0; i < rank; i++)
+	{
+		block_elements *= block[i];
+	}
+
+	buf = g_malloc(block_elements * type_size);
+
+	while (TRUE)
+	{
+		g_auto(hid_t) mem_space = H5I_INVALID_HID;
+		hsize_t count_elements = 1;
+		gint i;
+
+		for (i = 0; i < rank; i++)
+		{
+			count[i] = MIN(block[i], dims[i] - start[i]);
+			count_elements *= count[i];
+		}
+
+		if (H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+		{
+			return retval;
+		}
+
+		if ((mem_space = H5Screate_simple(rank, count, NULL)) == H5I_INVALID_HID)
+		{
+			return retval;
+		}
+
+		if (H5Dread(src, dtype, mem_space, space, dxpl, buf) < 0)
+		{
+			return retval;
+		}
+
+		if (H5Dwrite(dst, dtype, mem_space, space, dxpl, buf) < 0)
+		{
+			return retval;
+		}
+
+		// Advance to the next block in row-major order
+		for (i = rank - 1; i >= 0; i--)
+		{
+			start[i] += block[i];
+
+			if (start[i] < dims[i])
+			{
+				break;
+			}
+
+			start[i] = 0;
+		}
+
+		update_progress(count_elements * type_size, i < 0);
+
+		if (i < 0)
+		{
+			break;
+		}
+	}
+
+	retval = 0;
+	return retval;
+}
+
+/**
+ * Copy the data of a dataset. Function of type GFunc.
+ *
+ * Gets called by the worker pool.
+ * Both datasets are only kept open while their data is copied.
+ *
+ * \param data The copy job.
+ * \param user_data A pointer to the memory budget of a worker.
+ */
+static void
+copy_job_run(gpointer data, gpointer user_data)
+{
+	g_auto(hid_t) src = H5I_INVALID_HID;
+	g_auto(hid_t) dst = H5I_INVALID_HID;
+	JHDF5CopyJob_t* job = data;
+	gsize budget = *((gsize*)user_data);
+
+	if ((src = H5Dopen2(job->src_file, job->path, H5P_DEFAULT)) == H5I_INVALID_HID || (dst = H5Dopen2(job->dst_file, job->path, H5P_DEFAULT)) == H5I_INVALID_HID || copy_dataset_data(src, dst, job->dxpl, budget) < 0)
+	{
+		g_critical("%s: Could not copy dataset \"%s\"!", G_STRLOC, job->path);
+		g_atomic_int_set(&(progress.failed), TRUE);
+	}
+}
+
+/**
+ * Copy the data of all datasets.
+ *
+ * The datasets are distributed among a pool of workers if the HDF5 library is thread-safe.
+ * Thread-safe HDF5 serializes all API calls behind a global lock, so the workers do not overlap their I/O within the library.
+ * Each worker therefore gets the full memory budget instead of a share of it, which would only make the blocks smaller.
+ *
+ * \param jobs The copy jobs.
+ *
+ * \return A negative value on error.
+ */
+static herr_t
+copy_jobs(GPtrArray* jobs)
+{
+	hbool_t threadsafe = FALSE;
+	guint workers;
+	gsize budget;
+
+	workers = MIN((guint)opt_workers, MAX(jobs->len, 1));
+
+	if (workers > 1 && (H5is_library_threadsafe(&threadsafe) < 0 || !threadsafe))
+	{
+		g_warning("%s: HDF5 is not thread-safe, copying datasets sequentially.", G_STRLOC);
+		workers = 1;
+	}
+
+	budget = (gsize)opt_memory * 1024 * 1024;
+	progress.start = g_get_monotonic_time();
+	progress.last_report = progress.start;
+
+	if (workers == 1)
+	{
+		for (guint i = 0; i < jobs->len; i++)
+		{
+			copy_job_run(g_ptr_array_index(jobs, i), &budget);
+		}
+	}
+	else
+	{
+		GThreadPool* pool;
+
+		pool = g_thread_pool_new(copy_job_run, &budget, workers, TRUE, NULL);
+
+		for (guint i = 0; i < jobs->len; i++)
+		{
+			g_thread_pool_push(pool, g_ptr_array_index(jobs, i), NULL);
+		}
+
+		// Wait for all jobs to finish
+		g_thread_pool_free(pool, FALSE, TRUE);
+	}
+
+	if (opt_progress)
+	{
+		g_mutex_lock(&(progress.mutex));
+		print_progress(g_get_monotonic_time());
+		g_mutex_unlock(&(progress.mutex));
+	}
+
+	return g_atomic_int_get(&(progress.failed)) ? -1 : 0;
+}
+
 /**
  * Copy the files content to a different file.
  *
@@ -140,6 +540,7 @@ create_fapl_for_vol(const gchar* vol)
 static herr_t
 copy_file(hid_t src_file, hid_t dest_file)
 {
+	g_autoptr(GPtrArray) jobs = NULL;
 	JHDF5CopyParam_t copy_data;
 	herr_t retval = -1;
 
@@ -149,9 +550,25 @@ copy_file(hid_t src_file, hid_t dest_file)
 		return retval;
 	}
 
+	jobs = g_ptr_array_new_with_free_func(copy_job_free);
+
+	copy_data.src_file = src_file;
+	copy_data.dst_file = dest_file;
 	copy_data.dest_curr_group = dest_file;
+	copy_data.curr_path = g_strdup("");
 	copy_data.dxpl = H5P_DEFAULT;
+	copy_data.jobs = jobs;
+
+	// Create the objects first, the data of the datasets is copied afterwards
 	retval = H5Literate(src_file, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, iterate_copy, &copy_data);
+	g_free(copy_data.curr_path);
+
+	if (retval < 0)
+	{
+		return retval;
+	}
+
+	retval = copy_jobs(jobs);
 
 	return retval;
 }
@@ -254,22 +671,25 @@ copy_attributes(hid_t src, hid_t dst)
 /**
  * Copy a dataset to a new location.
  *
+ * Only the dataset and its attributes are created, a job to copy the data is added to the copy parameters.
+ *
  * \param set The dataset to copy.
  * \param dst_loc The location identfier of the target group.
  * \param dst_name The name of the new copy.
- * \param dxpl_id The dataset transfer property list.
+ * \param copy_data The copy parameters.
  *
  * \return A negative value on error.
  */
 static herr_t
-copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
+copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, JHDF5CopyParam_t* copy_data)
 {
 	g_auto(hid_t) dst = H5I_INVALID_HID;
 	g_auto(hid_t) space = H5I_INVALID_HID;
 	g_auto(hid_t) dtype = H5I_INVALID_HID;
 	g_auto(hid_t) dapl = H5I_INVALID_HID;
-	g_autofree gchar* buf = NULL;
-	size_t mem_size;
+	JHDF5CopyJob_t* job;
+	hssize_t npoints;
+	size_t type_size;
 	herr_t retval = -1;
 
 	// copy general attributes of the set
@@ -289,12 +709,7 @@ copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
 	}
 
 	// determine size of data set in memory
-	if ((mem_size = H5Sget_select_npoints(space) * H5Tget_size(dtype)) <= 0)
-	{
-		return retval;
-	}
-
-	if (!(buf = g_malloc(mem_size)))
+	if ((npoints = H5Sget_select_npoints(space)) < 0 || (type_size = H5Tget_size(dtype)) == 0)
 	{
 		return retval;
 	}
@@ -309,15 +724,17 @@ copy_dataset(hid_t set, hid_t dst_loc, const gchar* dst_name, hid_t dxpl_id)
 		return retval;
 	}
 
-	if (H5Dread(set, dtype, space, space, dxpl_id, buf) < 0)
-	{
-		return retval;
-	}
+	// the datasets are closed here and reopened by path when their data is copied
+	job = g_new(JHDF5CopyJob_t, 1);
+	job->src_file = copy_data->src_file;
+	job->dst_file = copy_data->dst_file;
+	job->dxpl = copy_data->dxpl;
+	job->path = g_strconcat(copy_data->curr_path, "/", dst_name, NULL);
 
-	if (H5Dwrite(dst, dtype, space, space, dxpl_id, buf) < 0)
-	{
-		return retval;
-	}
+	g_ptr_array_add(copy_data->jobs, job);
+
+	progress.bytes_total += npoints * type_size;
+	progress.datasets_total++;
 
 	retval = 0;
 	return retval;
@@ -339,26 +756,33 @@ static herr_t
 handle_copy(hid_t object, const gchar* name, JHDF5CopyParam_t* copy_data)
 {
 	hid_t tmp_grp;
+	gchar* tmp_path;
 	herr_t retval = -1;
 
 	switch (H5Iget_type(object))
 	{
 		case H5I_GROUP:
 			tmp_grp = copy_data->dest_curr_group;
+			tmp_path = copy_data->curr_path;
 			if ((copy_data->dest_curr_group = H5Gcreate(tmp_grp, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) != H5I_INVALID_HID)
 			{
+				copy_data->curr_path = g_strconcat(tmp_path, "/", name, NULL);
+
 				if ((retval = H5Literate(object, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, iterate_copy, copy_data)) >= 0)
 				{
 					retval = copy_attributes(object, copy_data->dest_curr_group);
 				}
 
+				g_free(copy_data->curr_path);
+				copy_data->curr_path = tmp_path;
+
 				H5Gclose(copy_data->dest_curr_group);
 				copy_data->dest_curr_group = tmp_grp;
 			}
 			break;
 
 		case H5I_DATASET:
-			retval = copy_dataset(object, copy_data->dest_curr_group, name, copy_data->dxpl);
+			retval = copy_dataset(object, copy_data->dest_curr_group, name, copy_data);
 			break;
 
 		case H5I_DATATYPE:
@@ -420,16 +844,6 @@ iterate_copy(hid_t group, const char* name, const H5L_info2_t* info, void* op_da
 	return retval;
 }
 
-/**
- * Print the usage.
- */
-static void
-usage(void)
-{
-	/// \todo use argv[0]
-	printf("Usage: h5migrate [volname://]source [volname://]target\n");
-}
-
 int
 main(int argc, char** argv)
 {
@@ -439,22 +853,49 @@ main(int argc, char** argv)
 	g_auto(hid_t) fapl_vol_dst = H5I_INVALID_HID;
 	g_auto(GStrv) src_components = NULL;
 	g_auto(GStrv) dst_components = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	GError* error = NULL;
 	gchar* source = NULL;
 	gchar* destination = NULL;
 	herr_t retval = -1;
 
+	GOptionEntry entries[] = {
+		{ "memory", 0, 0, G_OPTION_ARG_INT, &opt_memory, "Memory to use for buffering data per worker in MiB", "64" },
+		{ "workers", 0, 0, G_OPTION_ARG_INT, &opt_workers, "Number of datasets to copy concurrently (HDF5 serializes its API calls, so this does not overlap I/O)", "1" },
+		{ "progress", 0, 0, G_OPTION_ARG_NONE, &opt_progress, "Report progress and throughput", NULL },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
+
 	/**
 	 * \todo Needed because otherwise native VOL cannot be used.
 	 */
 	g_setenv("HDF5_VOL_CONNECTOR", "native", true);
 
-	if (argc <= 2)
+	context = g_option_context_new("[volname://]source [volname://]target");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error))
 	{
-		usage();
+		if (error)
+		{
+			g_warning("%s", error->message);
+			g_error_free(error);
+		}
+
+		return retval;
+	}
+
+	if (argc != 3 || opt_memory <= 0 || opt_workers <= 0)
+	{
+		g_autofree gchar* help = NULL;
+
+		help = g_option_context_get_help(context, TRUE, NULL);
+		g_print("%s", help);
+
 		return retval;
 	}
 
-	/// \todo add options (e.g. chunked copy or copy only some objects like h5copy)
+	/// \todo add options to copy only some objects like h5copy
 	source = argv[1];
 	destination = argv[2];
 
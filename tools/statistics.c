@@ -28,6 +28,47 @@
 #include <jmessage.h>
 #include <jstatistics.h>
 
+static gboolean opt_prometheus = FALSE;
+
+/**
+ * Estimates a percentile using a histogram.
+ *
+ * \param statistics A statistics.
+ * \param type       A message type.
+ * \param histogram  A histogram.
+ * \param percentile A percentile between 0 and 1.
+ *
+ * \return The upper bound of the bucket containing the percentile in microseconds, 0 if there are no values.
+ **/
+static guint64
+get_percentile(JStatistics* statistics, JMessageType type, JStatisticsHistogram histogram, gdouble percentile)
+{
+	guint64 count;
+	guint64 rank;
+	guint64 seen = 0;
+
+	count = j_statistics_get_message(statistics, type, J_STATISTICS_MESSAGE_REQUESTS);
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	rank = MAX(1, (guint64)(percentile * count + 0.5));
+
+	for (guint i = 0; i < J_STATISTICS_HISTOGRAM_BUCKETS; i++)
+	{
+		seen += j_statistics_get_histogram(statistics, type, histogram, i);
+
+		if (seen >= rank)
+		{
+			return G_GUINT64_CONSTANT(1) << i;
+		}
+	}
+
+	return G_GUINT64_CONSTANT(1) << (J_STATISTICS_HISTOGRAM_BUCKETS - 1);
+}
+
 static void
 print_statistics(JStatistics* statistics)
 {
@@ -54,90 +95,197 @@ print_statistics(JStatistics* statistics)
 	g_free(size_written);
 	g_free(size_received);
 	g_free(size_sent);
+
+	g_print("  %-20s %10s %10s %9s %13s %13s %13s %13s\n", "message", "requests", "operations", "in flight", "queue avg[µs]", "queue p99[µs]", "serv. avg[µs]", "serv. p99[µs]");
+
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		guint64 requests;
+		guint64 in_flight;
+
+		requests = j_statistics_get_message(statistics, i, J_STATISTICS_MESSAGE_REQUESTS);
+		in_flight = j_statistics_get_message(statistics, i, J_STATISTICS_MESSAGE_IN_FLIGHT);
+
+		if (requests == 0 && in_flight == 0)
+		{
+			continue;
+		}
+
+		g_print("  %-20s %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT " %9" G_GUINT64_FORMAT " %13" G_GUINT64_FORMAT " %13" G_GUINT64_FORMAT " %13" G_GUINT64_FORMAT " %13" G_GUINT64_FORMAT "\n",
+			j_statistics_get_message_type_name(i),
+			requests,
+			j_statistics_get_message(statistics, i, J_STATISTICS_MESSAGE_OPERATIONS),
+			in_flight,
+			(requests > 0) ? j_statistics_get_message(statistics, i, J_STATISTICS_MESSAGE_QUEUE_TIME) / requests : 0,
+			get_percentile(statistics, i, J_STATISTICS_HISTOGRAM_QUEUE_TIME, 0.99),
+			(requests > 0) ? j_statistics_get_message(statistics, i, J_STATISTICS_MESSAGE_SERVICE_TIME) / requests : 0,
+			get_percentile(statistics, i, J_STATISTICS_HISTOGRAM_SERVICE_TIME, 0.99));
+	}
 }
 
-int
-main(int argc, char** argv)
+static void
+add_statistics(JStatistics* statistics, JStatistics* statistics_total, JStatisticsType type, guint64 value)
+{
+	j_statistics_add(statistics, type, value);
+	j_statistics_add(statistics_total, type, value);
+}
+
+/**
+ * Reads the statistics of a server.
+ *
+ * \param connection       A connection to the server.
+ * \param statistics       The server's statistics.
+ * \param statistics_total The statistics of all servers.
+ **/
+static void
+get_statistics(gpointer connection, JStatistics* statistics, JStatistics* statistics_total)
 {
-	JConfiguration* configuration;
 	g_autoptr(JMessage) message = NULL;
-	JStatistics* statistics_total;
+	g_autoptr(JMessage) reply = NULL;
 	gchar get_all;
 
-	(void)argc;
-	(void)argv;
-
-	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
-	setlocale(LC_ALL, "C.UTF-8");
-
 	get_all = 1;
-	configuration = j_configuration();
-	statistics_total = j_statistics_new(FALSE);
 
 	message = j_message_new(J_MESSAGE_STATISTICS, sizeof(gchar));
 	j_message_add_operation(message, 0);
 	j_message_append_1(message, &get_all);
 
-	for (guint i = 0; i < j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT); i++)
-	{
-		g_autoptr(JMessage) reply = NULL;
-		JStatistics* statistics;
-		gpointer connection;
-		guint64 value;
+	j_message_send(message, connection);
 
-		connection = j_connection_pool_pop(J_BACKEND_TYPE_OBJECT, i);
-		statistics = j_statistics_new(FALSE);
+	reply = j_message_new_reply(message);
+	j_message_receive(reply, connection);
 
-		j_message_send(message, connection);
+	add_statistics(statistics, statistics_total, J_STATISTICS_FILES_CREATED, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_FILES_DELETED, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_FILES_STATED, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_SYNC, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_BYTES_READ, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_BYTES_WRITTEN, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_BYTES_RECEIVED, j_message_get_8(reply));
+	add_statistics(statistics, statistics_total, J_STATISTICS_BYTES_SENT, j_message_get_8(reply));
 
-		reply = j_message_new_reply(message);
-		j_message_receive(reply, connection);
+	for (guint i = 0; i < J_STATISTICS_MESSAGE_TYPES; i++)
+	{
+		static JStatisticsMessage const values[] = {
+			J_STATISTICS_MESSAGE_REQUESTS,
+			J_STATISTICS_MESSAGE_OPERATIONS,
+			J_STATISTICS_MESSAGE_IN_FLIGHT,
+			J_STATISTICS_MESSAGE_QUEUE_TIME,
+			J_STATISTICS_MESSAGE_SERVICE_TIME
+		};
+
+		static JStatisticsHistogram const histograms[] = {
+			J_STATISTICS_HISTOGRAM_QUEUE_TIME,
+			J_STATISTICS_HISTOGRAM_SERVICE_TIME
+		};
+
+		for (guint j = 0; j < G_N_ELEMENTS(values); j++)
+		{
+			guint64 value;
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_CREATED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_CREATED, value);
+			value = j_message_get_8(reply);
+			j_statistics_add_message(statistics, i, values[j], value);
+			j_statistics_add_message(statistics_total, i, values[j], value);
+		}
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_DELETED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_DELETED, value);
+		for (guint j = 0; j < G_N_ELEMENTS(histograms); j++)
+		{
+			for (guint k = 0; k < J_STATISTICS_HISTOGRAM_BUCKETS; k++)
+			{
+				guint64 value;
+
+				value = j_message_get_8(reply);
+				j_statistics_add_histogram(statistics, i, histograms[j], k, value);
+				j_statistics_add_histogram(statistics_total, i, histograms[j], k, value);
+			}
+		}
+	}
+}
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_FILES_STATED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_FILES_STATED, value);
+int
+main(int argc, char** argv)
+{
+	JConfiguration* configuration;
+	JStatistics* statistics_total;
+	GError* error = NULL;
+	g_autoptr(GOptionContext) context = NULL;
+	g_autoptr(GHashTable) servers = NULL;
+	guint server_count = 0;
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_SYNC, value);
-		j_statistics_add(statistics_total, J_STATISTICS_SYNC, value);
+	GOptionEntry entries[] = {
+		{ "prometheus", 0, 0, G_OPTION_ARG_NONE, &opt_prometheus, "Print the statistics of all servers in the Prometheus text format", NULL },
+		{ NULL, 0, 0, 0, NULL, NULL, NULL }
+	};
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_READ, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_READ, value);
+	// Explicitly enable UTF-8 since functions such as g_format_size might return UTF-8 characters.
+	setlocale(LC_ALL, "C.UTF-8");
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_WRITTEN, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_WRITTEN, value);
+	context = g_option_context_new(NULL);
+	g_option_context_add_main_entries(context, entries, NULL);
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_RECEIVED, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_RECEIVED, value);
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		if (error)
+		{
+			g_warning("%s", error->message);
+			g_error_free(error);
+		}
 
-		value = j_message_get_8(reply);
-		j_statistics_add(statistics, J_STATISTICS_BYTES_SENT, value);
-		j_statistics_add(statistics_total, J_STATISTICS_BYTES_SENT, value);
+		return 1;
+	}
 
-		g_print("Data server %d\n", i);
-		print_statistics(statistics);
+	configuration = j_configuration();
+	statistics_total = j_statistics_new(FALSE);
+	servers = g_hash_table_new(g_str_hash, g_str_equal);
 
-		if (i != j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT) - 1)
+	for (JBackendType type = J_BACKEND_TYPE_OBJECT; type <= J_BACKEND_TYPE_DB; type++)
+	{
+		for (guint i = 0; i < j_configuration_get_server_count(configuration, type); i++)
 		{
-			g_print("\n");
-		}
+			JStatistics* statistics;
+			gchar const* server;
+			gpointer connection;
+
+			server = j_configuration_get_server(configuration, type, i);
+
+			// A server might handle multiple backend types
+			if (!g_hash_table_add(servers, (gpointer)server))
+			{
+				continue;
+			}
 
-		j_statistics_free(statistics);
-		j_connection_pool_push(J_BACKEND_TYPE_OBJECT, i, connection);
+			connection = j_connection_pool_pop(type, i);
+			statistics = j_statistics_new(FALSE);
+
+			get_statistics(connection, statistics, statistics_total);
+
+			if (!opt_prometheus)
+			{
+				if (server_count > 0)
+				{
+					g_print("\n");
+				}
+
+				g_print("Server %s\n", server);
+				print_statistics(statistics);
+			}
+
+			server_count++;
+
+			j_statistics_free(statistics);
+			j_connection_pool_push(type, i, connection);
+		}
 	}
 
-	if (j_configuration_get_server_count(configuration, J_BACKEND_TYPE_OBJECT) > 1)
+	if (opt_prometheus)
+	{
+		g_autofree gchar* text = NULL;
+
+		// Servers export their own statistics when started with --metrics
+		text = j_statistics_to_prometheus(statistics_total, NULL);
+		g_print("%s", text);
+	}
+	else if (server_count > 1)
 	{
 		g_print("\n");
 		g_print("Total\n");